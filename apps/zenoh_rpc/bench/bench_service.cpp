@@ -0,0 +1,179 @@
+// Bench Service - Implementation
+
+#include "bench_service.h"
+
+#include <zephyr/logging/log.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "rpc/zenoh_attachment.h"
+
+LOG_MODULE_REGISTER(bench_service, LOG_LEVEL_INF);
+
+namespace bench {
+
+namespace {
+
+// Byte i is i % 256: the host checks Source replies and samples cheaply
+struct Pattern {
+  uint8_t bytes[kMaxBenchPayload];
+  constexpr Pattern() : bytes() {
+    for (size_t i = 0; i < kMaxBenchPayload; ++i) {
+      bytes[i] = static_cast<uint8_t>(i);
+    }
+  }
+};
+constexpr Pattern kPattern;
+
+uint32_t clamp_size(uint32_t size) {
+  return std::min<uint32_t>(size, kMaxBenchPayload);
+}
+
+}  // namespace
+
+BenchServiceImpl::BenchServiceImpl(z_loaned_session_t* session,
+                                   const char* device_id)
+    : session_(session),
+      running_(false),
+      rate_hz_(0),
+      size_(0),
+      duration_ms_(0),
+      start_us_(0),
+      last_us_(0),
+      sequence_(0),
+      published_(0),
+      failed_(0) {
+  k_mutex_init(&mutex_);
+  snprintf(key_expr_, sizeof(key_expr_), "%s%s", device_id, kBenchDataSuffix);
+}
+
+BenchServiceImpl::~BenchServiceImpl() {
+  k_mutex_lock(&mutex_, K_FOREVER);
+  stop_locked();
+  k_mutex_unlock(&mutex_);
+}
+
+zenoh_rpc::RpcStatus BenchServiceImpl::Ping(const practice_rpc_Empty& request,
+                                            practice_rpc_Empty* response,
+                                            const zenoh_rpc::RpcContext& ctx) {
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceImpl::Sink(
+    const practice_rpc_BenchPayload& request,
+    practice_rpc_BenchSinkResponse* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  response->received = request.data.size;
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceImpl::Source(
+    const practice_rpc_BenchSourceRequest& request,
+    practice_rpc_BenchPayload* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  uint32_t size = clamp_size(request.size);
+  memcpy(response->data.bytes, kPattern.bytes, size);
+  response->data.size = static_cast<pb_size_t>(size);
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceImpl::StartPublisher(
+    const practice_rpc_BenchPublishRequest& request,
+    practice_rpc_Empty* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  k_mutex_lock(&mutex_, K_FOREVER);
+  stop_locked();
+
+  z_view_keyexpr_t ke;
+  z_publisher_options_t opts;
+  z_publisher_options_default(&opts);
+  opts.is_express = request.express;
+  if (z_view_keyexpr_from_str(&ke, key_expr_) != Z_OK ||
+      publisher_.declare(session_, z_loan(ke), &opts,
+                         zenoh_rpc::PublicationCache()) != Z_OK) {
+    k_mutex_unlock(&mutex_);
+    LOG_ERR("Failed to declare the publisher on %s", key_expr_);
+    return zenoh_rpc::RpcStatus::TRANSPORT_ERROR;
+  }
+  rate_hz_ = std::max<uint32_t>(request.rate_hz, 1);
+  size_ = clamp_size(request.size);
+  duration_ms_ = request.duration_ms;
+  start_us_ = zenoh_rpc::monotonic_us();
+  last_us_ = start_us_;
+  sequence_ = 0;
+  published_ = 0;
+  failed_ = 0;
+  running_ = true;
+  k_mutex_unlock(&mutex_);
+
+  LOG_INF("Publishing %u bytes at %u Hz for %u ms%s on %s", size_, rate_hz_,
+          duration_ms_, request.express ? " (express)" : "", key_expr_);
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceImpl::StopPublisher(
+    const practice_rpc_Empty& request,
+    practice_rpc_BenchPublisherStats* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  k_mutex_lock(&mutex_, K_FOREVER);
+  stop_locked();
+  response->published = published_;
+  response->failed = failed_;
+  response->elapsed_us = last_us_ - start_us_;
+  k_mutex_unlock(&mutex_);
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+void BenchServiceImpl::tick() {
+  k_mutex_lock(&mutex_, K_FOREVER);
+  if (running_) {
+    uint64_t elapsed_us = zenoh_rpc::monotonic_us() - start_us_;
+    if (duration_ms_ != 0 && elapsed_us >= uint64_t{duration_ms_} * 1000) {
+      stop_locked();
+      LOG_INF("Published %u samples (%u failed)", published_, failed_);
+    } else {
+      // Samples due since the start; the first one at the start
+      uint64_t due = elapsed_us * rate_hz_ / 1000000 + 1;
+      for (uint32_t n = 0; sequence_ < due && n < kMaxBenchBurst; ++n) {
+        publish_one();
+      }
+    }
+  }
+  k_mutex_unlock(&mutex_);
+}
+
+void BenchServiceImpl::publish_one() {
+  // The payload refers to the pattern in flash: no copy, no heap for it
+  z_owned_bytes_t payload;
+  if (size_ == 0) {
+    z_bytes_empty(&payload);
+  } else {
+    z_bytes_from_static_buf(&payload, kPattern.bytes, size_);
+  }
+
+  last_us_ = zenoh_rpc::monotonic_us();
+  zenoh_rpc::AttachmentWriter attachment;
+  attachment.put_u32(zenoh_rpc::AttachmentKey::SEQUENCE, sequence_++);
+  attachment.put_u64(zenoh_rpc::AttachmentKey::SOURCE_TIMESTAMP_US, last_us_);
+  z_publisher_put_options_t opts;
+  z_publisher_put_options_default(&opts);
+  z_owned_bytes_t attachment_bytes;
+  if (attachment.to_bytes(&attachment_bytes) == Z_OK) {
+    opts.attachment = z_bytes_move(&attachment_bytes);
+  }
+
+  if (publisher_.put(z_bytes_move(&payload), &opts) == Z_OK) {
+    published_++;
+  } else {
+    failed_++;
+  }
+}
+
+void BenchServiceImpl::stop_locked() {
+  publisher_.undeclare();
+  running_ = false;
+}
+
+}  // namespace bench
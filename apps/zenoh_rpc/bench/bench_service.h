@@ -0,0 +1,95 @@
+// Bench Service - built-in link benchmark (CONFIG_APP_BENCH_SERVICE)
+//
+// Handlers of fixed, minimal cost, so that what tools/bench_sweep.py
+// measures is the transport and the RPC layer rather than the
+// application: Ping answers an empty request, Sink discards the payload
+// decoded into the handler slot, Source returns bytes of a constant
+// pattern in flash. None of them logs or touches the heap.
+//
+// The publisher sends `size` pattern bytes on <device>/bench/data at
+// `rate_hz`, with the sequence number and source timestamp attachments of
+// the telemetry publishers. The payload refers to the pattern (no copy);
+// the publisher is declared by StartPublisher and undeclared when the run
+// ends. tick() runs from the event loop every millisecond and publishes
+// the samples due since the start, at most kMaxBenchBurst per tick: above
+// about kMaxBenchBurst kHz (or with a slow loop in single-thread mode) the
+// achieved rate falls behind the requested one, which the host sees.
+
+#pragma once
+
+#include <zenoh-pico.h>
+#include <zephyr/kernel.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rpc/service_server.h"
+#include "rpc/zenoh_pubsub.h"
+
+namespace bench {
+
+// Largest Sink/Source payload and published sample (service.options)
+constexpr size_t kMaxBenchPayload =
+    sizeof(practice_rpc_BenchPayload{}.data.bytes);
+// Samples published per tick when behind schedule
+constexpr uint32_t kMaxBenchBurst = 8;
+// Key of the published samples, after the device ID
+constexpr const char* kBenchDataSuffix = "/bench/data";
+
+class BenchServiceImpl : public practice::rpc::BenchService {
+ public:
+  BenchServiceImpl(z_loaned_session_t* session, const char* device_id);
+  ~BenchServiceImpl() override;
+
+  // Non-copyable
+  BenchServiceImpl(const BenchServiceImpl&) = delete;
+  BenchServiceImpl& operator=(const BenchServiceImpl&) = delete;
+
+  zenoh_rpc::RpcStatus Ping(const practice_rpc_Empty& request,
+                            practice_rpc_Empty* response,
+                            const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus Sink(const practice_rpc_BenchPayload& request,
+                            practice_rpc_BenchSinkResponse* response,
+                            const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus Source(const practice_rpc_BenchSourceRequest& request,
+                              practice_rpc_BenchPayload* response,
+                              const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus StartPublisher(
+      const practice_rpc_BenchPublishRequest& request,
+      practice_rpc_Empty* response,
+      const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus StopPublisher(
+      const practice_rpc_Empty& request,
+      practice_rpc_BenchPublisherStats* response,
+      const zenoh_rpc::RpcContext& ctx) override;
+
+  // Publish the samples due (called every millisecond from the event loop)
+  void tick();
+
+ private:
+  // Called with mutex_ held
+  void publish_one();
+  void stop_locked();
+
+  z_loaned_session_t* session_;
+  char key_expr_[zenoh_rpc::kMaxTopicLen];
+
+  // Publisher state, shared by the RPC handlers and tick()
+  struct k_mutex mutex_;
+  zenoh_rpc::ZenohPublisher publisher_;
+  bool running_;
+  uint32_t rate_hz_;
+  uint32_t size_;
+  uint32_t duration_ms_;
+  uint64_t start_us_;
+  uint64_t last_us_;
+  uint32_t sequence_;
+  uint32_t published_;
+  uint32_t failed_;
+};
+
+}  // namespace bench
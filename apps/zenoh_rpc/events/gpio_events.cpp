@@ -0,0 +1,190 @@
+// GPIO Events - Implementation
+
+#include "gpio_events.h"
+
+#include <zephyr/logging/log.h>
+
+#include "rpc/zenoh_attachment.h"
+
+LOG_MODULE_REGISTER(gpio_events, LOG_LEVEL_INF);
+
+namespace events {
+
+#define EVENT_INPUTS_NODE DT_PATH(event_inputs)
+
+#if DT_NODE_EXISTS(EVENT_INPUTS_NODE)
+#define EVENT_INPUT_SPEC(node_id) GPIO_DT_SPEC_GET(node_id, gpios),
+static const struct gpio_dt_spec kInputSpecs[] = {
+    DT_FOREACH_CHILD(EVENT_INPUTS_NODE, EVENT_INPUT_SPEC)};
+#undef EVENT_INPUT_SPEC
+#else
+static const struct gpio_dt_spec* const kInputSpecs = nullptr;
+#endif
+
+#if DT_NODE_EXISTS(EVENT_INPUTS_NODE)
+static constexpr size_t kInputSpecCount = ARRAY_SIZE(kInputSpecs);
+#else
+static constexpr size_t kInputSpecCount = 0;
+#endif
+
+#if Z_FEATURE_MULTI_THREAD == 1
+K_THREAD_STACK_DEFINE(gpio_event_stack, CONFIG_APP_GPIO_EVENT_STACK_SIZE);
+#endif
+
+GpioEventCapture::GpioEventCapture(Publisher* publisher)
+    : publisher_(publisher),
+      input_count_(0),
+      head_(0),
+      tail_(0),
+      overflows_(0),
+      reported_overflows_(0),
+      published_(0),
+      failed_(0),
+      max_latency_us_(0),
+      sum_latency_us_(0) {
+  k_sem_init(&ready_, 0, 1);
+#if Z_FEATURE_MULTI_THREAD == 1
+  started_ = false;
+#endif
+}
+
+bool GpioEventCapture::init() {
+  if (kInputSpecCount > kMaxEventInputs) {
+    LOG_WRN("%u event inputs, using the first %u",
+            static_cast<unsigned>(kInputSpecCount),
+            static_cast<unsigned>(kMaxEventInputs));
+  }
+  for (size_t i = 0; i < kInputSpecCount && i < kMaxEventInputs; ++i) {
+    Input& input = inputs_[input_count_];
+    input.spec = kInputSpecs[i];
+    input.owner = this;
+    input.line = static_cast<uint8_t>(i);
+    if (!gpio_is_ready_dt(&input.spec)) {
+      LOG_ERR("Event input %u: device not ready", static_cast<unsigned>(i));
+      return false;
+    }
+    int ret = gpio_pin_configure_dt(&input.spec, GPIO_INPUT);
+    if (ret == 0) {
+      gpio_init_callback(&input.callback, on_edge, BIT(input.spec.pin));
+      ret = gpio_add_callback_dt(&input.spec, &input.callback);
+    }
+    if (ret == 0) {
+      ret = gpio_pin_interrupt_configure_dt(&input.spec, GPIO_INT_EDGE_BOTH);
+    }
+    if (ret != 0) {
+      LOG_ERR("Event input %u: configuration failed: %d",
+              static_cast<unsigned>(i), ret);
+      return false;
+    }
+    input_count_++;
+  }
+  LOG_INF("%u GPIO event inputs", static_cast<unsigned>(input_count_));
+  return true;
+}
+
+void GpioEventCapture::on_edge(const struct device* port,
+                               struct gpio_callback* cb, uint32_t pins) {
+  ARG_UNUSED(port);
+  ARG_UNUSED(pins);
+  // Stamp first: everything after it is part of the measured latency
+  const uint32_t cycles = k_cycle_get_32();
+  Input* input = CONTAINER_OF(cb, Input, callback);
+  GpioEventCapture* self = input->owner;
+
+  const uint32_t head = self->head_.load(std::memory_order_relaxed);
+  if (head - self->tail_.load(std::memory_order_acquire) >= kEventQueueSize) {
+    self->overflows_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Edge& edge = self->ring_[head & (kEventQueueSize - 1)];
+  edge.cycles = cycles;
+  edge.line = input->line;
+  edge.level = gpio_pin_get_dt(&input->spec) > 0 ? 1 : 0;
+  self->head_.store(head + 1, std::memory_order_release);
+  k_sem_give(&self->ready_);
+}
+
+size_t GpioEventCapture::drain() {
+  size_t n = 0;
+  uint32_t tail = tail_.load(std::memory_order_relaxed);
+  while (tail != head_.load(std::memory_order_acquire)) {
+    // Copy out and free the slot before the (slow) publish
+    const Edge edge = ring_[tail & (kEventQueueSize - 1)];
+    tail_.store(++tail, std::memory_order_release);
+    publish(edge);
+    n++;
+  }
+  return n;
+}
+
+void GpioEventCapture::publish(const Edge& edge) {
+  // The cycle counter wraps after tens of seconds at 150 MHz; queued edges
+  // are far younger, so the unsigned difference is their age
+  const uint32_t age_us = k_cyc_to_us_floor32(k_cycle_get_32() - edge.cycles);
+  const uint32_t overflows = overflows_.load(std::memory_order_relaxed);
+
+  practice_rpc_GpioEvent event = practice_rpc_GpioEvent_init_zero;
+  event.line = edge.line;
+  event.level = edge.level != 0;
+  event.timestamp_us = zenoh_rpc::monotonic_us() - age_us;
+  event.queued_us = age_us;
+  event.dropped = overflows - reported_overflows_;
+  if (publisher_ == nullptr || !publisher_->publish(event)) {
+    failed_++;
+    return;
+  }
+  reported_overflows_ = overflows;
+
+  const uint32_t latency_us =
+      k_cyc_to_us_floor32(k_cycle_get_32() - edge.cycles);
+  published_++;
+  sum_latency_us_ += latency_us;
+  if (latency_us > max_latency_us_) {
+    max_latency_us_ = latency_us;
+  }
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+bool GpioEventCapture::start() {
+  if (started_) {
+    return true;
+  }
+  k_thread_create(&thread_, gpio_event_stack,
+                  K_THREAD_STACK_SIZEOF(gpio_event_stack), thread_main, this,
+                  nullptr, nullptr,
+                  K_PRIO_PREEMPT(CONFIG_APP_GPIO_EVENT_PRIORITY), 0,
+                  K_NO_WAIT);
+  k_thread_name_set(&thread_, "gpio_events");
+  started_ = true;
+  return true;
+}
+
+void GpioEventCapture::thread_main(void* p1, void* p2, void* p3) {
+  ARG_UNUSED(p2);
+  ARG_UNUSED(p3);
+  auto* self = static_cast<GpioEventCapture*>(p1);
+  while (true) {
+    k_sem_take(&self->ready_, K_FOREVER);
+    self->drain();
+  }
+}
+#endif
+
+void GpioEventCapture::log_stats() {
+  const uint32_t overflows = overflows_.load(std::memory_order_relaxed);
+  if (published_ == 0 && failed_ == 0) {
+    return;
+  }
+  LOG_INF("GPIO events: %u published, %u failed, %u dropped (total), "
+          "latency avg %u us, max %u us",
+          published_, failed_, overflows,
+          published_ ? static_cast<uint32_t>(sum_latency_us_ / published_)
+                     : 0,
+          max_latency_us_);
+  published_ = 0;
+  failed_ = 0;
+  max_latency_us_ = 0;
+  sum_latency_us_ = 0;
+}
+
+}  // namespace events
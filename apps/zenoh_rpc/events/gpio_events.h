@@ -0,0 +1,113 @@
+// GPIO Events - edge-triggered inputs published with low latency
+//
+// The GPIO interrupt only stamps the edge with the cycle counter and pushes
+// it into a lock-free ring; a high-priority thread drains the ring and
+// publishes one GpioEvent per edge (express, real-time priority), so an
+// edge reaches the host within milliseconds instead of with the next 1 s
+// telemetry tick. The inputs are the children of the /event-inputs
+// devicetree node (boards/*.overlay).
+//
+// Z_FEATURE_MULTI_THREAD == 0: there is no publisher thread; call drain()
+//   from the event loop (ZenohEventLoop::add_poll()). The latency is then
+//   bounded by the zp_read() timeout.
+
+#pragma once
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "rpc/service.pb.h"
+#include "rpc/zenoh_pubsub.h"
+
+namespace events {
+
+// Event inputs handled (children of /event-inputs beyond are ignored)
+constexpr size_t kMaxEventInputs = 4;
+// Edges buffered between the interrupt and the publisher (power of two)
+constexpr uint32_t kEventQueueSize = CONFIG_APP_GPIO_EVENT_QUEUE;
+static_assert((kEventQueueSize & (kEventQueueSize - 1)) == 0,
+              "CONFIG_APP_GPIO_EVENT_QUEUE must be a power of two");
+
+/**
+ * @brief Captures GPIO edges in interrupt context and publishes them
+ *
+ * The ring has a single producer (the interrupts of the GPIO controller,
+ * which do not nest) and a single consumer (drain()); neither side takes a
+ * lock. A full ring drops the new edge; the count is sent with the next
+ * published event (GpioEvent.dropped).
+ */
+class GpioEventCapture {
+ public:
+  using Publisher = zenoh_rpc::TelemetryPublisher<practice_rpc_GpioEvent>;
+
+  explicit GpioEventCapture(Publisher* publisher);
+
+  // Non-copyable
+  GpioEventCapture(const GpioEventCapture&) = delete;
+  GpioEventCapture& operator=(const GpioEventCapture&) = delete;
+
+  // Configure the inputs and enable their edge interrupts
+  bool init();
+
+#if Z_FEATURE_MULTI_THREAD == 1
+  // Publish from a thread woken by the interrupt
+  bool start();
+#endif
+
+  // Publish the queued edges; returns how many were taken from the ring
+  size_t drain();
+
+  // Log the counters and the interrupt-to-published latency
+  void log_stats();
+
+  size_t input_count() const { return input_count_; }
+
+ private:
+  struct Edge {
+    uint32_t cycles;  // k_cycle_get_32() in the interrupt
+    uint8_t line;
+    uint8_t level;
+  };
+
+  struct Input {
+    struct gpio_dt_spec spec;
+    struct gpio_callback callback;
+    GpioEventCapture* owner;
+    uint8_t line;
+  };
+
+  static void on_edge(const struct device* port, struct gpio_callback* cb,
+                      uint32_t pins);
+#if Z_FEATURE_MULTI_THREAD == 1
+  static void thread_main(void* p1, void* p2, void* p3);
+#endif
+  void publish(const Edge& edge);
+
+  Publisher* publisher_;
+  Input inputs_[kMaxEventInputs];
+  size_t input_count_;
+
+  // Ring: the interrupt advances head_, drain() advances tail_
+  Edge ring_[kEventQueueSize];
+  std::atomic<uint32_t> head_;
+  std::atomic<uint32_t> tail_;
+  std::atomic<uint32_t> overflows_;
+  uint32_t reported_overflows_;
+  struct k_sem ready_;
+#if Z_FEATURE_MULTI_THREAD == 1
+  struct k_thread thread_;
+  bool started_;
+#endif
+
+  // Counters since the last log_stats()
+  uint32_t published_;
+  uint32_t failed_;
+  uint32_t max_latency_us_;
+  uint64_t sum_latency_us_;
+};
+
+}  // namespace events
@@ -4,22 +4,38 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/sys_heap.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_if.h>
 #include <zephyr/sys/reboot.h>
 #include <zephyr/usb/usb_device.h>
 
+#include "rpc/alloc_guard.h"
+#include "rpc/rate_control.h"
 #include "rpc/service_server.h"
+#include "rpc/rpc_scheduler.h"
+#include "rpc/timed_dispatch.h"
+#include "rpc/service_settings.h"
+#include "rpc/state_sync.h"
+#include "rpc/telemetry_batch.h"
+#include "rpc/zenoh_event_loop.h"
 #include "rpc/zenoh_pubsub.h"
 #include "rpc/zenoh_rpc_channel.h"
 #include "service.pb.h"
 #include "service_impl.h"
+#include "settings/settings_store.h"
+#ifdef CONFIG_APP_BENCH_SERVICE
+#include "bench/bench_service.h"
+#endif
+#ifdef CONFIG_APP_GPIO_EVENTS
+#include "events/gpio_events.h"
+#endif
 #include "wifi/wifi_manager.h"
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
-// Device ID for telemetry topics
-#define DEVICE_ID "pico2w-001"
+// Device ID for RPC keys and telemetry topics
+#define DEVICE_ID CONFIG_APP_DEVICE_ID
 
 // LED GPIO (same as in device_service_impl.cpp)
 #define LED0_NODE DT_ALIAS(led0)
@@ -34,6 +50,48 @@ const struct device* usb_dev = DEVICE_DT_GET(DT_NODELABEL(cdc_acm_uart0));
 // Zenoh server port
 #define ZENOH_LISTEN_PORT "7447"
 
+// Handler time spent per single-thread loop iteration before the session is
+// serviced again [us]
+#define RPC_POLL_BUDGET_US 50000
+
+// Sensor sample interval: the full telemetry rate [ms]
+#define SENSOR_INTERVAL_MS 1000
+
+// Settings cache (entries generated from messages with the settings_key option)
+static practice::rpc::ServiceSettings settings;
+
+// Publication caches (samples kept for late-joining / recovering subscribers)
+#ifdef CONFIG_APP_ZENOH_ADVANCED_PUBLICATION
+static const zenoh_rpc::PublicationCache telemetry_cache = {
+    CONFIG_APP_TELEMETRY_CACHE_SAMPLES};
+static const zenoh_rpc::PublicationCache log_cache = {
+    CONFIG_APP_LOG_CACHE_SAMPLES};
+#else
+static const zenoh_rpc::PublicationCache telemetry_cache;
+static const zenoh_rpc::PublicationCache log_cache;
+#endif
+
+#ifdef CONFIG_APP_GPIO_EVENTS
+// GPIO events overtake telemetry and logs and are not batched
+static const zenoh_rpc::PublisherQos event_qos = {
+    Z_PRIORITY_REAL_TIME, Z_CONGESTION_CONTROL_BLOCK, true};
+#endif
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+// Heap used by zenoh-pico (k_malloc), incl. the publication caches
+extern struct k_heap _system_heap;
+
+static void log_heap_stats() {
+  struct sys_memory_stats stats;
+  if (sys_heap_runtime_stats_get(&_system_heap.heap, &stats) == 0) {
+    LOG_INF("Heap: %u bytes allocated, %u max, %u free",
+            static_cast<uint32_t>(stats.allocated_bytes),
+            static_cast<uint32_t>(stats.max_allocated_bytes),
+            static_cast<uint32_t>(stats.free_bytes));
+  }
+}
+#endif
+
 // Check if DTR is set (Data Terminal Ready)
 // This indicates that the host has opened the serial port
 static bool is_dtr_set(const struct device* dev) {
@@ -70,11 +128,28 @@ int main() {
   }
   LOG_INF("CDC-ACM device ready: %s", usb_dev->name);
 
+  // Load settings into RAM
+  config::SettingsStore& settings_store = config::get_settings_store();
+  settings.register_all(settings_store);
+  if (!settings_store.load()) {
+    LOG_ERR("Failed to load settings");
+  }
+
   // Initialize Wi-Fi manager
   wifi::WifiManager& wifi_mgr = wifi::get_wifi_manager();
   if (wifi_mgr.init()) {
-    // Check for stored credentials and auto-connect
-    if (wifi_mgr.has_stored_credentials()) {
+    practice_rpc_WifiSettings wifi_settings = settings.wifi_settings.get();
+    // Check for stored settings/credentials and auto-connect
+    if (wifi_settings.ssid[0] != '\0') {
+      LOG_INF("Found stored Wi-Fi settings, connecting...");
+      if (wifi_mgr.connect(wifi_settings.ssid, wifi_settings.password)) {
+        LOG_INF("Wi-Fi connection initiated");
+        // Give some time for Wi-Fi to connect
+        k_sleep(K_SECONDS(5));
+      } else {
+        LOG_WRN("Failed to initiate Wi-Fi connection");
+      }
+    } else if (wifi_mgr.has_stored_credentials()) {
       LOG_INF("Found stored Wi-Fi credentials, connecting...");
       if (wifi_mgr.connect_from_storage()) {
         LOG_INF("Wi-Fi connection initiated");
@@ -139,49 +214,162 @@ int main() {
   // Get loaned session (mutable loan for Pub/Sub and RPC)
   z_loaned_session_t* session_loan = z_session_loan_mut(&session);
   zenoh_rpc::ZenohRpcChannel channel(session_loan, DEVICE_ID);
+  // Fair share of handler time per calling client (CLIENT_ID attachment)
+  zenoh_rpc::SchedulerConfig scheduler_config;
+  scheduler_config.quantum_us = CONFIG_APP_RPC_QUANTUM_US;
+  scheduler_config.max_in_flight = CONFIG_APP_RPC_MAX_IN_FLIGHT;
+  scheduler_config.rate_per_s = CONFIG_APP_RPC_CLIENT_RATE;
+  zenoh_rpc::RpcScheduler scheduler(scheduler_config);
+  channel.set_scheduler(&scheduler);
+  // Calls to run at a given device time (EXECUTE_AT_US attachment), and the
+  // device clock the callers schedule them with
+  zenoh_rpc::TimedDispatchConfig timed_config;
+  timed_config.lead_us = CONFIG_APP_RPC_TIMED_LEAD_US;
+  timed_config.max_late_us = CONFIG_APP_RPC_TIMED_MAX_LATE_US;
+  zenoh_rpc::TimedDispatcher timed(timed_config);
+  channel.set_timed_dispatcher(&timed);
+  channel.serve_clock();
   zenoh_rpc::TelemetryPublisher<practice_rpc_SensorTelemetry> sensor_pub(
       session_loan, DEVICE_ID, PRACTICE_RPC_SENSOR_TELEMETRY_ZENOH_KEY,
-      practice_rpc_SensorTelemetry_fields);
-  zenoh_rpc::LogPublisher log_pub(session_loan, DEVICE_ID);
-  practice::rpc::DeviceServiceImpl service_impl(&sensor_pub, &log_pub);
+      practice_rpc_SensorTelemetry_fields, telemetry_cache);
+  // Compressed sensor batches (StartSensorStream with batch_size > 1)
+  zenoh_rpc::TelemetryPublisher<practice_rpc_TelemetryBatch> sensor_batch_pub(
+      session_loan, DEVICE_ID,
+      PRACTICE_RPC_SENSOR_TELEMETRY_ZENOH_KEY ZENOH_TELEMETRY_BATCH_SUFFIX,
+      practice_rpc_TelemetryBatch_fields, telemetry_cache);
+  practice::rpc::SensorBatcher sensor_batcher(
+      &sensor_batch_pub, practice_rpc_SensorTelemetry_fields);
+  zenoh_rpc::LogPublisher log_pub(session_loan, DEVICE_ID, log_cache);
+#ifdef CONFIG_APP_GPIO_EVENTS
+  // Edges of the /event-inputs pins, published from their interrupt
+  zenoh_rpc::TelemetryPublisher<practice_rpc_GpioEvent> gpio_event_pub(
+      session_loan, DEVICE_ID, PRACTICE_RPC_GPIO_EVENT_ZENOH_KEY,
+      practice_rpc_GpioEvent_fields, zenoh_rpc::PublicationCache(),
+      event_qos);
+  events::GpioEventCapture gpio_events(&gpio_event_pub);
+  if (!gpio_events.init()) {
+    LOG_WRN("GPIO events unavailable");
+  }
+#endif
+  // Device state: deltas on <device>/state, full state on /state/snapshot
+  practice::rpc::DeviceStateSync device_state(
+      session_loan, DEVICE_ID, PRACTICE_RPC_DEVICE_STATE_STATE_KEY,
+      practice_rpc_DeviceState_fields, practice_rpc_DeviceState_init_zero);
+  practice::rpc::DeviceServiceImpl service_impl(
+      &sensor_pub, &sensor_batcher, &log_pub, &settings, &device_state);
+#ifdef CONFIG_APP_TELEMETRY_RATE_CONTROL
+  // Sensor samples and batches back off together when the link congests
+  zenoh_rpc::RateControlConfig sensor_rate_config;
+  sensor_rate_config.min_interval_ms = SENSOR_INTERVAL_MS;
+  sensor_rate_config.max_interval_ms =
+      PRACTICE_RPC_SENSOR_TELEMETRY_MAX_INTERVAL_MS;
+  sensor_rate_config.max_batch = PRACTICE_RPC_SENSOR_TELEMETRY_MAX_BATCH;
+  sensor_rate_config.latency_threshold_us = CONFIG_APP_TELEMETRY_CONGESTION_US;
+  zenoh_rpc::TelemetryRateControl sensor_rate(sensor_rate_config);
+  sensor_pub.set_rate_control(&sensor_rate);
+  sensor_batch_pub.set_rate_control(&sensor_rate);
+  service_impl.set_sensor_rate_control(&sensor_rate);
+#endif
   practice::rpc::DeviceServiceServer server(channel, service_impl);
   if (!server.register_handlers()) {
     LOG_ERR("Failed to register RPC handlers");
     z_drop(z_session_move(&session));
     return -1;
   }
-  LOG_INF("Starting Zenoh read and lease tasks...");
-  z_result_t read_res = zp_start_read_task(session_loan, NULL);
-  z_result_t lease_res = zp_start_lease_task(session_loan, NULL);
-  LOG_INF("Read task result: %d, Lease task result: %d", read_res, lease_res);
-  if (read_res != Z_OK || lease_res != Z_OK) {
-    LOG_ERR("Failed to start Zenoh tasks");
+#ifdef CONFIG_APP_BENCH_SERVICE
+  // Link benchmark (tools/bench_sweep.py)
+  bench::BenchServiceImpl bench_impl(session_loan, DEVICE_ID);
+  practice::rpc::BenchServiceServer bench_server(channel, bench_impl);
+  if (!bench_server.register_handlers()) {
+    LOG_WRN("BenchService unavailable");
   }
-  // Main loop: Sensor Publish
-  LOG_INF("Entering main loop...");
+#endif
+  // Event loop: session servicing (single-thread mode), sensor publish and
+  // host connection monitoring
+  zenoh_rpc::ZenohEventLoop loop(session_loan);
+  // add_periodic() and add_poll() fail once their table is full
+  bool loop_ok = true;
+#if Z_FEATURE_MULTI_THREAD == 1
+  if (!scheduler.start() || !timed.start()) {
+    z_drop(z_session_move(&session));
+    return -1;
+  }
+#ifdef CONFIG_APP_GPIO_EVENTS
+  gpio_events.start();
+#endif
+#else
+  loop_ok &= loop.add_poll([&]() { scheduler.run(RPC_POLL_BUDGET_US); });
+  loop_ok &= loop.add_poll([&]() { timed.run(); });
+#ifdef CONFIG_APP_GPIO_EVENTS
+  loop_ok &= loop.add_poll([&]() { gpio_events.drain(); });
+#endif
+#endif
   uint32_t loop_count = 0;
-  while (true) {
+  loop_ok &= loop.add_periodic(SENSOR_INTERVAL_MS, [&]() {
     loop_count++;
+#ifdef CONFIG_APP_TELEMETRY_RATE_CONTROL
+    // Control calls waiting for a handler: telemetry gives way
+    sensor_rate.set_queue_depth(scheduler.pending());
+#endif
     if (service_impl.is_streaming_enabled()) {
       LOG_INF("Loop %u: Publishing sensor data...", loop_count);
       service_impl.publish_sensor_data();
     } else {
+      service_impl.flush_sensor_batch();
+      // Rules keep sampling the sensor (nothing is published)
+      if (service_impl.has_rules()) {
+        service_impl.publish_sensor_data();
+      }
       if (loop_count % 10 == 0) {
         LOG_INF("Loop %u: Streaming disabled", loop_count);
       }
     }
-    k_sleep(K_MSEC(1000));
-    if (use_wifi == false && is_dtr_set(usb_dev) == false) {
-      LOG_WRN("DTR cleared - host disconnected");
-      break;
-    }
-    if (zp_lease_task_is_running(session_loan) == false ||
-        zp_read_task_is_running(session_loan) == false) {
-      LOG_WRN("Keep-alive failed");
-      break;
-    }
+  });
+  // "repeated N times" / rate limit summaries of the published logs
+  loop_ok &= loop.add_periodic(1000, [&]() { log_pub.flush_repeats(); });
+  loop_ok &=
+      loop.add_periodic(1000, [&]() { service_impl.update_wifi_state(); });
+  loop_ok &= loop.add_periodic(10000, [&]() {
+    scheduler.log_stats();
+    timed.log_stats();
+  });
+  loop_ok &= loop.add_periodic(10000, [&]() { channel.log_stats(); });
+  loop_ok &=
+      loop.add_periodic(10000, [&]() { service_impl.log_rule_stats(); });
+#ifdef CONFIG_APP_TELEMETRY_RATE_CONTROL
+  loop_ok &= loop.add_periodic(10000, [&]() { sensor_rate.log_stats(); });
+#endif
+#ifdef CONFIG_APP_GPIO_EVENTS
+  loop_ok &= loop.add_periodic(10000, [&]() { gpio_events.log_stats(); });
+#endif
+#ifdef CONFIG_APP_BENCH_SERVICE
+  loop_ok &= loop.add_periodic(1, [&]() { bench_impl.tick(); });
+#endif
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+  loop_ok &= loop.add_periodic(10000, [&]() { log_heap_stats(); });
+#endif
+#ifdef CONFIG_APP_ALLOC_GUARD
+  loop_ok &= loop.add_periodic(
+      10000, [&]() { zenoh_rpc::log_alloc_stats(&log_pub); });
+#endif
+  if (use_wifi == false) {
+    loop_ok &= loop.add_periodic(1000, [&]() {
+      if (is_dtr_set(usb_dev) == false) {
+        LOG_WRN("DTR cleared - host disconnected");
+        loop.stop();
+      }
+    });
   }
-  // Reboot
+  if (!loop_ok) {
+    LOG_ERR("Event loop task table full (CONFIG_APP_LOOP_TASKS/POLLS)");
+    z_drop(z_session_move(&session));
+    return -1;
+  }
+  loop.start();
+  LOG_INF("Entering main loop...");
+  loop.run();
+  // Reboot (write pending settings first)
+  settings_store.flush_sync();
   LOG_WRN("Rebooting system...");
   k_sleep(K_MSEC(1000));
   sys_reboot(SYS_REBOOT_COLD);
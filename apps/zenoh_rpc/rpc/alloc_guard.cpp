@@ -0,0 +1,220 @@
+// Alloc Guard - Implementation
+
+#include "alloc_guard.h"
+
+#ifdef ZENOH_RPC_ALLOC_GUARD
+
+#include <atomic>
+#include <cstdlib>
+
+#include "log_wrapper.h"
+#include "zenoh_pubsub.h"
+
+#ifdef __ZEPHYR__
+LOG_MODULE_REGISTER(alloc_guard, LOG_LEVEL_INF);
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+namespace {
+
+constexpr size_t kPathCount = static_cast<size_t>(AllocPath::COUNT);
+
+struct PathCounters {
+  std::atomic<uint32_t> ops{0};
+  std::atomic<uint32_t> warmup_allocs{0};
+  std::atomic<uint32_t> allocs{0};
+  std::atomic<uint32_t> bytes{0};
+};
+
+struct SiteSlot {
+  std::atomic<uintptr_t> caller{0};  // 0: free
+  std::atomic<uint32_t> allocs{0};
+};
+
+PathCounters counters[kPathCount];
+SiteSlot sites[kPathCount][kMaxAllocSites];
+
+// Path of the running thread
+thread_local AllocPath current_path = AllocPath::NONE;
+// Inside an allocator wrapper: the allocator's own nested calls (calloc ->
+// malloc, z_malloc -> k_malloc) are not counted again
+thread_local bool in_allocator = false;
+
+const char* const kPathNames[kPathCount] = {"query", "handler",
+                                            "telemetry"};
+
+void record_site(AllocPath path, uintptr_t caller) {
+  for (SiteSlot& slot : sites[static_cast<size_t>(path)]) {
+    uintptr_t expected = 0;
+    if (!slot.caller.compare_exchange_strong(expected, caller) &&
+        expected != caller) {
+      continue;  // slot of another site
+    }
+    slot.allocs.fetch_add(1);
+    return;
+  }
+}
+
+void note_allocation(size_t size, void* caller) {
+  if (current_path == AllocPath::NONE) {
+    return;
+  }
+  PathCounters& c = counters[static_cast<size_t>(current_path)];
+  if (c.ops.load() <= kAllocWarmupOps) {
+    c.warmup_allocs.fetch_add(1);
+    return;
+  }
+  c.allocs.fetch_add(1);
+  c.bytes.fetch_add(static_cast<uint32_t>(size));
+  record_site(current_path, reinterpret_cast<uintptr_t>(caller));
+#ifdef ZENOH_RPC_ALLOC_GUARD_PANIC
+  LOG_ERR("%u bytes allocated on the %s path at %p",
+          static_cast<unsigned>(size), alloc_path_name(current_path), caller);
+#ifdef __ZEPHYR__
+  k_panic();
+#else
+  abort();
+#endif
+#endif
+}
+
+// Counts one allocation of the outermost wrapper call
+class AllocatorCall {
+ public:
+  AllocatorCall(size_t size, void* caller) : outer_(!in_allocator) {
+    if (outer_) {
+      in_allocator = true;
+      note_allocation(size, caller);
+    }
+  }
+  ~AllocatorCall() {
+    if (outer_) {
+      in_allocator = false;
+    }
+  }
+
+ private:
+  bool outer_;
+};
+
+}  // namespace
+
+AllocScope::AllocScope(AllocPath path) : previous_(current_path) {
+  if (path != previous_ && path != AllocPath::NONE) {
+    counters[static_cast<size_t>(path)].ops.fetch_add(1);
+  }
+  current_path = path;
+}
+
+AllocScope::~AllocScope() { current_path = previous_; }
+
+AllocPathStats alloc_stats(AllocPath path) {
+  const PathCounters& c = counters[static_cast<size_t>(path)];
+  return {c.ops.load(), c.warmup_allocs.load(), c.allocs.load(),
+          c.bytes.load()};
+}
+
+size_t alloc_sites(AllocSite* out, size_t max_sites) {
+  size_t count = 0;
+  for (size_t i = 0; i < kPathCount; ++i) {
+    for (const SiteSlot& slot : sites[i]) {
+      uintptr_t caller = slot.caller.load();
+      if (caller != 0 && count < max_sites) {
+        out[count++] = {caller, static_cast<AllocPath>(i), slot.allocs.load()};
+      }
+    }
+  }
+  return count;
+}
+
+const char* alloc_path_name(AllocPath path) {
+  return path < AllocPath::COUNT ? kPathNames[static_cast<size_t>(path)]
+                                 : "none";
+}
+
+void log_alloc_stats(LogPublisher* log) {
+  LogModuleId module = kDefaultLogModule;
+  if (log != nullptr) {
+    module = log->register_module("alloc_guard");
+  }
+  // key=value: parsed by tools/alloc_report.py
+  for (size_t i = 0; i < kPathCount; ++i) {
+    AllocPath path = static_cast<AllocPath>(i);
+    AllocPathStats s = alloc_stats(path);
+    LOG_INF("%s ops=%u allocs=%u bytes=%u warmup_allocs=%u",
+            alloc_path_name(path), s.ops, s.allocs, s.bytes, s.warmup_allocs);
+    if (log != nullptr) {
+      log->log(module, LogLevel::INFO,
+               "%s ops=%u allocs=%u bytes=%u warmup_allocs=%u",
+               alloc_path_name(path), s.ops, s.allocs, s.bytes,
+               s.warmup_allocs);
+    }
+  }
+  AllocSite found[kPathCount * kMaxAllocSites];
+  size_t count = alloc_sites(found, kPathCount * kMaxAllocSites);
+  for (size_t i = 0; i < count; ++i) {
+    LOG_INF("%s site=0x%08lx allocs=%u", alloc_path_name(found[i].path),
+            static_cast<unsigned long>(found[i].caller), found[i].allocs);
+    if (log != nullptr) {
+      log->log(module, LogLevel::INFO, "%s site=0x%08lx allocs=%u",
+               alloc_path_name(found[i].path),
+               static_cast<unsigned long>(found[i].caller), found[i].allocs);
+    }
+  }
+}
+
+}  // namespace zenoh_rpc
+
+// Allocator wrappers (-Wl,--wrap=<name>, see CMakeLists.txt)
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_z_malloc(size_t size);
+void* __real_z_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  zenoh_rpc::AllocatorCall call(size, __builtin_return_address(0));
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  zenoh_rpc::AllocatorCall call(count * size, __builtin_return_address(0));
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  zenoh_rpc::AllocatorCall call(size, __builtin_return_address(0));
+  return __real_realloc(ptr, size);
+}
+
+void* __wrap_z_malloc(size_t size) {
+  zenoh_rpc::AllocatorCall call(size, __builtin_return_address(0));
+  return __real_z_malloc(size);
+}
+
+void* __wrap_z_realloc(void* ptr, size_t size) {
+  zenoh_rpc::AllocatorCall call(size, __builtin_return_address(0));
+  return __real_z_realloc(ptr, size);
+}
+
+#ifdef __ZEPHYR__
+void* __real_k_malloc(size_t size);
+void* __real_k_calloc(size_t count, size_t size);
+
+void* __wrap_k_malloc(size_t size) {
+  zenoh_rpc::AllocatorCall call(size, __builtin_return_address(0));
+  return __real_k_malloc(size);
+}
+
+void* __wrap_k_calloc(size_t count, size_t size) {
+  zenoh_rpc::AllocatorCall call(count * size, __builtin_return_address(0));
+  return __real_k_calloc(count, size);
+}
+#endif  // __ZEPHYR__
+
+}  // extern "C"
+
+#endif  // ZENOH_RPC_ALLOC_GUARD
@@ -0,0 +1,103 @@
+// Alloc Guard - heap allocations on the steady-state RPC and telemetry paths
+//
+// With CONFIG_APP_ALLOC_GUARD the firmware is linked with --wrap for
+// malloc/calloc/realloc, k_malloc/k_calloc and zenoh-pico's z_malloc/
+// z_realloc. An AllocScope marks the running thread as being on one of the
+// paths below; an allocation inside a scope is attributed to the innermost
+// one. The first ZENOH_RPC_ALLOC_GUARD_WARMUP operations of a path are the
+// warm-up (lazy initialization is allowed there); after that, every
+// allocation is counted with its call site, or stops the firmware with
+// CONFIG_APP_ALLOC_GUARD_PANIC.
+//
+// LogPublisher::log_impl is excluded (AllocPath::NONE, also when called in a
+// guarded scope): it copies every line into a newly allocated zenoh payload,
+// so each log line would count, and logging is diagnostics rather than a
+// steady-state path.
+//
+// Without the option AllocScope is empty and costs nothing.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zenoh_rpc {
+
+class LogPublisher;
+
+enum class AllocPath : uint8_t {
+  QUERY,      // ZenohRpcChannel::query_callback / handle_query (dispatch)
+  HANDLER,    // generated <Service>Server::handle_*
+  TELEMETRY,  // TelemetryPublisher::publish
+  COUNT,
+  // Not guarded, not attributed to an enclosing scope (LogPublisher)
+  NONE = COUNT,
+};
+
+#ifdef ZENOH_RPC_ALLOC_GUARD
+
+#ifndef ZENOH_RPC_ALLOC_GUARD_WARMUP
+#define ZENOH_RPC_ALLOC_GUARD_WARMUP 16
+#endif
+
+// Operations of a path before its allocations count
+constexpr uint32_t kAllocWarmupOps = ZENOH_RPC_ALLOC_GUARD_WARMUP;
+// Distinct allocating call sites recorded per path
+constexpr size_t kMaxAllocSites = 8;
+
+struct AllocPathStats {
+  uint32_t ops;            // scopes entered (nested scopes of the path: 1)
+  uint32_t warmup_allocs;  // allocations during the warm-up
+  uint32_t allocs;         // allocations after the warm-up
+  uint32_t bytes;
+};
+
+struct AllocSite {
+  uintptr_t caller;  // return address of the allocator call
+  AllocPath path;
+  uint32_t allocs;
+};
+
+/**
+ * @brief Marks the current thread as running on a path (RAII)
+ *
+ * Scopes nest; a scope of the path already running does not count as
+ * another operation.
+ */
+class AllocScope {
+ public:
+  explicit AllocScope(AllocPath path);
+  ~AllocScope();
+
+  AllocScope(const AllocScope&) = delete;
+  AllocScope& operator=(const AllocScope&) = delete;
+
+ private:
+  AllocPath previous_;
+};
+
+AllocPathStats alloc_stats(AllocPath path);
+// Recorded call sites; returns their number
+size_t alloc_sites(AllocSite* sites, size_t max_sites);
+const char* alloc_path_name(AllocPath path);
+
+/**
+ * @brief Log the counters of every path and the call sites
+ *
+ * To the console and, if given, published on <device>/log ("alloc_guard"
+ * module), where tools/alloc_report.py reads them.
+ */
+void log_alloc_stats(LogPublisher* log);
+
+#else  // ZENOH_RPC_ALLOC_GUARD
+
+class AllocScope {
+ public:
+  explicit AllocScope(AllocPath) {}
+};
+
+inline void log_alloc_stats(LogPublisher*) {}
+
+#endif  // ZENOH_RPC_ALLOC_GUARD
+
+}  // namespace zenoh_rpc
@@ -0,0 +1,184 @@
+// Gorilla Codec - streaming compression of time series with 32-bit columns
+// Timestamps are delta-of-delta encoded, values XOR-delta encoded against the
+// previous value of the same column (Pelkonen et al., "Gorilla", VLDB 2015).
+// Keep in sync with tools/rpc/telemetry_batch.py
+//
+// Bit stream (MSB first), samples one after another:
+//   first sample:  [timestamp:32] [value:32] x columns
+//   later samples: [timestamp dod] [value xor] x columns
+//   timestamp dod: '0' | '10' int7 | '110' int9 | '1110' int12 | '1111' int32
+//   value xor:     '0'                        same value
+//                  '10' [bits]                fits previous leading/trailing
+//                  '11' [lead:5] [len-1:5] [bits:len]
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zenoh_rpc {
+
+// Maximum number of value columns per stream
+constexpr size_t kMaxGorillaColumns = 8;
+
+// Appends bit fields to a caller-owned buffer
+class BitWriter {
+ public:
+  BitWriter(uint8_t* buf, size_t capacity) : buf_(buf), capacity_(capacity) {}
+
+  void reset() {
+    bits_ = 0;
+    acc_ = 0;
+  }
+
+  // Write the low nbits (1..32) of value
+  void write(uint32_t value, uint8_t nbits) {
+    if (nbits < 32) {
+      value &= (1u << nbits) - 1;
+    }
+    // At most 7 bits are pending, so 39 bits fit the accumulator
+    acc_ = (acc_ << nbits) | value;
+    size_t pending = (bits_ & 7) + nbits;
+    size_t byte = bits_ >> 3;
+    while (pending >= 8) {
+      pending -= 8;
+      buf_[byte++] = static_cast<uint8_t>(acc_ >> pending);
+    }
+    // Keep the partial last byte in the buffer, zero padded
+    if (pending > 0) {
+      buf_[byte] = static_cast<uint8_t>(acc_ << (8 - pending));
+    }
+    bits_ += nbits;
+  }
+
+  size_t bits() const { return bits_; }
+  size_t bytes() const { return (bits_ + 7) >> 3; }
+  size_t free_bits() const { return capacity_ * 8 - bits_; }
+
+ private:
+  uint8_t* buf_;
+  size_t capacity_;
+  size_t bits_ = 0;
+  uint64_t acc_ = 0;
+};
+
+/**
+ * @brief Streaming Gorilla encoder
+ *
+ * RAM use is the output buffer plus a few bytes of state per column; no
+ * sample history is kept. Values are raw 32-bit patterns (float bits for
+ * float fields).
+ */
+class GorillaEncoder {
+ public:
+  GorillaEncoder(uint8_t* buf, size_t capacity, size_t columns)
+      : writer_(buf, capacity),
+        columns_(columns < kMaxGorillaColumns ? columns : kMaxGorillaColumns) {}
+
+  void reset() {
+    writer_.reset();
+    count_ = 0;
+  }
+
+  /**
+   * @brief Append one sample
+   *
+   * @param timestamp_ms Sample time (wraps at 2^32)
+   * @param values One 32-bit value per column
+   * @return false if the buffer may not hold the sample (nothing written)
+   */
+  bool append(uint32_t timestamp_ms, const uint32_t* values) {
+    if (writer_.free_bits() < worst_case_bits()) {
+      return false;
+    }
+    if (count_ == 0) {
+      writer_.write(timestamp_ms, 32);
+      prev_delta_ = 0;
+      for (size_t c = 0; c < columns_; ++c) {
+        writer_.write(values[c], 32);
+        column_[c] = {values[c], kNoWindow, 0};
+      }
+    } else {
+      int32_t delta = static_cast<int32_t>(timestamp_ms - prev_timestamp_);
+      write_dod(delta - prev_delta_);
+      prev_delta_ = delta;
+      for (size_t c = 0; c < columns_; ++c) {
+        write_xor(column_[c], values[c]);
+      }
+    }
+    prev_timestamp_ = timestamp_ms;
+    count_++;
+    return true;
+  }
+
+  size_t count() const { return count_; }
+  size_t columns() const { return columns_; }
+  size_t size() const { return writer_.bytes(); }
+
+ private:
+  static constexpr uint8_t kNoWindow = 0xFF;
+
+  struct ColumnState {
+    uint32_t prev;
+    uint8_t leading;  // kNoWindow until the first non-zero XOR
+    uint8_t trailing;
+  };
+
+  // Largest possible encoding of one sample
+  size_t worst_case_bits() const {
+    return count_ == 0 ? 32 + 32 * columns_
+                       : (4 + 32) + (2 + 5 + 5 + 32) * columns_;
+  }
+
+  void write_dod(int32_t dod) {
+    if (dod == 0) {
+      writer_.write(0b0, 1);
+    } else if (dod >= -64 && dod <= 63) {
+      writer_.write(0b10, 2);
+      writer_.write(static_cast<uint32_t>(dod), 7);
+    } else if (dod >= -256 && dod <= 255) {
+      writer_.write(0b110, 3);
+      writer_.write(static_cast<uint32_t>(dod), 9);
+    } else if (dod >= -2048 && dod <= 2047) {
+      writer_.write(0b1110, 4);
+      writer_.write(static_cast<uint32_t>(dod), 12);
+    } else {
+      writer_.write(0b1111, 4);
+      writer_.write(static_cast<uint32_t>(dod), 32);
+    }
+  }
+
+  void write_xor(ColumnState& s, uint32_t value) {
+    uint32_t x = value ^ s.prev;
+    s.prev = value;
+    if (x == 0) {
+      writer_.write(0b0, 1);
+      return;
+    }
+    uint8_t leading = static_cast<uint8_t>(__builtin_clz(x));
+    uint8_t trailing = static_cast<uint8_t>(__builtin_ctz(x));
+    if (s.leading != kNoWindow && leading >= s.leading &&
+        trailing >= s.trailing) {
+      // Meaningful bits fit the previous window
+      writer_.write(0b10, 2);
+      writer_.write(x >> s.trailing, 32 - s.leading - s.trailing);
+      return;
+    }
+    uint8_t len = 32 - leading - trailing;
+    writer_.write(0b11, 2);
+    writer_.write(leading, 5);
+    writer_.write(len - 1, 5);
+    writer_.write(x >> trailing, len);
+    s.leading = leading;
+    s.trailing = trailing;
+  }
+
+  BitWriter writer_;
+  size_t columns_;
+  size_t count_ = 0;
+  uint32_t prev_timestamp_ = 0;
+  int32_t prev_delta_ = 0;
+  ColumnState column_[kMaxGorillaColumns] = {};
+};
+
+}  // namespace zenoh_rpc
@@ -0,0 +1,71 @@
+// Message Pool - handler request/response storage outside the task stack
+//
+// Generated handlers (service_server.cpp) decode the request and build the
+// response in a slot of a static pool instead of on the stack of the task
+// running them (zenoh read task, RPC worker, timed-call worker or an
+// on-device caller), so that stack stays the same size when max_size grows
+// in service.options. A slot holds the largest request/response pair of the
+// service; there is one slot per concurrently running handler
+// (ZENOH_RPC_HANDLER_SLOTS, set from CONFIG_APP_RPC_HANDLER_SLOTS). If all
+// slots are taken the call fails with RpcStatus::BUSY.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#ifndef ZENOH_RPC_HANDLER_SLOTS
+#define ZENOH_RPC_HANDLER_SLOTS 3
+#endif
+
+namespace zenoh_rpc {
+
+constexpr size_t kHandlerSlots = ZENOH_RPC_HANDLER_SLOTS;
+
+template <typename T, size_t N>
+class MessagePool {
+ public:
+  // Free slot, or NULL if all N are in use
+  T* acquire() {
+    for (size_t i = 0; i < N; ++i) {
+      if (!used_[i].exchange(true, std::memory_order_acquire)) {
+        return &slots_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  void release(T* slot) {
+    used_[slot - slots_].store(false, std::memory_order_release);
+  }
+
+ private:
+  T slots_[N];
+  std::atomic<bool> used_[N] = {};
+};
+
+// Slot held for the lifetime of a handler call
+template <typename T, size_t N>
+class PooledMessage {
+ public:
+  explicit PooledMessage(MessagePool<T, N>& pool)
+      : pool_(pool), slot_(pool.acquire()) {}
+  ~PooledMessage() {
+    if (slot_ != nullptr) {
+      pool_.release(slot_);
+    }
+  }
+
+  // Non-copyable
+  PooledMessage(const PooledMessage&) = delete;
+  PooledMessage& operator=(const PooledMessage&) = delete;
+
+  explicit operator bool() const { return slot_ != nullptr; }
+  T* operator->() const { return slot_; }
+
+ private:
+  MessagePool<T, N>& pool_;
+  T* slot_;
+};
+
+}  // namespace zenoh_rpc
@@ -0,0 +1,124 @@
+// Rate Control - Implementation
+
+#include "rate_control.h"
+
+#include "log_wrapper.h"
+
+#ifdef __ZEPHYR__
+LOG_MODULE_REGISTER(rate_control, LOG_LEVEL_INF);
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+namespace {
+
+uint32_t rate_of(uint32_t interval_ms) {
+  return 1000000 / (interval_ms > 0 ? interval_ms : 1);
+}
+
+}  // namespace
+
+TelemetryRateControl::TelemetryRateControl(const RateControlConfig& config)
+    : config_(config),
+      min_rate_mhz_(rate_of(config.max_interval_ms)),
+      max_rate_mhz_(rate_of(config.min_interval_ms)),
+      rate_mhz_(max_rate_mhz_),
+      batch_(1),
+      congested_(false),
+      window_start_us_(0),
+      last_admit_us_(0),
+      window_max_latency_us_(0),
+      window_failed_(0),
+      window_max_depth_(0),
+      admitted_(0),
+      skipped_(0),
+      puts_(0),
+      failed_(0),
+      backoffs_(0),
+      max_latency_us_(0) {
+  if (min_rate_mhz_ == 0 || min_rate_mhz_ > max_rate_mhz_) {
+    min_rate_mhz_ = max_rate_mhz_;
+  }
+  if (config_.max_batch == 0) {
+    config_.max_batch = 1;
+  }
+}
+
+bool TelemetryRateControl::admit(uint64_t now_us) {
+  if (window_start_us_ == 0) {
+    window_start_us_ = now_us;
+  } else if (now_us - window_start_us_ >=
+             static_cast<uint64_t>(config_.window_ms) * 1000) {
+    close_window(now_us);
+  }
+  // Half a source interval of slack: at the full rate every sample passes
+  // despite the jitter of the source schedule
+  uint64_t interval_us = 1000000000ULL / rate_mhz_;
+  uint64_t slack_us = static_cast<uint64_t>(config_.min_interval_ms) * 500;
+  if (last_admit_us_ != 0 && now_us + slack_us < last_admit_us_ + interval_us) {
+    skipped_++;
+    return false;
+  }
+  last_admit_us_ = now_us;
+  admitted_++;
+  return true;
+}
+
+void TelemetryRateControl::on_put(uint32_t latency_us, bool ok) {
+  puts_++;
+  if (!ok) {
+    failed_++;
+    window_failed_++;
+  }
+  if (latency_us > window_max_latency_us_) {
+    window_max_latency_us_ = latency_us;
+  }
+  if (latency_us > max_latency_us_) {
+    max_latency_us_ = latency_us;
+  }
+}
+
+void TelemetryRateControl::close_window(uint64_t now_us) {
+  congested_ = window_failed_ > 0 ||
+               window_max_latency_us_ > config_.latency_threshold_us ||
+               window_max_depth_ > config_.max_queue_depth;
+  if (congested_) {
+    // Multiplicative decrease: fewer puts first, then fewer samples
+    backoffs_++;
+    if (batch_ < config_.max_batch) {
+      batch_ = batch_ * 2 < config_.max_batch ? batch_ * 2 : config_.max_batch;
+    } else if (rate_mhz_ > min_rate_mhz_) {
+      rate_mhz_ = rate_mhz_ / 2 > min_rate_mhz_ ? rate_mhz_ / 2 : min_rate_mhz_;
+    }
+  } else if (rate_mhz_ < max_rate_mhz_) {
+    // Additive increase: the rate comes back before the batches shrink
+    rate_mhz_ = max_rate_mhz_ - rate_mhz_ > config_.increase_mhz
+                    ? rate_mhz_ + config_.increase_mhz
+                    : max_rate_mhz_;
+  } else if (batch_ > 1) {
+    batch_--;
+  }
+  window_start_us_ = now_us;
+  window_max_latency_us_ = 0;
+  window_failed_ = 0;
+  window_max_depth_ = 0;
+}
+
+void TelemetryRateControl::log_stats() {
+  if (admitted_ == 0 && skipped_ == 0) {
+    return;
+  }
+  LOG_INF("Telemetry rate: %u.%03u/s, batch %u%s; %u published, "
+          "%u skipped, %u puts (%u failed, max %u us), %u backoffs",
+          rate_mhz_ / 1000, rate_mhz_ % 1000, batch_,
+          congested_ ? " (congested)" : "", admitted_, skipped_, puts_,
+          failed_, max_latency_us_, backoffs_);
+  admitted_ = 0;
+  skipped_ = 0;
+  puts_ = 0;
+  failed_ = 0;
+  backoffs_ = 0;
+  max_latency_us_ = 0;
+}
+
+}  // namespace zenoh_rpc
@@ -0,0 +1,115 @@
+// Rate Control - congestion-aware publish rate of a telemetry stream
+//
+// Telemetry shares the link with RPC replies. With a fixed sample rate a
+// saturated Wi-Fi or serial link makes the puts block (congestion control
+// BLOCK) or fail, and control calls wait behind the samples. The controller
+// watches, per evaluation window of window_ms:
+//   - put latency: time TelemetryPublisher::publish() spent in the put.
+//     zenoh-pico has no transmit queue of its own: a put writes to the
+//     socket under the transport's tx lock, so a full send buffer or a busy
+//     link shows up as a slow put
+//   - failed puts (samples dropped)
+//   - queue depth: queries waiting for their handler (set_queue_depth(),
+//     RpcScheduler::pending()), i.e. control calls behind the telemetry
+// A window with a put slower than latency_threshold_us, a failed put or a
+// queue deeper than max_queue_depth is congested, and the stream backs off
+// multiplicatively, once per window: first by doubling the samples per
+// batch up to max_batch (fewer puts, no sample lost), then by halving the
+// sample rate down to one per max_interval_ms. Every clear window adds
+// increase_mhz back to the rate, then takes one sample off the batch, until
+// the stream runs at the source rate with the requested batch size again.
+// Windows without puts count as clear: the stream probes its way back up.
+//
+// The limits come from the telemetry message's proto options max_interval_ms
+// and max_batch (generated as <MESSAGE>_MAX_INTERVAL_MS / _MAX_BATCH).
+//
+// Not thread-safe: call admit() and publish the stream from one thread.
+
+#pragma once
+
+#include <cstdint>
+
+namespace zenoh_rpc {
+
+struct RateControlConfig {
+  // Source sample interval, the fastest rate [ms]
+  uint32_t min_interval_ms = 1000;
+  // Slowest rate under congestion [ms]
+  uint32_t max_interval_ms = 10000;
+  // Largest samples per batch under congestion (1: never batch)
+  uint32_t max_batch = 1;
+  // Slower puts make the window congested [us]
+  uint32_t latency_threshold_us = 20000;
+  // Deeper queues make the window congested
+  uint32_t max_queue_depth = 0;
+  // Evaluation window [ms]: at most one step per window
+  uint32_t window_ms = 2000;
+  // Rate added per clear window [millisamples/s]
+  uint32_t increase_mhz = 100;
+};
+
+class TelemetryRateControl {
+ public:
+  explicit TelemetryRateControl(
+      const RateControlConfig& config = RateControlConfig());
+
+  // Non-copyable
+  TelemetryRateControl(const TelemetryRateControl&) = delete;
+  TelemetryRateControl& operator=(const TelemetryRateControl&) = delete;
+
+  /**
+   * @brief Should the sample taken now be published (call for every sample)
+   *
+   * Closes the evaluation window when it is due.
+   *
+   * @return false if the sample is skipped to keep the current rate
+   */
+  bool admit(uint64_t now_us);
+
+  // Samples per batch: requested (0 or 1: unbatched) or more under congestion
+  uint32_t batch_size(uint32_t requested) const {
+    return requested >= batch_ ? requested : batch_;
+  }
+
+  // Outcome of a put of the stream (TelemetryPublisher::publish())
+  void on_put(uint32_t latency_us, bool ok);
+
+  // Queries waiting for their handler (sampled by the caller)
+  void set_queue_depth(uint32_t depth) {
+    if (depth > window_max_depth_) window_max_depth_ = depth;
+  }
+
+  // Current rate [millisamples/s] and the interval between samples [ms]
+  uint32_t rate_mhz() const { return rate_mhz_; }
+  uint32_t interval_ms() const { return 1000000 / rate_mhz_; }
+  bool congested() const { return congested_; }
+
+  // Log the rate and the counters since the last call
+  void log_stats();
+
+ private:
+  void close_window(uint64_t now_us);
+
+  RateControlConfig config_;
+  uint32_t min_rate_mhz_;
+  uint32_t max_rate_mhz_;
+  uint32_t rate_mhz_;
+  uint32_t batch_;
+  bool congested_;
+  uint64_t window_start_us_;
+  // Last admitted sample (0: none yet)
+  uint64_t last_admit_us_;
+  // Current window
+  uint32_t window_max_latency_us_;
+  uint32_t window_failed_;
+  uint32_t window_max_depth_;
+  // Counters since the last log_stats()
+  uint32_t admitted_;
+  uint32_t skipped_;
+  uint32_t puts_;
+  uint32_t failed_;
+  uint32_t backoffs_;
+  uint32_t max_latency_us_;
+};
+
+}  // namespace zenoh_rpc
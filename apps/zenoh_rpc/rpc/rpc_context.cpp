@@ -0,0 +1,122 @@
+// RPC Context - Implementation
+
+#include "rpc_context.h"
+
+#include <pb_common.h>
+
+#include <cstring>
+
+#include "zenoh_attachment.h"
+
+namespace zenoh_rpc {
+
+namespace {
+
+// A zero value is the proto3 default and is not encoded
+void clear_value(pb_field_iter_t& iter, bool pointer) {
+  if (pointer) {
+    *static_cast<void**>(iter.pField) = NULL;
+  } else {
+    memset(iter.pData, 0, iter.data_size);
+  }
+}
+
+// FNV-1a; 0 is reserved for anonymous callers
+uint32_t hash_client_id(const uint8_t* id, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ id[i]) * 16777619u;
+  }
+  return hash == kAnonymousClient ? 1 : hash;
+}
+
+}  // namespace
+
+RpcContext RpcContext::from_attachment(const z_loaned_bytes_t* attachment) {
+  RpcContext ctx;
+  if (attachment == NULL) {
+    return ctx;
+  }
+  AttachmentReader reader(attachment);
+  size_t len = 0;
+  const uint8_t* p = reader.find(AttachmentKey::CLIENT_ID, &len);
+  if (p != NULL && len > 0) {
+    ctx.client_id = hash_client_id(p, len);
+  }
+  reader.get_u32(AttachmentKey::TIMEOUT_MS, &ctx.timeout_ms);
+  ctx.timed = reader.get_u64(AttachmentKey::EXECUTE_AT_US, &ctx.execute_at_us);
+  p = reader.find(AttachmentKey::FIELD_MASK, &len);
+  if (p == NULL || len == 0 || len > sizeof(uint64_t)) {
+    return ctx;
+  }
+  // Little endian, trailing zero bytes omitted by the client
+  uint64_t mask = 0;
+  for (size_t i = 0; i < len; ++i) {
+    mask |= static_cast<uint64_t>(p[i]) << (8 * i);
+  }
+  // Fields above the mask width are always sent
+  if (len < sizeof(uint64_t)) {
+    mask |= kAllFields << (8 * len);
+  }
+  ctx.field_mask = mask;
+  return ctx;
+}
+
+void RpcContext::wait_until_start() const {
+  uint64_t now = monotonic_us();
+  if (execute_at_us > now) {
+    // Sleep in one go (tick granularity), the rest is spent spinning
+    if (execute_at_us - now > kTimedSpinUs) {
+      z_sleep_us(static_cast<size_t>(execute_at_us - now - kTimedSpinUs));
+    }
+    while ((now = monotonic_us()) < execute_at_us) {
+    }
+  }
+  started_us = now;
+}
+
+void mask_fields(const pb_msgdesc_t* fields, void* msg, uint64_t mask) {
+  RpcContext ctx;
+  ctx.field_mask = mask;
+  pb_field_iter_t iter;
+  if (!pb_field_iter_begin(&iter, fields, msg)) {
+    return;
+  }
+  do {
+    if (ctx.wants(iter.tag)) {
+      continue;
+    }
+    if (PB_ATYPE(iter.type) == PB_ATYPE_CALLBACK) {
+      static_cast<pb_callback_t*>(iter.pField)->funcs.encode = NULL;
+      continue;
+    }
+    bool pointer = PB_ATYPE(iter.type) == PB_ATYPE_POINTER;
+    switch (PB_HTYPE(iter.type)) {
+      case PB_HTYPE_OPTIONAL:
+        // Also proto3 singular fields, which have no has_ flag (pSize NULL)
+        if (iter.pSize != NULL && !pointer) {
+          *static_cast<bool*>(iter.pSize) = false;
+          break;
+        }
+        clear_value(iter, pointer);
+        break;
+      case PB_HTYPE_REPEATED:
+        // Fixed-count arrays (pSize points into the iterator) are always sent
+        if (iter.pSize != &iter.array_size) {
+          *static_cast<pb_size_t*>(iter.pSize) = 0;
+        }
+        break;
+      case PB_HTYPE_ONEOF:
+        if (*static_cast<pb_size_t*>(iter.pSize) == iter.tag) {
+          *static_cast<pb_size_t*>(iter.pSize) = 0;
+        }
+        break;
+      default:
+        // Required fields are always encoded; send the zero value
+        clear_value(iter, pointer);
+        break;
+    }
+  } while (pb_field_iter_next(&iter));
+}
+
+}  // namespace zenoh_rpc
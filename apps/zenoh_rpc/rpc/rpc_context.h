@@ -0,0 +1,127 @@
+// RPC Context - per-call metadata received in the query attachment
+// The response field mask (the client lists the response fields it needs and
+// the server encodes only those, see AttachmentKey::FIELD_MASK), the
+// caller identity used for fair scheduling (AttachmentKey::CLIENT_ID) and
+// the deadline of the call (AttachmentKey::TIMEOUT_MS, method time budget)
+// and the time to run it at (AttachmentKey::EXECUTE_AT_US, timed_dispatch.h)
+
+#pragma once
+
+#include <pb_encode.h>
+#include <zenoh-pico.h>
+
+#include <cstdint>
+
+#include "zenoh_attachment.h"
+
+namespace zenoh_rpc {
+
+// Field mask selecting every field (also used when no mask was sent)
+constexpr uint64_t kAllFields = UINT64_MAX;
+
+// Client key of calls without a CLIENT_ID attachment
+constexpr uint32_t kAnonymousClient = 0;
+
+// Deadline of calls without a timeout or time budget
+constexpr uint64_t kNoDeadline = UINT64_MAX;
+
+// End of the wait for a timed call spent spinning instead of sleeping [us]
+// (sleeps end on a kernel tick; longer than one tick at 1 kHz)
+constexpr uint64_t kTimedSpinUs = 1000;
+
+// Metadata of the call being served
+struct RpcContext {
+  // Bit n-1 selects field number n; fields above 64 are always encoded
+  uint64_t field_mask = kAllFields;
+  // Hash of the CLIENT_ID attachment (never 0 for identified clients)
+  uint32_t client_id = kAnonymousClient;
+  // TIMEOUT_MS attachment (0: not sent)
+  uint32_t timeout_ms = 0;
+  // Monotonic time [us] after which the reply is of no use: the client's
+  // timeout from the arrival of the query, capped by the method's time
+  // budget from the start of the handler (set by ZenohRpcChannel)
+  uint64_t deadline_us = kNoDeadline;
+  // EXECUTE_AT_US attachment (timed: it was sent): device monotonic time
+  // [us] to run the implementation at (0: on arrival) ...
+  bool timed = false;
+  uint64_t execute_at_us = 0;
+  // ... and when it started (set by wait_until_start(), sent in the reply)
+  mutable uint64_t started_us = 0;
+
+  bool has_field_mask() const { return field_mask != kAllFields; }
+
+  // Time left until the deadline [us]; kNoDeadline if there is none
+  uint64_t remaining_us() const {
+    if (deadline_us == kNoDeadline) {
+      return kNoDeadline;
+    }
+    uint64_t now = monotonic_us();
+    return now < deadline_us ? deadline_us - now : 0;
+  }
+
+  // True once the deadline has passed: long-running handlers check it,
+  // stop and return RpcStatus::TIMEOUT (the client gets a "timeout" error)
+  bool cancelled() const {
+    return deadline_us != kNoDeadline && monotonic_us() >= deadline_us;
+  }
+
+  // True if the client wants the response field with this tag
+  bool wants(uint32_t tag) const {
+    return tag == 0 || tag > 64 || ((field_mask >> (tag - 1)) & 1) != 0;
+  }
+
+  // Called by the generated handlers between decoding the request and
+  // calling the implementation: sleeps until shortly before execute_at_us,
+  // then spins to it, and records the start
+  void wait_until_start() const;
+
+  // Parse the query attachment (may be NULL)
+  static RpcContext from_attachment(const z_loaned_bytes_t* attachment);
+};
+
+// Context of calls that did not come with one
+inline constexpr RpcContext kDefaultRpcContext{};
+
+/**
+ * @brief Clear the fields of msg that are not selected by mask
+ *
+ * Cleared fields are left out by pb_encode: static fields are zeroed
+ * (proto3 defaults are not encoded), has_ flags, repeated counts and oneof
+ * tags are reset, pointer and callback fields are detached. Pointer fields
+ * are not freed, so mask a copy and release the original.
+ */
+void mask_fields(const pb_msgdesc_t* fields, void* msg, uint64_t mask);
+
+/**
+ * @brief Encode a response, honouring the field mask of the call
+ *
+ * Without a mask the message is encoded in place; otherwise a shallow copy
+ * is masked, so msg can still be released with pb_release() afterwards.
+ */
+template <typename T>
+bool encode_response(pb_ostream_t* stream, const pb_msgdesc_t* fields,
+                     const T& msg, const RpcContext& ctx) {
+  if (!ctx.has_field_mask()) {
+    return pb_encode(stream, fields, &msg);
+  }
+  T masked = msg;
+  mask_fields(fields, &masked, ctx.field_mask);
+  return pb_encode(stream, fields, &masked);
+}
+
+/**
+ * @brief Encode a response, masking msg itself instead of a copy
+ *
+ * Keeps large responses off the stack. Only for messages without pointer
+ * fields; msg must not be used afterwards.
+ */
+template <typename T>
+bool encode_response_in_place(pb_ostream_t* stream, const pb_msgdesc_t* fields,
+                              T& msg, const RpcContext& ctx) {
+  if (ctx.has_field_mask()) {
+    mask_fields(fields, &msg, ctx.field_mask);
+  }
+  return pb_encode(stream, fields, &msg);
+}
+
+}  // namespace zenoh_rpc
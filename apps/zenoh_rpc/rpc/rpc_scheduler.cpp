@@ -0,0 +1,293 @@
+// RPC Scheduler - Implementation
+
+#include "rpc_scheduler.h"
+
+#include <cstring>
+
+#include "log_wrapper.h"
+#include "zenoh_attachment.h"
+
+#ifdef __ZEPHYR__
+LOG_MODULE_REGISTER(rpc_scheduler, LOG_LEVEL_INF);
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+RpcScheduler::RpcScheduler(const SchedulerConfig& config)
+    : config_(config), cursor_(0), pending_(0), served_(0), rejected_(0) {
+  if (config_.max_in_flight == 0 ||
+      config_.max_in_flight > kMaxQueuedPerClient) {
+    config_.max_in_flight = kMaxQueuedPerClient;
+  }
+  if (config_.burst == 0) {
+    config_.burst = config_.rate_per_s;
+  }
+  memset(clients_, 0, sizeof(clients_));
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_init(&mutex_);
+  z_condvar_init(&cond_);
+  task_started_ = false;
+  stopping_ = false;
+#endif
+}
+
+RpcScheduler::~RpcScheduler() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  if (task_started_) {
+    lock();
+    stopping_ = true;
+    z_condvar_signal(z_condvar_loan_mut(&cond_));
+    unlock();
+    z_task_join(z_task_move(&task_));
+  }
+#endif
+  // Queries still queued get their final reply (timeout on the client)
+  for (Client& c : clients_) {
+    for (uint8_t i = 0; i < c.count; ++i) {
+      Job& job = c.jobs[(c.head + i) % kMaxQueuedPerClient];
+      z_query_drop(z_query_move(&job.query));
+    }
+    c.count = 0;
+  }
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_condvar_drop(z_condvar_move(&cond_));
+  z_mutex_drop(z_mutex_move(&mutex_));
+#endif
+}
+
+void RpcScheduler::lock() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_lock(z_mutex_loan_mut(&mutex_));
+#endif
+}
+
+void RpcScheduler::unlock() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_unlock(z_mutex_loan_mut(&mutex_));
+#endif
+}
+
+RpcScheduler::Client* RpcScheduler::find_client(uint32_t client_id,
+                                                uint64_t now_us) {
+  Client* idle = nullptr;
+  for (Client& c : clients_) {
+    if (c.used && c.id == client_id) {
+      return &c;
+    }
+    // Reuse a free slot, else the least recently active idle client
+    if (c.count == 0 && !c.running &&
+        (idle == nullptr || (!c.used && idle->used) ||
+         (c.used && idle->used && c.last_active_us < idle->last_active_us))) {
+      idle = &c;
+    }
+  }
+  if (idle == nullptr) {
+    return nullptr;
+  }
+  memset(idle, 0, sizeof(*idle));
+  idle->used = true;
+  idle->id = client_id;
+  idle->tokens_milli = static_cast<uint32_t>(config_.burst) * 1000;
+  idle->refill_us = now_us;
+  return idle;
+}
+
+bool RpcScheduler::take_token(Client& c, uint64_t now_us) {
+  if (config_.rate_per_s == 0) {
+    return true;
+  }
+  uint64_t refill =
+      (now_us - c.refill_us) * config_.rate_per_s / 1000 + c.tokens_milli;
+  uint64_t cap = static_cast<uint64_t>(config_.burst) * 1000;
+  c.tokens_milli = static_cast<uint32_t>(refill < cap ? refill : cap);
+  c.refill_us = now_us;
+  if (c.tokens_milli < 1000) {
+    return false;
+  }
+  c.tokens_milli -= 1000;
+  return true;
+}
+
+void RpcScheduler::reject(const z_loaned_query_t* query, const char* reason) {
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_str(&payload, reason);
+  z_query_reply_err_options_t opts;
+  z_query_reply_err_options_default(&opts);
+  z_result_t res = z_query_reply_err(query, z_bytes_move(&payload), &opts);
+  if (res != Z_OK) {
+    LOG_ERR("z_query_reply_err failed: %d", res);
+  }
+}
+
+bool RpcScheduler::submit(const z_loaned_query_t* query, uint32_t client_id,
+                          Dispatch dispatch, void* context) {
+  uint64_t now = monotonic_us();
+  const char* reason = nullptr;
+  lock();
+  Client* c = find_client(client_id, now);
+  if (c == nullptr) {
+    reason = "busy";
+  } else {
+    c->last_active_us = now;
+    if (c->count + (c->running ? 1 : 0) >= config_.max_in_flight) {
+      c->busy++;
+      reason = "busy";
+    } else if (!take_token(*c, now)) {
+      c->rate_limited++;
+      reason = "rate limited";
+    } else {
+      // The clone keeps the query open after the callback returns
+      Job& job = c->jobs[(c->head + c->count) % kMaxQueuedPerClient];
+      if (z_query_clone(&job.query, query) != Z_OK) {
+        reason = "out of memory";
+      } else {
+        job.dispatch = dispatch;
+        job.context = context;
+        job.queued_us = now;
+        c->count++;
+        pending_++;
+      }
+    }
+  }
+  if (reason != nullptr) {
+    rejected_++;
+  }
+#if Z_FEATURE_MULTI_THREAD == 1
+  else {
+    z_condvar_signal(z_condvar_loan_mut(&cond_));
+  }
+#endif
+  unlock();
+
+  if (reason != nullptr) {
+    reject(query, reason);
+    return false;
+  }
+  return true;
+}
+
+bool RpcScheduler::run(uint32_t budget_us) {
+  uint64_t start = monotonic_us();
+  lock();
+  while (pending_ > 0) {
+    Client& c = clients_[cursor_];
+    if (c.count == 0) {
+      // DRR: an empty queue does not save up credit
+      c.deficit_us = 0;
+      c.granted = false;
+      cursor_ = (cursor_ + 1) % kMaxSchedClients;
+      continue;
+    }
+    if (!c.granted) {
+      c.deficit_us += static_cast<int32_t>(config_.quantum_us);
+      c.granted = true;
+    }
+    if (c.deficit_us <= 0) {
+      // Overdrawn by a long handler: wait for the next round
+      c.granted = false;
+      cursor_ = (cursor_ + 1) % kMaxSchedClients;
+      continue;
+    }
+
+    Job job = c.jobs[c.head];
+    c.head = (c.head + 1) % kMaxQueuedPerClient;
+    c.count--;
+    pending_--;
+    c.running = true;
+    unlock();
+
+    uint64_t begin = monotonic_us();
+    job.dispatch(job.context, z_query_loan(&job.query), job.queued_us);
+    // Dropping the last reference sends the final reply
+    z_query_drop(z_query_move(&job.query));
+    uint64_t end = monotonic_us();
+
+    lock();
+    c.running = false;
+    uint64_t took = end - begin;
+    c.deficit_us -= static_cast<int32_t>(took < INT32_MAX ? took : INT32_MAX);
+    c.handler_us += took;
+    c.served++;
+    uint64_t wait = begin - job.queued_us;
+    if (wait > c.max_wait_us) {
+      c.max_wait_us =
+          static_cast<uint32_t>(wait < UINT32_MAX ? wait : UINT32_MAX);
+    }
+    served_++;
+    if (end - start >= budget_us) {
+      break;
+    }
+  }
+  bool more = pending_ > 0;
+  unlock();
+  return more;
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+bool RpcScheduler::start() {
+  if (task_started_) {
+    return true;
+  }
+  z_result_t res = z_task_init(&task_, NULL, worker, this);
+  if (res != Z_OK) {
+    LOG_ERR("Failed to start RPC worker task: %d", res);
+    return false;
+  }
+  task_started_ = true;
+  return true;
+}
+
+void* RpcScheduler::worker(void* arg) {
+  auto* self = static_cast<RpcScheduler*>(arg);
+  while (true) {
+    self->lock();
+    while (self->pending_ == 0 && !self->stopping_) {
+      z_condvar_wait(z_condvar_loan_mut(&self->cond_),
+                     z_mutex_loan_mut(&self->mutex_));
+    }
+    bool stopping = self->stopping_;
+    self->unlock();
+    if (stopping) {
+      return NULL;
+    }
+    self->run();
+  }
+}
+#endif
+
+void RpcScheduler::log_stats() {
+  struct Counters {
+    uint32_t id;
+    uint32_t served;
+    uint32_t busy;
+    uint32_t rate_limited;
+    uint32_t max_wait_us;
+    uint32_t handler_us;
+  };
+  Counters counters[kMaxSchedClients];
+  size_t n = 0;
+  lock();
+  for (Client& c : clients_) {
+    if (c.used && (c.served != 0 || c.busy != 0 || c.rate_limited != 0)) {
+      counters[n++] = {c.id,          c.served,
+                       c.busy,        c.rate_limited,
+                       c.max_wait_us, static_cast<uint32_t>(c.handler_us)};
+    }
+    c.served = 0;
+    c.busy = 0;
+    c.rate_limited = 0;
+    c.max_wait_us = 0;
+    c.handler_us = 0;
+  }
+  unlock();
+  // Logged outside the lock
+  for (size_t i = 0; i < n; ++i) {
+    const Counters& c = counters[i];
+    LOG_INF("RPC client %08x: %u served (%u us), %u busy, %u rate limited, "
+            "max wait %u us",
+            c.id, c.served, c.handler_us, c.busy, c.rate_limited,
+            c.max_wait_us);
+  }
+}
+
+}  // namespace zenoh_rpc
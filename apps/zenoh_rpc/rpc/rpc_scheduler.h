@@ -0,0 +1,143 @@
+// RPC Scheduler - per-client fair scheduling of RPC handler work
+//
+// Query callbacks only queue the query, per caller (CLIENT_ID attachment,
+// see RpcContext::client_id; callers without one share a queue). Queued
+// queries are served with deficit round-robin on measured handler time:
+// every round a client with work is granted quantum_us, runs queries while
+// its deficit is positive and is charged the time each handler took. A
+// client flooding cheap or expensive calls therefore gets the same share of
+// handler time as any other active client, and a well-behaved client waits
+// for at most one round instead of the whole backlog.
+//
+// Admission, per client: at most max_in_flight queued or running queries and
+// rate_per_s accepted queries per second (token bucket). Rejected queries get
+// an error reply ("busy" / "rate limited") instead of timing out.
+//
+// Z_FEATURE_MULTI_THREAD == 1: start() runs the queue on a worker task.
+// Z_FEATURE_MULTI_THREAD == 0: call run() after each session read
+//   (ZenohEventLoop::add_poll()).
+
+#pragma once
+
+#include <zenoh-pico.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zenoh_rpc {
+
+// Limits
+constexpr size_t kMaxSchedClients = 8;
+constexpr size_t kMaxQueuedPerClient = 4;
+
+struct SchedulerConfig {
+  // Handler time granted to each client per round [us]
+  uint32_t quantum_us = 2000;
+  // Queued + running queries per client (1..kMaxQueuedPerClient)
+  uint8_t max_in_flight = kMaxQueuedPerClient;
+  // Accepted queries per client and second (0: unlimited)
+  uint16_t rate_per_s = 0;
+  // Token bucket depth (0: rate_per_s)
+  uint16_t burst = 0;
+};
+
+class RpcScheduler {
+ public:
+  // Serves one query (context: e.g. the queryable entry; received_us: when
+  // the query was queued, for its deadline)
+  using Dispatch = void (*)(void* context, const z_loaned_query_t* query,
+                            uint64_t received_us);
+
+  explicit RpcScheduler(const SchedulerConfig& config = SchedulerConfig());
+  ~RpcScheduler();
+
+  // Non-copyable
+  RpcScheduler(const RpcScheduler&) = delete;
+  RpcScheduler& operator=(const RpcScheduler&) = delete;
+
+  /**
+   * @brief Queue a query (from the query callback)
+   *
+   * @return false if the query was rejected (an error reply was sent)
+   */
+  bool submit(const z_loaned_query_t* query, uint32_t client_id,
+              Dispatch dispatch, void* context);
+
+  /**
+   * @brief Serve queued queries in deficit round-robin order
+   *
+   * @param budget_us Stop after this much handler time
+   * @return true if queries are still queued
+   */
+  bool run(uint32_t budget_us = UINT32_MAX);
+
+#if Z_FEATURE_MULTI_THREAD == 1
+  // Serve queued queries from a worker task as they arrive
+  bool start();
+#endif
+
+  // Log per-client counters of the clients active since the last call
+  void log_stats();
+
+  // Totals
+  uint32_t served() const { return served_; }
+  uint32_t rejected() const { return rejected_; }
+  // Queries waiting for their handler (read without the lock: a snapshot)
+  size_t pending() const { return pending_; }
+
+ private:
+  struct Job {
+    z_owned_query_t query;
+    Dispatch dispatch;
+    void* context;
+    uint64_t queued_us;
+  };
+
+  struct Client {
+    uint32_t id;
+    bool used;
+    // Ring of queued jobs
+    Job jobs[kMaxQueuedPerClient];
+    uint8_t head;
+    uint8_t count;
+    bool running;
+    // Deficit round-robin [us]; granted: quantum added this round
+    int32_t deficit_us;
+    bool granted;
+    // Token bucket [millitokens]
+    uint32_t tokens_milli;
+    uint64_t refill_us;
+    uint64_t last_active_us;
+    // Counters since the last log_stats()
+    uint32_t served;
+    uint32_t busy;
+    uint32_t rate_limited;
+    uint32_t max_wait_us;
+    uint64_t handler_us;
+  };
+
+  Client* find_client(uint32_t client_id, uint64_t now_us);
+  bool take_token(Client& c, uint64_t now_us);
+  void reject(const z_loaned_query_t* query, const char* reason);
+  void lock();
+  void unlock();
+#if Z_FEATURE_MULTI_THREAD == 1
+  static void* worker(void* arg);
+#endif
+
+  SchedulerConfig config_;
+  Client clients_[kMaxSchedClients];
+  size_t cursor_;
+  size_t pending_;
+  uint32_t served_;
+  uint32_t rejected_;
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_owned_mutex_t mutex_;
+  z_owned_condvar_t cond_;
+  z_owned_task_t task_;
+  bool task_started_;
+  volatile bool stopping_;
+#endif
+};
+
+}  // namespace zenoh_rpc
@@ -33,8 +33,50 @@ PB_BIND(practice_rpc_SensorRequest, practice_rpc_SensorRequest, AUTO)
 PB_BIND(practice_rpc_SensorTelemetry, practice_rpc_SensorTelemetry, AUTO)
 
 
+PB_BIND(practice_rpc_TelemetryBatch, practice_rpc_TelemetryBatch, AUTO)
+
+
+PB_BIND(practice_rpc_GpioEvent, practice_rpc_GpioEvent, AUTO)
+
+
+PB_BIND(practice_rpc_LogLevelRequest, practice_rpc_LogLevelRequest, AUTO)
+
+
+PB_BIND(practice_rpc_LogLevelResponse, practice_rpc_LogLevelResponse, AUTO)
+
+
+PB_BIND(practice_rpc_Rule, practice_rpc_Rule, AUTO)
+
+
+PB_BIND(practice_rpc_RuleSet, practice_rpc_RuleSet, AUTO)
+
+
+PB_BIND(practice_rpc_SetRulesResponse, practice_rpc_SetRulesResponse, AUTO)
+
+
+PB_BIND(practice_rpc_DeviceState, practice_rpc_DeviceState, AUTO)
+
+
+PB_BIND(practice_rpc_StreamControl, practice_rpc_StreamControl, AUTO)
+
+
 PB_BIND(practice_rpc_Empty, practice_rpc_Empty, AUTO)
 
 
+PB_BIND(practice_rpc_BenchPayload, practice_rpc_BenchPayload, AUTO)
+
+
+PB_BIND(practice_rpc_BenchSinkResponse, practice_rpc_BenchSinkResponse, AUTO)
+
+
+PB_BIND(practice_rpc_BenchSourceRequest, practice_rpc_BenchSourceRequest, AUTO)
+
+
+PB_BIND(practice_rpc_BenchPublishRequest, practice_rpc_BenchPublishRequest, AUTO)
+
+
+PB_BIND(practice_rpc_BenchPublisherStats, practice_rpc_BenchPublisherStats, AUTO)
+
+
 
 
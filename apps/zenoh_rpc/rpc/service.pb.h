@@ -9,6 +9,28 @@
 #error Regenerate this file with the current version of nanopb generator.
 #endif
 
+/* Enum definitions */
+typedef enum _practice_rpc_LogLevel {
+    practice_rpc_LogLevel_LOG_LEVEL_DEBUG = 0,
+    practice_rpc_LogLevel_LOG_LEVEL_INFO = 1,
+    practice_rpc_LogLevel_LOG_LEVEL_WARN = 2,
+    practice_rpc_LogLevel_LOG_LEVEL_ERROR = 3,
+    practice_rpc_LogLevel_LOG_LEVEL_OFF = 4
+} practice_rpc_LogLevel;
+
+typedef enum _practice_rpc_RuleCondition {
+    practice_rpc_RuleCondition_RULE_ABOVE = 0,
+    practice_rpc_RuleCondition_RULE_BELOW = 1,
+    practice_rpc_RuleCondition_RULE_RISING = 2,
+    practice_rpc_RuleCondition_RULE_FALLING = 3
+} practice_rpc_RuleCondition;
+
+typedef enum _practice_rpc_RuleAction {
+    practice_rpc_RuleAction_RULE_ACTION_NONE = 0,
+    practice_rpc_RuleAction_RULE_ACTION_SET_LED = 1,
+    practice_rpc_RuleAction_RULE_ACTION_LOG = 2
+} practice_rpc_RuleAction;
+
 /* Struct definitions */
 typedef struct _practice_rpc_WifiSettings {
     char ssid[32];
@@ -40,7 +62,7 @@ typedef struct _practice_rpc_EchoResponseMalloc {
 } practice_rpc_EchoResponseMalloc;
 
 typedef struct _practice_rpc_SensorRequest {
-    char dummy_field;
+    uint32_t batch_size;
 } practice_rpc_SensorRequest;
 
 typedef struct _practice_rpc_SensorTelemetry {
@@ -48,19 +70,139 @@ typedef struct _practice_rpc_SensorTelemetry {
     float humidity;
 } practice_rpc_SensorTelemetry;
 
+typedef PB_BYTES_ARRAY_T(192) practice_rpc_TelemetryBatch_data_t;
+typedef struct _practice_rpc_TelemetryBatch {
+    uint32_t count;
+    pb_size_t field_tags_count;
+    uint32_t field_tags[8];
+    practice_rpc_TelemetryBatch_data_t data;
+} practice_rpc_TelemetryBatch;
+
+typedef struct _practice_rpc_GpioEvent {
+    uint32_t line;
+    bool level;
+    uint64_t timestamp_us;
+    uint32_t queued_us;
+    uint32_t dropped;
+} practice_rpc_GpioEvent;
+
+typedef struct _practice_rpc_LogLevelRequest {
+    char module[16];
+    practice_rpc_LogLevel level;
+    uint32_t rate_per_s;
+    uint32_t burst;
+} practice_rpc_LogLevelRequest;
+
+typedef struct _practice_rpc_LogLevelResponse {
+    uint32_t log_modules;
+    uint32_t zephyr_modules;
+} practice_rpc_LogLevelResponse;
+
+typedef struct _practice_rpc_Rule {
+    uint32_t field;
+    practice_rpc_RuleCondition condition;
+    float threshold;
+    float hysteresis;
+    practice_rpc_RuleAction action;
+    uint32_t value;
+    bool on_exit;
+    uint32_t exit_value;
+} practice_rpc_Rule;
+
+typedef struct _practice_rpc_RuleSet {
+    pb_size_t rules_count;
+    practice_rpc_Rule rules[6];
+} practice_rpc_RuleSet;
+
+typedef struct _practice_rpc_SetRulesResponse {
+    uint32_t installed;
+} practice_rpc_SetRulesResponse;
+
+typedef struct _practice_rpc_DeviceState {
+    bool led_on;
+    bool streaming;
+    uint32_t batch_size;
+    bool wifi_connected;
+    char wifi_ssid[33];
+} practice_rpc_DeviceState;
+
+typedef struct _practice_rpc_StreamControl {
+    uint32_t stream_id;
+    uint32_t window;
+    bool close;
+} practice_rpc_StreamControl;
+
 typedef struct _practice_rpc_Empty {
     char dummy_field;
 } practice_rpc_Empty;
 
+typedef PB_BYTES_ARRAY_T(2048) practice_rpc_BenchPayload_data_t;
+typedef struct _practice_rpc_BenchPayload {
+    practice_rpc_BenchPayload_data_t data;
+} practice_rpc_BenchPayload;
+
+typedef struct _practice_rpc_BenchSinkResponse {
+    uint32_t received;
+} practice_rpc_BenchSinkResponse;
+
+typedef struct _practice_rpc_BenchSourceRequest {
+    uint32_t size;
+} practice_rpc_BenchSourceRequest;
+
+typedef struct _practice_rpc_BenchPublishRequest {
+    uint32_t rate_hz;
+    uint32_t size;
+    uint32_t duration_ms;
+    bool express;
+} practice_rpc_BenchPublishRequest;
+
+typedef struct _practice_rpc_BenchPublisherStats {
+    uint32_t published;
+    uint32_t failed;
+    uint64_t elapsed_us;
+} practice_rpc_BenchPublisherStats;
+
 
 /* Extensions */
 /* Extension field practice_rpc_zenoh_key was skipped because only "optional"
    type of extension fields is currently supported. */
+/* Extension field practice_rpc_settings_key was skipped because only "optional"
+   type of extension fields is currently supported. */
+/* Extension field practice_rpc_state_key was skipped because only "optional"
+   type of extension fields is currently supported. */
+/* Extension field practice_rpc_max_rate was skipped because only "optional"
+   type of extension fields is currently supported. */
+/* Extension field practice_rpc_max_payload was skipped because only "optional"
+   type of extension fields is currently supported. */
+/* Extension field practice_rpc_max_interval_ms was skipped because only "optional"
+   type of extension fields is currently supported. */
+/* Extension field practice_rpc_max_batch was skipped because only "optional"
+   type of extension fields is currently supported. */
+/* Extension field practice_rpc_time_budget_ms was skipped because only "optional"
+   type of extension fields is currently supported. */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Helper constants for enums */
+#define _practice_rpc_LogLevel_MIN practice_rpc_LogLevel_LOG_LEVEL_DEBUG
+#define _practice_rpc_LogLevel_MAX practice_rpc_LogLevel_LOG_LEVEL_OFF
+#define _practice_rpc_LogLevel_ARRAYSIZE ((practice_rpc_LogLevel)(practice_rpc_LogLevel_LOG_LEVEL_OFF+1))
+
+#define _practice_rpc_RuleCondition_MIN practice_rpc_RuleCondition_RULE_ABOVE
+#define _practice_rpc_RuleCondition_MAX practice_rpc_RuleCondition_RULE_FALLING
+#define _practice_rpc_RuleCondition_ARRAYSIZE ((practice_rpc_RuleCondition)(practice_rpc_RuleCondition_RULE_FALLING+1))
+
+#define _practice_rpc_RuleAction_MIN practice_rpc_RuleAction_RULE_ACTION_NONE
+#define _practice_rpc_RuleAction_MAX practice_rpc_RuleAction_RULE_ACTION_LOG
+#define _practice_rpc_RuleAction_ARRAYSIZE ((practice_rpc_RuleAction)(practice_rpc_RuleAction_RULE_ACTION_LOG+1))
+
+#define practice_rpc_LogLevelRequest_level_ENUMTYPE practice_rpc_LogLevel
+#define practice_rpc_Rule_condition_ENUMTYPE practice_rpc_RuleCondition
+#define practice_rpc_Rule_action_ENUMTYPE practice_rpc_RuleAction
+
+
 /* Initializer values for message structs */
 #define practice_rpc_WifiSettings_init_default   {"", ""}
 #define practice_rpc_LedRequest_init_default     {0}
@@ -71,7 +213,21 @@ extern "C" {
 #define practice_rpc_EchoResponseMalloc_init_default {NULL}
 #define practice_rpc_SensorRequest_init_default  {0}
 #define practice_rpc_SensorTelemetry_init_default {0, 0}
+#define practice_rpc_TelemetryBatch_init_default {0, 0, {0, 0, 0, 0, 0, 0, 0, 0}, {0, {0}}}
+#define practice_rpc_GpioEvent_init_default      {0, 0, 0, 0, 0}
+#define practice_rpc_LogLevelRequest_init_default {"", _practice_rpc_LogLevel_MIN, 0, 0}
+#define practice_rpc_LogLevelResponse_init_default {0, 0}
+#define practice_rpc_Rule_init_default           {0, _practice_rpc_RuleCondition_MIN, 0, 0, _practice_rpc_RuleAction_MIN, 0, 0, 0}
+#define practice_rpc_RuleSet_init_default        {0, {practice_rpc_Rule_init_default, practice_rpc_Rule_init_default, practice_rpc_Rule_init_default, practice_rpc_Rule_init_default, practice_rpc_Rule_init_default, practice_rpc_Rule_init_default}}
+#define practice_rpc_SetRulesResponse_init_default {0}
+#define practice_rpc_DeviceState_init_default    {0, 0, 0, 0, ""}
+#define practice_rpc_StreamControl_init_default  {0, 0, 0}
 #define practice_rpc_Empty_init_default          {0}
+#define practice_rpc_BenchPayload_init_default   {{0, {0}}}
+#define practice_rpc_BenchSinkResponse_init_default {0}
+#define practice_rpc_BenchSourceRequest_init_default {0}
+#define practice_rpc_BenchPublishRequest_init_default {0, 0, 0, 0}
+#define practice_rpc_BenchPublisherStats_init_default {0, 0, 0}
 #define practice_rpc_WifiSettings_init_zero      {"", ""}
 #define practice_rpc_LedRequest_init_zero        {0}
 #define practice_rpc_LedResponse_init_zero       {0}
@@ -81,7 +237,21 @@ extern "C" {
 #define practice_rpc_EchoResponseMalloc_init_zero {NULL}
 #define practice_rpc_SensorRequest_init_zero     {0}
 #define practice_rpc_SensorTelemetry_init_zero   {0, 0}
+#define practice_rpc_TelemetryBatch_init_zero    {0, 0, {0, 0, 0, 0, 0, 0, 0, 0}, {0, {0}}}
+#define practice_rpc_GpioEvent_init_zero         {0, 0, 0, 0, 0}
+#define practice_rpc_LogLevelRequest_init_zero   {"", _practice_rpc_LogLevel_MIN, 0, 0}
+#define practice_rpc_LogLevelResponse_init_zero  {0, 0}
+#define practice_rpc_Rule_init_zero              {0, _practice_rpc_RuleCondition_MIN, 0, 0, _practice_rpc_RuleAction_MIN, 0, 0, 0}
+#define practice_rpc_RuleSet_init_zero           {0, {practice_rpc_Rule_init_zero, practice_rpc_Rule_init_zero, practice_rpc_Rule_init_zero, practice_rpc_Rule_init_zero, practice_rpc_Rule_init_zero, practice_rpc_Rule_init_zero}}
+#define practice_rpc_SetRulesResponse_init_zero  {0}
+#define practice_rpc_DeviceState_init_zero       {0, 0, 0, 0, ""}
+#define practice_rpc_StreamControl_init_zero     {0, 0, 0}
 #define practice_rpc_Empty_init_zero             {0}
+#define practice_rpc_BenchPayload_init_zero      {{0, {0}}}
+#define practice_rpc_BenchSinkResponse_init_zero {0}
+#define practice_rpc_BenchSourceRequest_init_zero {0}
+#define practice_rpc_BenchPublishRequest_init_zero {0, 0, 0, 0}
+#define practice_rpc_BenchPublisherStats_init_zero {0, 0, 0}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define practice_rpc_WifiSettings_ssid_tag       1
@@ -91,9 +261,59 @@ extern "C" {
 #define practice_rpc_EchoResponse_msg_tag        1
 #define practice_rpc_EchoRequestMalloc_msg_tag   1
 #define practice_rpc_EchoResponseMalloc_msg_tag  1
+#define practice_rpc_SensorRequest_batch_size_tag 1
 #define practice_rpc_SensorTelemetry_temperature_tag 1
 #define practice_rpc_SensorTelemetry_humidity_tag 2
+#define practice_rpc_TelemetryBatch_count_tag    1
+#define practice_rpc_TelemetryBatch_field_tags_tag 2
+#define practice_rpc_TelemetryBatch_data_tag     3
+#define practice_rpc_GpioEvent_line_tag          1
+#define practice_rpc_GpioEvent_level_tag         2
+#define practice_rpc_GpioEvent_timestamp_us_tag  3
+#define practice_rpc_GpioEvent_queued_us_tag     4
+#define practice_rpc_GpioEvent_dropped_tag       5
+#define practice_rpc_LogLevelRequest_module_tag  1
+#define practice_rpc_LogLevelRequest_level_tag   2
+#define practice_rpc_LogLevelRequest_rate_per_s_tag 3
+#define practice_rpc_LogLevelRequest_burst_tag   4
+#define practice_rpc_LogLevelResponse_log_modules_tag 1
+#define practice_rpc_LogLevelResponse_zephyr_modules_tag 2
+#define practice_rpc_Rule_field_tag              1
+#define practice_rpc_Rule_condition_tag          2
+#define practice_rpc_Rule_threshold_tag          3
+#define practice_rpc_Rule_hysteresis_tag         4
+#define practice_rpc_Rule_action_tag             5
+#define practice_rpc_Rule_value_tag              6
+#define practice_rpc_Rule_on_exit_tag            7
+#define practice_rpc_Rule_exit_value_tag         8
+#define practice_rpc_RuleSet_rules_tag           1
+#define practice_rpc_SetRulesResponse_installed_tag 1
+#define practice_rpc_DeviceState_led_on_tag      1
+#define practice_rpc_DeviceState_streaming_tag   2
+#define practice_rpc_DeviceState_batch_size_tag  3
+#define practice_rpc_DeviceState_wifi_connected_tag 4
+#define practice_rpc_DeviceState_wifi_ssid_tag   5
+#define practice_rpc_StreamControl_stream_id_tag 1
+#define practice_rpc_StreamControl_window_tag    2
+#define practice_rpc_StreamControl_close_tag     3
+#define practice_rpc_BenchPayload_data_tag       1
+#define practice_rpc_BenchSinkResponse_received_tag 1
+#define practice_rpc_BenchSourceRequest_size_tag 1
+#define practice_rpc_BenchPublishRequest_rate_hz_tag 1
+#define practice_rpc_BenchPublishRequest_size_tag 2
+#define practice_rpc_BenchPublishRequest_duration_ms_tag 3
+#define practice_rpc_BenchPublishRequest_express_tag 4
+#define practice_rpc_BenchPublisherStats_published_tag 1
+#define practice_rpc_BenchPublisherStats_failed_tag 2
+#define practice_rpc_BenchPublisherStats_elapsed_us_tag 3
 #define practice_rpc_zenoh_key_tag               50001
+#define practice_rpc_settings_key_tag            50002
+#define practice_rpc_state_key_tag               50003
+#define practice_rpc_max_rate_tag                50005
+#define practice_rpc_max_payload_tag             50006
+#define practice_rpc_max_interval_ms_tag         50007
+#define practice_rpc_max_batch_tag               50008
+#define practice_rpc_time_budget_ms_tag          50004
 
 /* Struct field encoding specification for nanopb */
 #define practice_rpc_WifiSettings_FIELDLIST(X, a) \
@@ -133,7 +353,7 @@ X(a, POINTER,  SINGULAR, BYTES,    msg,               1)
 #define practice_rpc_EchoResponseMalloc_DEFAULT NULL
 
 #define practice_rpc_SensorRequest_FIELDLIST(X, a) \
-
+X(a, STATIC,   SINGULAR, UINT32,   batch_size,        1)
 #define practice_rpc_SensorRequest_CALLBACK NULL
 #define practice_rpc_SensorRequest_DEFAULT NULL
 
@@ -143,11 +363,110 @@ X(a, STATIC,   SINGULAR, FLOAT,    humidity,          2)
 #define practice_rpc_SensorTelemetry_CALLBACK NULL
 #define practice_rpc_SensorTelemetry_DEFAULT NULL
 
+#define practice_rpc_TelemetryBatch_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             1) \
+X(a, STATIC,   REPEATED, UINT32,   field_tags,        2) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              3)
+#define practice_rpc_TelemetryBatch_CALLBACK NULL
+#define practice_rpc_TelemetryBatch_DEFAULT NULL
+
+#define practice_rpc_GpioEvent_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   line,              1) \
+X(a, STATIC,   SINGULAR, BOOL,     level,             2) \
+X(a, STATIC,   SINGULAR, UINT64,   timestamp_us,      3) \
+X(a, STATIC,   SINGULAR, UINT32,   queued_us,         4) \
+X(a, STATIC,   SINGULAR, UINT32,   dropped,           5)
+#define practice_rpc_GpioEvent_CALLBACK NULL
+#define practice_rpc_GpioEvent_DEFAULT NULL
+
+#define practice_rpc_LogLevelRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   module,            1) \
+X(a, STATIC,   SINGULAR, UENUM,    level,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   rate_per_s,        3) \
+X(a, STATIC,   SINGULAR, UINT32,   burst,             4)
+#define practice_rpc_LogLevelRequest_CALLBACK NULL
+#define practice_rpc_LogLevelRequest_DEFAULT NULL
+
+#define practice_rpc_LogLevelResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   log_modules,       1) \
+X(a, STATIC,   SINGULAR, UINT32,   zephyr_modules,    2)
+#define practice_rpc_LogLevelResponse_CALLBACK NULL
+#define practice_rpc_LogLevelResponse_DEFAULT NULL
+
+#define practice_rpc_Rule_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   field,             1) \
+X(a, STATIC,   SINGULAR, UENUM,    condition,         2) \
+X(a, STATIC,   SINGULAR, FLOAT,    threshold,         3) \
+X(a, STATIC,   SINGULAR, FLOAT,    hysteresis,        4) \
+X(a, STATIC,   SINGULAR, UENUM,    action,            5) \
+X(a, STATIC,   SINGULAR, UINT32,   value,             6) \
+X(a, STATIC,   SINGULAR, BOOL,     on_exit,           7) \
+X(a, STATIC,   SINGULAR, UINT32,   exit_value,        8)
+#define practice_rpc_Rule_CALLBACK NULL
+#define practice_rpc_Rule_DEFAULT NULL
+
+#define practice_rpc_RuleSet_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  rules,             1)
+#define practice_rpc_RuleSet_CALLBACK NULL
+#define practice_rpc_RuleSet_DEFAULT NULL
+#define practice_rpc_RuleSet_rules_MSGTYPE practice_rpc_Rule
+
+#define practice_rpc_SetRulesResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   installed,         1)
+#define practice_rpc_SetRulesResponse_CALLBACK NULL
+#define practice_rpc_SetRulesResponse_DEFAULT NULL
+
+#define practice_rpc_DeviceState_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     led_on,            1) \
+X(a, STATIC,   SINGULAR, BOOL,     streaming,         2) \
+X(a, STATIC,   SINGULAR, UINT32,   batch_size,        3) \
+X(a, STATIC,   SINGULAR, BOOL,     wifi_connected,    4) \
+X(a, STATIC,   SINGULAR, STRING,   wifi_ssid,         5)
+#define practice_rpc_DeviceState_CALLBACK NULL
+#define practice_rpc_DeviceState_DEFAULT NULL
+
+#define practice_rpc_StreamControl_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   stream_id,         1) \
+X(a, STATIC,   SINGULAR, UINT32,   window,            2) \
+X(a, STATIC,   SINGULAR, BOOL,     close,             3)
+#define practice_rpc_StreamControl_CALLBACK NULL
+#define practice_rpc_StreamControl_DEFAULT NULL
+
 #define practice_rpc_Empty_FIELDLIST(X, a) \
 
 #define practice_rpc_Empty_CALLBACK NULL
 #define practice_rpc_Empty_DEFAULT NULL
 
+#define practice_rpc_BenchPayload_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              1)
+#define practice_rpc_BenchPayload_CALLBACK NULL
+#define practice_rpc_BenchPayload_DEFAULT NULL
+
+#define practice_rpc_BenchSinkResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   received,          1)
+#define practice_rpc_BenchSinkResponse_CALLBACK NULL
+#define practice_rpc_BenchSinkResponse_DEFAULT NULL
+
+#define practice_rpc_BenchSourceRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   size,              1)
+#define practice_rpc_BenchSourceRequest_CALLBACK NULL
+#define practice_rpc_BenchSourceRequest_DEFAULT NULL
+
+#define practice_rpc_BenchPublishRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   rate_hz,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   size,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   duration_ms,       3) \
+X(a, STATIC,   SINGULAR, BOOL,     express,           4)
+#define practice_rpc_BenchPublishRequest_CALLBACK NULL
+#define practice_rpc_BenchPublishRequest_DEFAULT NULL
+
+#define practice_rpc_BenchPublisherStats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   published,         1) \
+X(a, STATIC,   SINGULAR, UINT32,   failed,            2) \
+X(a, STATIC,   SINGULAR, UINT64,   elapsed_us,        3)
+#define practice_rpc_BenchPublisherStats_CALLBACK NULL
+#define practice_rpc_BenchPublisherStats_DEFAULT NULL
+
 extern const pb_msgdesc_t practice_rpc_WifiSettings_msg;
 extern const pb_msgdesc_t practice_rpc_LedRequest_msg;
 extern const pb_msgdesc_t practice_rpc_LedResponse_msg;
@@ -157,7 +476,21 @@ extern const pb_msgdesc_t practice_rpc_EchoRequestMalloc_msg;
 extern const pb_msgdesc_t practice_rpc_EchoResponseMalloc_msg;
 extern const pb_msgdesc_t practice_rpc_SensorRequest_msg;
 extern const pb_msgdesc_t practice_rpc_SensorTelemetry_msg;
+extern const pb_msgdesc_t practice_rpc_TelemetryBatch_msg;
+extern const pb_msgdesc_t practice_rpc_GpioEvent_msg;
+extern const pb_msgdesc_t practice_rpc_LogLevelRequest_msg;
+extern const pb_msgdesc_t practice_rpc_LogLevelResponse_msg;
+extern const pb_msgdesc_t practice_rpc_Rule_msg;
+extern const pb_msgdesc_t practice_rpc_RuleSet_msg;
+extern const pb_msgdesc_t practice_rpc_SetRulesResponse_msg;
+extern const pb_msgdesc_t practice_rpc_DeviceState_msg;
+extern const pb_msgdesc_t practice_rpc_StreamControl_msg;
 extern const pb_msgdesc_t practice_rpc_Empty_msg;
+extern const pb_msgdesc_t practice_rpc_BenchPayload_msg;
+extern const pb_msgdesc_t practice_rpc_BenchSinkResponse_msg;
+extern const pb_msgdesc_t practice_rpc_BenchSourceRequest_msg;
+extern const pb_msgdesc_t practice_rpc_BenchPublishRequest_msg;
+extern const pb_msgdesc_t practice_rpc_BenchPublisherStats_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define practice_rpc_WifiSettings_fields &practice_rpc_WifiSettings_msg
@@ -169,19 +502,47 @@ extern const pb_msgdesc_t practice_rpc_Empty_msg;
 #define practice_rpc_EchoResponseMalloc_fields &practice_rpc_EchoResponseMalloc_msg
 #define practice_rpc_SensorRequest_fields &practice_rpc_SensorRequest_msg
 #define practice_rpc_SensorTelemetry_fields &practice_rpc_SensorTelemetry_msg
+#define practice_rpc_TelemetryBatch_fields &practice_rpc_TelemetryBatch_msg
+#define practice_rpc_GpioEvent_fields &practice_rpc_GpioEvent_msg
+#define practice_rpc_LogLevelRequest_fields &practice_rpc_LogLevelRequest_msg
+#define practice_rpc_LogLevelResponse_fields &practice_rpc_LogLevelResponse_msg
+#define practice_rpc_Rule_fields &practice_rpc_Rule_msg
+#define practice_rpc_RuleSet_fields &practice_rpc_RuleSet_msg
+#define practice_rpc_SetRulesResponse_fields &practice_rpc_SetRulesResponse_msg
+#define practice_rpc_DeviceState_fields &practice_rpc_DeviceState_msg
+#define practice_rpc_StreamControl_fields &practice_rpc_StreamControl_msg
 #define practice_rpc_Empty_fields &practice_rpc_Empty_msg
+#define practice_rpc_BenchPayload_fields &practice_rpc_BenchPayload_msg
+#define practice_rpc_BenchSinkResponse_fields &practice_rpc_BenchSinkResponse_msg
+#define practice_rpc_BenchSourceRequest_fields &practice_rpc_BenchSourceRequest_msg
+#define practice_rpc_BenchPublishRequest_fields &practice_rpc_BenchPublishRequest_msg
+#define practice_rpc_BenchPublisherStats_fields &practice_rpc_BenchPublisherStats_msg
 
 /* Maximum encoded size of messages (where known) */
 /* practice_rpc_EchoRequestMalloc_size depends on runtime parameters */
 /* practice_rpc_EchoResponseMalloc_size depends on runtime parameters */
-#define PRACTICE_RPC_SERVICE_PB_H_MAX_SIZE       practice_rpc_EchoRequest_size
+#define PRACTICE_RPC_SERVICE_PB_H_MAX_SIZE       practice_rpc_BenchPayload_size
+#define practice_rpc_BenchPayload_size           2051
+#define practice_rpc_BenchPublishRequest_size    20
+#define practice_rpc_BenchPublisherStats_size    23
+#define practice_rpc_BenchSinkResponse_size      6
+#define practice_rpc_BenchSourceRequest_size     6
+#define practice_rpc_DeviceState_size            46
 #define practice_rpc_EchoRequest_size            130
 #define practice_rpc_EchoResponse_size           130
 #define practice_rpc_Empty_size                  0
+#define practice_rpc_GpioEvent_size              31
 #define practice_rpc_LedRequest_size             2
 #define practice_rpc_LedResponse_size            0
-#define practice_rpc_SensorRequest_size          0
+#define practice_rpc_LogLevelRequest_size        31
+#define practice_rpc_LogLevelResponse_size       12
+#define practice_rpc_Rule_size                   34
+#define practice_rpc_RuleSet_size                216
+#define practice_rpc_SensorRequest_size          6
 #define practice_rpc_SensorTelemetry_size        10
+#define practice_rpc_SetRulesResponse_size       6
+#define practice_rpc_StreamControl_size          14
+#define practice_rpc_TelemetryBatch_size         249
 #define practice_rpc_WifiSettings_size           98
 
 #ifdef __cplusplus
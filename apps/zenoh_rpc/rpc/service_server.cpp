@@ -2,7 +2,10 @@
 #include <pb_encode.h>
 #include <pb_decode.h>
 #include <pb_common.h>
+#include <cstring>
+#include "alloc_guard.h"
 #include "log_wrapper.h"
+#include "message_pool.h"
 
 #ifdef __ZEPHYR__
 LOG_MODULE_REGISTER(service_server, LOG_LEVEL_INF);
@@ -10,8 +13,80 @@ LOG_MODULE_REGISTER(service_server, LOG_LEVEL_INF);
 
 namespace practice::rpc {
 
+namespace {
+
+// Request and response of one running DeviceService handler (message_pool.h)
+union DeviceServiceMessages {
+  struct {
+    practice_rpc_LedRequest request;
+    practice_rpc_LedResponse response;
+  } SetLed;
+  struct {
+    practice_rpc_EchoRequest request;
+    practice_rpc_EchoResponse response;
+  } Echo;
+  struct {
+    practice_rpc_EchoRequestMalloc request;
+    practice_rpc_EchoResponseMalloc response;
+  } EchoMalloc;
+  struct {
+    practice_rpc_SensorRequest request;
+    practice_rpc_Empty response;
+  } StartSensorStream;
+  struct {
+    practice_rpc_Empty request;
+    practice_rpc_Empty response;
+  } StopSensorStream;
+  struct {
+    practice_rpc_WifiSettings request;
+    practice_rpc_Empty response;
+  } ConfigureWifi;
+  struct {
+    practice_rpc_LogLevelRequest request;
+    practice_rpc_LogLevelResponse response;
+  } SetLogLevel;
+  struct {
+    practice_rpc_RuleSet request;
+    practice_rpc_SetRulesResponse response;
+  } SetRules;
+  struct {
+    practice_rpc_EchoRequest request;
+    practice_rpc_EchoResponse response;
+  } EchoStream;
+};
+zenoh_rpc::MessagePool<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> device_service_messages;
+
+// Request and response of one running BenchService handler (message_pool.h)
+union BenchServiceMessages {
+  struct {
+    practice_rpc_Empty request;
+    practice_rpc_Empty response;
+  } Ping;
+  struct {
+    practice_rpc_BenchPayload request;
+    practice_rpc_BenchSinkResponse response;
+  } Sink;
+  struct {
+    practice_rpc_BenchSourceRequest request;
+    practice_rpc_BenchPayload response;
+  } Source;
+  struct {
+    practice_rpc_BenchPublishRequest request;
+    practice_rpc_Empty response;
+  } StartPublisher;
+  struct {
+    practice_rpc_Empty request;
+    practice_rpc_BenchPublisherStats response;
+  } StopPublisher;
+};
+zenoh_rpc::MessagePool<BenchServiceMessages, zenoh_rpc::kHandlerSlots> bench_service_messages;
+
+}  // namespace
+
 DeviceServiceServer::DeviceServiceServer(zenoh_rpc::ZenohRpcChannel& channel, DeviceService& impl)
-    : channel_(channel), impl_(impl) {}
+    : channel_(channel),
+      impl_(impl),
+      echo_stream_streams_(channel, receive_EchoStream, closed_EchoStream, this) {}
 
 bool DeviceServiceServer::register_handlers() {
   bool success = true;
@@ -19,45 +94,73 @@ bool DeviceServiceServer::register_handlers() {
   // SetLed
   success &= channel_.register_handler(
       kServiceName, "SetLed",
-      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
-        return handle_SetLed(req_stream, resp_stream);
-      });
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_SetLed(req_stream, resp_stream, ctx);
+      },
+      20);  // time_budget_ms
 
   // Echo
   success &= channel_.register_handler(
       kServiceName, "Echo",
-      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
-        return handle_Echo(req_stream, resp_stream);
-      });
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_Echo(req_stream, resp_stream, ctx);
+      },
+      20);  // time_budget_ms
 
   // EchoMalloc
   success &= channel_.register_handler(
       kServiceName, "EchoMalloc",
-      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
-        return handle_EchoMalloc(req_stream, resp_stream);
-      });
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_EchoMalloc(req_stream, resp_stream, ctx);
+      },
+      50);  // time_budget_ms
 
   // StartSensorStream
   success &= channel_.register_handler(
       kServiceName, "StartSensorStream",
-      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
-        return handle_StartSensorStream(req_stream, resp_stream);
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_StartSensorStream(req_stream, resp_stream, ctx);
       });
 
   // StopSensorStream
   success &= channel_.register_handler(
       kServiceName, "StopSensorStream",
-      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
-        return handle_StopSensorStream(req_stream, resp_stream);
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_StopSensorStream(req_stream, resp_stream, ctx);
       });
 
   // ConfigureWifi
   success &= channel_.register_handler(
       kServiceName, "ConfigureWifi",
-      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
-        return handle_ConfigureWifi(req_stream, resp_stream);
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_ConfigureWifi(req_stream, resp_stream, ctx);
+      });
+
+  // SetLogLevel
+  success &= channel_.register_handler(
+      kServiceName, "SetLogLevel",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_SetLogLevel(req_stream, resp_stream, ctx);
       });
 
+  // SetRules
+  success &= channel_.register_handler(
+      kServiceName, "SetRules",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_SetRules(req_stream, resp_stream, ctx);
+      },
+      20);  // time_budget_ms
+
+  // EchoStream
+  success &= channel_.register_handler(
+      kServiceName, "EchoStream",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_EchoStream(req_stream, resp_stream, ctx);
+      });
+
+  // On-device callers (DeviceServiceClient) call impl_ directly
+  success &= channel_.register_local_service(kServiceName, &impl_);
+
   if (success) {
     LOG_INF("All DeviceService handlers registered");
   } else {
@@ -67,23 +170,36 @@ bool DeviceServiceServer::register_handlers() {
 }
 
 zenoh_rpc::RpcStatus DeviceServiceServer::handle_SetLed(
-    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for SetLed");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->SetLed, 0, sizeof(slot->SetLed));  // *_init_zero
+  practice_rpc_LedRequest& request = slot->SetLed.request;
+  practice_rpc_LedResponse& response = slot->SetLed.response;
+
   // Decode request
-  practice_rpc_LedRequest request = practice_rpc_LedRequest_init_zero;
   if (!pb_decode(req_stream, practice_rpc_LedRequest_fields, &request)) {
     LOG_ERR("Failed to decode LedRequest");
     return zenoh_rpc::RpcStatus::DECODE_ERROR;
   }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
 
   // Call implementation
-  practice_rpc_LedResponse response = practice_rpc_LedResponse_init_zero;
-  zenoh_rpc::RpcStatus status = impl_.SetLed(request, &response);
+  zenoh_rpc::RpcStatus status = impl_.SetLed(request, &response, ctx);
   if (status != zenoh_rpc::RpcStatus::OK) {
     return status;
   }
 
-  // Encode response directly to stream (zero-copy)
-  if (!pb_encode(resp_stream, practice_rpc_LedResponse_fields, &response)) {
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_LedResponse_fields, response, ctx)) {
     LOG_ERR("Failed to encode LedResponse");
     return zenoh_rpc::RpcStatus::ENCODE_ERROR;
   }
@@ -92,23 +208,36 @@ zenoh_rpc::RpcStatus DeviceServiceServer::handle_SetLed(
 }
 
 zenoh_rpc::RpcStatus DeviceServiceServer::handle_Echo(
-    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for Echo");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->Echo, 0, sizeof(slot->Echo));  // *_init_zero
+  practice_rpc_EchoRequest& request = slot->Echo.request;
+  practice_rpc_EchoResponse& response = slot->Echo.response;
+
   // Decode request
-  practice_rpc_EchoRequest request = practice_rpc_EchoRequest_init_zero;
   if (!pb_decode(req_stream, practice_rpc_EchoRequest_fields, &request)) {
     LOG_ERR("Failed to decode EchoRequest");
     return zenoh_rpc::RpcStatus::DECODE_ERROR;
   }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
 
   // Call implementation
-  practice_rpc_EchoResponse response = practice_rpc_EchoResponse_init_zero;
-  zenoh_rpc::RpcStatus status = impl_.Echo(request, &response);
+  zenoh_rpc::RpcStatus status = impl_.Echo(request, &response, ctx);
   if (status != zenoh_rpc::RpcStatus::OK) {
     return status;
   }
 
-  // Encode response directly to stream (zero-copy)
-  if (!pb_encode(resp_stream, practice_rpc_EchoResponse_fields, &response)) {
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_EchoResponse_fields, response, ctx)) {
     LOG_ERR("Failed to encode EchoResponse");
     return zenoh_rpc::RpcStatus::ENCODE_ERROR;
   }
@@ -117,24 +246,38 @@ zenoh_rpc::RpcStatus DeviceServiceServer::handle_Echo(
 }
 
 zenoh_rpc::RpcStatus DeviceServiceServer::handle_EchoMalloc(
-    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for EchoMalloc");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->EchoMalloc, 0, sizeof(slot->EchoMalloc));  // *_init_zero
+  practice_rpc_EchoRequestMalloc& request = slot->EchoMalloc.request;
+  practice_rpc_EchoResponseMalloc& response = slot->EchoMalloc.response;
+
   // Decode request
-  practice_rpc_EchoRequestMalloc request = practice_rpc_EchoRequestMalloc_init_zero;
   if (!pb_decode(req_stream, practice_rpc_EchoRequestMalloc_fields, &request)) {
     LOG_ERR("Failed to decode EchoRequestMalloc");
     return zenoh_rpc::RpcStatus::DECODE_ERROR;
   }
+  if (ctx.cancelled()) {
+    pb_release(practice_rpc_EchoRequestMalloc_fields, &request);
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
 
   // Call implementation
-  practice_rpc_EchoResponseMalloc response = practice_rpc_EchoResponseMalloc_init_zero;
-  zenoh_rpc::RpcStatus status = impl_.EchoMalloc(request, &response);
+  zenoh_rpc::RpcStatus status = impl_.EchoMalloc(request, &response, ctx);
   if (status != zenoh_rpc::RpcStatus::OK) {
     pb_release(practice_rpc_EchoRequestMalloc_fields, &request);
     return status;
   }
 
-  // Encode response directly to stream (zero-copy)
-  if (!pb_encode(resp_stream, practice_rpc_EchoResponseMalloc_fields, &response)) {
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response(resp_stream, practice_rpc_EchoResponseMalloc_fields, response, ctx)) {
     LOG_ERR("Failed to encode EchoResponseMalloc");
     pb_release(practice_rpc_EchoRequestMalloc_fields, &request);
     pb_release(practice_rpc_EchoResponseMalloc_fields, &response);
@@ -149,23 +292,36 @@ zenoh_rpc::RpcStatus DeviceServiceServer::handle_EchoMalloc(
 }
 
 zenoh_rpc::RpcStatus DeviceServiceServer::handle_StartSensorStream(
-    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for StartSensorStream");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->StartSensorStream, 0, sizeof(slot->StartSensorStream));  // *_init_zero
+  practice_rpc_SensorRequest& request = slot->StartSensorStream.request;
+  practice_rpc_Empty& response = slot->StartSensorStream.response;
+
   // Decode request
-  practice_rpc_SensorRequest request = practice_rpc_SensorRequest_init_zero;
   if (!pb_decode(req_stream, practice_rpc_SensorRequest_fields, &request)) {
     LOG_ERR("Failed to decode SensorRequest");
     return zenoh_rpc::RpcStatus::DECODE_ERROR;
   }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
 
   // Call implementation
-  practice_rpc_Empty response = practice_rpc_Empty_init_zero;
-  zenoh_rpc::RpcStatus status = impl_.StartSensorStream(request, &response);
+  zenoh_rpc::RpcStatus status = impl_.StartSensorStream(request, &response, ctx);
   if (status != zenoh_rpc::RpcStatus::OK) {
     return status;
   }
 
-  // Encode response directly to stream (zero-copy)
-  if (!pb_encode(resp_stream, practice_rpc_Empty_fields, &response)) {
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_Empty_fields, response, ctx)) {
     LOG_ERR("Failed to encode Empty");
     return zenoh_rpc::RpcStatus::ENCODE_ERROR;
   }
@@ -174,23 +330,36 @@ zenoh_rpc::RpcStatus DeviceServiceServer::handle_StartSensorStream(
 }
 
 zenoh_rpc::RpcStatus DeviceServiceServer::handle_StopSensorStream(
-    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for StopSensorStream");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->StopSensorStream, 0, sizeof(slot->StopSensorStream));  // *_init_zero
+  practice_rpc_Empty& request = slot->StopSensorStream.request;
+  practice_rpc_Empty& response = slot->StopSensorStream.response;
+
   // Decode request
-  practice_rpc_Empty request = practice_rpc_Empty_init_zero;
   if (!pb_decode(req_stream, practice_rpc_Empty_fields, &request)) {
     LOG_ERR("Failed to decode Empty");
     return zenoh_rpc::RpcStatus::DECODE_ERROR;
   }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
 
   // Call implementation
-  practice_rpc_Empty response = practice_rpc_Empty_init_zero;
-  zenoh_rpc::RpcStatus status = impl_.StopSensorStream(request, &response);
+  zenoh_rpc::RpcStatus status = impl_.StopSensorStream(request, &response, ctx);
   if (status != zenoh_rpc::RpcStatus::OK) {
     return status;
   }
 
-  // Encode response directly to stream (zero-copy)
-  if (!pb_encode(resp_stream, practice_rpc_Empty_fields, &response)) {
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_Empty_fields, response, ctx)) {
     LOG_ERR("Failed to encode Empty");
     return zenoh_rpc::RpcStatus::ENCODE_ERROR;
   }
@@ -199,23 +368,458 @@ zenoh_rpc::RpcStatus DeviceServiceServer::handle_StopSensorStream(
 }
 
 zenoh_rpc::RpcStatus DeviceServiceServer::handle_ConfigureWifi(
-    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for ConfigureWifi");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->ConfigureWifi, 0, sizeof(slot->ConfigureWifi));  // *_init_zero
+  practice_rpc_WifiSettings& request = slot->ConfigureWifi.request;
+  practice_rpc_Empty& response = slot->ConfigureWifi.response;
+
   // Decode request
-  practice_rpc_WifiSettings request = practice_rpc_WifiSettings_init_zero;
   if (!pb_decode(req_stream, practice_rpc_WifiSettings_fields, &request)) {
     LOG_ERR("Failed to decode WifiSettings");
     return zenoh_rpc::RpcStatus::DECODE_ERROR;
   }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.ConfigureWifi(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_Empty_fields, response, ctx)) {
+    LOG_ERR("Failed to encode Empty");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus DeviceServiceServer::handle_SetLogLevel(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for SetLogLevel");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->SetLogLevel, 0, sizeof(slot->SetLogLevel));  // *_init_zero
+  practice_rpc_LogLevelRequest& request = slot->SetLogLevel.request;
+  practice_rpc_LogLevelResponse& response = slot->SetLogLevel.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_LogLevelRequest_fields, &request)) {
+    LOG_ERR("Failed to decode LogLevelRequest");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.SetLogLevel(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_LogLevelResponse_fields, response, ctx)) {
+    LOG_ERR("Failed to encode LogLevelResponse");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus DeviceServiceServer::handle_SetRules(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for SetRules");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->SetRules, 0, sizeof(slot->SetRules));  // *_init_zero
+  practice_rpc_RuleSet& request = slot->SetRules.request;
+  practice_rpc_SetRulesResponse& response = slot->SetRules.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_RuleSet_fields, &request)) {
+    LOG_ERR("Failed to decode RuleSet");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.SetRules(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_SetRulesResponse_fields, response, ctx)) {
+    LOG_ERR("Failed to encode SetRulesResponse");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+// EchoStream: open or close a stream; the messages flow on the stream keys
+zenoh_rpc::RpcStatus DeviceServiceServer::handle_EchoStream(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  (void)ctx;
+  practice_rpc_StreamControl control = practice_rpc_StreamControl_init_zero;
+  if (!pb_decode(req_stream, practice_rpc_StreamControl_fields, &control)) {
+    LOG_ERR("Failed to decode StreamControl");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+
+  practice_rpc_StreamControl reply = practice_rpc_StreamControl_init_zero;
+  reply.stream_id = control.stream_id;
+  if (control.close) {
+    reply.close = echo_stream_streams_.close(control.stream_id);
+  } else {
+    zenoh_rpc::StreamPort* port = echo_stream_streams_.open(control.window > 0 ? control.window : 1);
+    if (port == nullptr) {
+      LOG_WRN("No free EchoStream stream");
+      return zenoh_rpc::RpcStatus::BUSY;
+    }
+    reply.stream_id = port->id();
+    reply.window = zenoh_rpc::kStreamWindow;
+  }
+  if (!pb_encode(resp_stream, practice_rpc_StreamControl_fields, &reply)) {
+    LOG_ERR("Failed to encode StreamControl");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus DeviceServiceServer::receive_EchoStream(
+    void* context, zenoh_rpc::StreamPort& port, pb_istream_t* in) {
+  auto* self = static_cast<DeviceServiceServer*>(context);
+  zenoh_rpc::PooledMessage<DeviceServiceMessages, zenoh_rpc::kHandlerSlots> slot(device_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for EchoStream");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->EchoStream, 0, sizeof(slot->EchoStream));  // *_init_zero
+  practice_rpc_EchoRequest& request = slot->EchoStream.request;
+  if (!pb_decode(in, practice_rpc_EchoRequest_fields, &request)) {
+    LOG_ERR("Failed to decode EchoRequest");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  zenoh_rpc::StreamWriter<practice_rpc_EchoResponse> writer(&port, practice_rpc_EchoResponse_fields);
+  zenoh_rpc::RpcStatus status = self->impl_.EchoStream(request, writer);
+  return status;
+}
+
+void DeviceServiceServer::closed_EchoStream(void* context, uint32_t stream_id) {
+  static_cast<DeviceServiceServer*>(context)->impl_.EchoStreamClosed(stream_id);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::SetLed(
+    const practice_rpc_LedRequest& req, practice_rpc_LedResponse* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->SetLed(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_LedRequest_size, practice_rpc_LedResponse_size>(
+      kServiceName, "SetLed", practice_rpc_LedRequest_fields, &req,
+      practice_rpc_LedResponse_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::Echo(
+    const practice_rpc_EchoRequest& req, practice_rpc_EchoResponse* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->Echo(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_EchoRequest_size, practice_rpc_EchoResponse_size>(
+      kServiceName, "Echo", practice_rpc_EchoRequest_fields, &req,
+      practice_rpc_EchoResponse_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::EchoMalloc(
+    const practice_rpc_EchoRequestMalloc& req, practice_rpc_EchoResponseMalloc* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->EchoMalloc(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<zenoh_rpc::kMaxDynamicMessageSize, zenoh_rpc::kMaxDynamicMessageSize>(
+      kServiceName, "EchoMalloc", practice_rpc_EchoRequestMalloc_fields, &req,
+      practice_rpc_EchoResponseMalloc_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::StartSensorStream(
+    const practice_rpc_SensorRequest& req, practice_rpc_Empty* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->StartSensorStream(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_SensorRequest_size, practice_rpc_Empty_size>(
+      kServiceName, "StartSensorStream", practice_rpc_SensorRequest_fields, &req,
+      practice_rpc_Empty_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::StopSensorStream(
+    const practice_rpc_Empty& req, practice_rpc_Empty* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->StopSensorStream(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_Empty_size, practice_rpc_Empty_size>(
+      kServiceName, "StopSensorStream", practice_rpc_Empty_fields, &req,
+      practice_rpc_Empty_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::ConfigureWifi(
+    const practice_rpc_WifiSettings& req, practice_rpc_Empty* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->ConfigureWifi(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_WifiSettings_size, practice_rpc_Empty_size>(
+      kServiceName, "ConfigureWifi", practice_rpc_WifiSettings_fields, &req,
+      practice_rpc_Empty_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::SetLogLevel(
+    const practice_rpc_LogLevelRequest& req, practice_rpc_LogLevelResponse* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->SetLogLevel(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_LogLevelRequest_size, practice_rpc_LogLevelResponse_size>(
+      kServiceName, "SetLogLevel", practice_rpc_LogLevelRequest_fields, &req,
+      practice_rpc_LogLevelResponse_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus DeviceServiceClient::SetRules(
+    const practice_rpc_RuleSet& req, practice_rpc_SetRulesResponse* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<DeviceService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->SetRules(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_RuleSet_size, practice_rpc_SetRulesResponse_size>(
+      kServiceName, "SetRules", practice_rpc_RuleSet_fields, &req,
+      practice_rpc_SetRulesResponse_fields, resp, timeout_ms);
+}
+
+BenchServiceServer::BenchServiceServer(zenoh_rpc::ZenohRpcChannel& channel, BenchService& impl)
+    : channel_(channel), impl_(impl) {}
+
+bool BenchServiceServer::register_handlers() {
+  bool success = true;
+
+  // Ping
+  success &= channel_.register_handler(
+      kServiceName, "Ping",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_Ping(req_stream, resp_stream, ctx);
+      });
+
+  // Sink
+  success &= channel_.register_handler(
+      kServiceName, "Sink",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_Sink(req_stream, resp_stream, ctx);
+      });
+
+  // Source
+  success &= channel_.register_handler(
+      kServiceName, "Source",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_Source(req_stream, resp_stream, ctx);
+      });
+
+  // StartPublisher
+  success &= channel_.register_handler(
+      kServiceName, "StartPublisher",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_StartPublisher(req_stream, resp_stream, ctx);
+      });
+
+  // StopPublisher
+  success &= channel_.register_handler(
+      kServiceName, "StopPublisher",
+      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+        return handle_StopPublisher(req_stream, resp_stream, ctx);
+      });
+
+  // On-device callers (BenchServiceClient) call impl_ directly
+  success &= channel_.register_local_service(kServiceName, &impl_);
+
+  if (success) {
+    LOG_INF("All BenchService handlers registered");
+  } else {
+    LOG_ERR("Failed to register some BenchService handlers");
+  }
+  return success;
+}
+
+zenoh_rpc::RpcStatus BenchServiceServer::handle_Ping(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<BenchServiceMessages, zenoh_rpc::kHandlerSlots> slot(bench_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for Ping");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->Ping, 0, sizeof(slot->Ping));  // *_init_zero
+  practice_rpc_Empty& request = slot->Ping.request;
+  practice_rpc_Empty& response = slot->Ping.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_Empty_fields, &request)) {
+    LOG_ERR("Failed to decode Empty");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.Ping(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_Empty_fields, response, ctx)) {
+    LOG_ERR("Failed to encode Empty");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceServer::handle_Sink(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<BenchServiceMessages, zenoh_rpc::kHandlerSlots> slot(bench_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for Sink");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->Sink, 0, sizeof(slot->Sink));  // *_init_zero
+  practice_rpc_BenchPayload& request = slot->Sink.request;
+  practice_rpc_BenchSinkResponse& response = slot->Sink.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_BenchPayload_fields, &request)) {
+    LOG_ERR("Failed to decode BenchPayload");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.Sink(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_BenchSinkResponse_fields, response, ctx)) {
+    LOG_ERR("Failed to encode BenchSinkResponse");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceServer::handle_Source(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<BenchServiceMessages, zenoh_rpc::kHandlerSlots> slot(bench_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for Source");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->Source, 0, sizeof(slot->Source));  // *_init_zero
+  practice_rpc_BenchSourceRequest& request = slot->Source.request;
+  practice_rpc_BenchPayload& response = slot->Source.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_BenchSourceRequest_fields, &request)) {
+    LOG_ERR("Failed to decode BenchSourceRequest");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
 
   // Call implementation
-  practice_rpc_Empty response = practice_rpc_Empty_init_zero;
-  zenoh_rpc::RpcStatus status = impl_.ConfigureWifi(request, &response);
+  zenoh_rpc::RpcStatus status = impl_.Source(request, &response, ctx);
   if (status != zenoh_rpc::RpcStatus::OK) {
     return status;
   }
 
-  // Encode response directly to stream (zero-copy)
-  if (!pb_encode(resp_stream, practice_rpc_Empty_fields, &response)) {
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_BenchPayload_fields, response, ctx)) {
+    LOG_ERR("Failed to encode BenchPayload");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceServer::handle_StartPublisher(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<BenchServiceMessages, zenoh_rpc::kHandlerSlots> slot(bench_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for StartPublisher");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->StartPublisher, 0, sizeof(slot->StartPublisher));  // *_init_zero
+  practice_rpc_BenchPublishRequest& request = slot->StartPublisher.request;
+  practice_rpc_Empty& response = slot->StartPublisher.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_BenchPublishRequest_fields, &request)) {
+    LOG_ERR("Failed to decode BenchPublishRequest");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.StartPublisher(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_Empty_fields, response, ctx)) {
     LOG_ERR("Failed to encode Empty");
     return zenoh_rpc::RpcStatus::ENCODE_ERROR;
   }
@@ -223,4 +827,97 @@ zenoh_rpc::RpcStatus DeviceServiceServer::handle_ConfigureWifi(
   return zenoh_rpc::RpcStatus::OK;
 }
 
+zenoh_rpc::RpcStatus BenchServiceServer::handle_StopPublisher(
+    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {
+  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);
+  zenoh_rpc::PooledMessage<BenchServiceMessages, zenoh_rpc::kHandlerSlots> slot(bench_service_messages);
+  if (!slot) {
+    LOG_ERR("No free message slot for StopPublisher");
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  memset(&slot->StopPublisher, 0, sizeof(slot->StopPublisher));  // *_init_zero
+  practice_rpc_Empty& request = slot->StopPublisher.request;
+  practice_rpc_BenchPublisherStats& response = slot->StopPublisher.response;
+
+  // Decode request
+  if (!pb_decode(req_stream, practice_rpc_Empty_fields, &request)) {
+    LOG_ERR("Failed to decode Empty");
+    return zenoh_rpc::RpcStatus::DECODE_ERROR;
+  }
+  if (ctx.cancelled()) {
+    return zenoh_rpc::RpcStatus::TIMEOUT;
+  }
+  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time
+  ctx.wait_until_start();
+
+  // Call implementation
+  zenoh_rpc::RpcStatus status = impl_.StopPublisher(request, &response, ctx);
+  if (status != zenoh_rpc::RpcStatus::OK) {
+    return status;
+  }
+
+  // Encode response directly to stream (zero-copy), selected fields only
+  if (!zenoh_rpc::encode_response_in_place(resp_stream, practice_rpc_BenchPublisherStats_fields, response, ctx)) {
+    LOG_ERR("Failed to encode BenchPublisherStats");
+    return zenoh_rpc::RpcStatus::ENCODE_ERROR;
+  }
+
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+zenoh_rpc::RpcStatus BenchServiceClient::Ping(
+    const practice_rpc_Empty& req, practice_rpc_Empty* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<BenchService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->Ping(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_Empty_size, practice_rpc_Empty_size>(
+      kServiceName, "Ping", practice_rpc_Empty_fields, &req,
+      practice_rpc_Empty_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus BenchServiceClient::Sink(
+    const practice_rpc_BenchPayload& req, practice_rpc_BenchSinkResponse* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<BenchService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->Sink(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_BenchPayload_size, practice_rpc_BenchSinkResponse_size>(
+      kServiceName, "Sink", practice_rpc_BenchPayload_fields, &req,
+      practice_rpc_BenchSinkResponse_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus BenchServiceClient::Source(
+    const practice_rpc_BenchSourceRequest& req, practice_rpc_BenchPayload* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<BenchService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->Source(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_BenchSourceRequest_size, practice_rpc_BenchPayload_size>(
+      kServiceName, "Source", practice_rpc_BenchSourceRequest_fields, &req,
+      practice_rpc_BenchPayload_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus BenchServiceClient::StartPublisher(
+    const practice_rpc_BenchPublishRequest& req, practice_rpc_Empty* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<BenchService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->StartPublisher(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_BenchPublishRequest_size, practice_rpc_Empty_size>(
+      kServiceName, "StartPublisher", practice_rpc_BenchPublishRequest_fields, &req,
+      practice_rpc_Empty_fields, resp, timeout_ms);
+}
+
+zenoh_rpc::RpcStatus BenchServiceClient::StopPublisher(
+    const practice_rpc_Empty& req, practice_rpc_BenchPublisherStats* resp, uint32_t timeout_ms) {
+  auto* impl = static_cast<BenchService*>(channel_.local_service(kServiceName));
+  if (impl != nullptr) {
+    return impl->StopPublisher(req, resp, zenoh_rpc::kDefaultRpcContext);
+  }
+  return channel_.call_message<practice_rpc_Empty_size, practice_rpc_BenchPublisherStats_size>(
+      kServiceName, "StopPublisher", practice_rpc_Empty_fields, &req,
+      practice_rpc_BenchPublisherStats_fields, resp, timeout_ms);
+}
+
 }  // namespace practice::rpc
\ No newline at end of file
@@ -3,8 +3,18 @@
 
 #include "zenoh_rpc_channel.h"
 #include "service.pb.h"
+#include "zenoh_stream.h"
+
+#if Z_FEATURE_SUBSCRIPTION != 1
+#error "Stream methods need Z_FEATURE_SUBSCRIPTION"
+#endif
 
 #define PRACTICE_RPC_SENSOR_TELEMETRY_ZENOH_KEY "/telemetry/sensor"
+#define PRACTICE_RPC_SENSOR_TELEMETRY_MAX_INTERVAL_MS 10000
+#define PRACTICE_RPC_SENSOR_TELEMETRY_MAX_BATCH 8
+#define PRACTICE_RPC_GPIO_EVENT_ZENOH_KEY "/events/gpio"
+
+#define PRACTICE_RPC_DEVICE_STATE_STATE_KEY "/state"
 
 namespace practice::rpc {
 
@@ -12,12 +22,23 @@ namespace practice::rpc {
 class DeviceService {
  public:
   virtual ~DeviceService() = default;
-  virtual zenoh_rpc::RpcStatus SetLed(const practice_rpc_LedRequest& req, practice_rpc_LedResponse* resp) = 0;
-  virtual zenoh_rpc::RpcStatus Echo(const practice_rpc_EchoRequest& req, practice_rpc_EchoResponse* resp) = 0;
-  virtual zenoh_rpc::RpcStatus EchoMalloc(const practice_rpc_EchoRequestMalloc& req, practice_rpc_EchoResponseMalloc* resp) = 0;
-  virtual zenoh_rpc::RpcStatus StartSensorStream(const practice_rpc_SensorRequest& req, practice_rpc_Empty* resp) = 0;
-  virtual zenoh_rpc::RpcStatus StopSensorStream(const practice_rpc_Empty& req, practice_rpc_Empty* resp) = 0;
-  virtual zenoh_rpc::RpcStatus ConfigureWifi(const practice_rpc_WifiSettings& req, practice_rpc_Empty* resp) = 0;
+  // ctx: context of the call being served, e.g. to skip computing response
+  // fields the client did not ask for: ctx.wants(<field>_tag), or to stop
+  // long work at the deadline: ctx.cancelled() (return TIMEOUT). Calls may
+  // run concurrently on several threads, each with its own context
+  virtual zenoh_rpc::RpcStatus SetLed(const practice_rpc_LedRequest& req, practice_rpc_LedResponse* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus Echo(const practice_rpc_EchoRequest& req, practice_rpc_EchoResponse* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus EchoMalloc(const practice_rpc_EchoRequestMalloc& req, practice_rpc_EchoResponseMalloc* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus StartSensorStream(const practice_rpc_SensorRequest& req, practice_rpc_Empty* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus StopSensorStream(const practice_rpc_Empty& req, practice_rpc_Empty* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus ConfigureWifi(const practice_rpc_WifiSettings& req, practice_rpc_Empty* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus SetLogLevel(const practice_rpc_LogLevelRequest& req, practice_rpc_LogLevelResponse* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus SetRules(const practice_rpc_RuleSet& req, practice_rpc_SetRulesResponse* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  // EchoStream stream: called for every message received; reply with any
+  // number of stream.send() (false without credit from the client)
+  virtual zenoh_rpc::RpcStatus EchoStream(const practice_rpc_EchoRequest& req, zenoh_rpc::StreamWriter<practice_rpc_EchoResponse>& stream) = 0;
+  // Called once a stream closed (by the client or after idling)
+  virtual void EchoStreamClosed(uint32_t /*stream_id*/) {}
 };
 
 class DeviceServiceServer {
@@ -30,12 +51,93 @@ class DeviceServiceServer {
   DeviceService& impl_;
   static constexpr const char* kServiceName = "DeviceService";
 
-  zenoh_rpc::RpcStatus handle_SetLed(pb_istream_t* req_stream, pb_ostream_t* resp_stream);
-  zenoh_rpc::RpcStatus handle_Echo(pb_istream_t* req_stream, pb_ostream_t* resp_stream);
-  zenoh_rpc::RpcStatus handle_EchoMalloc(pb_istream_t* req_stream, pb_ostream_t* resp_stream);
-  zenoh_rpc::RpcStatus handle_StartSensorStream(pb_istream_t* req_stream, pb_ostream_t* resp_stream);
-  zenoh_rpc::RpcStatus handle_StopSensorStream(pb_istream_t* req_stream, pb_ostream_t* resp_stream);
-  zenoh_rpc::RpcStatus handle_ConfigureWifi(pb_istream_t* req_stream, pb_ostream_t* resp_stream);
+  zenoh_rpc::RpcStatus handle_SetLed(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_Echo(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_EchoMalloc(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_StartSensorStream(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_StopSensorStream(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_ConfigureWifi(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_SetLogLevel(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_SetRules(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_EchoStream(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+
+  // EchoStream streams (handle_EchoStream opens and closes them)
+  static zenoh_rpc::RpcStatus receive_EchoStream(void* context, zenoh_rpc::StreamPort& port, pb_istream_t* in);
+  static void closed_EchoStream(void* context, uint32_t stream_id);
+  zenoh_rpc::StreamTable echo_stream_streams_;
+};
+
+// On-device client for DeviceService: calls the implementation served on the
+// same channel directly with the structs (caller's thread, no encoding),
+// otherwise encodes the call and sends it through the router.
+// Responses with FT_POINTER fields must be released with pb_release().
+class DeviceServiceClient {
+ public:
+  explicit DeviceServiceClient(zenoh_rpc::ZenohRpcChannel& channel) : channel_(channel) {}
+
+  zenoh_rpc::RpcStatus SetLed(const practice_rpc_LedRequest& req, practice_rpc_LedResponse* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus Echo(const practice_rpc_EchoRequest& req, practice_rpc_EchoResponse* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus EchoMalloc(const practice_rpc_EchoRequestMalloc& req, practice_rpc_EchoResponseMalloc* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus StartSensorStream(const practice_rpc_SensorRequest& req, practice_rpc_Empty* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus StopSensorStream(const practice_rpc_Empty& req, practice_rpc_Empty* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus ConfigureWifi(const practice_rpc_WifiSettings& req, practice_rpc_Empty* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus SetLogLevel(const practice_rpc_LogLevelRequest& req, practice_rpc_LogLevelResponse* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus SetRules(const practice_rpc_RuleSet& req, practice_rpc_SetRulesResponse* resp, uint32_t timeout_ms = 5000);
+
+ private:
+  zenoh_rpc::ZenohRpcChannel& channel_;
+  static constexpr const char* kServiceName = "DeviceService";
+};
+
+// Interface for BenchService
+class BenchService {
+ public:
+  virtual ~BenchService() = default;
+  // ctx: context of the call being served, e.g. to skip computing response
+  // fields the client did not ask for: ctx.wants(<field>_tag), or to stop
+  // long work at the deadline: ctx.cancelled() (return TIMEOUT). Calls may
+  // run concurrently on several threads, each with its own context
+  virtual zenoh_rpc::RpcStatus Ping(const practice_rpc_Empty& req, practice_rpc_Empty* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus Sink(const practice_rpc_BenchPayload& req, practice_rpc_BenchSinkResponse* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus Source(const practice_rpc_BenchSourceRequest& req, practice_rpc_BenchPayload* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus StartPublisher(const practice_rpc_BenchPublishRequest& req, practice_rpc_Empty* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+  virtual zenoh_rpc::RpcStatus StopPublisher(const practice_rpc_Empty& req, practice_rpc_BenchPublisherStats* resp, const zenoh_rpc::RpcContext& ctx) = 0;
+};
+
+class BenchServiceServer {
+ public:
+  BenchServiceServer(zenoh_rpc::ZenohRpcChannel& channel, BenchService& impl);
+  bool register_handlers();
+
+ private:
+  zenoh_rpc::ZenohRpcChannel& channel_;
+  BenchService& impl_;
+  static constexpr const char* kServiceName = "BenchService";
+
+  zenoh_rpc::RpcStatus handle_Ping(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_Sink(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_Source(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_StartPublisher(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+  zenoh_rpc::RpcStatus handle_StopPublisher(pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx);
+};
+
+// On-device client for BenchService: calls the implementation served on the
+// same channel directly with the structs (caller's thread, no encoding),
+// otherwise encodes the call and sends it through the router.
+// Responses with FT_POINTER fields must be released with pb_release().
+class BenchServiceClient {
+ public:
+  explicit BenchServiceClient(zenoh_rpc::ZenohRpcChannel& channel) : channel_(channel) {}
+
+  zenoh_rpc::RpcStatus Ping(const practice_rpc_Empty& req, practice_rpc_Empty* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus Sink(const practice_rpc_BenchPayload& req, practice_rpc_BenchSinkResponse* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus Source(const practice_rpc_BenchSourceRequest& req, practice_rpc_BenchPayload* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus StartPublisher(const practice_rpc_BenchPublishRequest& req, practice_rpc_Empty* resp, uint32_t timeout_ms = 5000);
+  zenoh_rpc::RpcStatus StopPublisher(const practice_rpc_Empty& req, practice_rpc_BenchPublisherStats* resp, uint32_t timeout_ms = 5000);
+
+ private:
+  zenoh_rpc::ZenohRpcChannel& channel_;
+  static constexpr const char* kServiceName = "BenchService";
 };
 
 }  // namespace practice::rpc
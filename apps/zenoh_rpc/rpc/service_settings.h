@@ -0,0 +1,27 @@
+#ifndef SERVICE_SETTINGS_H
+#define SERVICE_SETTINGS_H
+
+#include "settings_store.h"
+#include "service.pb.h"
+
+#define PRACTICE_RPC_WIFI_SETTINGS_SETTINGS_KEY "wifi"
+#define PRACTICE_RPC_RULE_SET_SETTINGS_KEY "rules"
+
+namespace practice::rpc {
+
+// Settings cache for messages with the settings_key option
+struct ServiceSettings {
+  config::SettingsEntry<practice_rpc_WifiSettings, practice_rpc_WifiSettings_size> wifi_settings{
+      PRACTICE_RPC_WIFI_SETTINGS_SETTINGS_KEY, practice_rpc_WifiSettings_fields};
+  config::SettingsEntry<practice_rpc_RuleSet, practice_rpc_RuleSet_size> rule_set{
+      PRACTICE_RPC_RULE_SET_SETTINGS_KEY, practice_rpc_RuleSet_fields};
+
+  // Register all entries (call before SettingsStore::load())
+  void register_all(config::SettingsStore& store) {
+    store.add(wifi_settings);
+    store.add(rule_set);
+  }
+};
+
+}  // namespace practice::rpc
+#endif  // SERVICE_SETTINGS_H
\ No newline at end of file
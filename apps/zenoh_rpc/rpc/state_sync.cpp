@@ -0,0 +1,119 @@
+// State Sync - Implementation
+
+#include "state_sync.h"
+
+#include <pb_common.h>
+
+#include <cstring>
+
+namespace zenoh_rpc {
+
+namespace {
+
+// Number of stored elements of a static field
+pb_size_t element_count(const pb_field_iter_t& iter) {
+  if (PB_HTYPE(iter.type) != PB_HTYPE_REPEATED) {
+    return 1;
+  }
+  if (iter.pSize == &iter.array_size) {
+    return iter.array_size;
+  }
+  return *static_cast<const pb_size_t*>(iter.pSize);
+}
+
+bool value_equal(const pb_field_iter_t& a, const pb_field_iter_t& b) {
+  pb_size_t count = element_count(a);
+  if (count != element_count(b)) {
+    return false;
+  }
+  const auto* pa = static_cast<const uint8_t*>(a.pData);
+  const auto* pb = static_cast<const uint8_t*>(b.pData);
+  for (pb_size_t i = 0; i < count; ++i) {
+    const uint8_t* ea = pa + i * a.data_size;
+    const uint8_t* eb = pb + i * b.data_size;
+    switch (PB_LTYPE(a.type)) {
+      case PB_LTYPE_STRING:
+        // Bytes after the terminator are not part of the value
+        if (strncmp(reinterpret_cast<const char*>(ea),
+                    reinterpret_cast<const char*>(eb), a.data_size) != 0) {
+          return false;
+        }
+        break;
+      case PB_LTYPE_BYTES: {
+        auto* ba = reinterpret_cast<const pb_bytes_array_t*>(ea);
+        auto* bb = reinterpret_cast<const pb_bytes_array_t*>(eb);
+        if (ba->size != bb->size || memcmp(ba->bytes, bb->bytes, ba->size)) {
+          return false;
+        }
+        break;
+      }
+      case PB_LTYPE_SUBMESSAGE:
+      case PB_LTYPE_SUBMSG_W_CB:
+        if (diff_fields(a.submsg_desc, ea, eb) != 0) {
+          return false;
+        }
+        break;
+      default:
+        if (memcmp(ea, eb, a.data_size) != 0) {
+          return false;
+        }
+        break;
+    }
+  }
+  return true;
+}
+
+bool field_equal(const pb_field_iter_t& a, const pb_field_iter_t& b) {
+  switch (PB_HTYPE(a.type)) {
+    case PB_HTYPE_OPTIONAL:
+      // has_ flag (pSize NULL for proto3 singular fields)
+      if (a.pSize != NULL) {
+        bool has_a = *static_cast<const bool*>(a.pSize);
+        if (has_a != *static_cast<const bool*>(b.pSize)) {
+          return false;
+        }
+        if (!has_a) {
+          return true;
+        }
+      }
+      break;
+    case PB_HTYPE_ONEOF: {
+      // Members share storage: compare only the active one
+      bool active_a = *static_cast<const pb_size_t*>(a.pSize) == a.tag;
+      if (active_a != (*static_cast<const pb_size_t*>(b.pSize) == b.tag)) {
+        return false;
+      }
+      if (!active_a) {
+        return true;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return value_equal(a, b);
+}
+
+}  // namespace
+
+uint64_t diff_fields(const pb_msgdesc_t* fields, const void* a,
+                     const void* b) {
+  pb_field_iter_t ia;
+  pb_field_iter_t ib;
+  if (!pb_field_iter_begin_const(&ia, fields, a) ||
+      !pb_field_iter_begin_const(&ib, fields, b)) {
+    return 0;
+  }
+  uint64_t changed = 0;
+  do {
+    if (ia.tag == 0 || ia.tag > 64 || PB_ATYPE(ia.type) != PB_ATYPE_STATIC) {
+      continue;
+    }
+    if (!field_equal(ia, ib)) {
+      changed |= uint64_t{1} << (ia.tag - 1);
+    }
+  } while (pb_field_iter_next(&ia) && pb_field_iter_next(&ib));
+  return changed;
+}
+
+}  // namespace zenoh_rpc
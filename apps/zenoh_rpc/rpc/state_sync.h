@@ -0,0 +1,204 @@
+// State Sync - versioned device state mirrored by clients as deltas
+// Every change bumps the version and publishes only the changed fields on
+// <device><state_key>, with the version and the changed-field mask in the
+// attachment. <device><state_key>/snapshot answers with the full state for
+// clients that join late or detect a version gap.
+// Keep in sync with tools/rpc/state_mirror.py
+
+#pragma once
+
+#include <pb_encode.h>
+#include <zenoh-pico.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "log_wrapper.h"
+#include "rpc_context.h"
+#include "zenoh_attachment.h"
+#include "zenoh_pubsub.h"
+
+// Queryable of the full state: <device><state_key>/snapshot
+#define ZENOH_STATE_SNAPSHOT_SUFFIX "/snapshot"
+
+namespace zenoh_rpc {
+
+/**
+ * @brief Mask of the fields that differ between two messages
+ *
+ * Bit n-1 is set if field n differs. Only statically allocated fields are
+ * compared (state messages have no FT_POINTER / callback fields).
+ */
+uint64_t diff_fields(const pb_msgdesc_t* fields, const void* a, const void* b);
+
+// Bytes needed for a mask of every field of the message (1..8)
+inline size_t field_mask_width(const pb_msgdesc_t* fields) {
+  size_t width = (fields->largest_tag + 7) / 8;
+  return width < 1 ? 1 : (width > 8 ? 8 : width);
+}
+
+/**
+ * @brief Versioned state, published as deltas and served as snapshots
+ *
+ * @tparam T State message struct (statically allocated fields only)
+ * @tparam MaxSize Maximum encoded size of T (<msg>_size from nanopb)
+ */
+template <typename T, size_t MaxSize>
+class StateSync {
+ public:
+  StateSync(z_loaned_session_t* session, const char* device_id,
+            const char* state_key, const pb_msgdesc_t* fields,
+            const T& initial)
+      : publisher_(session, device_id, state_key, fields),
+        fields_(fields),
+        mask_width_(field_mask_width(fields)),
+        state_(initial) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    z_mutex_init(&mutex_);
+#endif
+#if Z_FEATURE_QUERYABLE == 1
+    snprintf(snapshot_key_, sizeof(snapshot_key_), "%s%s%s", device_id,
+             state_key, ZENOH_STATE_SNAPSHOT_SUFFIX);
+    z_view_keyexpr_t ke;
+    if (z_view_keyexpr_from_str(&ke, snapshot_key_) != Z_OK) {
+      __print("StateSync: Failed to create keyexpr: %s\n", snapshot_key_);
+      return;
+    }
+    z_owned_closure_query_t callback;
+    z_closure_query(&callback, query_callback, nullptr, this);
+    z_queryable_options_t opts;
+    z_queryable_options_default(&opts);
+    z_result_t res =
+        z_declare_queryable(session, &queryable_, z_view_keyexpr_loan(&ke),
+                            z_closure_query_move(&callback), &opts);
+    if (res != Z_OK) {
+      __print("StateSync: z_declare_queryable failed: %d\n", res);
+      return;
+    }
+    queryable_valid_ = true;
+#endif
+  }
+
+  ~StateSync() {
+#if Z_FEATURE_QUERYABLE == 1
+    if (queryable_valid_) {
+      z_undeclare_queryable(z_queryable_move(&queryable_));
+    }
+#endif
+#if Z_FEATURE_MULTI_THREAD == 1
+    z_mutex_drop(z_mutex_move(&mutex_));
+#endif
+  }
+
+  // Non-copyable, non-movable (the queryable points to this object)
+  StateSync(const StateSync&) = delete;
+  StateSync& operator=(const StateSync&) = delete;
+
+  /**
+   * @brief Modify the state; publishes a delta if any field changed
+   *
+   * @param fn Called with a copy of the state to modify (void(T&))
+   * @return false if publishing the delta failed (clients resync from the
+   * version gap)
+   */
+  template <typename F>
+  bool update(F&& fn) {
+    lock();
+    T next = state_;
+    fn(next);
+    uint64_t changed = diff_fields(fields_, &state_, &next);
+    if (changed == 0) {
+      unlock();
+      return true;
+    }
+    state_ = next;
+    version_++;
+
+    AttachmentWriter attachment;
+    attachment.put_u32(AttachmentKey::STATE_VERSION, version_);
+    attachment.put_uint(AttachmentKey::FIELD_MASK, changed, mask_width_);
+    // Published under the lock so that deltas leave in version order
+    mask_fields(fields_, &next, changed);
+    bool ok = publisher_.publish(next, &attachment);
+    unlock();
+    return ok;
+  }
+
+  // Copy of the current state
+  T get() const {
+    lock();
+    T copy = state_;
+    unlock();
+    return copy;
+  }
+
+  uint32_t version() const {
+    lock();
+    uint32_t v = version_;
+    unlock();
+    return v;
+  }
+
+ private:
+  void lock() const {
+#if Z_FEATURE_MULTI_THREAD == 1
+    z_mutex_lock(z_mutex_loan_mut(&mutex_));
+#endif
+  }
+  void unlock() const {
+#if Z_FEATURE_MULTI_THREAD == 1
+    z_mutex_unlock(z_mutex_loan_mut(&mutex_));
+#endif
+  }
+
+#if Z_FEATURE_QUERYABLE == 1
+  // Snapshot query: reply with the full state and its version
+  static void query_callback(z_loaned_query_t* query, void* context) {
+    auto* self = static_cast<StateSync*>(context);
+    self->lock();
+    T state = self->state_;
+    uint32_t version = self->version_;
+    self->unlock();
+
+    uint8_t buf[MaxSize];
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, sizeof(buf));
+    if (!pb_encode(&stream, self->fields_, &state)) {
+      __print("StateSync: pb_encode failed\n");
+      return;
+    }
+    z_owned_bytes_t payload;
+    z_bytes_copy_from_buf(&payload, buf, stream.bytes_written);
+
+    z_query_reply_options_t opts;
+    z_query_reply_options_default(&opts);
+    AttachmentWriter attachment;
+    attachment.put_u32(AttachmentKey::STATE_VERSION, version);
+    z_owned_bytes_t attachment_bytes;
+    if (attachment.to_bytes(&attachment_bytes) == Z_OK) {
+      opts.attachment = z_bytes_move(&attachment_bytes);
+    }
+    z_result_t res = z_query_reply(query, z_query_keyexpr(query),
+                                   z_bytes_move(&payload), &opts);
+    if (res != Z_OK) {
+      __print("StateSync: z_query_reply failed: %d\n", res);
+    }
+  }
+#endif
+
+  TelemetryPublisher<T> publisher_;
+  const pb_msgdesc_t* fields_;
+  size_t mask_width_;
+  T state_;
+  uint32_t version_ = 0;
+#if Z_FEATURE_MULTI_THREAD == 1
+  mutable z_owned_mutex_t mutex_;
+#endif
+#if Z_FEATURE_QUERYABLE == 1
+  z_owned_queryable_t queryable_;
+  bool queryable_valid_ = false;
+  char snapshot_key_[kMaxTopicLen];
+#endif
+};
+
+}  // namespace zenoh_rpc
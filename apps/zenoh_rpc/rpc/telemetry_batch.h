@@ -0,0 +1,164 @@
+// Telemetry Batch - collects samples of a telemetry message into compressed
+// batches (see gorilla_codec.h) and publishes them as one message
+
+#pragma once
+
+#include <pb_common.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gorilla_codec.h"
+#include "zenoh_pubsub.h"
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#endif  // __ZEPHYR__
+
+// Topic of the batches of a telemetry message: <zenoh_key>/batch
+#define ZENOH_TELEMETRY_BATCH_SUFFIX "/batch"
+
+namespace zenoh_rpc {
+
+// Upper bound for the samples per batch
+constexpr size_t kMaxBatchSamples = 120;
+
+// Hardware cycle counter used for encoder statistics (0 off-target)
+inline uint32_t cycle_count() {
+#ifdef __ZEPHYR__
+  return k_cycle_get_32();
+#else
+  return 0;
+#endif  // __ZEPHYR__
+}
+
+/**
+ * @brief Batches the 32-bit fields (float, fixed32, sfixed32) of a telemetry
+ * message
+ *
+ * Batch must be a nanopb message with the TelemetryBatch layout: count,
+ * field_tags (repeated, fixed count) and data (fixed-size bytes). The encoder
+ * writes directly into the batch, so RAM use is one Batch.
+ *
+ * @tparam T Telemetry message struct
+ * @tparam Batch Batch message struct
+ */
+template <typename T, typename Batch>
+class TelemetryBatcher {
+ public:
+  TelemetryBatcher(TelemetryPublisher<Batch>* publisher,
+                   const pb_msgdesc_t* fields)
+      : publisher_(publisher),
+        batch_{},
+        column_count_(find_columns(fields)),
+        encoder_(batch_.data.bytes, sizeof(batch_.data.bytes), column_count_) {
+  }
+
+  // Non-copyable
+  TelemetryBatcher(const TelemetryBatcher&) = delete;
+  TelemetryBatcher& operator=(const TelemetryBatcher&) = delete;
+
+  // Samples per batch (0 or 1 disables batching)
+  void set_batch_size(size_t samples) {
+    batch_size_ = samples < kMaxBatchSamples ? samples : kMaxBatchSamples;
+  }
+  size_t batch_size() const { return batch_size_; }
+  bool enabled() const { return batch_size_ > 1; }
+
+  // Samples waiting in the current batch
+  size_t pending() const { return encoder_.count(); }
+
+  /**
+   * @brief Add a sample; publishes when the batch is full
+   *
+   * @return false if publishing a batch failed (the batch is dropped and
+   * shows up as a sequence gap on the host)
+   */
+  bool add(uint32_t timestamp_ms, const T& sample) {
+    uint32_t values[kMaxGorillaColumns];
+    const auto* base = reinterpret_cast<const uint8_t*>(&sample);
+    for (size_t c = 0; c < column_count_; ++c) {
+      memcpy(&values[c], base + offsets_[c], sizeof(uint32_t));
+    }
+
+    uint32_t start = cycle_count();
+    bool appended = encoder_.append(timestamp_ms, values);
+    uint32_t cycles = cycle_count() - start;
+    bool ok = true;
+    if (!appended) {
+      // Out of space before reaching batch_size: publish and start over
+      ok = flush();
+      start = cycle_count();
+      appended = encoder_.append(timestamp_ms, values);
+      cycles = cycle_count() - start;
+    }
+    if (appended) {
+      encode_cycles_ += cycles;
+      samples_++;
+    }
+    if (encoder_.count() >= batch_size_) {
+      ok = flush() && ok;
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Publish the pending samples (no-op if there are none)
+   */
+  bool flush() {
+    if (encoder_.count() == 0) {
+      return true;
+    }
+    batch_.count = encoder_.count();
+    batch_.data.size = encoder_.size();
+    encoded_bytes_ += batch_.data.size;
+    batches_++;
+    encoder_.reset();
+    return publisher_->publish(batch_);
+  }
+
+  // Statistics (since boot)
+  uint32_t samples() const { return samples_; }
+  uint32_t batches() const { return batches_; }
+  uint32_t encoded_bytes() const { return encoded_bytes_; }
+  uint64_t encode_cycles() const { return encode_cycles_; }
+  size_t columns() const { return column_count_; }
+
+ private:
+  // Record the offsets of the singular 32-bit fields, in field order
+  size_t find_columns(const pb_msgdesc_t* fields) {
+    T probe{};
+    pb_field_iter_t iter;
+    size_t n = 0;
+    if (!pb_field_iter_begin(&iter, fields, &probe)) {
+      return 0;
+    }
+    do {
+      if (PB_LTYPE(iter.type) == PB_LTYPE_FIXED32 &&
+          PB_HTYPE(iter.type) == PB_HTYPE_SINGULAR &&
+          n < kMaxGorillaColumns &&
+          n < sizeof(batch_.field_tags) / sizeof(batch_.field_tags[0])) {
+        offsets_[n] = static_cast<const uint8_t*>(iter.pData) -
+                      reinterpret_cast<const uint8_t*>(&probe);
+        batch_.field_tags[n] = iter.tag;
+        n++;
+      }
+    } while (pb_field_iter_next(&iter));
+    batch_.field_tags_count = n;
+    return n;
+  }
+
+  TelemetryPublisher<Batch>* publisher_;
+  Batch batch_;
+  size_t offsets_[kMaxGorillaColumns] = {};
+  size_t column_count_;
+  GorillaEncoder encoder_;
+  size_t batch_size_ = 0;
+  uint32_t samples_ = 0;
+  uint32_t batches_ = 0;
+  uint32_t encoded_bytes_ = 0;
+  uint64_t encode_cycles_ = 0;
+};
+
+}  // namespace zenoh_rpc
@@ -0,0 +1,244 @@
+// Timed Dispatch - Implementation
+
+#include "timed_dispatch.h"
+
+#include <cstring>
+
+#include "log_wrapper.h"
+#include "zenoh_attachment.h"
+
+#ifdef __ZEPHYR__
+LOG_MODULE_REGISTER(timed_dispatch, LOG_LEVEL_INF);
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+namespace {
+
+// Longest sleep of the worker while a call is queued [us]: a call queued
+// meanwhile with an earlier target is picked up within this
+uint64_t max_sleep_us(uint32_t lead_us) {
+  return lead_us > 200 ? lead_us / 2 : 100;
+}
+
+}  // namespace
+
+TimedDispatcher::TimedDispatcher(const TimedDispatchConfig& config)
+    : config_(config),
+      count_(0),
+      run_(0),
+      late_(0),
+      rejected_(0),
+      max_start_error_us_(0) {
+  memset(jobs_, 0, sizeof(jobs_));
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_init(&mutex_);
+  z_condvar_init(&cond_);
+  task_started_ = false;
+  stopping_ = false;
+#endif
+}
+
+TimedDispatcher::~TimedDispatcher() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  if (task_started_) {
+    lock();
+    stopping_ = true;
+    z_condvar_signal(z_condvar_loan_mut(&cond_));
+    unlock();
+    z_task_join(z_task_move(&task_));
+  }
+#endif
+  // Calls still queued get their final reply (timeout on the client)
+  for (size_t i = 0; i < count_; ++i) {
+    z_query_drop(z_query_move(&jobs_[i].query));
+  }
+  count_ = 0;
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_condvar_drop(z_condvar_move(&cond_));
+  z_mutex_drop(z_mutex_move(&mutex_));
+#endif
+}
+
+void TimedDispatcher::lock() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_lock(z_mutex_loan_mut(&mutex_));
+#endif
+}
+
+void TimedDispatcher::unlock() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_unlock(z_mutex_loan_mut(&mutex_));
+#endif
+}
+
+void TimedDispatcher::reject(const z_loaned_query_t* query,
+                             const char* reason) {
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_str(&payload, reason);
+  z_query_reply_err_options_t opts;
+  z_query_reply_err_options_default(&opts);
+  z_result_t res = z_query_reply_err(query, z_bytes_move(&payload), &opts);
+  if (res != Z_OK) {
+    LOG_ERR("z_query_reply_err failed: %d", res);
+  }
+}
+
+bool TimedDispatcher::submit(const z_loaned_query_t* query,
+                             uint64_t execute_at_us, uint64_t deadline_us,
+                             Dispatch dispatch, void* context) {
+  uint64_t now = monotonic_us();
+  const char* reason = nullptr;
+  lock();
+  if (execute_at_us + config_.max_late_us < now) {
+    late_++;
+    reason = "late";
+  } else if (execute_at_us > now + uint64_t{config_.horizon_ms} * 1000 ||
+             execute_at_us >= deadline_us) {
+    rejected_++;
+    reason = "too far";
+  } else if (count_ == kMaxTimedCalls) {
+    rejected_++;
+    reason = "busy";
+  } else {
+    // Insert after the calls due at the same time or earlier
+    size_t pos = count_;
+    while (pos > 0 && jobs_[pos - 1].execute_at_us > execute_at_us) {
+      --pos;
+    }
+    Job job;
+    // The clone keeps the query open after the callback returns
+    if (z_query_clone(&job.query, query) != Z_OK) {
+      rejected_++;
+      reason = "out of memory";
+    } else {
+      job.dispatch = dispatch;
+      job.context = context;
+      job.execute_at_us = execute_at_us;
+      job.queued_us = now;
+      memmove(&jobs_[pos + 1], &jobs_[pos], (count_ - pos) * sizeof(Job));
+      jobs_[pos] = job;
+      count_++;
+    }
+  }
+#if Z_FEATURE_MULTI_THREAD == 1
+  if (reason == nullptr) {
+    z_condvar_signal(z_condvar_loan_mut(&cond_));
+  }
+#endif
+  unlock();
+
+  if (reason != nullptr) {
+    reject(query, reason);
+    return false;
+  }
+  return true;
+}
+
+uint64_t TimedDispatcher::run() {
+  lock();
+  while (count_ > 0) {
+    uint64_t now = monotonic_us();
+    uint64_t due = jobs_[0].execute_at_us > config_.lead_us
+                       ? jobs_[0].execute_at_us - config_.lead_us
+                       : 0;
+    if (now < due) {
+      unlock();
+      return due - now;
+    }
+    Job job = jobs_[0];
+    count_--;
+    memmove(&jobs_[0], &jobs_[1], count_ * sizeof(Job));
+    bool late = now > job.execute_at_us + config_.max_late_us;
+    if (late) {
+      late_++;
+    } else {
+      run_++;
+    }
+    unlock();
+
+    if (late) {
+      // A call ahead of it ran long, or the loop was busy
+      reject(z_query_loan(&job.query), "late");
+    } else {
+      // The handler waits for execute_at_us after decoding the request
+      job.dispatch(job.context, z_query_loan(&job.query), job.queued_us);
+    }
+    // Dropping the last reference sends the final reply
+    z_query_drop(z_query_move(&job.query));
+    lock();
+  }
+  unlock();
+  return UINT64_MAX;
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+bool TimedDispatcher::start() {
+  if (task_started_) {
+    return true;
+  }
+  z_result_t res = z_task_init(&task_, NULL, worker, this);
+  if (res != Z_OK) {
+    LOG_ERR("Failed to start timed dispatch task: %d", res);
+    return false;
+  }
+  task_started_ = true;
+  return true;
+}
+
+void* TimedDispatcher::worker(void* arg) {
+  auto* self = static_cast<TimedDispatcher*>(arg);
+  uint64_t max_sleep = max_sleep_us(self->config_.lead_us);
+  while (true) {
+    self->lock();
+    while (self->count_ == 0 && !self->stopping_) {
+      z_condvar_wait(z_condvar_loan_mut(&self->cond_),
+                     z_mutex_loan_mut(&self->mutex_));
+    }
+    bool stopping = self->stopping_;
+    self->unlock();
+    if (stopping) {
+      return NULL;
+    }
+    uint64_t wait_us = self->run();
+    if (wait_us != UINT64_MAX) {
+      // No timed wait on the condition variable: sleep in slices short
+      // enough for a call with an earlier target to be dispatched in time
+      z_sleep_us(static_cast<size_t>(wait_us < max_sleep ? wait_us
+                                                         : max_sleep));
+    }
+  }
+}
+#endif
+
+void TimedDispatcher::account_start(uint64_t execute_at_us,
+                                    uint64_t started_us) {
+  uint64_t error = started_us > execute_at_us ? started_us - execute_at_us
+                                              : execute_at_us - started_us;
+  lock();
+  if (error > max_start_error_us_) {
+    max_start_error_us_ =
+        static_cast<uint32_t>(error < UINT32_MAX ? error : UINT32_MAX);
+  }
+  unlock();
+}
+
+void TimedDispatcher::log_stats() {
+  lock();
+  uint32_t run = run_;
+  uint32_t late = late_;
+  uint32_t rejected = rejected_;
+  uint32_t max_error = max_start_error_us_;
+  run_ = 0;
+  late_ = 0;
+  rejected_ = 0;
+  max_start_error_us_ = 0;
+  unlock();
+  if (run != 0 || late != 0 || rejected != 0) {
+    LOG_INF("Timed calls: %u run (max start error %u us), %u late, "
+            "%u rejected",
+            run, max_error, late, rejected);
+  }
+}
+
+}  // namespace zenoh_rpc
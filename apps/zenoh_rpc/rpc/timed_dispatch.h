@@ -0,0 +1,120 @@
+// Timed Dispatch - RPC calls run at a requested device time
+//
+// A query with an EXECUTE_AT_US attachment is not run on arrival: the
+// query callback queues it here, ordered by target time, and it is
+// dispatched lead_us before the target. The generated handler decodes the
+// request and waits in RpcContext::wait_until_start(), so only the
+// implementation runs at the target time and link or queueing jitter up to
+// the lead does not become actuation jitter. The reply carries the actual
+// start (EXECUTE_AT_US). Hosts translate their clock into the device's
+// with <device>/rpc/clock (ZenohRpcChannel::serve_clock(),
+// tools/rpc/device_clock.py).
+//
+// Admission: at most kMaxTimedCalls queued. A target past horizon_ms or
+// past the client's timeout is rejected ("too far"); one more than
+// max_late_us behind is rejected on arrival and when it is due ("late").
+// Calls are dispatched one at a time: two calls for the same time start
+// one after the other.
+//
+// Z_FEATURE_MULTI_THREAD == 1: start() runs the queue on a worker task.
+// Z_FEATURE_MULTI_THREAD == 0: call run() after each session read
+//   (ZenohEventLoop::add_poll()); the zp_read() timeout then bounds how late
+//   a call is picked up.
+
+#pragma once
+
+#include <zenoh-pico.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rpc_scheduler.h"
+
+namespace zenoh_rpc {
+
+// Queued timed calls
+constexpr size_t kMaxTimedCalls = 8;
+
+struct TimedDispatchConfig {
+  // Calls are dispatched this long before their target time [us]
+  uint32_t lead_us = 2000;
+  // Calls this late are not run ("late" error reply) [us]
+  uint32_t max_late_us = 1000;
+  // Targets further ahead are rejected [ms]
+  uint32_t horizon_ms = 60000;
+};
+
+class TimedDispatcher {
+ public:
+  using Dispatch = RpcScheduler::Dispatch;
+
+  explicit TimedDispatcher(
+      const TimedDispatchConfig& config = TimedDispatchConfig());
+  ~TimedDispatcher();
+
+  // Non-copyable
+  TimedDispatcher(const TimedDispatcher&) = delete;
+  TimedDispatcher& operator=(const TimedDispatcher&) = delete;
+
+  /**
+   * @brief Queue a query to run at execute_at_us (from the query callback)
+   *
+   * @param deadline_us The client's deadline (kNoDeadline: none)
+   * @return false if the query was rejected (an error reply was sent)
+   */
+  bool submit(const z_loaned_query_t* query, uint64_t execute_at_us,
+              uint64_t deadline_us, Dispatch dispatch, void* context);
+
+  /**
+   * @brief Dispatch the calls that are due
+   *
+   * @return Time until the next call is due [us] (UINT64_MAX: none queued)
+   */
+  uint64_t run();
+
+#if Z_FEATURE_MULTI_THREAD == 1
+  // Dispatch from a worker task
+  bool start();
+#endif
+
+  // Start error of a timed call (ZenohRpcChannel, after its handler)
+  void account_start(uint64_t execute_at_us, uint64_t started_us);
+
+  // Log the counters since the last call
+  void log_stats();
+
+ private:
+  struct Job {
+    z_owned_query_t query;
+    Dispatch dispatch;
+    void* context;
+    uint64_t execute_at_us;
+    uint64_t queued_us;
+  };
+
+  void reject(const z_loaned_query_t* query, const char* reason);
+  void lock();
+  void unlock();
+#if Z_FEATURE_MULTI_THREAD == 1
+  static void* worker(void* arg);
+#endif
+
+  TimedDispatchConfig config_;
+  // Sorted by execute_at_us
+  Job jobs_[kMaxTimedCalls];
+  size_t count_;
+  // Counters since the last log_stats()
+  uint32_t run_;
+  uint32_t late_;
+  uint32_t rejected_;
+  uint32_t max_start_error_us_;
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_owned_mutex_t mutex_;
+  z_owned_condvar_t cond_;
+  z_owned_task_t task_;
+  bool task_started_;
+  volatile bool stopping_;
+#endif
+};
+
+}  // namespace zenoh_rpc
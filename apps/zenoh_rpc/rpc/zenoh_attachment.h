@@ -0,0 +1,155 @@
+// Zenoh Attachment - compact key/value metadata sent alongside payloads
+// Wire format: repeated [key:u8][len:u8][value:len bytes, little endian]
+// Keep in sync with tools/rpc/zenoh_attachment.py
+
+#pragma once
+
+#include <zenoh-pico.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#else
+#include <chrono>
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+// Attachment entry keys
+enum class AttachmentKey : uint8_t {
+  SEQUENCE = 1,             // u32: per-publisher sample sequence number
+  SOURCE_TIMESTAMP_US = 2,  // u64: publisher monotonic clock [us]
+  FIELD_MASK = 3,           // 1..8 bytes: response fields requested by a
+                            // query, or fields changed by a state delta
+  STATE_VERSION = 4,        // u32: version of a synchronized state
+  CLIENT_ID = 5,            // 1..16 bytes: opaque id of the calling client
+  TIMEOUT_MS = 6,           // u32: client timeout of a query [ms]
+  CREDITS = 7,              // u32: messages the peer may send on a stream
+  EXECUTE_AT_US = 8,        // u64: device monotonic time to run the handler
+                            // at (0: on arrival); reply: time it started
+};
+
+// Buffer sizes
+constexpr size_t kMaxAttachmentSize = 64;
+
+// Monotonic clock used for source timestamps [us]
+inline uint64_t monotonic_us() {
+#ifdef __ZEPHYR__
+  return k_ticks_to_us_floor64(k_uptime_ticks());
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif  // __ZEPHYR__
+}
+
+// Builds an attachment in a fixed-size buffer (no heap until to_bytes())
+class AttachmentWriter {
+ public:
+  bool put_u32(AttachmentKey key, uint32_t value) {
+    return put_uint(key, value, sizeof(value));
+  }
+  bool put_u64(AttachmentKey key, uint64_t value) {
+    return put_uint(key, value, sizeof(value));
+  }
+  // Low width (1..8) bytes of value, little endian
+  bool put_uint(AttachmentKey key, uint64_t value, size_t width) {
+    uint8_t le[sizeof(uint64_t)];
+    for (size_t i = 0; i < width; ++i) {
+      le[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return put_bytes(key, le, width);
+  }
+  bool put_bytes(AttachmentKey key, const uint8_t* data, size_t len) {
+    if (len > UINT8_MAX || len_ + 2 + len > sizeof(buf_)) {
+      return false;
+    }
+    buf_[len_++] = static_cast<uint8_t>(key);
+    buf_[len_++] = static_cast<uint8_t>(len);
+    memcpy(&buf_[len_], data, len);
+    len_ += len;
+    return true;
+  }
+
+  const uint8_t* data() const { return buf_; }
+  size_t size() const { return len_; }
+
+  // Copy into Zenoh bytes, e.g. for z_publisher_put_options_t::attachment
+  z_result_t to_bytes(z_owned_bytes_t* bytes) const {
+    return z_bytes_copy_from_buf(bytes, buf_, len_);
+  }
+
+ private:
+  uint8_t buf_[kMaxAttachmentSize];
+  size_t len_ = 0;
+};
+
+// Parses an attachment received with a query or sample
+class AttachmentReader {
+ public:
+  // attachment may be NULL (no attachment sent)
+  explicit AttachmentReader(const z_loaned_bytes_t* attachment) {
+    if (attachment == NULL) {
+      return;
+    }
+    size_t len = z_bytes_len(attachment);
+    if (len > sizeof(buf_)) {
+      return;
+    }
+    z_bytes_reader_t reader = z_bytes_get_reader(attachment);
+    len_ = z_bytes_reader_read(&reader, buf_, len);
+  }
+
+  // Returns a pointer to the value of key (and its length), or NULL
+  const uint8_t* find(AttachmentKey key, size_t* len) const {
+    size_t pos = 0;
+    while (pos + 2 <= len_) {
+      uint8_t entry_key = buf_[pos];
+      uint8_t entry_len = buf_[pos + 1];
+      if (pos + 2 + entry_len > len_) {
+        return NULL;
+      }
+      if (entry_key == static_cast<uint8_t>(key)) {
+        *len = entry_len;
+        return &buf_[pos + 2];
+      }
+      pos += 2 + entry_len;
+    }
+    return NULL;
+  }
+
+  bool get_u32(AttachmentKey key, uint32_t* value) const {
+    uint64_t v;
+    if (!get_uint(key, &v, sizeof(*value))) {
+      return false;
+    }
+    *value = static_cast<uint32_t>(v);
+    return true;
+  }
+  bool get_u64(AttachmentKey key, uint64_t* value) const {
+    return get_uint(key, value, sizeof(*value));
+  }
+
+ private:
+  bool get_uint(AttachmentKey key, uint64_t* value, size_t width) const {
+    size_t len = 0;
+    const uint8_t* p = find(key, &len);
+    if (p == NULL || len != width) {
+      return false;
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < width; ++i) {
+      v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    *value = v;
+    return true;
+  }
+
+  uint8_t buf_[kMaxAttachmentSize];
+  size_t len_ = 0;
+};
+
+}  // namespace zenoh_rpc
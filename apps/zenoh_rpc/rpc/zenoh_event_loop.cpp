@@ -0,0 +1,172 @@
+// Zenoh Event Loop - Implementation
+
+#include "zenoh_event_loop.h"
+
+#include <utility>
+
+#include "log_wrapper.h"
+
+#ifdef __ZEPHYR__
+LOG_MODULE_REGISTER(zenoh_event_loop, LOG_LEVEL_INF);
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+namespace {
+
+// Longest sleep between session health checks (multi-thread mode) [ms]
+constexpr uint32_t kMaxIdleMs = 1000;
+
+#if Z_FEATURE_MULTI_THREAD == 0
+// Same cadence as zenoh-pico's lease task
+constexpr uint32_t kKeepAliveIntervalMs =
+    Z_TRANSPORT_LEASE / Z_TRANSPORT_LEASE_EXPIRE_FACTOR;
+constexpr uint32_t kJoinIntervalMs = 2500;
+#endif
+
+// Wrap-safe "a is at or after b"
+bool time_reached(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) >= 0;
+}
+
+}  // namespace
+
+ZenohEventLoop::ZenohEventLoop(z_loaned_session_t* session)
+    : session_(session), epoch_(z_clock_now()), task_count_(0),
+      poll_count_(0), running_(false) {
+#if Z_FEATURE_MULTI_THREAD == 0
+  next_keep_alive_ms_ = 0;
+  next_join_ms_ = 0;
+  last_rx_ms_ = 0;
+#endif
+}
+
+uint32_t ZenohEventLoop::now_ms() {
+  return static_cast<uint32_t>(z_clock_elapsed_ms(&epoch_));
+}
+
+bool ZenohEventLoop::add_periodic(uint32_t period_ms, Task task) {
+  if (task_count_ >= kMaxLoopTasks) {
+    LOG_ERR("Too many loop tasks (max %zu)", kMaxLoopTasks);
+    return false;
+  }
+  tasks_[task_count_].task = std::move(task);
+  tasks_[task_count_].period_ms = period_ms;
+  tasks_[task_count_].next_ms = now_ms() + period_ms;
+  task_count_++;
+  return true;
+}
+
+bool ZenohEventLoop::add_poll(Task task) {
+  if (poll_count_ >= kMaxLoopPolls) {
+    LOG_ERR("Too many loop polls (max %zu)", kMaxLoopPolls);
+    return false;
+  }
+  polls_[poll_count_++] = std::move(task);
+  return true;
+}
+
+bool ZenohEventLoop::start() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  LOG_INF("Starting Zenoh read and lease tasks...");
+  z_result_t read_res = zp_start_read_task(session_, NULL);
+  z_result_t lease_res = zp_start_lease_task(session_, NULL);
+  LOG_INF("Read task result: %d, Lease task result: %d", read_res, lease_res);
+  if (read_res != Z_OK || lease_res != Z_OK) {
+    LOG_ERR("Failed to start Zenoh tasks");
+    return false;
+  }
+#else
+  LOG_INF("Single-threaded Zenoh event loop");
+  last_rx_ms_ = now_ms();
+#endif
+  running_ = true;
+  return true;
+}
+
+uint32_t ZenohEventLoop::run_due_tasks() {
+  uint32_t now = now_ms();
+  uint32_t wait_ms = kMaxIdleMs;
+  for (size_t i = 0; i < task_count_; ++i) {
+    PeriodicTask& t = tasks_[i];
+    if (time_reached(now, t.next_ms)) {
+      t.task();
+      t.next_ms += t.period_ms;
+      // Skip missed periods instead of running the task back to back
+      now = now_ms();
+      if (time_reached(now, t.next_ms)) {
+        t.next_ms = now + t.period_ms;
+      }
+    }
+    uint32_t until = t.next_ms - now;
+    if (until < wait_ms) {
+      wait_ms = until;
+    }
+  }
+  return wait_ms;
+}
+
+bool ZenohEventLoop::service_session() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  if (zp_lease_task_is_running(session_) == false ||
+      zp_read_task_is_running(session_) == false) {
+    LOG_WRN("Keep-alive failed");
+    return false;
+  }
+  return true;
+#else
+  // Blocks until data arrives or Z_CONFIG_SOCKET_TIMEOUT expires; query
+  // callbacks (RPC handlers) run from here
+  if (zp_read(session_, NULL) == Z_OK) {
+    last_rx_ms_ = now_ms();
+  }
+
+  uint32_t now = now_ms();
+  if (time_reached(now, next_keep_alive_ms_)) {
+    if (zp_send_keep_alive(session_, NULL) != Z_OK) {
+      LOG_WRN("Keep-alive failed");
+      return false;
+    }
+    next_keep_alive_ms_ = now + kKeepAliveIntervalMs;
+  }
+  if (time_reached(now, next_join_ms_)) {
+    zp_send_join(session_, NULL);
+    next_join_ms_ = now + kJoinIntervalMs;
+  }
+  // The router keeps the lease alive as well; silence means it is gone
+  if (now - last_rx_ms_ > Z_TRANSPORT_LEASE) {
+    LOG_WRN("Lease expired (no data for %u ms)", now - last_rx_ms_);
+    return false;
+  }
+  return true;
+#endif
+}
+
+bool ZenohEventLoop::run_once() {
+  if (!service_session()) {
+    return false;
+  }
+  for (size_t i = 0; i < poll_count_; ++i) {
+    polls_[i]();
+  }
+  uint32_t wait_ms = run_due_tasks();
+#if Z_FEATURE_MULTI_THREAD == 1
+  if (wait_ms > 0) {
+    z_sleep_ms(wait_ms);
+  }
+#else
+  // zp_read() already waits for the socket
+  (void)wait_ms;
+#endif
+  return true;
+}
+
+void ZenohEventLoop::run() {
+  while (running_) {
+    if (!run_once()) {
+      running_ = false;
+    }
+  }
+}
+
+}  // namespace zenoh_rpc
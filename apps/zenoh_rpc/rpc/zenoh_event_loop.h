@@ -0,0 +1,95 @@
+// Zenoh Event Loop - drives a zenoh-pico session and periodic application
+// work from the calling thread.
+//
+// Z_FEATURE_MULTI_THREAD == 1: zenoh-pico read/lease tasks run in their own
+//   threads; the loop only sleeps until the next periodic task is due.
+// Z_FEATURE_MULTI_THREAD == 0: the loop itself calls zp_read(),
+//   zp_send_keep_alive() and zp_send_join(). Query callbacks run inside
+//   zp_read() and poll tasks (queued RPC work) right after it, so everything
+//   runs on one thread without locks.
+//   zp_read() returns as soon as data arrives or after Z_CONFIG_SOCKET_TIMEOUT,
+//   which bounds the timing resolution of the periodic tasks.
+
+#pragma once
+
+#include <zenoh-pico.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace zenoh_rpc {
+
+// Maximum number of periodic tasks (CONFIG_APP_LOOP_TASKS)
+#ifdef ZENOH_RPC_LOOP_TASKS
+constexpr size_t kMaxLoopTasks = ZENOH_RPC_LOOP_TASKS;
+#else
+constexpr size_t kMaxLoopTasks = 16;
+#endif
+// Maximum number of poll tasks (CONFIG_APP_LOOP_POLLS)
+#ifdef ZENOH_RPC_LOOP_POLLS
+constexpr size_t kMaxLoopPolls = ZENOH_RPC_LOOP_POLLS;
+#else
+constexpr size_t kMaxLoopPolls = 4;
+#endif
+
+class ZenohEventLoop {
+ public:
+  using Task = std::function<void()>;
+
+  explicit ZenohEventLoop(z_loaned_session_t* session);
+
+  // Non-copyable
+  ZenohEventLoop(const ZenohEventLoop&) = delete;
+  ZenohEventLoop& operator=(const ZenohEventLoop&) = delete;
+
+  // Run task every period_ms from the loop thread; false if the table is
+  // full (kMaxLoopTasks)
+  bool add_periodic(uint32_t period_ms, Task task);
+
+  // Run task on every iteration, right after the session was serviced
+  // (single-thread mode: after each zp_read(), e.g. queued RPC work);
+  // false if the table is full (kMaxLoopPolls)
+  bool add_poll(Task task);
+
+  // Start the session background work (read/lease tasks in multi-thread mode)
+  bool start();
+
+  // One iteration: service the session and run due tasks.
+  // Returns false when the session is considered lost.
+  bool run_once();
+
+  // Run until stop() is called or the session is lost
+  void run();
+  void stop() { running_ = false; }
+
+  // Milliseconds since the loop was created
+  uint32_t now_ms();
+
+ private:
+  struct PeriodicTask {
+    Task task;
+    uint32_t period_ms;
+    uint32_t next_ms;
+  };
+
+  z_loaned_session_t* session_;
+  z_clock_t epoch_;
+  PeriodicTask tasks_[kMaxLoopTasks];
+  size_t task_count_;
+  Task polls_[kMaxLoopPolls];
+  size_t poll_count_;
+  volatile bool running_;
+
+#if Z_FEATURE_MULTI_THREAD == 0
+  uint32_t next_keep_alive_ms_;
+  uint32_t next_join_ms_;
+  uint32_t last_rx_ms_;
+#endif
+
+  // Run due tasks; returns time until the next one [ms]
+  uint32_t run_due_tasks();
+  bool service_session();
+};
+
+}  // namespace zenoh_rpc
@@ -13,12 +13,116 @@ LOG_MODULE_REGISTER(zenoh_pubsub, LOG_LEVEL_INF);
 
 namespace zenoh_rpc {
 
+// ============================================================================
+// ZenohPublisher
+// ============================================================================
+
+z_result_t ZenohPublisher::declare(z_loaned_session_t* session,
+                                   const z_loaned_keyexpr_t* ke,
+                                   const z_publisher_options_t* opts,
+                                   const PublicationCache& cache) {
+  undeclare();
+  if (cache.max_samples > 0) {
+#if Z_FEATURE_ADVANCED_PUBLICATION == 1
+    ze_advanced_publisher_options_t adv_opts;
+    ze_advanced_publisher_options_default(&adv_opts);
+    adv_opts.publisher_options = *opts;
+    ze_advanced_publisher_cache_options_default(&adv_opts.cache);
+    adv_opts.cache.is_enabled = true;
+    adv_opts.cache.max_samples = cache.max_samples;
+    // Sequence numbers let subscribers detect gaps and query the cache
+    ze_advanced_publisher_sample_miss_detection_options_default(
+        &adv_opts.sample_miss_detection);
+    adv_opts.sample_miss_detection.is_enabled = true;
+    // Liveliness token: late-joining subscribers find the cache
+    adv_opts.publisher_detection = true;
+    z_result_t res =
+        ze_declare_advanced_publisher(session, &advanced_, ke, &adv_opts);
+    if (res == Z_OK) {
+      valid_ = true;
+      cached_ = true;
+    }
+    return res;
+#else
+    LOG_WRN("ZenohPublisher: publication cache needs "
+            "Z_FEATURE_ADVANCED_PUBLICATION, not cached");
+#endif
+  }
+  z_result_t res = z_declare_publisher(session, &publisher_, ke, opts);
+  valid_ = res == Z_OK;
+  return res;
+}
+
+void ZenohPublisher::undeclare() {
+  if (!valid_) {
+    return;
+  }
+#if Z_FEATURE_ADVANCED_PUBLICATION == 1
+  if (cached_) {
+    ze_undeclare_advanced_publisher(ze_advanced_publisher_move(&advanced_));
+  } else
+#endif
+  {
+    z_undeclare_publisher(z_publisher_move(&publisher_));
+  }
+  valid_ = false;
+  cached_ = false;
+}
+
+z_result_t ZenohPublisher::put(z_moved_bytes_t* payload,
+                               z_publisher_put_options_t* opts) {
+  if (!valid_) {
+    z_bytes_drop(payload);
+    return _Z_ERR_GENERIC;
+  }
+#if Z_FEATURE_ADVANCED_PUBLICATION == 1
+  if (cached_) {
+    ze_advanced_publisher_put_options_t adv_opts;
+    ze_advanced_publisher_put_options_default(&adv_opts);
+    if (opts != nullptr) {
+      adv_opts.put_options = *opts;
+    }
+    return ze_advanced_publisher_put(ze_advanced_publisher_loan(&advanced_),
+                                     payload, &adv_opts);
+  }
+#endif
+  return z_publisher_put(z_publisher_loan(&publisher_), payload, opts);
+}
+
 // ============================================================================
 // LogPublisher
 // ============================================================================
 
-LogPublisher::LogPublisher(z_loaned_session_t* session, const char* device_id)
-    : valid_(false) {
+namespace {
+
+// FNV-1a, used to detect repeated messages
+uint32_t hash_string(const char* s, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; ++i) {
+    h = (h ^ static_cast<uint8_t>(s[i])) * 16777619u;
+  }
+  return h;
+}
+
+bool module_matches(const char* pattern, const char* name) {
+  return pattern == nullptr || pattern[0] == '\0' ||
+         strcmp(pattern, "*") == 0 || strcmp(pattern, name) == 0;
+}
+
+}  // namespace
+
+LogPublisher::LogPublisher(z_loaned_session_t* session, const char* device_id,
+                           const PublicationCache& cache)
+    : valid_(false),
+      module_count_(0),
+      filtered_(0),
+      deduplicated_(0),
+      rate_limited_(0) {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_init(&mutex_);
+#endif
+  register_module("app");
+
   char key_expr[kMaxTopicLen];
   snprintf(key_expr, sizeof(key_expr), "%s/log", device_id);
 
@@ -32,19 +136,33 @@ LogPublisher::LogPublisher(z_loaned_session_t* session, const char* device_id)
   z_publisher_options_default(&opts);
   opts.congestion_control = Z_CONGESTION_CONTROL_BLOCK;
   LOG_INF("LogPublisher: Declaring publisher for: %s", key_expr);
-  z_result_t res = z_declare_publisher(session, &publisher_, z_loan(ke), &opts);
+  z_result_t res = publisher_.declare(session, z_loan(ke), &opts, cache);
   if (res != Z_OK) {
-    LOG_ERR("LogPublisher: z_declare_publisher failed: %d", res);
+    LOG_ERR("LogPublisher: declare failed: %d", res);
     return;
   }
   valid_ = true;
-  LOG_INF("LogPublisher: Publisher created successfully");
+  LOG_INF("LogPublisher: Publisher created successfully%s",
+          publisher_.is_cached() ? " (cached)" : "");
 }
 
 LogPublisher::~LogPublisher() {
-  if (valid_) {
-    z_undeclare_publisher(z_publisher_move(&publisher_));
-  }
+  publisher_.undeclare();
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_drop(z_mutex_move(&mutex_));
+#endif
+}
+
+void LogPublisher::lock() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_lock(z_mutex_loan_mut(&mutex_));
+#endif
+}
+
+void LogPublisher::unlock() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_unlock(z_mutex_loan_mut(&mutex_));
+#endif
 }
 
 const char* LogPublisher::level_string(LogLevel level) {
@@ -57,60 +175,231 @@ const char* LogPublisher::level_string(LogLevel level) {
       return "WARN";
     case LogLevel::ERROR:
       return "ERROR";
+    case LogLevel::OFF:
+      return "OFF";
     default:
       return "UNKNOWN";
   }
 }
 
-void LogPublisher::log_impl(LogLevel level, const char* format, va_list args) {
+LogModuleId LogPublisher::register_module(const char* name) {
+  lock();
+  for (size_t i = 0; i < module_count_; ++i) {
+    if (strcmp(modules_[i].name, name) == 0) {
+      unlock();
+      return static_cast<LogModuleId>(i);
+    }
+  }
+  if (module_count_ >= kMaxLogModules) {
+    unlock();
+    LOG_WRN("LogPublisher: module table full, %s logs as app", name);
+    return kDefaultLogModule;
+  }
+  Module& m = modules_[module_count_];
+  memset(&m, 0, sizeof(m));
+  snprintf(m.name, sizeof(m.name), "%s", name);
+  m.level = kDefaultLogLevel;
+  m.rate_per_s = kDefaultLogRatePerSec;
+  m.burst = kDefaultLogBurst;
+  m.tokens_milli = kDefaultLogBurst * 1000;
+  m.refill_us = monotonic_us();
+  LogModuleId id = static_cast<LogModuleId>(module_count_++);
+  unlock();
+  return id;
+}
+
+size_t LogPublisher::configure(const char* module, LogLevel level,
+                               uint32_t rate_per_s, uint32_t burst) {
+  size_t changed = 0;
+  lock();
+  for (size_t i = 0; i < module_count_; ++i) {
+    Module& m = modules_[i];
+    if (!module_matches(module, m.name)) {
+      continue;
+    }
+    m.level = level;
+    m.rate_per_s = rate_per_s;
+    m.burst = burst > 0 ? burst : rate_per_s;
+    m.tokens_milli = m.burst * 1000;
+    m.refill_us = monotonic_us();
+    changed++;
+  }
+  unlock();
+  return changed;
+}
+
+bool LogPublisher::take_token(Module& m, uint64_t now_us) {
+  if (m.rate_per_s == 0) {
+    return true;
+  }
+  uint64_t refill =
+      (now_us - m.refill_us) * m.rate_per_s / 1000 + m.tokens_milli;
+  uint64_t cap = static_cast<uint64_t>(m.burst) * 1000;
+  m.tokens_milli = static_cast<uint32_t>(refill < cap ? refill : cap);
+  m.refill_us = now_us;
+  if (m.tokens_milli < 1000) {
+    return false;
+  }
+  m.tokens_milli -= 1000;
+  return true;
+}
+
+size_t LogPublisher::take_summaries(Module& m, char* buf, size_t buf_size) {
+  // Same prefix as log_impl(): the default module is not named
+  bool named = &m != &modules_[kDefaultLogModule];
+  const char* name = named ? m.name : "";
+  const char* sep = named ? ": " : "";
+  int len = 0;
+  if (m.repeats > 0 && m.dropped > 0) {
+    len = snprintf(buf, buf_size,
+                   "[WARN] %s%slast message repeated %u times, %u messages "
+                   "dropped (rate limit)",
+                   name, sep, m.repeats, m.dropped);
+  } else if (m.repeats > 0) {
+    len = snprintf(buf, buf_size, "[%s] %s%slast message repeated %u times",
+                   level_string(m.last_level), name, sep, m.repeats);
+  } else if (m.dropped > 0) {
+    len = snprintf(buf, buf_size,
+                   "[WARN] %s%s%u messages dropped (rate limit)", name, sep,
+                   m.dropped);
+  }
+  m.repeats = 0;
+  m.dropped = 0;
+  // The next occurrence of the repeated message starts a new count
+  m.has_last = false;
+  if (len < 0) {
+    return 0;
+  }
+  return static_cast<size_t>(len) < buf_size ? len : buf_size - 1;
+}
+
+void LogPublisher::publish(const char* text, size_t len) {
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_buf(&payload, reinterpret_cast<const uint8_t*>(text), len);
+  publisher_.put(z_bytes_move(&payload), NULL);
+}
+
+void LogPublisher::log_impl(LogModuleId module, LogLevel level,
+                            const char* format, va_list args) {
+  // Not guarded: each line is copied to an allocated payload (alloc_guard.h)
+  AllocScope alloc_scope(AllocPath::NONE);
   if (!valid_) {
     return;
   }
+  // Level filter before any formatting
+  if (!is_enabled(module, level)) {
+    filtered_++;
+    return;
+  }
+
   char buffer_[kMaxLogMessageLen];
   int prefix_len =
-      snprintf(buffer_, sizeof(buffer_), "[%s] ", level_string(level));
+      module == kDefaultLogModule
+          ? snprintf(buffer_, sizeof(buffer_), "[%s] ", level_string(level))
+          : snprintf(buffer_, sizeof(buffer_), "[%s] %s: ", level_string(level),
+                     modules_[module].name);
   if (prefix_len < 0) {
     return;
   }
   vsnprintf(buffer_ + prefix_len, sizeof(buffer_) - prefix_len, format, args);
-  z_owned_bytes_t payload;
-  z_bytes_copy_from_buf(&payload, reinterpret_cast<const uint8_t*>(buffer_),
-                        strlen(buffer_));
-  z_publisher_put(z_publisher_loan(&publisher_), z_bytes_move(&payload), NULL);
+  size_t len = strlen(buffer_);
+  uint32_t hash = hash_string(buffer_, len);
+  uint64_t now = monotonic_us();
+
+  char summary[kMaxLogMessageLen];
+  size_t summary_len = 0;
+  bool publish_message = false;
+
+  lock();
+  Module& m = modules_[module];
+  if (m.has_last && m.last_hash == hash) {
+    if (m.repeats++ == 0) {
+      m.first_repeat_us = now;
+    }
+    deduplicated_++;
+  } else if (take_token(m, now)) {
+    summary_len = take_summaries(m, summary, sizeof(summary));
+    m.has_last = true;
+    m.last_hash = hash;
+    m.last_level = level;
+    publish_message = true;
+  } else {
+    m.dropped++;
+    rate_limited_++;
+  }
+  unlock();
+
+  // Publish outside the lock (congestion control may block)
+  if (summary_len > 0) {
+    publish(summary, summary_len);
+  }
+  if (publish_message) {
+    publish(buffer_, len);
+  }
+}
+
+void LogPublisher::flush_repeats() {
+  if (!valid_) {
+    return;
+  }
+  uint64_t now = monotonic_us();
+  for (size_t i = 0; i < module_count_; ++i) {
+    char summary[kMaxLogMessageLen];
+    size_t summary_len = 0;
+    lock();
+    Module& m = modules_[i];
+    bool repeats_due =
+        m.repeats > 0 && now - m.first_repeat_us >= kLogRepeatFlushMs * 1000ull;
+    if (repeats_due || (m.dropped > 0 && take_token(m, now))) {
+      summary_len = take_summaries(m, summary, sizeof(summary));
+    }
+    unlock();
+    if (summary_len > 0) {
+      publish(summary, summary_len);
+    }
+  }
 }
 
 void LogPublisher::log(LogLevel level, const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_impl(level, format, args);
+  log_impl(kDefaultLogModule, level, format, args);
+  va_end(args);
+}
+
+void LogPublisher::log(LogModuleId module, LogLevel level, const char* format,
+                       ...) {
+  va_list args;
+  va_start(args, format);
+  log_impl(module, level, format, args);
   va_end(args);
 }
 
 void LogPublisher::log_debug(const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_impl(LogLevel::DEBUG, format, args);
+  log_impl(kDefaultLogModule, LogLevel::DEBUG, format, args);
   va_end(args);
 }
 
 void LogPublisher::log_info(const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_impl(LogLevel::INFO, format, args);
+  log_impl(kDefaultLogModule, LogLevel::INFO, format, args);
   va_end(args);
 }
 
 void LogPublisher::log_warn(const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_impl(LogLevel::WARN, format, args);
+  log_impl(kDefaultLogModule, LogLevel::WARN, format, args);
   va_end(args);
 }
 
 void LogPublisher::log_error(const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_impl(LogLevel::ERROR, format, args);
+  log_impl(kDefaultLogModule, LogLevel::ERROR, format, args);
   va_end(args);
 }
 
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <pb_decode.h>
 #include <pb_encode.h>
 #include <zenoh-pico.h>
 
@@ -9,7 +10,10 @@
 #include <cstdint>
 #include <functional>
 
+#include "alloc_guard.h"
 #include "log_wrapper.h"
+#include "rate_control.h"
+#include "zenoh_attachment.h"
 
 #define ZENOH_PUBLISH_PROTO_ZERO_COPY
 
@@ -20,13 +24,72 @@ constexpr size_t kMaxTopicLen = 128;
 constexpr size_t kMaxLogMessageLen = 256;
 constexpr size_t kMaxTelemetryPayloadSize = 256;
 
+// Publication cache (advanced publisher) of a publisher
+//
+// With max_samples > 0 the last max_samples samples stay in RAM (heap, one
+// payload + attachment copy each) and are served to subscribers that join
+// late or detect a gap in the publisher's sequence numbers
+// (zenoh.ext.declare_advanced_subscriber with history / recovery). A gap
+// is seen with the next sample; there are no heartbeats (they need
+// Z_FEATURE_PERIODIC_TASKS), so subscribers poll for a lost last sample.
+// Needs Z_FEATURE_ADVANCED_PUBLICATION
+// (CONFIG_APP_ZENOH_ADVANCED_PUBLICATION); without it the publisher is a
+// plain one.
+struct PublicationCache {
+  size_t max_samples = 0;
+};
+
+// Delivery options of a publisher (defaults: those of zenoh-pico)
+struct PublisherQos {
+  z_priority_t priority = Z_PRIORITY_DEFAULT;
+  z_congestion_control_t congestion_control = Z_CONGESTION_CONTROL_DEFAULT;
+  // Send each sample right away instead of batching it with others
+  bool is_express = false;
+};
+
+// Publisher with an optional publication cache
+class ZenohPublisher {
+ public:
+  ZenohPublisher() : valid_(false), cached_(false) {}
+  ~ZenohPublisher() { undeclare(); }
+
+  // Non-copyable
+  ZenohPublisher(const ZenohPublisher&) = delete;
+  ZenohPublisher& operator=(const ZenohPublisher&) = delete;
+
+  z_result_t declare(z_loaned_session_t* session, const z_loaned_keyexpr_t* ke,
+                     const z_publisher_options_t* opts,
+                     const PublicationCache& cache);
+  void undeclare();
+
+  // opts may be NULL
+  z_result_t put(z_moved_bytes_t* payload, z_publisher_put_options_t* opts);
+
+  bool is_valid() const { return valid_; }
+  // True if samples are kept for late joiners / recovery
+  bool is_cached() const { return cached_; }
+
+ private:
+  z_owned_publisher_t publisher_;
+#if Z_FEATURE_ADVANCED_PUBLICATION == 1
+  ze_owned_advanced_publisher_t advanced_;
+#endif
+  bool valid_;
+  bool cached_;
+};
+
 // Telemetry Publisher (typed wrapper with nanopb encoding)
 template <typename T>
 class TelemetryPublisher {
  public:
   TelemetryPublisher(z_loaned_session_t* session, const char* device_id,
-                     const char* topic_suffix, const pb_msgdesc_t* fields)
-      : fields_(fields), valid_(false) {
+                     const char* topic_suffix, const pb_msgdesc_t* fields,
+                     const PublicationCache& cache = PublicationCache(),
+                     const PublisherQos& qos = PublisherQos())
+      : fields_(fields),
+        rate_control_(nullptr),
+        sequence_(0),
+        valid_(false) {
     char key_expr[kMaxTopicLen];
     snprintf(key_expr, sizeof(key_expr), "%s%s", device_id, topic_suffix);
 
@@ -38,23 +101,20 @@ class TelemetryPublisher {
 
     z_publisher_options_t opts;
     z_publisher_options_default(&opts);
+    opts.priority = qos.priority;
+    opts.congestion_control = qos.congestion_control;
+    opts.is_express = qos.is_express;
 
     __print("TelemetryPublisher: Declaring publisher for: %s\n", key_expr);
-    z_result_t res =
-        z_declare_publisher(session, &publisher_, z_loan(ke), &opts);
+    z_result_t res = publisher_.declare(session, z_loan(ke), &opts, cache);
     if (res != Z_OK) {
-      __print("TelemetryPublisher: z_declare_publisher failed: %d\n", res);
+      __print("TelemetryPublisher: declare failed: %d\n", res);
       return;
     }
 
     valid_ = true;
-    __print("TelemetryPublisher: Publisher created successfully\n");
-  }
-
-  ~TelemetryPublisher() {
-    if (valid_) {
-      z_undeclare_publisher(z_publisher_move(&publisher_));
-    }
+    __print("TelemetryPublisher: Publisher created successfully%s\n",
+            publisher_.is_cached() ? " (cached)" : "");
   }
 
   // Non-copyable, non-movable
@@ -64,8 +124,20 @@ class TelemetryPublisher {
   TelemetryPublisher& operator=(TelemetryPublisher&&) = delete;
 
   bool is_valid() const { return valid_; }
+  bool is_cached() const { return publisher_.is_cached(); }
 
-  bool publish(const T& message) {
+  // Sequence number of the next sample (host side detects gaps from it)
+  uint32_t sequence() const { return sequence_; }
+
+  // Report the latency and result of every put (nullptr: none); publishers
+  // of one stream (samples and batches) share the controller
+  void set_rate_control(TelemetryRateControl* rate_control) {
+    rate_control_ = rate_control;
+  }
+
+  // extra: attachment entries sent before the sequence and timestamp
+  bool publish(const T& message, const AttachmentWriter* extra = nullptr) {
+    AllocScope alloc_scope(AllocPath::TELEMETRY);
     if (!valid_) {
       __print("TelemetryPublisher: publisher not valid\n");
       return false;
@@ -88,11 +160,13 @@ class TelemetryPublisher {
     z_bytes_copy_from_buf(&bytes, buffer, message_size);
 
     // Publish
-    z_result_t res = z_publisher_put(z_publisher_loan(&publisher_),
-                                     z_bytes_move(&bytes), NULL);
+    z_publisher_put_options_t put_opts;
+    z_owned_bytes_t attachment;
+    make_put_options(&put_opts, &attachment, extra);
+    z_result_t res = put(z_bytes_move(&bytes), &put_opts);
 
     if (res != Z_OK) {
-      __print("TelemetryPublisher: z_publisher_put failed: %d\n", res);
+      __print("TelemetryPublisher: put failed: %d\n", res);
       return false;
     }
     return true;
@@ -140,36 +214,175 @@ class TelemetryPublisher {
     z_bytes_writer_finish(z_bytes_writer_move(&writer), &bytes);
 
     // Publish
-    z_result_t res = z_publisher_put(z_publisher_loan(&publisher_),
-                                     z_bytes_move(&bytes), NULL);
+    z_publisher_put_options_t put_opts;
+    z_owned_bytes_t attachment;
+    make_put_options(&put_opts, &attachment, extra);
+    z_result_t res = put(z_bytes_move(&bytes), &put_opts);
 
     if (res != Z_OK) {
-      __print("TelemetryPublisher: z_publisher_put failed: %d\n", res);
+      __print("TelemetryPublisher: put failed: %d\n", res);
       return false;
     }
-    __print("TelemetryPublisher: published successfully\n");
     return true;
 #endif
   }
 
  private:
+  // Put, timed for the rate controller: a blocking put (congestion control
+  // BLOCK, full socket buffer) is the congestion signal
+  z_result_t put(z_moved_bytes_t* payload, z_publisher_put_options_t* opts) {
+    if (rate_control_ == nullptr) {
+      return publisher_.put(payload, opts);
+    }
+    uint64_t start_us = monotonic_us();
+    z_result_t res = publisher_.put(payload, opts);
+    rate_control_->on_put(static_cast<uint32_t>(monotonic_us() - start_us),
+                          res == Z_OK);
+    return res;
+  }
+
+  // Attach sequence number and source timestamp to every sample. The
+  // sequence advances even if the put fails so that the loss is visible.
+  // bytes must outlive the put (opts refers to it)
+  void make_put_options(z_publisher_put_options_t* opts, z_owned_bytes_t* bytes,
+                        const AttachmentWriter* extra) {
+    z_publisher_put_options_default(opts);
+
+    AttachmentWriter attachment = extra ? *extra : AttachmentWriter();
+    attachment.put_u32(AttachmentKey::SEQUENCE, sequence_++);
+    attachment.put_u64(AttachmentKey::SOURCE_TIMESTAMP_US, monotonic_us());
+
+    if (attachment.to_bytes(bytes) == Z_OK) {
+      opts->attachment = z_bytes_move(bytes);
+    }
+  }
+
   const pb_msgdesc_t* fields_;
-  z_owned_publisher_t publisher_;
+  ZenohPublisher publisher_;
+  TelemetryRateControl* rate_control_;
+  uint32_t sequence_;
   bool valid_;
 };
 
+#if Z_FEATURE_SUBSCRIPTION == 1
+// Telemetry Subscriber (typed wrapper with nanopb decoding)
+//
+// For on-device consumers of another component's publications. With
+// Z_FEATURE_LOCAL_SUBSCRIBER, samples published by this session are
+// delivered in-process: the callback runs inside the publisher's put(),
+// on the publishing thread, without a round trip through the router.
+template <typename T>
+class TelemetrySubscriber {
+ public:
+  using Callback = std::function<void(const T& message)>;
+
+  TelemetrySubscriber(z_loaned_session_t* session, const char* device_id,
+                      const char* topic_suffix, const pb_msgdesc_t* fields,
+                      Callback callback)
+      : fields_(fields), callback_(std::move(callback)), valid_(false) {
+    char key_expr[kMaxTopicLen];
+    snprintf(key_expr, sizeof(key_expr), "%s%s", device_id, topic_suffix);
+
+    z_view_keyexpr_t ke;
+    if (z_view_keyexpr_from_str(&ke, key_expr) != Z_OK) {
+      __print("TelemetrySubscriber: Failed to create keyexpr: %s\n",
+              key_expr);
+      return;
+    }
+
+    z_owned_closure_sample_t closure;
+    z_closure_sample(&closure, sample_callback, nullptr, this);
+    z_subscriber_options_t opts;
+    z_subscriber_options_default(&opts);
+
+    z_result_t res = z_declare_subscriber(
+        session, &subscriber_, z_loan(ke), z_closure_sample_move(&closure),
+        &opts);
+    if (res != Z_OK) {
+      __print("TelemetrySubscriber: z_declare_subscriber failed: %d\n", res);
+      return;
+    }
+    valid_ = true;
+  }
+
+  ~TelemetrySubscriber() {
+    if (valid_) {
+      z_undeclare_subscriber(z_subscriber_move(&subscriber_));
+    }
+  }
+
+  // Non-copyable, non-movable (the closure refers to this)
+  TelemetrySubscriber(const TelemetrySubscriber&) = delete;
+  TelemetrySubscriber& operator=(const TelemetrySubscriber&) = delete;
+  TelemetrySubscriber(TelemetrySubscriber&&) = delete;
+  TelemetrySubscriber& operator=(TelemetrySubscriber&&) = delete;
+
+  bool is_valid() const { return valid_; }
+
+ private:
+  static void sample_callback(z_loaned_sample_t* sample, void* context) {
+    auto* self = static_cast<TelemetrySubscriber*>(context);
+    const z_loaned_bytes_t* payload = z_sample_payload(sample);
+    size_t len = z_bytes_len(payload);
+    uint8_t buffer[kMaxTelemetryPayloadSize];
+    if (len > sizeof(buffer)) {
+      __print("TelemetrySubscriber: payload too large: %zu\n", len);
+      return;
+    }
+    z_bytes_reader_t reader = z_bytes_get_reader(payload);
+    z_bytes_reader_read(&reader, buffer, len);
+
+    T message = {};
+    pb_istream_t stream = pb_istream_from_buffer(buffer, len);
+    if (!pb_decode(&stream, self->fields_, &message)) {
+      __print("TelemetrySubscriber: pb_decode failed\n");
+      return;
+    }
+    self->callback_(message);
+  }
+
+  const pb_msgdesc_t* fields_;
+  Callback callback_;
+  z_owned_subscriber_t subscriber_;
+  bool valid_;
+};
+#endif  // Z_FEATURE_SUBSCRIPTION == 1
+
 // Log level
-enum class LogLevel {
+enum class LogLevel : uint8_t {
   DEBUG,
   INFO,
   WARN,
   ERROR,
+  OFF,  // filter only: nothing is published
 };
 
+// Log filter limits
+constexpr size_t kMaxLogModules = 8;
+constexpr size_t kMaxLogModuleNameLen = 16;
+constexpr LogLevel kDefaultLogLevel = LogLevel::INFO;
+constexpr uint32_t kDefaultLogRatePerSec = 10;
+constexpr uint32_t kDefaultLogBurst = 20;
+// Pending "repeated N times" summaries are published after this delay [ms]
+constexpr uint32_t kLogRepeatFlushMs = 5000;
+
+// Index into the LogPublisher module table
+using LogModuleId = uint8_t;
+constexpr LogModuleId kDefaultLogModule = 0;  // "app", used by log_info() etc.
+
 // Log Publisher
+//
+// Messages pass three filters, per module:
+//   1. level: checked before formatting, so filtered messages cost a compare
+//   2. dedup: a message equal to the previous one is counted, not published;
+//      the count is published as "repeated N times" with the next different
+//      message or after kLogRepeatFlushMs (flush_repeats())
+//   3. token bucket: rate_per_s messages per second with bursts of burst;
+//      dropped messages are reported once tokens are available again
 class LogPublisher {
  public:
-  LogPublisher(z_loaned_session_t* session, const char* device_id);
+  LogPublisher(z_loaned_session_t* session, const char* device_id,
+               const PublicationCache& cache = PublicationCache());
   ~LogPublisher();
 
   // Non-copyable
@@ -178,18 +391,83 @@ class LogPublisher {
 
   bool is_valid() const { return valid_; }
 
+  /**
+   * @brief Get the module with this name, adding it if needed
+   *
+   * @return module id (kDefaultLogModule if the table is full)
+   */
+  LogModuleId register_module(const char* name);
+
+  // True if a message of this level would pass the level filter
+  bool is_enabled(LogModuleId module, LogLevel level) const {
+    return module < module_count_ && level != LogLevel::OFF &&
+           level >= modules_[module].level;
+  }
+
+  /**
+   * @brief Set the level filter and rate limit of matching modules
+   *
+   * @param module Module name, "" or "*" for all modules
+   * @param rate_per_s Messages per second (0: unlimited)
+   * @param burst Bucket depth (0: rate_per_s)
+   * @return number of modules changed
+   */
+  size_t configure(const char* module, LogLevel level, uint32_t rate_per_s,
+                   uint32_t burst);
+
   void log(LogLevel level, const char* format, ...);
+  void log(LogModuleId module, LogLevel level, const char* format, ...);
   void log_debug(const char* format, ...);
   void log_info(const char* format, ...);
   void log_warn(const char* format, ...);
   void log_error(const char* format, ...);
 
- private:
-  z_owned_publisher_t publisher_;
-  bool valid_;
+  // Publish overdue "repeated N times" summaries (call periodically)
+  void flush_repeats();
 
-  void log_impl(LogLevel level, const char* format, va_list args);
+  // Statistics (all modules)
+  uint32_t filtered() const { return filtered_; }
+  uint32_t deduplicated() const { return deduplicated_; }
+  uint32_t rate_limited() const { return rate_limited_; }
+
+ private:
+  struct Module {
+    char name[kMaxLogModuleNameLen];
+    LogLevel level;
+    // Token bucket [millitokens, so slow rates refill smoothly]
+    uint32_t rate_per_s;
+    uint32_t burst;
+    uint32_t tokens_milli;
+    uint64_t refill_us;
+    uint32_t dropped;
+    // Last published message
+    bool has_last;
+    uint32_t last_hash;
+    LogLevel last_level;
+    uint32_t repeats;
+    uint64_t first_repeat_us;
+  };
+
+  void log_impl(LogModuleId module, LogLevel level, const char* format,
+                va_list args);
+  bool take_token(Module& m, uint64_t now_us);
+  // Write the pending summaries of m into buf; returns length (0: none)
+  size_t take_summaries(Module& m, char* buf, size_t buf_size);
+  void publish(const char* text, size_t len);
+  void lock();
+  void unlock();
   static const char* level_string(LogLevel level);
+
+  ZenohPublisher publisher_;
+  bool valid_;
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_owned_mutex_t mutex_;
+#endif
+  Module modules_[kMaxLogModules];
+  size_t module_count_;
+  uint32_t filtered_;
+  uint32_t deduplicated_;
+  uint32_t rate_limited_;
 };
 
 }  // namespace zenoh_rpc
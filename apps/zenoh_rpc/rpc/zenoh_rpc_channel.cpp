@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <cstring>
 
+#include "alloc_guard.h"
 #include "log_wrapper.h"
 
 #ifdef __ZEPHYR__
@@ -18,9 +19,20 @@ namespace zenoh_rpc {
 
 ZenohRpcChannel::ZenohRpcChannel(z_loaned_session_t* session,
                                  const char* device_id)
-    : session_(session), device_id_(device_id), queryable_count_(0) {
+    : session_(session),
+      device_id_(device_id),
+      scheduler_(nullptr),
+      timed_(nullptr),
+      local_dispatch_(true),
+      clock_active_(false),
+      queryable_count_(0),
+      local_service_count_(0) {
   for (size_t i = 0; i < kMaxQueryables; ++i) {
     queryables_[i].active = false;
+    queryables_[i].scheduler = nullptr;
+    queryables_[i].timed = nullptr;
+    queryables_[i].budget_ms = 0;
+    queryables_[i].stats = {};
     queryables_[i].key_expr[0] = '\0';
   }
 }
@@ -33,6 +45,10 @@ ZenohRpcChannel::~ZenohRpcChannel() {
       queryables_[i].active = false;
     }
   }
+  if (clock_active_) {
+    z_undeclare_queryable(z_queryable_move(&clock_queryable_));
+    clock_active_ = false;
+  }
 }
 
 void ZenohRpcChannel::build_key_expr(char* buf, size_t buf_size,
@@ -46,15 +62,82 @@ void ZenohRpcChannel::build_key_expr(char* buf, size_t buf_size,
   }
 }
 
+ZenohRpcChannel::QueryableEntry* ZenohRpcChannel::find_handler(
+    const char* key_expr) {
+  for (QueryableEntry& entry : queryables_) {
+    if (entry.active && strcmp(entry.key_expr, key_expr) == 0) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+RpcStatus ZenohRpcChannel::call_local(QueryableEntry& entry,
+                                      const RpcBuffer& request,
+                                      uint8_t* response_buf,
+                                      size_t response_buf_size,
+                                      size_t* response_size,
+                                      uint32_t timeout_ms) {
+  pb_istream_t istream = pb_istream_from_buffer(request.data, request.size);
+  pb_ostream_t ostream =
+      pb_ostream_from_buffer(response_buf, response_buf_size);
+  // The caller waits on this thread: its timeout is the deadline
+  RpcContext ctx;
+  uint64_t start_us = monotonic_us();
+  ctx.timeout_ms = timeout_ms;
+  ctx.deadline_us = start_us + timeout_ms * 1000ull;
+  apply_budget(entry, &ctx, start_us);
+  RpcStatus status = entry.handler(&istream, &ostream, ctx);
+  account(entry, status, start_us, monotonic_us());
+  if (status == RpcStatus::OK) {
+    *response_size = ostream.bytes_written;
+  }
+  return status;
+}
+
+void ZenohRpcChannel::apply_budget(const QueryableEntry& entry,
+                                   RpcContext* ctx, uint64_t start_us) {
+  if (entry.budget_ms == 0) {
+    return;
+  }
+  uint64_t budget_end = start_us + entry.budget_ms * 1000ull;
+  if (budget_end < ctx->deadline_us) {
+    ctx->deadline_us = budget_end;
+  }
+}
+
+void ZenohRpcChannel::account(QueryableEntry& entry, RpcStatus status,
+                              uint64_t start_us, uint64_t end_us) {
+  if (status == RpcStatus::TIMEOUT) {
+    entry.stats.cancelled++;
+  }
+  uint64_t took_us = end_us - start_us;
+  if (entry.budget_ms > 0 && took_us > entry.budget_ms * 1000ull) {
+    entry.stats.overruns++;
+    LOG_WRN("%s: handler took %u us, budget %u ms", entry.key_expr,
+            static_cast<uint32_t>(took_us), entry.budget_ms);
+  }
+}
+
 RpcStatus ZenohRpcChannel::call(const char* service_name,
                                 const char* method_name,
                                 const RpcBuffer& request, uint8_t* response_buf,
                                 size_t response_buf_size, size_t* response_size,
                                 uint32_t timeout_ms) {
-#if Z_FEATURE_QUERY == 1
   char key_expr_str[kMaxKeyExprLen];
   build_key_expr(key_expr_str, sizeof(key_expr_str), service_name, method_name);
 
+  // Handler on this device: no query, no router round trip
+  if (local_dispatch_) {
+    QueryableEntry* entry = find_handler(key_expr_str);
+    if (entry != nullptr) {
+      return call_local(*entry, request, response_buf, response_buf_size,
+                        response_size, timeout_ms);
+    }
+  }
+
+#if Z_FEATURE_QUERY == 1
+
   z_view_keyexpr_t keyexpr;
   if (z_view_keyexpr_from_str(&keyexpr, key_expr_str) != Z_OK) {
     LOG_ERR("Failed to create keyexpr: %s", key_expr_str);
@@ -87,8 +170,22 @@ RpcStatus ZenohRpcChannel::call(const char* service_name,
 
   // Wait for reply
   z_owned_reply_t reply;
+#if Z_FEATURE_MULTI_THREAD == 1
   z_result_t recv_res =
       z_fifo_handler_reply_recv(z_fifo_handler_reply_loan(&handler), &reply);
+#else
+  // No read task: pump the session until the reply arrives or time runs out
+  z_clock_t start = z_clock_now();
+  z_result_t recv_res;
+  while ((recv_res = z_fifo_handler_reply_try_recv(
+              z_fifo_handler_reply_loan(&handler), &reply)) ==
+         Z_CHANNEL_NODATA) {
+    if (z_clock_elapsed_ms(&start) > timeout_ms) {
+      break;
+    }
+    zp_read(session_, NULL);
+  }
+#endif
   z_fifo_handler_reply_drop(z_fifo_handler_reply_move(&handler));
 
   if (recv_res != Z_OK) {
@@ -145,11 +242,56 @@ bool ZenohRpcChannel::nanopb_zenoh_write_callback(pb_ostream_t* stream,
 }
 
 void ZenohRpcChannel::query_callback(z_loaned_query_t* query, void* context) {
+  AllocScope alloc_scope(AllocPath::QUERY);
   auto* entry = static_cast<QueryableEntry*>(context);
   if (!entry || !entry->active || !entry->handler) {
     LOG_ERR("Invalid queryable entry in callback");
     return;
   }
+  RpcContext ctx = RpcContext::from_attachment(z_query_attachment(query));
+  if (ctx.timed && ctx.execute_at_us != 0) {
+    if (entry->timed == nullptr) {
+      z_owned_bytes_t err_payload;
+      z_bytes_copy_from_str(&err_payload, "unsupported");
+      z_query_reply_err_options_t err_opts;
+      z_query_reply_err_options_default(&err_opts);
+      z_query_reply_err(query, z_bytes_move(&err_payload), &err_opts);
+      return;
+    }
+    uint64_t now = monotonic_us();
+    uint64_t deadline_us =
+        ctx.timeout_ms > 0 ? now + ctx.timeout_ms * 1000ull : kNoDeadline;
+    entry->timed->submit(query, ctx.execute_at_us, deadline_us, handle_query,
+                         entry);
+    return;
+  }
+  if (entry->scheduler == nullptr) {
+    handle_query(entry, query, monotonic_us());
+    return;
+  }
+  entry->scheduler->submit(query, ctx.client_id, handle_query, entry);
+}
+
+void ZenohRpcChannel::handle_query(void* context, const z_loaned_query_t* query,
+                                   uint64_t received_us) {
+  AllocScope alloc_scope(AllocPath::QUERY);
+  auto* entry = static_cast<QueryableEntry*>(context);
+  RpcContext ctx = RpcContext::from_attachment(z_query_attachment(query));
+  uint64_t start_us = monotonic_us();
+  uint64_t client_deadline_us = kNoDeadline;
+  if (ctx.timeout_ms > 0) {
+    client_deadline_us = received_us + ctx.timeout_ms * 1000ull;
+    if (start_us >= client_deadline_us) {
+      // Queued past the client's timeout: nobody waits for the reply
+      entry->stats.skipped++;
+      return;
+    }
+  }
+  ctx.deadline_us = client_deadline_us;
+  // A timed call's handler waits for its target time: the budget and the
+  // overrun accounting start there
+  uint64_t run_us = ctx.execute_at_us > start_us ? ctx.execute_at_us : start_us;
+  apply_budget(*entry, &ctx, run_us);
 
   const z_loaned_bytes_t* payload = z_query_payload(query);
   z_bytes_reader_t reader = z_bytes_get_reader(payload);
@@ -174,12 +316,38 @@ void ZenohRpcChannel::query_callback(z_loaned_query_t* query, void* context) {
                           .bytes_written = 0,
                           .errmsg = NULL};
 
-  RpcStatus status = entry->handler(&istream, &ostream);
+  RpcStatus status = entry->handler(&istream, &ostream, ctx);
+  uint64_t end_us = monotonic_us();
+  account(*entry, status, run_us, end_us);
+  if (ctx.timed && ctx.execute_at_us != 0 && entry->timed != nullptr) {
+    entry->timed->account_start(ctx.execute_at_us, ctx.started_us);
+  }
+  if (end_us >= client_deadline_us) {
+    // The client has given up: skip the reply
+    entry->stats.late++;
+    z_drop(z_bytes_writer_move(&writer));
+    return;
+  }
 
   if (status != RpcStatus::OK || write_ctx.error) {
-    LOG_ERR("Handler returned error: %d or write error",
-            static_cast<int>(status));
     z_drop(z_bytes_writer_move(&writer));
+    // Transient, deadline or rejected request: tell the client now instead
+    // of letting it time out
+    const char* reason =
+        status == RpcStatus::BUSY               ? "busy"
+        : status == RpcStatus::TIMEOUT          ? "timeout"
+        : status == RpcStatus::INVALID_ARGUMENT ? "invalid argument"
+                                                : nullptr;
+    if (reason == nullptr) {
+      LOG_ERR("Handler returned error: %d or write error",
+              static_cast<int>(status));
+      return;
+    }
+    z_owned_bytes_t err_payload;
+    z_bytes_copy_from_str(&err_payload, reason);
+    z_query_reply_err_options_t err_opts;
+    z_query_reply_err_options_default(&err_opts);
+    z_query_reply_err(query, z_bytes_move(&err_payload), &err_opts);
     return;
   }
 
@@ -188,6 +356,15 @@ void ZenohRpcChannel::query_callback(z_loaned_query_t* query, void* context) {
 
   z_query_reply_options_t reply_opts;
   z_query_reply_options_default(&reply_opts);
+  if (ctx.timed) {
+    // When the implementation started, for the caller's jitter figures
+    AttachmentWriter attachment;
+    attachment.put_u64(AttachmentKey::EXECUTE_AT_US, ctx.started_us);
+    z_owned_bytes_t attachment_bytes;
+    if (attachment.to_bytes(&attachment_bytes) == Z_OK) {
+      reply_opts.attachment = z_bytes_move(&attachment_bytes);
+    }
+  }
 
   const z_loaned_keyexpr_t* query_keyexpr = z_query_keyexpr(query);
   z_result_t res = z_query_reply(query, query_keyexpr,
@@ -198,7 +375,8 @@ void ZenohRpcChannel::query_callback(z_loaned_query_t* query, void* context) {
 }
 bool ZenohRpcChannel::register_handler(const char* service_name,
                                        const char* method_name,
-                                       RequestHandler handler) {
+                                       RequestHandler handler,
+                                       uint32_t budget_ms) {
 #if Z_FEATURE_QUERYABLE == 1
   if (queryable_count_ >= kMaxQueryables) {
     LOG_ERR("Max queryables reached");
@@ -221,6 +399,10 @@ bool ZenohRpcChannel::register_handler(const char* service_name,
   build_key_expr(entry.key_expr, sizeof(entry.key_expr), service_name,
                  method_name);
   entry.handler = std::move(handler);
+  entry.scheduler = scheduler_;
+  entry.timed = timed_;
+  entry.budget_ms = budget_ms;
+  entry.stats = {};
 
   z_view_keyexpr_t keyexpr;
   if (z_view_keyexpr_from_str(&keyexpr, entry.key_expr) != Z_OK) {
@@ -252,6 +434,108 @@ bool ZenohRpcChannel::register_handler(const char* service_name,
   return false;
 #endif
 }
+void ZenohRpcChannel::clock_callback(z_loaned_query_t* query,
+                                     void* context) {
+  // Taken first: the host halves the round trip around it
+  uint64_t now = monotonic_us();
+  AttachmentWriter attachment;
+  attachment.put_u64(AttachmentKey::SOURCE_TIMESTAMP_US, now);
+  z_query_reply_options_t opts;
+  z_query_reply_options_default(&opts);
+  z_owned_bytes_t attachment_bytes;
+  if (attachment.to_bytes(&attachment_bytes) == Z_OK) {
+    opts.attachment = z_bytes_move(&attachment_bytes);
+  }
+  z_owned_bytes_t payload;
+  z_bytes_empty(&payload);
+  z_result_t res = z_query_reply(query, z_query_keyexpr(query),
+                                 z_bytes_move(&payload), &opts);
+  if (res != Z_OK) {
+    LOG_ERR("z_query_reply failed: %d", res);
+  }
+}
+
+bool ZenohRpcChannel::serve_clock() {
+#if Z_FEATURE_QUERYABLE == 1
+  if (clock_active_) {
+    return true;
+  }
+  char key_expr[kMaxKeyExprLen];
+  if (device_id_ && strlen(device_id_) > 0) {
+    snprintf(key_expr, sizeof(key_expr), "%s/rpc/clock", device_id_);
+  } else {
+    snprintf(key_expr, sizeof(key_expr), "rpc/clock");
+  }
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key_expr) != Z_OK) {
+    LOG_ERR("Failed to create keyexpr: %s", key_expr);
+    return false;
+  }
+  z_owned_closure_query_t callback;
+  z_closure_query(&callback, clock_callback, nullptr, this);
+  z_queryable_options_t opts;
+  z_queryable_options_default(&opts);
+  z_result_t res = z_declare_queryable(session_, &clock_queryable_,
+                                       z_view_keyexpr_loan(&keyexpr),
+                                       z_closure_query_move(&callback), &opts);
+  if (res != Z_OK) {
+    LOG_ERR("z_declare_queryable failed: %d for %s", res, key_expr);
+    return false;
+  }
+  clock_active_ = true;
+  LOG_INF("Serving the device clock on: %s", key_expr);
+  return true;
+#else
+  LOG_ERR("Queryable feature not enabled");
+  return false;
+#endif
+}
+
+void ZenohRpcChannel::log_stats() const {
+  for (const QueryableEntry& entry : queryables_) {
+    const DeadlineStats& s = entry.stats;
+    if (!entry.active ||
+        s.skipped + s.cancelled + s.overruns + s.late == 0) {
+      continue;
+    }
+    LOG_INF("%s: skipped %u, cancelled %u, overruns %u, late %u",
+            entry.key_expr, s.skipped, s.cancelled, s.overruns, s.late);
+  }
+}
+
+DeadlineStats ZenohRpcChannel::deadline_stats() const {
+  DeadlineStats total = {};
+  for (const QueryableEntry& entry : queryables_) {
+    total.skipped += entry.stats.skipped;
+    total.cancelled += entry.stats.cancelled;
+    total.overruns += entry.stats.overruns;
+    total.late += entry.stats.late;
+  }
+  return total;
+}
+
+bool ZenohRpcChannel::register_local_service(const char* service_name,
+                                             void* impl) {
+  if (local_service_count_ >= kMaxLocalServices) {
+    LOG_ERR("Max local services reached");
+    return false;
+  }
+  local_services_[local_service_count_++] = {service_name, impl};
+  return true;
+}
+
+void* ZenohRpcChannel::local_service(const char* service_name) const {
+  if (!local_dispatch_) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < local_service_count_; ++i) {
+    if (strcmp(local_services_[i].name, service_name) == 0) {
+      return local_services_[i].impl;
+    }
+  }
+  return nullptr;
+}
+
 bool ZenohRpcChannel::nanopb_zenoh_read_callback(pb_istream_t* stream,
                                                  uint8_t* buf, size_t count) {
   z_bytes_reader_t* reader = static_cast<z_bytes_reader_t*>(stream->state);
@@ -1,14 +1,36 @@
 // Zenoh RPC Channel - Transport abstraction for RPC over Zenoh
 // Supports USB-CDC ACM serial transport
+//
+// Calls to a method registered on the same channel (on-device callers) are
+// dispatched to the handler directly instead of going through the router.
+//
+// Deadlines: a query carrying the client's timeout (TIMEOUT_MS attachment)
+// that is still queued when the timeout expires is dropped without running
+// its handler, and a reply finished after it is not sent. A method's time
+// budget (time_budget_ms option in the .proto) caps the deadline seen by
+// the handler (RpcContext::cancelled()). Handlers are not preempted: a
+// handler that stops at the deadline returns RpcStatus::TIMEOUT and the
+// client gets a "timeout" error; one that runs past its budget anyway is
+// counted as an overrun.
+//
+// Timed calls (EXECUTE_AT_US attachment, timed_dispatch.h) bypass the
+// scheduler and are queued on the timed dispatcher; the budget starts at
+// the target time. Their reply carries the time the implementation started
+// (EXECUTE_AT_US), also for EXECUTE_AT_US = 0 (run on arrival).
 
 #pragma once
 
+#include <pb_decode.h>
 #include <pb_encode.h>
 #include <zenoh-pico.h>
 
 #include <cstdint>
 #include <functional>
 
+#include "rpc_context.h"
+#include "rpc_scheduler.h"
+#include "timed_dispatch.h"
+
 namespace zenoh_rpc {
 
 // RPC call result
@@ -19,6 +41,16 @@ enum class RpcStatus {
   DECODE_ERROR,
   TRANSPORT_ERROR,
   NOT_FOUND,
+  BUSY,              // no free handler message slot (message_pool.h)
+  INVALID_ARGUMENT,  // request decoded but rejected by the implementation
+};
+
+// Deadline counters of a method (totals)
+struct DeadlineStats {
+  uint32_t skipped;    // dropped while queued: client timeout expired
+  uint32_t cancelled;  // handler stopped at the deadline (TIMEOUT)
+  uint32_t overruns;   // handler ran past the method's time budget
+  uint32_t late;       // finished after the client timeout, reply dropped
 };
 
 // Request/Response buffer
@@ -29,6 +61,11 @@ struct RpcBuffer {
 
 // Maximum number of queryables that can be registered
 constexpr size_t kMaxQueryables = 16;
+// Maximum number of service implementations callable with structs
+constexpr size_t kMaxLocalServices = 4;
+// call_message() buffer for messages without a static maximum size
+// (FT_POINTER fields)
+constexpr size_t kMaxDynamicMessageSize = 512;
 
 // Buffer sizes
 constexpr size_t kMaxKeyExprLen = 128;
@@ -44,42 +81,139 @@ class ZenohRpcChannel {
   ZenohRpcChannel(const ZenohRpcChannel&) = delete;
   ZenohRpcChannel& operator=(const ZenohRpcChannel&) = delete;
 
-  // Client side: synchronous RPC call
+  // Client side: synchronous RPC call. Methods registered on this channel
+  // run on the calling thread, without a query (no timeout).
   RpcStatus call(const char* service_name, const char* method_name,
                  const RpcBuffer& request, uint8_t* response_buf,
                  size_t response_buf_size, size_t* response_size,
                  uint32_t timeout_ms = 5000);
 
+  /**
+   * @brief Client side: call with messages (encode, call(), decode)
+   *
+   * @tparam ReqSize Maximum encoded request size
+   * @tparam RespSize Maximum encoded response size
+   */
+  template <size_t ReqSize, size_t RespSize>
+  RpcStatus call_message(const char* service_name, const char* method_name,
+                         const pb_msgdesc_t* req_fields, const void* req,
+                         const pb_msgdesc_t* resp_fields, void* resp,
+                         uint32_t timeout_ms = 5000) {
+    uint8_t req_buf[ReqSize > 0 ? ReqSize : 1];
+    pb_ostream_t ostream = pb_ostream_from_buffer(req_buf, sizeof(req_buf));
+    if (!pb_encode(&ostream, req_fields, req)) {
+      return RpcStatus::ENCODE_ERROR;
+    }
+    uint8_t resp_buf[RespSize > 0 ? RespSize : 1];
+    size_t resp_size = 0;
+    RpcStatus status = call(service_name, method_name,
+                            RpcBuffer{req_buf, ostream.bytes_written},
+                            resp_buf, sizeof(resp_buf), &resp_size,
+                            timeout_ms);
+    if (status != RpcStatus::OK) {
+      return status;
+    }
+    pb_istream_t istream = pb_istream_from_buffer(resp_buf, resp_size);
+    return pb_decode(&istream, resp_fields, resp) ? RpcStatus::OK
+                                                  : RpcStatus::DECODE_ERROR;
+  }
+
+  // Dispatch calls to handlers registered on this channel directly
+  // (default); false sends them through the router like remote calls
+  void set_local_dispatch(bool enabled) { local_dispatch_ = enabled; }
+
+  // ctx carries the metadata from the query attachment (field mask)
   using RequestHandler = std::function<RpcStatus(
-      pb_istream_t* req_stream, pb_ostream_t* response_stream)>;
+      pb_istream_t* req_stream, pb_ostream_t* response_stream,
+      const RpcContext& ctx)>;
 
   // Server side: register handler for a specific method
+  // budget_ms: handler time budget (0: only the client's timeout applies)
   bool register_handler(const char* service_name, const char* method_name,
-                        RequestHandler handler);
+                        RequestHandler handler, uint32_t budget_ms = 0);
+
+  // Log the deadline counters of methods that missed a deadline
+  void log_stats() const;
+  // Sum of the deadline counters of all methods
+  DeadlineStats deadline_stats() const;
+
+  // Server side: publish a service implementation to on-device clients,
+  // which then call it with the structs (no encoding, see the generated
+  // <Service>Client). impl must outlive the channel.
+  bool register_local_service(const char* service_name, void* impl);
+  // Implementation registered under service_name, or NULL
+  void* local_service(const char* service_name) const;
+
+  // Server side: queue queries on the scheduler instead of running the
+  // handlers in the query callback (set before register_handler())
+  void set_scheduler(RpcScheduler* scheduler) { scheduler_ = scheduler; }
+
+  // Server side: accept timed calls (set before register_handler()); without
+  // a dispatcher they get an "unsupported" error reply
+  void set_timed_dispatcher(TimedDispatcher* timed) { timed_ = timed; }
+
+  // Server side: answer <device>/rpc/clock with the device's monotonic time
+  // (SOURCE_TIMESTAMP_US attachment), for hosts scheduling timed calls
+  bool serve_clock();
 
   // Get the session
   z_loaned_session_t* session() const { return session_; }
+  // Device ID the method keys are prefixed with (may be NULL)
+  const char* device_id() const { return device_id_; }
 
  private:
   z_loaned_session_t* session_;
   const char* device_id_;
+  RpcScheduler* scheduler_;
+  TimedDispatcher* timed_;
+  bool local_dispatch_;
+  z_owned_queryable_t clock_queryable_;
+  bool clock_active_;
 
   // Registered queryables
   struct QueryableEntry {
     z_owned_queryable_t queryable;
     RequestHandler handler;
+    RpcScheduler* scheduler;
+    TimedDispatcher* timed;
     bool active;
+    uint32_t budget_ms;
+    DeadlineStats stats;
     char key_expr[kMaxKeyExprLen];
   };
   QueryableEntry queryables_[kMaxQueryables];
   size_t queryable_count_;
 
+  struct LocalService {
+    const char* name;
+    void* impl;
+  };
+  LocalService local_services_[kMaxLocalServices];
+  size_t local_service_count_;
+
+  // Registered handler for key_expr, or NULL
+  QueryableEntry* find_handler(const char* key_expr);
+  RpcStatus call_local(QueryableEntry& entry, const RpcBuffer& request,
+                       uint8_t* response_buf, size_t response_buf_size,
+                       size_t* response_size, uint32_t timeout_ms);
+  // Cap ctx.deadline_us by the method's time budget from start_us
+  static void apply_budget(const QueryableEntry& entry, RpcContext* ctx,
+                           uint64_t start_us);
+  // Count a handler that stopped at or ran past its deadline
+  static void account(QueryableEntry& entry, RpcStatus status,
+                      uint64_t start_us, uint64_t end_us);
+
   // Build key expression for RPC
   void build_key_expr(char* buf, size_t buf_size, const char* service_name,
                       const char* method_name);
 
-  // Query callback dispatcher
+  // Query callback: runs the handler or queues the query on the scheduler
   static void query_callback(z_loaned_query_t* query, void* context);
+  // Decode, run the handler and reply (RpcScheduler::Dispatch)
+  static void handle_query(void* context, const z_loaned_query_t* query,
+                           uint64_t received_us);
+  // Reply to <device>/rpc/clock
+  static void clock_callback(z_loaned_query_t* query, void* context);
 
   // NanoPB write callback context
   struct NanoPbZenohWriterContext {
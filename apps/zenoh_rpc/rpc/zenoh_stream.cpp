@@ -0,0 +1,367 @@
+// Zenoh Stream - Implementation
+
+#include "zenoh_stream.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "log_wrapper.h"
+
+#if Z_FEATURE_SUBSCRIPTION == 1
+
+#ifdef __ZEPHYR__
+LOG_MODULE_REGISTER(zenoh_stream, LOG_LEVEL_INF);
+#endif  // __ZEPHYR__
+
+namespace zenoh_rpc {
+
+namespace {
+
+// Device-wide, so that a late sample of a closed stream never reaches a
+// new one on the same slot
+std::atomic<uint32_t> next_stream_id{1};
+
+}  // namespace
+
+StreamPort::StreamPort()
+    : id_(0),
+      open_(false),
+      receive_(nullptr),
+      context_(nullptr),
+      credits_(0),
+      owed_(0),
+      next_seq_(0),
+      expected_seq_(0),
+      last_active_us_(0),
+      sent_(0),
+      received_(0),
+      stalls_(0),
+      lost_(0),
+      stale_(0) {
+  in_key_[0] = '\0';
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_init(&rx_mutex_);
+  z_mutex_init(&tx_mutex_);
+#endif
+}
+
+StreamPort::~StreamPort() {
+  close();
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_drop(z_mutex_move(&tx_mutex_));
+  z_mutex_drop(z_mutex_move(&rx_mutex_));
+#endif
+}
+
+void StreamPort::lock_rx() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_lock(z_mutex_loan_mut(&rx_mutex_));
+#endif
+}
+
+void StreamPort::unlock_rx() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_unlock(z_mutex_loan_mut(&rx_mutex_));
+#endif
+}
+
+void StreamPort::lock_tx() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_lock(z_mutex_loan_mut(&tx_mutex_));
+#endif
+}
+
+void StreamPort::unlock_tx() {
+#if Z_FEATURE_MULTI_THREAD == 1
+  z_mutex_unlock(z_mutex_loan_mut(&tx_mutex_));
+#endif
+}
+
+bool StreamPort::open(z_loaned_session_t* session, const char* device_id,
+                      uint32_t id, uint32_t peer_window, Receive receive,
+                      void* context) {
+  char out_key[kMaxKeyExprLen];
+  snprintf(out_key, sizeof(out_key), "%s/stream/%u/out", device_id,
+           static_cast<unsigned>(id));
+  snprintf(in_key_, sizeof(in_key_), "%s/stream/%u/in", device_id,
+           static_cast<unsigned>(id));
+
+  z_view_keyexpr_t out_ke;
+  z_view_keyexpr_t in_ke;
+  if (z_view_keyexpr_from_str(&out_ke, out_key) != Z_OK ||
+      z_view_keyexpr_from_str(&in_ke, in_key_) != Z_OK) {
+    LOG_ERR("Invalid stream key: %s", out_key);
+    return false;
+  }
+
+  // Small messages each way: do not wait for a batch to fill
+  z_publisher_options_t pub_opts;
+  z_publisher_options_default(&pub_opts);
+  pub_opts.is_express = true;
+  z_result_t res =
+      z_declare_publisher(session, &publisher_, z_loan(out_ke), &pub_opts);
+  if (res != Z_OK) {
+    LOG_ERR("Stream %u: declare publisher failed: %d",
+            static_cast<unsigned>(id), res);
+    return false;
+  }
+
+  lock_rx();
+  id_ = id;
+  receive_ = receive;
+  context_ = context;
+  credits_.store(peer_window);
+  owed_.store(0);
+  next_seq_ = 0;
+  expected_seq_ = 0;
+  sent_ = 0;
+  received_ = 0;
+  stalls_ = 0;
+  lost_ = 0;
+  stale_ = 0;
+  last_active_us_.store(monotonic_us());
+  open_ = true;
+  unlock_rx();
+
+  z_owned_closure_sample_t closure;
+  z_closure_sample(&closure, on_sample, nullptr, this);
+  z_subscriber_options_t sub_opts;
+  z_subscriber_options_default(&sub_opts);
+  res = z_declare_subscriber(session, &subscriber_, z_loan(in_ke),
+                             z_closure_sample_move(&closure), &sub_opts);
+  if (res != Z_OK) {
+    LOG_ERR("Stream %u: declare subscriber failed: %d",
+            static_cast<unsigned>(id), res);
+    open_ = false;
+    z_undeclare_publisher(z_publisher_move(&publisher_));
+    return false;
+  }
+  return true;
+}
+
+void StreamPort::close() {
+  if (!open_) {
+    return;
+  }
+  // Wait for a running handler, then for a running send
+  lock_rx();
+  open_ = false;
+  lock_tx();
+  z_undeclare_subscriber(z_subscriber_move(&subscriber_));
+  z_undeclare_publisher(z_publisher_move(&publisher_));
+  unlock_tx();
+  unlock_rx();
+  if (lost_ > 0 || stale_ > 0 || stalls_ > 0) {
+    LOG_INF("Stream %u closed: %u received, %u sent, %u lost, %u stale, "
+            "%u stalls",
+            static_cast<unsigned>(id_), received_, sent_, lost_, stale_,
+            stalls_);
+  }
+}
+
+uint64_t StreamPort::idle_us(uint64_t now_us) const {
+  uint64_t last = last_active_us_.load();
+  return now_us > last ? now_us - last : 0;
+}
+
+bool StreamPort::make_attachment(z_owned_bytes_t* bytes, int64_t seq) {
+  AttachmentWriter attachment;
+  if (seq >= 0) {
+    attachment.put_u32(AttachmentKey::SEQUENCE, static_cast<uint32_t>(seq));
+  }
+  uint32_t owed = owed_.exchange(0);
+  if (owed > 0) {
+    attachment.put_u32(AttachmentKey::CREDITS, owed);
+  }
+  return attachment.to_bytes(bytes) == Z_OK;
+}
+
+bool StreamPort::send(const pb_msgdesc_t* fields, const void* message) {
+  uint8_t buffer[kMaxStreamMessageSize];
+  pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+  if (!pb_encode(&stream, fields, message)) {
+    LOG_ERR("Stream %u: encode failed", static_cast<unsigned>(id_));
+    return false;
+  }
+
+  lock_tx();
+  if (!open_) {
+    unlock_tx();
+    return false;
+  }
+  // Take a credit: the peer has room for this message
+  uint32_t credits = credits_.load();
+  do {
+    if (credits == 0) {
+      stalls_++;
+      unlock_tx();
+      return false;
+    }
+  } while (!credits_.compare_exchange_weak(credits, credits - 1));
+
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_buf(&payload, buffer, stream.bytes_written);
+  z_publisher_put_options_t opts;
+  z_publisher_put_options_default(&opts);
+  z_owned_bytes_t attachment;
+  if (make_attachment(&attachment, next_seq_)) {
+    opts.attachment = z_bytes_move(&attachment);
+  }
+  next_seq_++;
+  z_result_t res = z_publisher_put(z_publisher_loan(&publisher_),
+                                   z_bytes_move(&payload), &opts);
+  unlock_tx();
+  if (res != Z_OK) {
+    LOG_ERR("Stream %u: put failed: %d", static_cast<unsigned>(id_), res);
+    return false;
+  }
+  sent_++;
+  last_active_us_.store(monotonic_us());
+  return true;
+}
+
+void StreamPort::return_credits() {
+  lock_tx();
+  if (!open_ || owed_.load() == 0) {
+    unlock_tx();
+    return;
+  }
+  z_owned_bytes_t payload;
+  z_bytes_empty(&payload);
+  z_publisher_put_options_t opts;
+  z_publisher_put_options_default(&opts);
+  z_owned_bytes_t attachment;
+  if (make_attachment(&attachment, -1)) {
+    opts.attachment = z_bytes_move(&attachment);
+  }
+  z_publisher_put(z_publisher_loan(&publisher_), z_bytes_move(&payload),
+                  &opts);
+  unlock_tx();
+}
+
+void StreamPort::on_sample(z_loaned_sample_t* sample, void* context) {
+  auto* self = static_cast<StreamPort*>(context);
+  self->lock_rx();
+  // A sample of the previous stream on this slot is dropped
+  z_view_string_t key;
+  z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key);
+  const z_loaned_string_t* key_str = z_view_string_loan(&key);
+  if (!self->open_ || z_string_len(key_str) != strlen(self->in_key_) ||
+      strncmp(z_string_data(key_str), self->in_key_, z_string_len(key_str)) !=
+          0) {
+    self->unlock_rx();
+    return;
+  }
+  self->last_active_us_.store(monotonic_us());
+
+  AttachmentReader attachment(z_sample_attachment(sample));
+  uint32_t granted = 0;
+  if (attachment.get_u32(AttachmentKey::CREDITS, &granted)) {
+    self->credits_.fetch_add(granted);
+  }
+  uint32_t seq = 0;
+  if (!attachment.get_u32(AttachmentKey::SEQUENCE, &seq)) {
+    // Credits only
+    self->unlock_rx();
+    return;
+  }
+  // The message leaves the window once copied out, whether it is handled or
+  // not: owed now, so a reply sent by the handler carries the credit
+  self->owed_.fetch_add(1);
+  // Wrap-safe distance: ahead is a gap; behind is a duplicate or a
+  // reordered message already counted as lost, and is not handled
+  int32_t ahead = static_cast<int32_t>(seq - self->expected_seq_);
+  if (ahead < 0) {
+    self->stale_++;
+  } else {
+    self->lost_ += static_cast<uint32_t>(ahead);
+    self->expected_seq_ = seq + 1;
+    self->received_++;
+
+    const z_loaned_bytes_t* payload = z_sample_payload(sample);
+    size_t len = z_bytes_len(payload);
+    uint8_t buffer[kMaxStreamMessageSize];
+    RpcStatus status = RpcStatus::DECODE_ERROR;
+    if (len <= sizeof(buffer)) {
+      z_bytes_reader_t reader = z_bytes_get_reader(payload);
+      z_bytes_reader_read(&reader, buffer, len);
+      pb_istream_t in = pb_istream_from_buffer(buffer, len);
+      status = self->receive_(self->context_, *self, &in);
+    }
+    if (status != RpcStatus::OK) {
+      LOG_WRN("Stream %u: message %u not handled: %d",
+              static_cast<unsigned>(self->id_), seq, static_cast<int>(status));
+    }
+  }
+  if (self->owed_.load() >= kStreamWindow / 2) {
+    self->return_credits();
+  }
+  self->unlock_rx();
+}
+
+StreamTable::StreamTable(ZenohRpcChannel& channel, StreamPort::Receive receive,
+                         Closed closed, void* context)
+    : channel_(channel),
+      receive_(receive),
+      closed_(closed),
+      context_(context) {}
+
+StreamTable::~StreamTable() {
+  for (StreamPort& port : ports_) {
+    port.close();
+  }
+}
+
+StreamPort* StreamTable::open(uint32_t peer_window) {
+  uint64_t now = monotonic_us();
+  StreamPort* slot = nullptr;
+  for (StreamPort& port : ports_) {
+    if (!port.is_open()) {
+      slot = &port;
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    // Take over the longest idle stream (client gone without closing)
+    for (StreamPort& port : ports_) {
+      if (port.idle_us(now) >= kStreamIdleMs * 1000ull &&
+          (slot == nullptr || port.idle_us(now) > slot->idle_us(now))) {
+        slot = &port;
+      }
+    }
+    if (slot == nullptr) {
+      return nullptr;
+    }
+    LOG_WRN("Stream %u idle, closing it", static_cast<unsigned>(slot->id()));
+    uint32_t old_id = slot->id();
+    slot->close();
+    if (closed_ != nullptr) {
+      closed_(context_, old_id);
+    }
+  }
+  uint32_t id = next_stream_id.fetch_add(1);
+  if (!slot->open(channel_.session(), channel_.device_id(), id,
+                  peer_window, receive_, context_)) {
+    return nullptr;
+  }
+  LOG_INF("Stream %u opened (client window %u)", static_cast<unsigned>(id),
+          peer_window);
+  return slot;
+}
+
+bool StreamTable::close(uint32_t stream_id) {
+  for (StreamPort& port : ports_) {
+    if (port.is_open() && port.id() == stream_id) {
+      port.close();
+      if (closed_ != nullptr) {
+        closed_(context_, stream_id);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace zenoh_rpc
+
+#endif  // Z_FEATURE_SUBSCRIPTION == 1
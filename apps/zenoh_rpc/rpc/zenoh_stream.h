@@ -0,0 +1,181 @@
+// Zenoh Stream - bidirectional message streams with credit-based flow control
+//
+// For steady flows of small messages each way (jogging an actuator, live
+// tuning), where a query per message would pay query setup, reply routing
+// and timeout bookkeeping every time. Methods declared as
+// `rpc M(stream Req) returns (stream Res)` become streams:
+//
+//   open   the client queries the method key with a StreamControl holding
+//          its receive window; the reply carries the stream id and the
+//          device's window
+//   data   Req samples on <device>/stream/<id>/in, Res samples on
+//          <device>/stream/<id>/out, each with a SEQUENCE attachment entry
+//   credit a sender may have at most the peer's window of messages
+//          unacknowledged; the receiver returns credits with a CREDITS
+//          attachment entry, on its own data or on an empty sample without
+//          SEQUENCE once half the window was consumed
+//   close  StreamControl with close set (or the slot is taken over by a new
+//          stream after kStreamIdleMs without traffic)
+//
+// Received messages are handled in the subscriber callback (zenoh read
+// task), so stream handlers must be short like RPC handlers.
+
+#pragma once
+
+#include <pb_decode.h>
+#include <pb_encode.h>
+#include <zenoh-pico.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "zenoh_attachment.h"
+#include "zenoh_rpc_channel.h"
+
+#if Z_FEATURE_SUBSCRIPTION == 1
+
+namespace zenoh_rpc {
+
+// Open streams per method
+#ifdef ZENOH_RPC_MAX_STREAMS
+constexpr size_t kMaxStreams = ZENOH_RPC_MAX_STREAMS;
+#else
+constexpr size_t kMaxStreams = 2;
+#endif
+// Messages the device accepts ahead of its handler (its receive window)
+constexpr uint32_t kStreamWindow = 8;
+// Largest encoded stream message
+constexpr size_t kMaxStreamMessageSize = 256;
+// A stream idle this long may be closed to open a new one
+constexpr uint32_t kStreamIdleMs = 10000;
+
+// One open stream (device side)
+class StreamPort {
+ public:
+  // Called for every message received (zenoh read task)
+  using Receive = RpcStatus (*)(void* context, StreamPort& port,
+                                pb_istream_t* in);
+
+  StreamPort();
+  ~StreamPort();
+
+  // Non-copyable
+  StreamPort(const StreamPort&) = delete;
+  StreamPort& operator=(const StreamPort&) = delete;
+
+  uint32_t id() const { return id_; }
+  bool is_open() const { return open_; }
+  // Messages that may be sent before the peer returns credits
+  uint32_t credits() const { return credits_.load(); }
+
+  // Encode and send one message; false without credit or on error
+  bool send(const pb_msgdesc_t* fields, const void* message);
+
+  // Counters of the current stream
+  uint32_t sent() const { return sent_; }
+  uint32_t received() const { return received_; }
+  // Sends refused for lack of credit
+  uint32_t stalls() const { return stalls_; }
+
+ private:
+  friend class StreamTable;
+
+  bool open(z_loaned_session_t* session, const char* device_id, uint32_t id,
+            uint32_t peer_window, Receive receive, void* context);
+  void close();
+  uint64_t idle_us(uint64_t now_us) const;
+
+  static void on_sample(z_loaned_sample_t* sample, void* context);
+  // Send the pending credits on an empty sample
+  void return_credits();
+  // Attachment of an outgoing sample; seq < 0: credits only
+  bool make_attachment(z_owned_bytes_t* bytes, int64_t seq);
+  void lock_rx();
+  void unlock_rx();
+  void lock_tx();
+  void unlock_tx();
+
+  uint32_t id_;
+  volatile bool open_;
+  Receive receive_;
+  void* context_;
+  z_owned_publisher_t publisher_;
+  z_owned_subscriber_t subscriber_;
+  char in_key_[kMaxKeyExprLen];
+  std::atomic<uint32_t> credits_;
+  // Credits owed to the peer (messages handled since the last return)
+  std::atomic<uint32_t> owed_;
+  uint32_t next_seq_;
+  uint32_t expected_seq_;
+  std::atomic<uint64_t> last_active_us_;
+  uint32_t sent_;
+  uint32_t received_;
+  uint32_t stalls_;
+  // Sequence gaps, and messages behind the expected sequence (dropped)
+  uint32_t lost_;
+  uint32_t stale_;
+#if Z_FEATURE_MULTI_THREAD == 1
+  // rx: held while a message is handled; tx: publisher and sequence.
+  // Always taken in this order.
+  z_owned_mutex_t rx_mutex_;
+  z_owned_mutex_t tx_mutex_;
+#endif
+};
+
+// Typed sender of a stream (generated handlers get one per message)
+template <typename T>
+class StreamWriter {
+ public:
+  StreamWriter(StreamPort* port, const pb_msgdesc_t* fields)
+      : port_(port), fields_(fields), id_(port ? port->id() : 0) {}
+
+  // False without credit (retry after the peer returned some), if the
+  // stream was closed meanwhile, or on error
+  bool send(const T& message) {
+    return is_open() && port_->send(fields_, &message);
+  }
+
+  // Copies stay valid: a writer of a closed stream refuses to send
+  bool is_open() const {
+    return port_ != nullptr && port_->is_open() && port_->id() == id_;
+  }
+  uint32_t id() const { return id_; }
+  uint32_t credits() const { return is_open() ? port_->credits() : 0; }
+
+ private:
+  StreamPort* port_;
+  const pb_msgdesc_t* fields_;
+  uint32_t id_;
+};
+
+// Streams of one method: open/close handshake and the stream slots
+class StreamTable {
+ public:
+  using Closed = void (*)(void* context, uint32_t stream_id);
+
+  StreamTable(ZenohRpcChannel& channel, StreamPort::Receive receive,
+              Closed closed, void* context);
+  ~StreamTable();
+
+  // Non-copyable
+  StreamTable(const StreamTable&) = delete;
+  StreamTable& operator=(const StreamTable&) = delete;
+
+  // Open a stream for a client with the given receive window; returns the
+  // port or NULL if every slot is busy
+  StreamPort* open(uint32_t peer_window);
+  // Close the stream; false if it is not open
+  bool close(uint32_t stream_id);
+
+ private:
+  ZenohRpcChannel& channel_;
+  StreamPort::Receive receive_;
+  Closed closed_;
+  void* context_;
+  StreamPort ports_[kMaxStreams];
+};
+
+}  // namespace zenoh_rpc
+
+#endif  // Z_FEATURE_SUBSCRIPTION == 1
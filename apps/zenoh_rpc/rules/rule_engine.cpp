@@ -0,0 +1,226 @@
+// Rule Engine - Implementation
+
+#include "rule_engine.h"
+
+#include <zephyr/logging/log.h>
+
+#include <cstring>
+
+LOG_MODULE_REGISTER(rule_engine, LOG_LEVEL_INF);
+
+namespace rules {
+
+RuleEngine::RuleEngine(const pb_msgdesc_t* fields, Action action,
+                       void* context)
+    : fields_(fields),
+      action_(action),
+      context_(context),
+      count_(0),
+      samples_(0),
+      fired_(0),
+      max_eval_cycles_(0) {
+  k_mutex_init(&mutex_);
+}
+
+bool RuleEngine::compile(const practice_rpc_Rule& rule, const void* layout,
+                         Entry* entry) const {
+  if (rule.condition > _practice_rpc_RuleCondition_MAX ||
+      rule.action > _practice_rpc_RuleAction_MAX ||
+      rule.hysteresis < 0.0f) {
+    return false;
+  }
+  pb_field_iter_t iter;
+  if (!pb_field_iter_begin_const(&iter, fields_, layout) ||
+      !pb_field_iter_find(&iter, rule.field) ||
+      PB_ATYPE(iter.type) != PB_ATYPE_STATIC ||
+      PB_HTYPE(iter.type) == PB_HTYPE_REPEATED ||
+      PB_HTYPE(iter.type) == PB_HTYPE_ONEOF) {
+    return false;
+  }
+  switch (PB_LTYPE(iter.type)) {
+    case PB_LTYPE_BOOL:
+      entry->type = ValueType::BOOL;
+      break;
+    case PB_LTYPE_VARINT:
+    case PB_LTYPE_SVARINT:
+      entry->type = iter.data_size == sizeof(int64_t) ? ValueType::INT64
+                                                      : ValueType::INT32;
+      break;
+    case PB_LTYPE_UVARINT:
+      entry->type = iter.data_size == sizeof(uint64_t) ? ValueType::UINT64
+                                                       : ValueType::UINT32;
+      break;
+    case PB_LTYPE_FIXED32:
+      entry->type = ValueType::FLOAT;
+      break;
+    case PB_LTYPE_FIXED64:
+      entry->type = ValueType::DOUBLE;
+      break;
+    default:
+      return false;
+  }
+  entry->offset =
+      static_cast<uint16_t>(static_cast<const uint8_t*>(iter.pData) -
+                            static_cast<const uint8_t*>(layout));
+  entry->condition = static_cast<uint8_t>(rule.condition);
+  entry->action = static_cast<uint8_t>(rule.action);
+  entry->on_exit = rule.on_exit;
+  entry->active = false;
+  entry->primed = false;
+  entry->value = rule.value;
+  entry->exit_value = rule.exit_value;
+  entry->last_value = 0.0f;
+  entry->last_ms = 0;
+  // FALLING compares the (negative) rate against -threshold
+  switch (rule.condition) {
+    case practice_rpc_RuleCondition_RULE_BELOW:
+      entry->threshold = rule.threshold;
+      entry->release = rule.threshold + rule.hysteresis;
+      break;
+    case practice_rpc_RuleCondition_RULE_FALLING:
+      entry->threshold = -rule.threshold;
+      entry->release = -rule.threshold + rule.hysteresis;
+      break;
+    default:
+      entry->threshold = rule.threshold;
+      entry->release = rule.threshold - rule.hysteresis;
+      break;
+  }
+  return true;
+}
+
+bool RuleEngine::install(const practice_rpc_RuleSet& rules, const void* layout,
+                         uint32_t* bad_index) {
+  Entry compiled[kMaxRules];
+  size_t count = rules.rules_count < kMaxRules ? rules.rules_count : kMaxRules;
+  for (size_t i = 0; i < count; ++i) {
+    if (!compile(rules.rules[i], layout, &compiled[i])) {
+      LOG_WRN("Rule %u: invalid (field %u)", static_cast<unsigned>(i),
+              rules.rules[i].field);
+      if (bad_index != nullptr) {
+        *bad_index = i;
+      }
+      return false;
+    }
+  }
+  k_mutex_lock(&mutex_, K_FOREVER);
+  memcpy(table_, compiled, count * sizeof(Entry));
+  count_ = count;
+  k_mutex_unlock(&mutex_);
+  LOG_INF("%u rules installed", static_cast<unsigned>(count));
+  return true;
+}
+
+float RuleEngine::read(const Entry& entry, const void* sample) {
+  const uint8_t* p = static_cast<const uint8_t*>(sample) + entry.offset;
+  switch (entry.type) {
+    case ValueType::FLOAT: {
+      float v;
+      memcpy(&v, p, sizeof(v));
+      return v;
+    }
+    case ValueType::DOUBLE: {
+      double v;
+      memcpy(&v, p, sizeof(v));
+      return static_cast<float>(v);
+    }
+    case ValueType::INT32: {
+      int32_t v;
+      memcpy(&v, p, sizeof(v));
+      return static_cast<float>(v);
+    }
+    case ValueType::INT64: {
+      int64_t v;
+      memcpy(&v, p, sizeof(v));
+      return static_cast<float>(v);
+    }
+    case ValueType::UINT32: {
+      uint32_t v;
+      memcpy(&v, p, sizeof(v));
+      return static_cast<float>(v);
+    }
+    case ValueType::UINT64: {
+      uint64_t v;
+      memcpy(&v, p, sizeof(v));
+      return static_cast<float>(v);
+    }
+    case ValueType::BOOL:
+      return *reinterpret_cast<const bool*>(p) ? 1.0f : 0.0f;
+  }
+  return 0.0f;
+}
+
+void RuleEngine::evaluate(const void* sample, uint32_t now_ms) {
+  Fired fired[kMaxRules];
+  size_t fired_count = 0;
+  const uint32_t start = k_cycle_get_32();
+
+  k_mutex_lock(&mutex_, K_FOREVER);
+  for (size_t i = 0; i < count_; ++i) {
+    Entry& entry = table_[i];
+    const float value = read(entry, sample);
+    float x = value;
+    if (entry.condition == practice_rpc_RuleCondition_RULE_RISING ||
+        entry.condition == practice_rpc_RuleCondition_RULE_FALLING) {
+      const bool have_rate = entry.primed && now_ms != entry.last_ms;
+      if (have_rate) {
+        x = (value - entry.last_value) * 1000.0f /
+            static_cast<float>(now_ms - entry.last_ms);
+      }
+      entry.last_value = value;
+      entry.last_ms = now_ms;
+      entry.primed = true;
+      if (!have_rate) {
+        continue;
+      }
+    }
+    const bool above =
+        entry.condition == practice_rpc_RuleCondition_RULE_ABOVE ||
+        entry.condition == practice_rpc_RuleCondition_RULE_RISING;
+    bool active;
+    if (!entry.active) {
+      active = above ? x > entry.threshold : x < entry.threshold;
+    } else {
+      active = above ? x >= entry.release : x <= entry.release;
+    }
+    if (active == entry.active) {
+      continue;
+    }
+    entry.active = active;
+    if (active || entry.on_exit) {
+      fired[fired_count++] = {static_cast<uint8_t>(i), entry.action, active,
+                              active ? entry.value : entry.exit_value, value};
+    }
+  }
+  k_mutex_unlock(&mutex_);
+
+  const uint32_t cycles = k_cycle_get_32() - start;
+  samples_++;
+  if (cycles > max_eval_cycles_) {
+    max_eval_cycles_ = cycles;
+  }
+  for (size_t i = 0; i < fired_count; ++i) {
+    const Fired& f = fired[i];
+    fired_++;
+    if (action_ != nullptr &&
+        f.action != practice_rpc_RuleAction_RULE_ACTION_NONE) {
+      action_(context_, f.rule,
+              static_cast<practice_rpc_RuleAction>(f.action), f.value,
+              f.active, f.sample);
+    }
+  }
+}
+
+void RuleEngine::log_stats() {
+  if (samples_ == 0) {
+    return;
+  }
+  LOG_INF("Rules: %u rules, %u samples, %u fired, evaluation max %u us",
+          static_cast<unsigned>(count_), samples_, fired_,
+          k_cyc_to_us_ceil32(max_eval_cycles_));
+  samples_ = 0;
+  fired_ = 0;
+  max_eval_cycles_ = 0;
+}
+
+}  // namespace rules
@@ -0,0 +1,142 @@
+// Rule Engine - local reactions to telemetry without a host round trip
+//
+// A RuleSet (SetRules RPC) is compiled into a table of fixed-size entries:
+// the field number is resolved once to an offset and a value type, so
+// evaluating a sample costs a load and a compare or two per rule, in the
+// task that produced the sample. A rule is active while its condition
+// holds; its action runs when it becomes active and, with on_exit, when it
+// clears. The hysteresis keeps a value hovering around the threshold from
+// toggling the action on every sample.
+//
+// fixed32/fixed64 fields are read as float/double (nanopb does not tell
+// them apart).
+
+#pragma once
+
+#include <pb.h>
+#include <pb_common.h>
+#include <zephyr/kernel.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rpc/service.pb.h"
+
+namespace rules {
+
+// Rules in a table (RuleSet.rules max_count in service.options)
+constexpr size_t kMaxRules =
+    sizeof(practice_rpc_RuleSet::rules) / sizeof(practice_rpc_Rule);
+
+/**
+ * @brief Compiled rules evaluated against samples of one message type
+ *
+ * install() and evaluate() may run in different tasks: the table is swapped
+ * under a lock, and actions run after it is released, so an action may call
+ * back into the RPC implementation.
+ */
+class RuleEngine {
+ public:
+  // Runs the action of a rule that became active (active = true) or cleared
+  using Action = void (*)(void* context, uint32_t rule,
+                          practice_rpc_RuleAction action, uint32_t value,
+                          bool active, float sample);
+
+  RuleEngine(const pb_msgdesc_t* fields, Action action, void* context);
+
+  // Non-copyable
+  RuleEngine(const RuleEngine&) = delete;
+  RuleEngine& operator=(const RuleEngine&) = delete;
+
+  size_t size() const { return count_; }
+
+  // Log the evaluation counters
+  void log_stats();
+
+ protected:
+  /**
+   * @brief Compile and replace the rules
+   *
+   * @param layout Any message of the evaluated type (for field offsets)
+   * @param bad_index Index of the first invalid rule (table unchanged)
+   * @return false if a rule names an unknown or unsupported field
+   */
+  bool install(const practice_rpc_RuleSet& rules, const void* layout,
+               uint32_t* bad_index);
+
+  void evaluate(const void* sample, uint32_t now_ms);
+
+ private:
+  enum class ValueType : uint8_t {
+    FLOAT,
+    DOUBLE,
+    INT32,
+    INT64,
+    UINT32,
+    UINT64,
+    BOOL,
+  };
+
+  // One compiled rule (the "bytecode")
+  struct Entry {
+    uint16_t offset;
+    ValueType type;
+    uint8_t condition;  // practice_rpc_RuleCondition
+    uint8_t action;     // practice_rpc_RuleAction
+    bool on_exit;
+    bool active;
+    bool primed;        // last_value/last_ms hold a previous sample
+    float threshold;
+    float release;      // threshold at which an active rule clears
+    uint32_t value;
+    uint32_t exit_value;
+    float last_value;
+    uint32_t last_ms;
+  };
+
+  struct Fired {
+    uint8_t rule;
+    uint8_t action;
+    bool active;
+    uint32_t value;
+    float sample;
+  };
+
+  bool compile(const practice_rpc_Rule& rule, const void* layout,
+               Entry* entry) const;
+  static float read(const Entry& entry, const void* sample);
+
+  const pb_msgdesc_t* fields_;
+  Action action_;
+  void* context_;
+  Entry table_[kMaxRules];
+  size_t count_;
+  struct k_mutex mutex_;
+
+  // Counters since the last log_stats()
+  uint32_t samples_;
+  uint32_t fired_;
+  uint32_t max_eval_cycles_;
+};
+
+/**
+ * @brief RuleEngine for samples of type T
+ */
+template <typename T>
+class TelemetryRules : public RuleEngine {
+ public:
+  TelemetryRules(const pb_msgdesc_t* fields, Action action, void* context)
+      : RuleEngine(fields, action, context) {}
+
+  bool install(const practice_rpc_RuleSet& rules,
+               uint32_t* bad_index = nullptr) {
+    T layout{};
+    return RuleEngine::install(rules, &layout, bad_index);
+  }
+
+  void evaluate(const T& sample, uint32_t now_ms) {
+    RuleEngine::evaluate(&sample, now_ms);
+  }
+};
+
+}  // namespace rules
@@ -4,6 +4,7 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
 
 #include <cstring>
 
@@ -21,7 +22,8 @@ namespace practice::rpc {
 
 zenoh_rpc::RpcStatus DeviceServiceImpl::SetLed(
     const practice_rpc_LedRequest& request,
-    practice_rpc_LedResponse* response) {
+    practice_rpc_LedResponse* response,
+    const zenoh_rpc::RpcContext& ctx) {
   LOG_INF("SetLed: on=%d", request.on);
 
   if (log_pub_) {
@@ -35,12 +37,15 @@ zenoh_rpc::RpcStatus DeviceServiceImpl::SetLed(
     LOG_INF("Turning LED OFF");
     gpio_pin_set_dt(&led, 0);
   }
+  state_->update(
+      [&](practice_rpc_DeviceState& state) { state.led_on = request.on; });
   return zenoh_rpc::RpcStatus::OK;
 }
 
 zenoh_rpc::RpcStatus DeviceServiceImpl::Echo(
     const practice_rpc_EchoRequest& request,
-    practice_rpc_EchoResponse* response) {
+    practice_rpc_EchoResponse* response,
+    const zenoh_rpc::RpcContext& ctx) {
   LOG_INF("Echo: msg=%s", request.msg);
 
   // Echo back the message
@@ -52,9 +57,15 @@ zenoh_rpc::RpcStatus DeviceServiceImpl::Echo(
 
 zenoh_rpc::RpcStatus DeviceServiceImpl::EchoMalloc(
     const practice_rpc_EchoRequestMalloc& request,
-    practice_rpc_EchoResponseMalloc* response) {
+    practice_rpc_EchoResponseMalloc* response,
+    const zenoh_rpc::RpcContext& ctx) {
   LOG_INF("EchoMalloc: msg length=%d", (int)request.msg->size);
 
+  // Field mask without msg: nothing to allocate
+  if (!ctx.wants(practice_rpc_EchoResponseMalloc_msg_tag)) {
+    return zenoh_rpc::RpcStatus::OK;
+  }
+
   // Echo back the message
   response->msg = (pb_bytes_array_t*)malloc(
       sizeof(pb_size_t) +
@@ -69,44 +80,174 @@ zenoh_rpc::RpcStatus DeviceServiceImpl::EchoMalloc(
   return zenoh_rpc::RpcStatus::OK;
 }
 
+zenoh_rpc::RpcStatus DeviceServiceImpl::SetRules(
+    const practice_rpc_RuleSet& request,
+    practice_rpc_SetRulesResponse* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  LOG_INF("SetRules: %u rules", static_cast<unsigned>(request.rules_count));
+  uint32_t bad_index = 0;
+  if (!rules_.install(request, &bad_index)) {
+    if (log_pub_) {
+      log_pub_->log(rules_log_, zenoh_rpc::LogLevel::ERROR,
+                    "Rule %u rejected: unknown field or condition", bad_index);
+    }
+    LOG_ERR("SetRules: rule %u rejected", bad_index);
+    return zenoh_rpc::RpcStatus::INVALID_ARGUMENT;
+  }
+  // Written to flash in the background, only on change
+  settings_->rule_set.set(request);
+  response->installed = rules_.size();
+  return zenoh_rpc::RpcStatus::OK;
+}
+
+void DeviceServiceImpl::run_rule_action(void* context, uint32_t rule,
+                                        practice_rpc_RuleAction action,
+                                        uint32_t value, bool active,
+                                        float sample) {
+  auto* self = static_cast<DeviceServiceImpl*>(context);
+  switch (action) {
+    case practice_rpc_RuleAction_RULE_ACTION_SET_LED: {
+      practice_rpc_LedRequest request = practice_rpc_LedRequest_init_zero;
+      practice_rpc_LedResponse response = practice_rpc_LedResponse_init_zero;
+      request.on = value != 0;
+      self->SetLed(request, &response, zenoh_rpc::kDefaultRpcContext);
+      break;
+    }
+    case practice_rpc_RuleAction_RULE_ACTION_LOG:
+      if (self->log_pub_) {
+        self->log_pub_->log(self->rules_log_, zenoh_rpc::LogLevel::WARN,
+                            "Rule %u %s at %d (value %u)", rule,
+                            active ? "active" : "cleared",
+                            static_cast<int>(sample), value);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+zenoh_rpc::RpcStatus DeviceServiceImpl::EchoStream(
+    const practice_rpc_EchoRequest& request,
+    zenoh_rpc::StreamWriter<practice_rpc_EchoResponse>& stream) {
+  // One reply per message, no logging: this path is the latency reference
+  practice_rpc_EchoResponse response = practice_rpc_EchoResponse_init_zero;
+  strncpy(response.msg, request.msg, sizeof(response.msg) - 1);
+  if (!stream.send(response)) {
+    // No credit: the client stopped reading
+    return zenoh_rpc::RpcStatus::BUSY;
+  }
+  return zenoh_rpc::RpcStatus::OK;
+}
+
 zenoh_rpc::RpcStatus DeviceServiceImpl::StartSensorStream(
-    const practice_rpc_SensorRequest& request, practice_rpc_Empty* response) {
-  LOG_INF("StartSensorStream");
+    const practice_rpc_SensorRequest& request, practice_rpc_Empty* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  LOG_INF("StartSensorStream: batch_size=%u", request.batch_size);
+  batch_size_ = request.batch_size;
   streaming_enabled_ = true;
+  state_->update([&](practice_rpc_DeviceState& state) {
+    state.streaming = true;
+    state.batch_size = request.batch_size;
+  });
   if (log_pub_) {
-    log_pub_->log_info("Sensor streaming started");
+    log_pub_->log(sensor_log_, zenoh_rpc::LogLevel::INFO,
+                  "Sensor streaming started (batch_size=%u)",
+                  request.batch_size);
   }
   return zenoh_rpc::RpcStatus::OK;
 }
 
 zenoh_rpc::RpcStatus DeviceServiceImpl::StopSensorStream(
-    const practice_rpc_Empty& request, practice_rpc_Empty* response) {
+    const practice_rpc_Empty& request, practice_rpc_Empty* response,
+    const zenoh_rpc::RpcContext& ctx) {
   LOG_INF("StopSensorStream");
   streaming_enabled_ = false;
+  state_->update(
+      [](practice_rpc_DeviceState& state) { state.streaming = false; });
   if (log_pub_) {
-    log_pub_->log_info("Sensor streaming stopped");
+    log_pub_->log(sensor_log_, zenoh_rpc::LogLevel::INFO,
+                  "Sensor streaming stopped");
   }
   return zenoh_rpc::RpcStatus::OK;
 }
 
 zenoh_rpc::RpcStatus DeviceServiceImpl::ConfigureWifi(
-    const practice_rpc_WifiSettings& request, practice_rpc_Empty* response) {
+    const practice_rpc_WifiSettings& request, practice_rpc_Empty* response,
+    const zenoh_rpc::RpcContext& ctx) {
   LOG_INF("ConfigureWifi: ssid=%s", request.ssid);
 
-  if (log_pub_) {
-    log_pub_->log_info("WiFi configured: %s", request.ssid);
+  if (request.ssid[0] == '\0') {
+    LOG_ERR("Invalid SSID");
+    return zenoh_rpc::RpcStatus::TRANSPORT_ERROR;
   }
-  // Save credentials to NVS and connect
+  // Update the RAM cache; flash is written in the background, only on change
+  bool changed = settings_->wifi_settings.set(request);
   wifi::WifiManager& wifi_mgr = wifi::get_wifi_manager();
-  if (!wifi_mgr.configure_and_connect(request.ssid, request.password)) {
+  if (!changed && wifi_mgr.is_connected() &&
+      strcmp(wifi_mgr.get_ssid(), request.ssid) == 0) {
+    LOG_INF("Wi-Fi settings unchanged");
+    return zenoh_rpc::RpcStatus::OK;
+  }
+
+  if (log_pub_) {
+    log_pub_->log(wifi_log_, zenoh_rpc::LogLevel::INFO, "WiFi configured: %s",
+                  request.ssid);
+  }
+  // Scan and connect take seconds: run them on the Wi-Fi work queue
+  if (!wifi_mgr.connect_async(request.ssid, request.password)) {
     LOG_ERR("Failed to configure Wi-Fi");
     return zenoh_rpc::RpcStatus::TRANSPORT_ERROR;
   }
   return zenoh_rpc::RpcStatus::OK;
 }
 
+zenoh_rpc::RpcStatus DeviceServiceImpl::SetLogLevel(
+    const practice_rpc_LogLevelRequest& request,
+    practice_rpc_LogLevelResponse* response,
+    const zenoh_rpc::RpcContext& ctx) {
+  LOG_INF("SetLogLevel: module=%s level=%d rate=%u burst=%u", request.module,
+          (int)request.level, request.rate_per_s, request.burst);
+  // proto3 enums are open: any int32 can arrive, negative ones included
+  if (request.level < practice_rpc_LogLevel_LOG_LEVEL_DEBUG ||
+      request.level > practice_rpc_LogLevel_LOG_LEVEL_OFF) {
+    LOG_ERR("Invalid log level: %d", (int)request.level);
+    return zenoh_rpc::RpcStatus::INVALID_ARGUMENT;
+  }
+
+  // Published logs (<device>/log)
+  if (log_pub_) {
+    response->log_modules = log_pub_->configure(
+        request.module, static_cast<zenoh_rpc::LogLevel>(request.level),
+        request.rate_per_s, request.burst);
+  }
+
+  // Zephyr log sources (console/UART); a source cannot log more than its
+  // compile-time level (LOG_MODULE_REGISTER)
+#ifdef CONFIG_LOG_RUNTIME_FILTERING
+  static const uint32_t kZephyrLevels[] = {LOG_LEVEL_DBG, LOG_LEVEL_INF,
+                                           LOG_LEVEL_WRN, LOG_LEVEL_ERR,
+                                           LOG_LEVEL_NONE};
+  bool all = request.module[0] == '\0' || strcmp(request.module, "*") == 0;
+  uint32_t sources = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+  for (uint32_t id = 0; id < sources; ++id) {
+    const char* name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, id);
+    if (name == nullptr || (!all && strcmp(name, request.module) != 0)) {
+      continue;
+    }
+    log_filter_set(NULL, Z_LOG_LOCAL_DOMAIN_ID, id,
+                   kZephyrLevels[request.level]);
+    response->zephyr_modules++;
+  }
+#endif  // CONFIG_LOG_RUNTIME_FILTERING
+
+  if (response->log_modules == 0 && response->zephyr_modules == 0) {
+    LOG_WRN("SetLogLevel: no module named %s", request.module);
+  }
+  return zenoh_rpc::RpcStatus::OK;
+}
+
 void DeviceServiceImpl::publish_sensor_data() {
-  if (!streaming_enabled_ || !sensor_pub_) {
+  if (!sensor_pub_ || (!streaming_enabled_ && !has_rules())) {
     return;
   }
   // Check if DHT22 device is ready
@@ -136,11 +277,82 @@ void DeviceServiceImpl::publish_sensor_data() {
   practice_rpc_SensorTelemetry payload = practice_rpc_SensorTelemetry_init_zero;
   payload.temperature = sensor_value_to_float(&temp_val);
   payload.humidity = sensor_value_to_float(&hum_val);
+  // React before publishing: the action does not wait for the link
+  rules_.evaluate(payload, k_uptime_get_32());
+  if (!streaming_enabled_) {
+    return;
+  }
+  // Congested link: samples are skipped (neither batched nor published) and
+  // batches grow, within the limits of the SensorTelemetry options
+  if (sensor_rate_ && !sensor_rate_->admit(zenoh_rpc::monotonic_us())) {
+    return;
+  }
+  uint32_t batch_size =
+      sensor_rate_ ? sensor_rate_->batch_size(batch_size_) : batch_size_;
   LOG_INF("DHT22: temp=%d deg C, humidity=%d percent", (int)payload.temperature,
           (int)payload.humidity);
+  if (log_pub_) {
+    // Costs a compare unless enabled with SetLogLevel(module="sensor")
+    log_pub_->log(sensor_log_, zenoh_rpc::LogLevel::DEBUG,
+                  "DHT22: temp=%d deg C, humidity=%d percent",
+                  (int)payload.temperature, (int)payload.humidity);
+  }
+
+  if (sensor_batcher_) {
+    if (sensor_batcher_->batch_size() != batch_size) {
+      flush_sensor_batch();
+      sensor_batcher_->set_batch_size(batch_size);
+    }
+    if (sensor_batcher_->enabled()) {
+      uint32_t batches = sensor_batcher_->batches();
+      if (!sensor_batcher_->add(k_uptime_get_32(), payload)) {
+        LOG_WRN("Failed to publish sensor batch");
+      }
+      if (sensor_batcher_->batches() != batches) {
+        log_batch_stats();
+      }
+      return;
+    }
+  }
   if (!sensor_pub_->publish(payload)) {
     LOG_WRN("Failed to publish sensor data");
   }
 }
 
+void DeviceServiceImpl::update_wifi_state() {
+  wifi::WifiManager& wifi_mgr = wifi::get_wifi_manager();
+  // No delta is published while nothing changed
+  state_->update([&](practice_rpc_DeviceState& state) {
+    state.wifi_connected = wifi_mgr.is_connected();
+    strncpy(state.wifi_ssid, state.wifi_connected ? wifi_mgr.get_ssid() : "",
+            sizeof(state.wifi_ssid) - 1);
+    state.wifi_ssid[sizeof(state.wifi_ssid) - 1] = '\0';
+  });
+}
+
+void DeviceServiceImpl::flush_sensor_batch() {
+  if (!sensor_batcher_ || sensor_batcher_->pending() == 0) {
+    return;
+  }
+  if (!sensor_batcher_->flush()) {
+    LOG_WRN("Failed to publish sensor batch");
+  }
+  log_batch_stats();
+}
+
+void DeviceServiceImpl::log_batch_stats() {
+  uint32_t samples = sensor_batcher_->samples();
+  if (samples == 0) {
+    return;
+  }
+  // Cycles of the hardware timer (CPU cycles with the Cortex-M SysTick)
+  LOG_INF("Sensor batches: %u samples, %u bytes, %u.%02u bytes/sample, "
+          "%u cycles/sample @ %u Hz",
+          samples, sensor_batcher_->encoded_bytes(),
+          sensor_batcher_->encoded_bytes() / samples,
+          sensor_batcher_->encoded_bytes() * 100 / samples % 100,
+          (uint32_t)(sensor_batcher_->encode_cycles() / samples),
+          sys_clock_hw_cycles_per_sec());
+}
+
 }  // namespace practice::rpc
@@ -5,48 +5,131 @@
 #include <zephyr/logging/log.h>
 
 #include "rpc/service_server.h"
+#include "rpc/service_settings.h"
+#include "rpc/rate_control.h"
+#include "rpc/state_sync.h"
+#include "rpc/telemetry_batch.h"
 #include "rpc/zenoh_pubsub.h"
+#include "rules/rule_engine.h"
 #include "service.pb.h"
 
 namespace practice::rpc {
 
+using SensorBatcher =
+    zenoh_rpc::TelemetryBatcher<practice_rpc_SensorTelemetry,
+                                practice_rpc_TelemetryBatch>;
+using DeviceStateSync = zenoh_rpc::StateSync<practice_rpc_DeviceState,
+                                             practice_rpc_DeviceState_size>;
+
 class DeviceServiceImpl : public DeviceService {
  public:
   DeviceServiceImpl(
       zenoh_rpc::TelemetryPublisher<practice_rpc_SensorTelemetry>* sensor_pub,
-      zenoh_rpc::LogPublisher* log_pub)
-      : sensor_pub_(sensor_pub), log_pub_(log_pub), streaming_enabled_(false) {}
+      SensorBatcher* sensor_batcher, zenoh_rpc::LogPublisher* log_pub,
+      ServiceSettings* settings, DeviceStateSync* state)
+      : sensor_pub_(sensor_pub),
+        sensor_batcher_(sensor_batcher),
+        log_pub_(log_pub),
+        settings_(settings),
+        state_(state),
+        streaming_enabled_(false),
+        batch_size_(0),
+        rules_(practice_rpc_SensorTelemetry_fields, run_rule_action, this) {
+    if (log_pub_) {
+      sensor_log_ = log_pub_->register_module("sensor");
+      wifi_log_ = log_pub_->register_module("wifi");
+      rules_log_ = log_pub_->register_module("rules");
+    }
+    // Rules stored by the last SetRules (settings are loaded before)
+    if (settings_ && settings_->rule_set.has_value()) {
+      rules_.install(settings_->rule_set.get());
+    }
+  }
 
   zenoh_rpc::RpcStatus SetLed(const practice_rpc_LedRequest& request,
-                              practice_rpc_LedResponse* response) override;
+                              practice_rpc_LedResponse* response,
+                              const zenoh_rpc::RpcContext& ctx) override;
 
   zenoh_rpc::RpcStatus Echo(const practice_rpc_EchoRequest& request,
-                            practice_rpc_EchoResponse* response) override;
+                            practice_rpc_EchoResponse* response,
+                            const zenoh_rpc::RpcContext& ctx) override;
 
   zenoh_rpc::RpcStatus EchoMalloc(
       const practice_rpc_EchoRequestMalloc& request,
-      practice_rpc_EchoResponseMalloc* response) override;
+      practice_rpc_EchoResponseMalloc* response,
+      const zenoh_rpc::RpcContext& ctx) override;
 
   zenoh_rpc::RpcStatus StartSensorStream(
       const practice_rpc_SensorRequest& request,
-      practice_rpc_Empty* response) override;
+      practice_rpc_Empty* response,
+      const zenoh_rpc::RpcContext& ctx) override;
 
-  zenoh_rpc::RpcStatus StopSensorStream(const practice_rpc_Empty& request,
-                                        practice_rpc_Empty* response) override;
+  zenoh_rpc::RpcStatus StopSensorStream(
+      const practice_rpc_Empty& request, practice_rpc_Empty* response,
+      const zenoh_rpc::RpcContext& ctx) override;
 
   zenoh_rpc::RpcStatus ConfigureWifi(const practice_rpc_WifiSettings& request,
-                                     practice_rpc_Empty* response) override;
+                                     practice_rpc_Empty* response,
+                                     const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus SetLogLevel(
+      const practice_rpc_LogLevelRequest& request,
+      practice_rpc_LogLevelResponse* response,
+      const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus SetRules(
+      const practice_rpc_RuleSet& request,
+      practice_rpc_SetRulesResponse* response,
+      const zenoh_rpc::RpcContext& ctx) override;
+
+  zenoh_rpc::RpcStatus EchoStream(
+      const practice_rpc_EchoRequest& request,
+      zenoh_rpc::StreamWriter<practice_rpc_EchoResponse>& stream) override;
 
   // Called periodically from sensor task to publish telemetry
   void publish_sensor_data();
 
+  // Publish batched samples left over after the stream was stopped
+  void flush_sensor_batch();
+
+  // Mirror the Wi-Fi connection into the device state (called periodically)
+  void update_wifi_state();
+
   // Check if streaming is enabled
   bool is_streaming_enabled() const { return streaming_enabled_; }
 
+  // Rules installed: the sensor is sampled even with streaming disabled
+  bool has_rules() const { return rules_.size() > 0; }
+
+  // Congestion control of the sensor stream (nullptr: fixed rate); its
+  // publishers report their puts to the same controller
+  void set_sensor_rate_control(zenoh_rpc::TelemetryRateControl* rate) {
+    sensor_rate_ = rate;
+  }
+
+  void log_rule_stats() { rules_.log_stats(); }
+
  private:
+  void log_batch_stats();
+  // Rule actions are the local handlers (rules::RuleEngine::Action)
+  static void run_rule_action(void* context, uint32_t rule,
+                              practice_rpc_RuleAction action, uint32_t value,
+                              bool active, float sample);
+
   zenoh_rpc::TelemetryPublisher<practice_rpc_SensorTelemetry>* sensor_pub_;
+  SensorBatcher* sensor_batcher_;
+  zenoh_rpc::TelemetryRateControl* sensor_rate_ = nullptr;
   zenoh_rpc::LogPublisher* log_pub_;
+  zenoh_rpc::LogModuleId sensor_log_ = zenoh_rpc::kDefaultLogModule;
+  zenoh_rpc::LogModuleId wifi_log_ = zenoh_rpc::kDefaultLogModule;
+  zenoh_rpc::LogModuleId rules_log_ = zenoh_rpc::kDefaultLogModule;
+  ServiceSettings* settings_;
+  DeviceStateSync* state_;
   bool streaming_enabled_;
+  // Requested by StartSensorStream, applied from the sensor task
+  uint32_t batch_size_;
+  // Local reactions to the sensor samples (SetRules)
+  rules::TelemetryRules<practice_rpc_SensorTelemetry> rules_;
 };
 
 }  // namespace practice::rpc
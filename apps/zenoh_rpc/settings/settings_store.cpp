@@ -0,0 +1,199 @@
+// Settings Store Implementation
+
+#include "settings_store.h"
+
+#include <pb_decode.h>
+#include <zephyr/logging/log.h>
+
+#include <cstdio>
+
+LOG_MODULE_REGISTER(settings_store, LOG_LEVEL_INF);
+
+namespace config {
+
+namespace {
+
+constexpr size_t kMaxSettingsPathLen = 64;
+
+void build_path(char* buf, size_t buf_size, const char* key) {
+  snprintf(buf, buf_size, "%s/%s", kSettingsSubtree, key);
+}
+
+}  // namespace
+
+// Global instance
+static SettingsStore g_settings_store;
+
+SettingsStore& get_settings_store() { return g_settings_store; }
+
+// --- SettingsEntryBase ---
+
+void SettingsEntryBase::read(void* out) const {
+  if (store_) {
+    k_mutex_lock(&store_->lock_, K_FOREVER);
+  }
+  memcpy(out, value_, value_size_);
+  if (store_) {
+    k_mutex_unlock(&store_->lock_);
+  }
+}
+
+bool SettingsEntryBase::commit(const void* value, const uint8_t* encoded,
+                               size_t len) {
+  if (!store_) {
+    LOG_ERR("Settings entry %s not registered", key_);
+    return false;
+  }
+
+  k_mutex_lock(&store_->lock_, K_FOREVER);
+  if (has_value_ && len == encoded_len_ &&
+      memcmp(encoded, encoded_, len) == 0) {
+    store_->skipped_writes_++;
+    k_mutex_unlock(&store_->lock_);
+    return false;
+  }
+  memcpy(value_, value, value_size_);
+  memcpy(encoded_, encoded, len);
+  encoded_len_ = len;
+  has_value_ = true;
+  dirty_ = true;
+  k_mutex_unlock(&store_->lock_);
+
+  // Coalesce: a pending flush is not pushed back by further writes
+  store_->schedule_flush(kSettingsFlushDelayMs);
+  return true;
+}
+
+// --- SettingsStore ---
+
+SettingsStore::SettingsStore() {
+  k_mutex_init(&lock_);
+  k_work_init_delayable(&flush_work_, flush_work_handler);
+}
+
+void SettingsStore::add(SettingsEntryBase& entry) {
+  k_mutex_lock(&lock_, K_FOREVER);
+  entry.store_ = this;
+  entry.next_ = entries_;
+  entries_ = &entry;
+  k_mutex_unlock(&lock_);
+}
+
+bool SettingsStore::load() {
+  int ret = settings_subsys_init();
+  if (ret != 0) {
+    LOG_ERR("Failed to initialize settings subsystem: %d", ret);
+    return false;
+  }
+
+  if (!initialized_) {
+    handler_.name = kSettingsSubtree;
+    handler_.h_set = settings_set;
+    ret = settings_register(&handler_);
+    if (ret != 0) {
+      LOG_ERR("Failed to register settings handler: %d", ret);
+      return false;
+    }
+    initialized_ = true;
+  }
+
+  ret = settings_load_subtree(kSettingsSubtree);
+  if (ret != 0) {
+    LOG_ERR("Failed to load settings: %d", ret);
+    return false;
+  }
+  return true;
+}
+
+int SettingsStore::settings_set(const char* key, size_t len,
+                                settings_read_cb read_cb, void* cb_arg) {
+  SettingsStore& store = get_settings_store();
+  const char* next = nullptr;
+
+  k_mutex_lock(&store.lock_, K_FOREVER);
+  for (SettingsEntryBase* e = store.entries_; e; e = e->next_) {
+    if (!settings_name_steq(key, e->key_, &next) || next != nullptr) {
+      continue;
+    }
+    if (len > e->max_size_) {
+      LOG_WRN("Settings %s: stored size %zu exceeds %zu, ignored", e->key_,
+              len, e->max_size_);
+      break;
+    }
+    ssize_t n = read_cb(cb_arg, e->encoded_, len);
+    if (n < 0 || static_cast<size_t>(n) != len) {
+      LOG_ERR("Settings %s: read failed: %d", e->key_, (int)n);
+      break;
+    }
+    pb_istream_t stream = pb_istream_from_buffer(e->encoded_, len);
+    if (!pb_decode(&stream, e->fields_, e->value_)) {
+      // Back to the defaults (value-initialized, as constructed) instead of
+      // a partially decoded message
+      LOG_ERR("Settings %s: decode failed, using defaults", e->key_);
+      memset(e->value_, 0, e->value_size_);
+      e->encoded_len_ = 0;
+      e->has_value_ = false;
+      break;
+    }
+    e->encoded_len_ = len;
+    e->has_value_ = true;
+    e->dirty_ = false;
+    LOG_INF("Settings %s loaded (%zu bytes)", e->key_, len);
+    break;
+  }
+  k_mutex_unlock(&store.lock_);
+  return 0;
+}
+
+void SettingsStore::schedule_flush(uint32_t delay_ms) {
+  k_work_schedule(&flush_work_, K_MSEC(delay_ms));
+}
+
+void SettingsStore::flush_work_handler(struct k_work* work) {
+  auto* dwork = k_work_delayable_from_work(work);
+  auto* store = CONTAINER_OF(dwork, SettingsStore, flush_work_);
+  if (!store->flush()) {
+    store->schedule_flush(kSettingsRetryDelayMs);
+  }
+}
+
+bool SettingsStore::flush() {
+  bool ok = true;
+  uint8_t buf[kMaxSettingsSize];
+  char path[kMaxSettingsPathLen];
+
+  for (SettingsEntryBase* e = entries_; e; e = e->next_) {
+    // Snapshot under the lock, write to flash without holding it
+    k_mutex_lock(&lock_, K_FOREVER);
+    if (!e->dirty_) {
+      k_mutex_unlock(&lock_);
+      continue;
+    }
+    size_t len = e->encoded_len_;
+    memcpy(buf, e->encoded_, len);
+    e->dirty_ = false;
+    k_mutex_unlock(&lock_);
+
+    build_path(path, sizeof(path), e->key_);
+    int ret = settings_save_one(path, buf, len);
+    if (ret != 0) {
+      LOG_ERR("Settings %s: write failed: %d", path, ret);
+      k_mutex_lock(&lock_, K_FOREVER);
+      e->dirty_ = true;
+      k_mutex_unlock(&lock_);
+      ok = false;
+      continue;
+    }
+    flash_writes_++;
+    LOG_INF("Settings %s written (%zu bytes)", path, len);
+  }
+  return ok;
+}
+
+bool SettingsStore::flush_sync() {
+  struct k_work_sync sync;
+  k_work_cancel_delayable_sync(&flush_work_, &sync);
+  return flush();
+}
+
+}  // namespace config
@@ -0,0 +1,194 @@
+// Settings Store - write-behind cache of protobuf messages in Zephyr settings
+// Reads come from RAM, writes are compared against the cached value and
+// flushed to flash in the background
+
+#pragma once
+
+#include <pb_encode.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace config {
+
+class SettingsStore;
+
+// Settings subtree that holds all entries ("app/<settings_key>")
+constexpr const char* kSettingsSubtree = "app";
+// Largest encoded entry
+constexpr size_t kMaxSettingsSize = 256;
+// Delay before dirty entries are written, so bursts are coalesced [ms]
+constexpr uint32_t kSettingsFlushDelayMs = 1000;
+// Retry delay after a failed flash write [ms]
+constexpr uint32_t kSettingsRetryDelayMs = 5000;
+
+/**
+ * @brief Type-erased part of a settings entry
+ *
+ * Holds the decoded value and its canonical protobuf encoding. The encoding
+ * is what gets compared on write and what is stored in flash.
+ */
+class SettingsEntryBase {
+ public:
+  // Non-copyable
+  SettingsEntryBase(const SettingsEntryBase&) = delete;
+  SettingsEntryBase& operator=(const SettingsEntryBase&) = delete;
+
+  const char* key() const { return key_; }
+
+  // True once a value was loaded from flash or set at runtime
+  bool has_value() const { return has_value_; }
+
+ protected:
+  SettingsEntryBase(const char* key, const pb_msgdesc_t* fields, void* value,
+                    size_t value_size, uint8_t* encoded, size_t max_size)
+      : key_(key),
+        fields_(fields),
+        value_(value),
+        value_size_(value_size),
+        encoded_(encoded),
+        max_size_(max_size) {}
+
+  // Copy the cached value out (under the store lock)
+  void read(void* out) const;
+
+  // Replace the cached value if its encoding differs; returns true if changed
+  bool commit(const void* value, const uint8_t* encoded, size_t len);
+
+  const pb_msgdesc_t* fields() const { return fields_; }
+
+ private:
+  friend class SettingsStore;
+
+  const char* key_;
+  const pb_msgdesc_t* fields_;
+  void* value_;
+  size_t value_size_;
+  uint8_t* encoded_;
+  size_t max_size_;
+  size_t encoded_len_ = 0;
+  bool has_value_ = false;
+  bool dirty_ = false;
+  SettingsStore* store_ = nullptr;
+  SettingsEntryBase* next_ = nullptr;
+};
+
+/**
+ * @brief Typed settings entry for a nanopb message
+ *
+ * T must be a statically allocated message (no FT_POINTER / callback fields).
+ *
+ * @tparam T nanopb message struct
+ * @tparam kMaxSize Maximum encoded size (<msg>_size from the .pb.h)
+ */
+template <typename T, size_t kMaxSize>
+class SettingsEntry : public SettingsEntryBase {
+  static_assert(kMaxSize <= kMaxSettingsSize, "Settings message too large");
+
+ public:
+  SettingsEntry(const char* key, const pb_msgdesc_t* fields)
+      : SettingsEntryBase(key, fields, &value_, sizeof(T), encoded_,
+                          kMaxSize),
+        value_{} {}
+
+  // Cached value (no flash access)
+  T get() const {
+    T value;
+    read(&value);
+    return value;
+  }
+
+  /**
+   * @brief Update the cached value
+   *
+   * Unchanged values are ignored; changed values are flushed to flash in the
+   * background.
+   *
+   * @return true if the value changed
+   */
+  bool set(const T& value) {
+    uint8_t buf[kMaxSize > 0 ? kMaxSize : 1];
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, kMaxSize);
+    if (!pb_encode(&stream, fields(), &value)) {
+      return false;
+    }
+    return commit(&value, buf, stream.bytes_written);
+  }
+
+ private:
+  T value_;
+  uint8_t encoded_[kMaxSize > 0 ? kMaxSize : 1];
+};
+
+/**
+ * @brief Owner of all settings entries and the background flush
+ *
+ * Each entry is one settings record. With the NVS backend a record is
+ * committed atomically (data first, then its allocation table entry), so a
+ * power failure during a flush leaves either the old or the new value.
+ */
+class SettingsStore {
+ public:
+  SettingsStore();
+
+  // Non-copyable
+  SettingsStore(const SettingsStore&) = delete;
+  SettingsStore& operator=(const SettingsStore&) = delete;
+
+  /**
+   * @brief Register an entry (before load())
+   */
+  void add(SettingsEntryBase& entry);
+
+  /**
+   * @brief Initialize the settings subsystem and load all entries into RAM
+   *
+   * @return true on success (missing records are not an error)
+   */
+  bool load();
+
+  /**
+   * @brief Write all dirty entries now (e.g. before reboot)
+   *
+   * @return true if everything was written
+   */
+  bool flush();
+
+  /**
+   * @brief Cancel the background flush, wait for a running one, then flush
+   *
+   * Use this before reboot: a plain flush() can race with the workqueue
+   * flush, which could write an older snapshot after the newer one.
+   *
+   * @return true if everything was written
+   */
+  bool flush_sync();
+
+  // Statistics
+  uint32_t skipped_writes() const { return skipped_writes_; }
+  uint32_t flash_writes() const { return flash_writes_; }
+
+ private:
+  friend class SettingsEntryBase;
+
+  void schedule_flush(uint32_t delay_ms);
+  static void flush_work_handler(struct k_work* work);
+  static int settings_set(const char* key, size_t len,
+                          settings_read_cb read_cb, void* cb_arg);
+
+  SettingsEntryBase* entries_ = nullptr;
+  mutable struct k_mutex lock_;
+  struct k_work_delayable flush_work_;
+  struct settings_handler handler_ = {};
+  bool initialized_ = false;
+  uint32_t skipped_writes_ = 0;
+  uint32_t flash_writes_ = 0;
+};
+
+// Global instance (settings handlers have no user context)
+SettingsStore& get_settings_store();
+
+}  // namespace config
@@ -18,6 +18,13 @@ namespace wifi {
 // Static callback structure
 static struct net_mgmt_event_callback wifi_mgmt_cb;
 
+// Work queue for connect_async() (connect() sleeps for seconds, so keep it
+// off the system work queue)
+#define WIFI_WORK_Q_STACK_SIZE 2048
+#define WIFI_WORK_Q_PRIORITY 10
+K_THREAD_STACK_DEFINE(wifi_work_q_stack, WIFI_WORK_Q_STACK_SIZE);
+static struct k_work_q wifi_work_q;
+
 // Global instance
 static WifiManager g_wifi_manager;
 
@@ -65,6 +72,15 @@ bool WifiManager::init() {
   // Register event callbacks
   register_event_callbacks();
 
+  // Start the connect work queue
+  k_mutex_init(&pending_lock_);
+  k_work_init(&connect_work_, connect_work_handler);
+  k_work_queue_init(&wifi_work_q);
+  k_work_queue_start(&wifi_work_q, wifi_work_q_stack,
+                     K_THREAD_STACK_SIZEOF(wifi_work_q_stack),
+                     WIFI_WORK_Q_PRIORITY, NULL);
+  k_thread_name_set(&wifi_work_q.thread, "wifi_work_q");
+
   initialized_ = true;
   LOG_INF("Wi-Fi manager initialized");
   return true;
@@ -199,6 +215,46 @@ bool WifiManager::configure_and_connect(const char* ssid,
   // Connect immediately
   return connect(ssid, password);
 }
+
+bool WifiManager::connect_async(const char* ssid, const char* password) {
+  if (!initialized_) {
+    LOG_ERR("Wi-Fi manager not initialized");
+    return false;
+  }
+
+  if (!ssid || strlen(ssid) == 0 || strlen(ssid) >= sizeof(pending_ssid_) ||
+      strlen(password) >= sizeof(pending_password_)) {
+    LOG_ERR("Invalid SSID or password");
+    return false;
+  }
+
+  k_mutex_lock(&pending_lock_, K_FOREVER);
+  strcpy(pending_ssid_, ssid);
+  strcpy(pending_password_, password);
+  k_mutex_unlock(&pending_lock_);
+
+  // Already queued requests pick up the latest credentials
+  int ret = k_work_submit_to_queue(&wifi_work_q, &connect_work_);
+  if (ret < 0) {
+    LOG_ERR("Failed to queue Wi-Fi connect: %d", ret);
+    return false;
+  }
+  return true;
+}
+
+void WifiManager::connect_work_handler(struct k_work* work) {
+  WifiManager& mgr = get_wifi_manager();
+  char ssid[sizeof(mgr.pending_ssid_)];
+  char password[sizeof(mgr.pending_password_)];
+
+  k_mutex_lock(&mgr.pending_lock_, K_FOREVER);
+  strcpy(ssid, mgr.pending_ssid_);
+  strcpy(password, mgr.pending_password_);
+  k_mutex_unlock(&mgr.pending_lock_);
+
+  mgr.connect(ssid, password);
+}
+
 bool WifiManager::connect(const char* ssid, const char* password) {
   if (!iface_) {
     LOG_ERR("No network interface");
@@ -60,6 +60,26 @@ class WifiManager {
    */
   bool configure_and_connect(const char* ssid, const char* password);
 
+  /**
+   * @brief Connect to a network (blocking: scan + connect request)
+   *
+   * @param ssid SSID to connect to
+   * @param password Password
+   * @return true if connection request sent successfully
+   */
+  bool connect(const char* ssid, const char* password);
+
+  /**
+   * @brief Connect from the Wi-Fi work queue and return immediately
+   *
+   * Credentials are copied; a newer request replaces a pending one.
+   *
+   * @param ssid SSID (max 32 chars)
+   * @param password Password (max 64 chars)
+   * @return true if the request was queued
+   */
+  bool connect_async(const char* ssid, const char* password);
+
   /**
    * @brief Check if currently connected to Wi-Fi
    *
@@ -75,15 +95,6 @@ class WifiManager {
   const char* get_ssid() const { return current_ssid_; }
 
  private:
-  /**
-   * @brief Internal connect method
-   *
-   * @param ssid SSID to connect to
-   * @param password Password
-   * @return true if connection request sent successfully
-   */
-  bool connect(const char* ssid, const char* password);
-
   /**
    * @brief Register net_mgmt event callbacks
    */
@@ -95,6 +106,11 @@ class WifiManager {
   static void wifi_event_handler(struct net_mgmt_event_callback* cb,
                                  uint64_t mgmt_event, struct net_if* iface);
 
+  /**
+   * @brief Work handler for connect_async()
+   */
+  static void connect_work_handler(struct k_work* work);
+
   // State
   bool initialized_ = false;
   bool connected_ = false;
@@ -102,6 +118,12 @@ class WifiManager {
 
   // Network interface
   struct net_if* iface_ = nullptr;
+
+  // Pending connect_async() request
+  struct k_work connect_work_;
+  struct k_mutex pending_lock_;
+  char pending_ssid_[33] = {0};
+  char pending_password_[65] = {0};
 };
 
 // Global instance (singleton pattern for Zephyr callback compatibility)
@@ -12,9 +12,23 @@
 #define ZP_PERIODIC_SCHEDULER_MAX_TASKS 64
 
 /* #undef Z_FEATURE_UNSTABLE_API */
+// CONFIG_APP_ZENOH_SINGLE_THREAD: no read/lease pthreads, the session is
+// driven by ZenohEventLoop (rpc/zenoh_event_loop.h)
+#ifdef CONFIG_APP_ZENOH_SINGLE_THREAD
+#define Z_FEATURE_MULTI_THREAD 0
+#else
 #define Z_FEATURE_MULTI_THREAD 1
+#endif
 #define Z_FEATURE_PUBLICATION 1
+// CONFIG_APP_ZENOH_ADVANCED_PUBLICATION: publication caches for late
+// joiners and gap recovery (PublicationCache in rpc/zenoh_pubsub.h); the
+// advanced publisher is still an unstable zenoh-pico API
+#ifdef CONFIG_APP_ZENOH_ADVANCED_PUBLICATION
+#define Z_FEATURE_UNSTABLE_API
+#define Z_FEATURE_ADVANCED_PUBLICATION 1
+#else
 #define Z_FEATURE_ADVANCED_PUBLICATION 0
+#endif
 #define Z_FEATURE_SUBSCRIPTION 1
 #define Z_FEATURE_ADVANCED_SUBSCRIPTION 0
 #define Z_FEATURE_QUERY 1
@@ -37,7 +51,10 @@
 #define Z_FEATURE_FRAGMENTATION 1
 #define Z_FEATURE_ENCODING_VALUES 1
 #define Z_FEATURE_TCP_NODELAY 1
-#define Z_FEATURE_LOCAL_SUBSCRIBER 0
+// Local publications reach local subscribers (TelemetrySubscriber) without
+// the router. RPCs to local handlers are short-circuited by ZenohRpcChannel
+// itself, which also skips the query, so no local queryable delivery.
+#define Z_FEATURE_LOCAL_SUBSCRIBER 1
 #define Z_FEATURE_LOCAL_QUERYABLE 0
 #define Z_FEATURE_SESSION_CHECK 1
 #define Z_FEATURE_BATCHING 1
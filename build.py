@@ -81,7 +81,7 @@ def run_command(cmd, cwd=None, check=True):
         return False
 
 
-def build(app_path, pristine=False):
+def build(app_path, pristine=False, extra_conf=None):
     """Build the Zephyr application."""
     cmd = ["west", "build", "-b", BOARD]
 
@@ -90,6 +90,10 @@ def build(app_path, pristine=False):
 
     cmd.append(str(app_path))
 
+    # Kconfig fragments on top of prj.conf (e.g. single_thread.conf)
+    if extra_conf:
+        cmd.extend(["--", f"-DEXTRA_CONF_FILE={';'.join(extra_conf)}"])
+
     return run_command(cmd)
 
 
@@ -119,6 +123,7 @@ def generate_proto(app_path):
         f"--plugin=protoc-gen-custom_client={WORKSPACE_ROOT}/generator/gen_client_python.py",
         f"--plugin=protoc-gen-custom_server={WORKSPACE_ROOT}/generator/gen_server_nanopb.py",
         f"--plugin=protoc-gen-nicegui={WORKSPACE_ROOT}/generator/gen_nicegui.py",
+        f"--plugin=protoc-gen-router_config={WORKSPACE_ROOT}/generator/gen_router_config.py",
         f"--proto_path={app_path}",
         f"--proto_path={NANOPB_PROTO_PATH}",
         f"--nanopb_opt=-I{app_path}",
@@ -129,6 +134,7 @@ def generate_proto(app_path):
         f"--custom_client_out={tools_dir}/rpc",
         f"--custom_server_out={app_path}/rpc",
         f"--nicegui_out={tools_dir}/rpc",
+        f"--router_config_out={tools_dir}/rpc",
         str(proto_file),
     ]
 
@@ -226,6 +232,15 @@ def main():
     )
     parser.add_argument("--build-only", action="store_true", help="Only build, don't flash or monitor")
 
+    parser.add_argument(
+        "--extra-conf", action="append", default=[], help="Extra Kconfig fragment in the app directory (repeatable)"
+    )
+    parser.add_argument(
+        "--single-thread",
+        action="store_true",
+        help="Run zenoh-pico from a single event-loop thread (adds single_thread.conf)",
+    )
+
     parser.add_argument("--flash-only", action="store_true", help="Only flash and monitor, don't build")
 
     parser.add_argument("--port", help="Serial port for monitoring (auto-detect if not specified)")
@@ -250,13 +265,17 @@ def main():
         print(f"❌ Application directory not found: {app_path}")
         return 1
 
+    extra_conf = list(args.extra_conf)
+    if args.single_thread:
+        extra_conf.append("single_thread.conf")
+
     # Build
     if not args.flash_only:
         if not generate_proto(app_path):
             return 1
         if args.proto_only:
             return 0
-        if not build(app_path, pristine=args.pristine):
+        if not build(app_path, pristine=args.pristine, extra_conf=extra_conf):
             return 1
 
     # Erase NVS if requested
@@ -7,7 +7,7 @@ import sys
 import os
 from google.protobuf.compiler import plugin_pb2 as plugin
 from google.protobuf.descriptor_pb2 import FieldDescriptorProto
-from util import get_option_value, to_snake_case, find_zenoh_key
+from util import get_option_value, to_snake_case, find_state_key, is_stream, telemetry_key
 
 
 TYPE_MAPPING = {
@@ -20,6 +20,7 @@ TYPE_MAPPING = {
     FieldDescriptorProto.TYPE_BOOL: "bool",
     FieldDescriptorProto.TYPE_STRING: "str",
     FieldDescriptorProto.TYPE_BYTES: "bytes",
+    FieldDescriptorProto.TYPE_ENUM: "Union[int, str]",  # value or value name
 }
 
 
@@ -49,11 +50,30 @@ def generate_code(request, response):
 
         pb_import_path = proto_file.name.replace(".proto", "_pb2").replace("/", ".")
 
+        # Compressed batches of telemetry messages (published on <zenoh_key>/batch)
+        has_batch = any(m.name == "TelemetryBatch" for m in proto_file.message_type)
+
         content = []
         content.append("import logging")
         content.append("from dataclasses import dataclass")
-        content.append("from typing import Callable, Optional, Tuple, Union, List")
-        content.append("from .zenoh_rpc_client import ZenohRpcClient, ZenohSubscriberClient, RpcResult, RpcResponse")
+        content.append("from typing import Callable, Optional, Sequence, Tuple, Union, List")
+        content.append(
+            "from .zenoh_rpc_client import AdvancedSubscription, ZenohRpcClient, ZenohSubscriberClient, RpcResult, "
+            "RpcResponse"
+        )
+        content.append("from .zenoh_attachment import field_mask_attachment")
+        content.append("from .telemetry_stats import TelemetryStats")
+        if has_batch:
+            content.append("from .telemetry_batch import BATCH_SUFFIX, TelemetryColumns, decode_batch_payload")
+        # Versioned state messages mirrored from deltas (state_key option)
+        state_key_value = find_state_key(request)
+        state_msgs = [(m, get_option_value(m.options, state_key_value)) for m in proto_file.message_type]
+        state_msgs = [(m, key) for m, key in state_msgs if key]
+        if state_msgs:
+            content.append("from .state_mirror import StateMirror")
+        # Bidirectional stream methods
+        if any(is_stream(m) for service in proto_file.service for m in service.method):
+            content.append("from .zenoh_stream import BidiStream, DEFAULT_WINDOW")
         content.append(f"from . import {pb_import_path.split('.')[-1]} as pb")
         content.append("")
         content.append("")
@@ -67,24 +87,58 @@ def generate_code(request, response):
             content.append("")
             content.append("    def __init__(self, rpc_client: ZenohRpcClient):")
             content.append("        self.rpc_client = rpc_client")
+            content.append("        # Prepared calls: key expression (and querier) set up once per method")
+            for method in service.method:
+                if is_stream(method):
+                    continue
+                content.append(
+                    f'        self._{to_snake_case(method.name)} = rpc_client.method(self.SERVICE_NAME, "{method.name}")'
+                )
             content.append("")
 
             for method in service.method:
                 method_snake = to_snake_case(method.name)
                 req_cls_name = method.input_type.split(".")[-1]
 
+                if is_stream(method):
+                    resp_cls = method.output_type.split(".")[-1]
+                    content.append(
+                        f"    def open_{method_snake}(self, on_message: Optional[Callable[[pb.{resp_cls}], None]] = None, "
+                        "window: int = DEFAULT_WINDOW) -> BidiStream:"
+                    )
+                    content.append(
+                        f'        """Open a stream of {method.name}: send() {req_cls_name}s, receive {resp_cls}s '
+                        '(on_message or recv())."""'
+                    )
+                    content.append(
+                        f'        return BidiStream.open(self.rpc_client, self.SERVICE_NAME, "{method.name}", '
+                        f"pb.StreamControl, pb.{resp_cls}, on_message, window)"
+                    )
+                    content.append("")
+                    continue
+
                 arg_list_str = f"self, request: Optional[pb.{req_cls_name}] = None"
                 input_msg = msg_map.get(method.input_type)
                 field_assigns = []
 
-                if input_msg and len(input_msg.field) > 0:
+                is_empty = method.output_type.endswith("Empty")
+                resp_cls = method.output_type.split(".")[-1]
+
+                if (input_msg and len(input_msg.field) > 0) or not is_empty:
                     arg_list_str += ", *"
+                if input_msg:
                     for field in input_msg.field:
-                        py_type = TYPE_MAPPING.get(field.type, "Any")
+                        if field.type == FieldDescriptorProto.TYPE_MESSAGE:
+                            py_type = f"pb.{field.type_name.split('.')[-1]}"
+                        else:
+                            py_type = TYPE_MAPPING.get(field.type, "Any")
+                        if field.label == FieldDescriptorProto.LABEL_REPEATED:
+                            py_type = f"Sequence[{py_type}]"
                         arg_list_str += f", {field.name}: Optional[{py_type}] = None"
                         field_assigns.append(f"{field.name}={field.name}")
-
-                is_empty = method.output_type.endswith("Empty")
+                # Response field mask: the device encodes only the named fields
+                if not is_empty:
+                    arg_list_str += ", fields: Optional[Sequence[str]] = None"
                 ret_type = (
                     "RpcResponse"
                     if is_empty
@@ -92,7 +146,12 @@ def generate_code(request, response):
                 )
 
                 content.append(f"    def {method_snake}({arg_list_str}) -> {ret_type}:")
-                content.append(f'        """{method.name} RPC call."""')
+                if is_empty:
+                    content.append(f'        """{method.name} RPC call."""')
+                else:
+                    content.append(
+                        f'        """{method.name} RPC call; fields limits the response to the named fields."""'
+                    )
                 content.append("        if request is None:")
                 if field_assigns:
                     assign_str = ", ".join(field_assigns)
@@ -101,49 +160,90 @@ def generate_code(request, response):
                     content.append(f"            request = pb.{req_cls_name}()")
 
                 content.append("")
-                content.append(
-                    f'        result = self.rpc_client.call(self.SERVICE_NAME, "{method.name}", request.SerializeToString())'
-                )
+                if is_empty:
+                    content.append(f"        result = self._{method_snake}(request.SerializeToString())")
+                else:
+                    content.append(
+                        f"        result = self._{method_snake}(request.SerializeToString(), "
+                        f"field_mask_attachment(pb.{resp_cls}, fields))"
+                    )
 
                 content.append("        if result.success:")
                 if is_empty:
                     content.append("            return RpcResponse(success=True)")
                     content.append("        return RpcResponse(success=False, error=result.error)")
                 else:
-                    resp_cls = method.output_type.split(".")[-1]
                     content.append(f"            response = pb.{resp_cls}()")
                     content.append("            response.ParseFromString(result.data)")
                     content.append("            return RpcResponse(success=True), response")
                     content.append("        return RpcResponse(success=False, error=result.error), None")
                 content.append("")
 
+                # Fast paths: caller-owned messages reused across calls, and encoded bytes in/out
+                if not is_empty:
+                    content.append(
+                        f"    def {method_snake}_into(self, request: pb.{req_cls_name}, response: pb.{resp_cls}, "
+                        "fields: Optional[Sequence[str]] = None) -> RpcResponse:"
+                    )
+                    content.append(
+                        f'        """{method.name} with caller-owned messages, reusable across calls '
+                        '(response is parsed in place)."""'
+                    )
+                    content.append(
+                        f"        result = self._{method_snake}(request.SerializeToString(), "
+                        f"field_mask_attachment(pb.{resp_cls}, fields))"
+                    )
+                    content.append("        if result.success:")
+                    content.append("            response.ParseFromString(result.data)")
+                    content.append("            return RpcResponse(success=True)")
+                    content.append("        return RpcResponse(success=False, error=result.error)")
+                    content.append("")
+                content.append(
+                    f"    def {method_snake}_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:"
+                )
+                content.append(
+                    f'        """{method.name} with an encoded {req_cls_name}; result.data is the encoded {resp_cls}."""'
+                )
+                content.append(f"        return self._{method_snake}(payload, attachment)")
+                content.append("")
+
         # ---------------------------------------------------------
         # 2. Telemetry Subscriber
         # ---------------------------------------------------------
         telemetry_msgs = [m for m in proto_file.message_type if m.name.endswith("Telemetry")]
 
         if telemetry_msgs:
+            # Topic suffix -> message class, for generic tools (recorder, dashboards)
+            content.append("TELEMETRY_TOPICS = {")
+            for msg in telemetry_msgs:
+                content.append(f'    "{telemetry_key(request, msg)}": pb.{msg.name},')
+            content.append("}")
+            content.append("")
+            content.append("")
             content.append("class TelemetrySubscriber:")
             content.append('    """Subscriber for telemetry data from device."""')
             content.append("")
             content.append(
-                "    def __init__(self, sub_client: ZenohSubscriberClient, device_id: str, logger: Optional[logging.Logger] = None):"
+                "    def __init__(self, sub_client: ZenohSubscriberClient, device_id: str, logger: Optional[logging.Logger] = None,"
+            )
+            content.append(
+                "                 stats: Optional[TelemetryStats] = None, advanced: Optional[AdvancedSubscription] = None):"
             )
             content.append("        self.sub_client = sub_client")
             content.append("        self.device_id = device_id")
             content.append("        self._sub_ids: List[str] = []")
             content.append("        self.logger = logger or logging.getLogger(__name__)")
+            content.append("        # Sequence/latency accounting from the sample attachments (optional)")
+            content.append("        self.stats = stats")
+            content.append("        # Late-joiner history / gap recovery from the device publication cache")
+            content.append("        self.advanced = advanced")
             content.append("")
 
             for msg in telemetry_msgs:
                 base_name = msg.name.replace("Telemetry", "")
                 snake_name = to_snake_case(base_name)
 
-                # Extract zenoh_key from custom options (field number 50001)
-                zenoh_key = get_option_value(msg.options, find_zenoh_key(request))
-                # Use default key if not specified
-                if not zenoh_key:
-                    zenoh_key = f"/telemetry/{snake_name}"
+                zenoh_key = telemetry_key(request, msg)
 
                 type_hint = f"Callable[[pb.{msg.name}], None]"
                 content.append(f"    def subscribe_{snake_name}(self, callback: {type_hint}):")
@@ -151,7 +251,9 @@ def generate_code(request, response):
                 content.append(f'        key_expr = f"{{self.device_id}}{zenoh_key}"')
                 content.append(f'        self.logger.info(f"Subscribing to: {{key_expr}}")')
                 content.append("")
-                content.append(f"        def handler(data: bytes):")
+                content.append(f"        def handler(key: str, data: bytes, attachment: Optional[bytes]):")
+                content.append(f"            if self.stats is not None:")
+                content.append(f"                self.stats.observe(key, attachment)")
                 content.append(f"            try:")
                 content.append(f"                payload = pb.{msg.name}()")
                 content.append(f"                payload.ParseFromString(data)")
@@ -159,7 +261,30 @@ def generate_code(request, response):
                 content.append(f"            except Exception as e:")
                 content.append(f'                self.logger.error(f"Failed to parse {msg.name}: {{e}}")')
                 content.append("")
-                content.append(f"        sub_id = self.sub_client.subscribe(key_expr, handler)")
+                content.append(f"        sub_id = self.sub_client.subscribe_sample(key_expr, handler, advanced=self.advanced)")
+                content.append(f"        self._sub_ids.append(sub_id)")
+                content.append("")
+
+                if not has_batch:
+                    continue
+                content.append(
+                    f"    def subscribe_{snake_name}_batch(self, callback: Callable[[TelemetryColumns], None]):"
+                )
+                content.append(f'        """Subscribe to compressed {snake_name} telemetry batches (decoded per column)."""')
+                content.append(f'        key_expr = f"{{self.device_id}}{zenoh_key}{{BATCH_SUFFIX}}"')
+                content.append(f'        self.logger.info(f"Subscribing to: {{key_expr}}")')
+                content.append("")
+                content.append(f"        def handler(key: str, data: bytes, attachment: Optional[bytes]):")
+                content.append(f"            if self.stats is not None:")
+                content.append(f"                self.stats.observe(key, attachment)")
+                content.append(f"            try:")
+                content.append(f"                columns = decode_batch_payload(data, pb.{msg.name})")
+                content.append(f"            except Exception as e:")
+                content.append(f'                self.logger.error(f"Failed to decode {msg.name} batch: {{e}}")')
+                content.append(f"                return")
+                content.append(f"            callback(columns)")
+                content.append("")
+                content.append(f"        sub_id = self.sub_client.subscribe_sample(key_expr, handler, advanced=self.advanced)")
                 content.append(f"        self._sub_ids.append(sub_id)")
                 content.append("")
 
@@ -171,6 +296,30 @@ def generate_code(request, response):
             content.append('        self.logger.info("Unsubscribed from all telemetry topics")')
             content.append("")
 
+        # ---------------------------------------------------------
+        # 3. State mirrors (state_key option)
+        # ---------------------------------------------------------
+        if state_msgs:
+            content.append("")
+            content.append("STATE_TOPICS = {")
+            for msg, key in state_msgs:
+                content.append(f'    "{key}": pb.{msg.name},')
+            content.append("}")
+            for msg, key in state_msgs:
+                content.append("")
+                content.append("")
+                content.append(f"def mirror_{to_snake_case(msg.name)}(")
+                content.append("    rpc_client: ZenohRpcClient,")
+                content.append("    sub_client: ZenohSubscriberClient,")
+                content.append("    device_id: str,")
+                content.append(f"    on_change: Optional[Callable[[pb.{msg.name}, List[str]], None]] = None,")
+                content.append(") -> StateMirror:")
+                content.append(f'    """Local copy of the device {msg.name}, kept up to date from deltas (call start())."""')
+                content.append(
+                    f'    return StateMirror(rpc_client, sub_client, device_id, "{key}", pb.{msg.name}, on_change)'
+                )
+            content.append("")
+
         f.content = "\n".join(content)
 
 
@@ -7,7 +7,7 @@ import sys
 import os
 from google.protobuf.compiler import plugin_pb2 as plugin
 from google.protobuf.descriptor_pb2 import FieldDescriptorProto
-from util import to_snake_case
+from util import is_stream, to_snake_case
 
 
 TYPE_MAPPING = {
@@ -33,6 +33,140 @@ def get_message_map(proto_file):
     return msg_map
 
 
+def get_enum_map(proto_file):
+    """Creates a map of fully qualified enum names to their descriptors."""
+    package = proto_file.package
+    enum_map = {}
+    for enum in proto_file.enum_type:
+        full_name = "." + package + "." + enum.name if package else "." + enum.name
+        enum_map[full_name] = enum
+    return enum_map
+
+
+def generate_fleet_ui(telemetry_msgs):
+    """
+    create_fleet_ui(): every device publishing telemetry in one virtualized table.
+
+    One wildcard subscription per telemetry topic (FleetTable); the rows changed since the previous frame are applied
+    to the grid in one transaction per frame. A row click subscribes to that device's logs and telemetry.
+    """
+    columns = ["device_id"]
+    for msg in telemetry_msgs:
+        for field in msg.field:
+            if field.label != FieldDescriptorProto.LABEL_REPEATED and field.type in TYPE_MAPPING:
+                if field.name not in columns:
+                    columns.append(field.name)
+    columns += ["samples", "last_seen"]
+
+    content = [
+        "",
+        "",
+        "# Fleet table refresh interval (batched row updates)",
+        "FLEET_FRAME_S = 0.25",
+        "",
+        "",
+        "def create_fleet_ui(zenoh_client):",
+        "    sub_client = ZenohSubscriberClient(zenoh_client.session)",
+        "    fleet = FleetTable(sub_client, service_client.TELEMETRY_TOPICS)",
+        "    detail_subs = []",
+        "    selected = {'device_id': None}",
+        "    rate = {'time': time.monotonic(), 'samples': 0}",
+        "",
+        "    with ui.row().classes('w-full items-start flex-nowrap'):",
+        "        # --- Left Column: Devices --- ",
+        "        with ui.column().classes('flex-grow p-2'):",
+        "            summary = ui.label('Waiting for telemetry...').classes('text-sm text-gray-600')",
+        "            # AG Grid renders only the visible rows; rows are identified by device ID for updates",
+        "            grid = ui.aggrid({",
+        "                'columnDefs': [",
+    ]
+    for column in columns:
+        header = "Device ID" if column == "device_id" else column.replace("_", " ").capitalize()
+        content.append(
+            f"                    {{'headerName': '{header}', 'field': '{column}', 'sortable': True, 'filter': True}},"
+        )
+    content.extend(
+        [
+            "                ],",
+            "                'rowData': [],",
+            "                ':getRowId': '(params) => params.data.device_id',",
+            "                'animateRows': False,",
+            "            }).classes('w-full h-[calc(100vh-120px)]')",
+            "",
+            "        # --- Right Column: Selected Device --- ",
+            "        with ui.column().classes('w-[400px] p-2'):",
+            "            with ui.row().classes('w-full items-center justify-between'):",
+            "                detail_title = ui.label('Select a device').classes('text-xl font-bold')",
+            "                open_button = ui.button('Open', on_click=lambda: open_device()).props('dense flat icon=open_in_new')",
+            "                open_button.set_visibility(False)",
+            "            detail_view = ui.log(max_lines=500).classes('w-full h-[calc(100vh-100px)] bg-gray-900 text-white font-mono text-xs')",
+            "",
+            "    def flush():",
+            "        added, changed = fleet.drain()",
+            "        if added or changed:",
+            "            grid.run_grid_method('applyTransaction', {'add': added, 'update': changed})",
+            "        now = time.monotonic()",
+            "        if now - rate['time'] >= 1.0:",
+            "            samples_per_s = (fleet.stats.samples - rate['samples']) / (now - rate['time'])",
+            "            rate.update(time=now, samples=fleet.stats.samples)",
+            "            summary.set_text(",
+            "                f'{len(fleet.rows)} devices, {samples_per_s:.0f} samples/s, '",
+            "                f'{fleet.stats.coalesced} coalesced, {fleet.stats.errors} errors'",
+            "            )",
+            "",
+            "    def detail_message(msg):",
+            "        ts = datetime.now().strftime('%H:%M:%S.%f')[:-3]",
+            "        detail_view.push(f'[{ts}] {msg}')",
+            "",
+            "    def select(event):",
+            "        device_id = event.args['data']['device_id']",
+            "        if device_id == selected['device_id']:",
+            "            return",
+            "        # Per-device subscriptions only for the selected device",
+            "        for sub in detail_subs:",
+            "            if hasattr(sub, 'unsubscribe'): sub.unsubscribe()",
+            "            if hasattr(sub, 'unsubscribe_all'): sub.unsubscribe_all()",
+            "        detail_subs.clear()",
+            "        selected['device_id'] = device_id",
+            "        detail_title.set_text(device_id)",
+            "        open_button.set_visibility(True)",
+            "        detail_view.clear()",
+            "        log_sub = LogSubscriber(sub_client, device_id)",
+            "        log_sub.subscribe(lambda msg: detail_message(f'[LOG] {msg}'))",
+            "        detail_subs.append(log_sub)",
+            "        tel_sub = service_client.TelemetrySubscriber(sub_client, device_id)",
+        ]
+    )
+    for msg in telemetry_msgs:
+        method_name = "subscribe_" + to_snake_case(msg.name.replace("Telemetry", ""))
+        content.append(f"        tel_sub.{method_name}(")
+        content.append(
+            f"            lambda data: detail_message(f'[TEL] {msg.name}: "
+            "{json.dumps(MessageToDict(data, preserving_proto_field_name=True))}')"
+        )
+        content.append("        )")
+    content.extend(
+        [
+            "        detail_subs.append(tel_sub)",
+            "",
+            "    def open_device():",
+            "        # The device page reads its device ID from the user storage",
+            "        app.storage.user['device_id'] = selected['device_id']",
+            "        ui.navigate.to('/')",
+            "",
+            "    def close():",
+            "        fleet.unsubscribe()",
+            "        sub_client.unsubscribe_all()",
+            "",
+            "    grid.on('cellClicked', select)",
+            "    fleet.subscribe()",
+            "    ui.timer(FLEET_FRAME_S, flush)",
+            "    ui.context.client.on_disconnect(close)",
+        ]
+    )
+    return content
+
+
 def generate_code(request, response):
     """Generates the NiceGUI application code."""
     files_to_generate = set(request.file_to_generate)
@@ -42,6 +176,7 @@ def generate_code(request, response):
             continue
 
         msg_map = get_message_map(proto_file)
+        enum_map = get_enum_map(proto_file)
         proto_filename_base = os.path.basename(proto_file.name).replace(".proto", "")
 
         f = response.file.add()
@@ -51,6 +186,7 @@ def generate_code(request, response):
             "#!/usr/bin/env python3",
             "import asyncio",
             "import json",
+            "import time",
             "from datetime import datetime",
             "from functools import partial",
             "from google.protobuf.json_format import MessageToDict",
@@ -60,6 +196,11 @@ def generate_code(request, response):
             "from . import " + proto_filename_base + "_client as service_client",
             "from . import " + proto_filename_base + "_pb2 as pb",
             "from .zenoh_rpc_client import ZenohSubscriberClient, LogSubscriber",
+        ]
+        telemetry_msgs = [msg for msg in proto_file.message_type if msg.name.endswith("Telemetry")]
+        if telemetry_msgs:
+            content.append("from .fleet_view import FleetTable")
+        content += [
             "",
             "def create_ui(zenoh_client, default_device_id='pico2w-001'):",
             "    # Subscriber Client",
@@ -95,9 +236,13 @@ def generate_code(request, response):
             content.append("                with ui.grid(columns=3).classes('w-full gap-4'):")
 
             for method in service.method:
+                if is_stream(method):
+                    continue  # streams need a live session, not a form
                 method_snake = to_snake_case(method.name)
 
                 input_msg_def = msg_map.get(method.input_type)
+                if input_msg_def and any(f.type == FieldDescriptorProto.TYPE_MESSAGE for f in input_msg_def.field):
+                    continue  # nested messages (e.g. RuleSet): no form, use the Python client
 
                 has_input = input_msg_def and len(input_msg_def.field) > 0
 
@@ -139,7 +284,25 @@ def generate_code(request, response):
                                 + "')"
                             )
 
-                        if field_type == "bool":
+                        if field.type == FieldDescriptorProto.TYPE_ENUM and field.type_name in enum_map:
+                            # Select by value name (protobuf accepts enum names)
+                            names = [v.name for v in enum_map[field.type_name].value]
+                            content.append(
+                                "                                inputs_"
+                                + method_snake
+                                + "['"
+                                + field.name
+                                + "'] = ui.select("
+                                + repr(names)
+                                + ", label='"
+                                + label
+                                + "', value='"
+                                + names[0]
+                                + "').classes('w-full')"
+                                + bind_suffix
+                            )
+
+                        elif field_type == "bool":
                             content.append(
                                 "                                inputs_"
                                 + method_snake
@@ -338,7 +501,6 @@ def generate_code(request, response):
         )
 
         # Telemetry Logic
-        telemetry_msgs = [msg for msg in proto_file.message_type if msg.name.endswith("Telemetry")]
         if telemetry_msgs:
             content.append("        # 2. Telemetry")
             content.append("        tel_sub = service_client.TelemetrySubscriber(sub_client, device_id_input.value)")
@@ -367,6 +529,9 @@ def generate_code(request, response):
             ]
         )
 
+        if telemetry_msgs:
+            content.extend(generate_fleet_ui(telemetry_msgs))
+
         f.content = "\n".join(content)
 
 
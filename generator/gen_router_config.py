@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+Generator for the router limits of the telemetry topics (max_rate / max_payload options).
+
+Output: router_limits.py, per consumer class the downsampling and low-pass rules of each telemetry topic.
+tools/start_router.py maps the classes to network interfaces and passes the rules to zenohd.
+"""
+
+import sys
+from google.protobuf.compiler import plugin_pb2 as plugin
+from util import find_max_payload, find_max_rate, get_option_value, telemetry_key
+
+
+def parse_limits(msg_name, option_name, text, value_type):
+    """'wan=1,lan=10' -> {'wan': 1, 'lan': 10}"""
+    limits = {}
+    for item in text.split(","):
+        consumer, _, value = (part.strip() for part in item.partition("="))
+        try:
+            limit = value_type(value)
+        except ValueError:
+            limit = None
+        if not consumer or limit is None or limit <= 0:
+            raise ValueError(f"{msg_name}: invalid {option_name} '{item.strip()}' (expected <class>=<value>)")
+        limits[consumer] = limit
+    return limits
+
+
+def generate_code(request, response):
+    files_to_generate = set(request.file_to_generate)
+    max_rate_number = find_max_rate(request)
+    max_payload_number = find_max_payload(request)
+
+    for proto_file in request.proto_file:
+        if proto_file.name not in files_to_generate:
+            continue
+
+        downsampling = {}
+        low_pass = {}
+        for msg in proto_file.message_type:
+            if not msg.name.endswith("Telemetry"):
+                continue
+            key_expr = "*" + telemetry_key(request, msg)
+            max_rate = get_option_value(msg.options, max_rate_number)
+            if max_rate:
+                for consumer, hz in parse_limits(msg.name, "max_rate", max_rate, float).items():
+                    downsampling.setdefault(consumer, []).append((key_expr, hz))
+            max_payload = get_option_value(msg.options, max_payload_number)
+            if max_payload:
+                for consumer, size in parse_limits(msg.name, "max_payload", max_payload, int).items():
+                    # Batches of the topic are published on <key>/batch
+                    low_pass.setdefault(consumer, []).append((key_expr, size))
+                    low_pass[consumer].append((key_expr + "/batch", size))
+
+        content = [
+            '"""',
+            "Router limits of the telemetry topics per consumer class (generated from the max_rate / max_payload",
+            "options in " + proto_file.name + "). tools/start_router.py turns them into zenohd configuration.",
+            '"""',
+            "",
+            "# Consumer class -> [(key expression, samples per second)]",
+            "DOWNSAMPLING = {",
+        ]
+        for consumer, rules in sorted(downsampling.items()):
+            content.append(f'    "{consumer}": [')
+            for key_expr, hz in rules:
+                content.append(f'        ("{key_expr}", {hz!r}),')
+            content.append("    ],")
+        content.append("}")
+        content.append("")
+        content.append("# Consumer class -> [(key expression, largest payload in bytes)]")
+        content.append("LOW_PASS = {")
+        for consumer, rules in sorted(low_pass.items()):
+            content.append(f'    "{consumer}": [')
+            for key_expr, size in rules:
+                content.append(f'        ("{key_expr}", {size}),')
+            content.append("    ],")
+        content.append("}")
+        content.append("")
+
+        f = response.file.add()
+        f.name = "router_limits.py"
+        f.content = "\n".join(content)
+
+
+if __name__ == "__main__":
+    data = sys.stdin.buffer.read()
+    request = plugin.CodeGeneratorRequest()
+    request.ParseFromString(data)
+    response = plugin.CodeGeneratorResponse()
+    generate_code(request, response)
+    sys.stdout.buffer.write(response.SerializeToString())
@@ -7,7 +7,18 @@ import sys
 import os
 from google.protobuf.compiler import plugin_pb2 as plugin
 from google.protobuf.descriptor_pb2 import FileDescriptorProto
-from util import to_snake_case, get_option_value, find_zenoh_key
+from util import (
+    to_snake_case,
+    get_option_int,
+    get_option_value,
+    find_zenoh_key,
+    find_settings_key,
+    find_state_key,
+    find_time_budget,
+    find_max_interval,
+    find_max_batch,
+    is_stream,
+)
 
 
 def get_nanopb_type_name(proto_package, msg_name):
@@ -148,10 +159,23 @@ def generate_code(request, response):
         h_content.append("")
         h_content.append('#include "zenoh_rpc_channel.h"')
         h_content.append(f'#include "{os.path.basename(proto_file.name).replace(".proto", ".pb.h")}"')  # Nanopb header
+        # Bidirectional stream methods: handshake with StreamControl, messages on zenoh_rpc::StreamTable
+        has_streams = any(is_stream(m) for service in proto_file.service for m in service.method)
+        if has_streams:
+            if not any(m.name == "StreamControl" for m in proto_file.message_type):
+                raise ValueError("Stream methods need a StreamControl message (stream_id, window, close)")
+            control_type = get_nanopb_type_name(package, "StreamControl")
+            h_content.append('#include "zenoh_stream.h"')
+            h_content.append("")
+            h_content.append("#if Z_FEATURE_SUBSCRIPTION != 1")
+            h_content.append('#error "Stream methods need Z_FEATURE_SUBSCRIPTION"')
+            h_content.append("#endif")
         h_content.append("")
 
-        # Emit #define for messages that have the custom zenoh_key option
+        # Emit #define for messages that have the custom zenoh_key option, and for the limits of their adaptive
+        # publish rate (max_interval_ms / max_batch options, zenoh_rpc::RateControlConfig)
         zenoh_key_value = find_zenoh_key(request)
+        rate_limit_options = [("MAX_INTERVAL_MS", find_max_interval(request)), ("MAX_BATCH", find_max_batch(request))]
         for msg in proto_file.message_type:
             try:
                 zenoh_key = get_option_value(msg.options, zenoh_key_value)
@@ -159,11 +183,30 @@ def generate_code(request, response):
                 zenoh_key = None
             if zenoh_key:
                 pkg_prefix = package.replace(".", "_").upper() if package else ""
-                macro_name = f"{pkg_prefix + '_' if pkg_prefix else ''}{to_snake_case(msg.name).upper()}_ZENOH_KEY"
-                h_content.append(f'#define {macro_name} "{zenoh_key}"')
+                macro_prefix = f"{pkg_prefix + '_' if pkg_prefix else ''}{to_snake_case(msg.name).upper()}"
+                h_content.append(f'#define {macro_prefix}_ZENOH_KEY "{zenoh_key}"')
+                for suffix, number in rate_limit_options:
+                    limit = get_option_int(msg.options, number)
+                    if limit is not None:
+                        h_content.append(f"#define {macro_prefix}_{suffix} {limit}")
         if any(get_option_value(m.options, zenoh_key_value) for m in proto_file.message_type):
             h_content.append("")
 
+        # State messages (state_key option): deltas and snapshots via zenoh_rpc::StateSync
+        state_key_value = find_state_key(request)
+        state_msgs = [(m, get_option_value(m.options, state_key_value)) for m in proto_file.message_type]
+        state_msgs = [(m, key) for m, key in state_msgs if key]
+        for msg, key in state_msgs:
+            if msg.name in messages_with_pointers:
+                raise ValueError(f"{msg.name}: state messages must be statically allocated (no FT_POINTER)")
+            if any(field.number > 64 for field in msg.field):
+                raise ValueError(f"{msg.name}: state message field numbers must be <= 64 (changed-field mask)")
+            pkg_prefix = package.replace(".", "_").upper() if package else ""
+            macro_name = f"{pkg_prefix + '_' if pkg_prefix else ''}{to_snake_case(msg.name).upper()}_STATE_KEY"
+            h_content.append(f'#define {macro_name} "{key}"')
+        if state_msgs:
+            h_content.append("")
+
         h_content.append(f"namespace {cpp_namespace} {{")
         h_content.append("")
 
@@ -173,14 +216,29 @@ def generate_code(request, response):
             h_content.append(f"class {service.name} {{")
             h_content.append(" public:")
             h_content.append(f"  virtual ~{service.name}() = default;")
+            if any(not is_stream(m) for m in service.method):
+                h_content.append("  // ctx: context of the call being served, e.g. to skip computing response")
+                h_content.append("  // fields the client did not ask for: ctx.wants(<field>_tag), or to stop")
+                h_content.append("  // long work at the deadline: ctx.cancelled() (return TIMEOUT). Calls may")
+                h_content.append("  // run concurrently on several threads, each with its own context")
 
             for method in service.method:
                 req_type = get_nanopb_type_name(package, method.input_type.split(".")[-1])
                 res_type = get_nanopb_type_name(package, method.output_type.split(".")[-1])
+                if is_stream(method):
+                    h_content.append(f"  // {method.name} stream: called for every message received; reply with any")
+                    h_content.append("  // number of stream.send() (false without credit from the client)")
+                    h_content.append(
+                        f"  virtual zenoh_rpc::RpcStatus {method.name}(const {req_type}& req, "
+                        f"zenoh_rpc::StreamWriter<{res_type}>& stream) = 0;"
+                    )
+                    h_content.append("  // Called once a stream closed (by the client or after idling)")
+                    h_content.append(f"  virtual void {method.name}Closed(uint32_t /*stream_id*/) {{}}")
+                    continue
                 h_content.append(
-                    f"  virtual zenoh_rpc::RpcStatus {method.name}(const {req_type}& req, {res_type}* resp) = 0;"
+                    f"  virtual zenoh_rpc::RpcStatus {method.name}(const {req_type}& req, {res_type}* resp, "
+                    "const zenoh_rpc::RpcContext& ctx) = 0;"
                 )
-
             h_content.append("};")
             h_content.append("")
 
@@ -199,9 +257,47 @@ def generate_code(request, response):
             # Handler method declarations
             for method in service.method:
                 h_content.append(
-                    f"  zenoh_rpc::RpcStatus handle_{method.name}(pb_istream_t* req_stream, pb_ostream_t* resp_stream);"
+                    f"  zenoh_rpc::RpcStatus handle_{method.name}(pb_istream_t* req_stream, pb_ostream_t* resp_stream, "
+                    "const zenoh_rpc::RpcContext& ctx);"
                 )
 
+            for method in service.method:
+                if not is_stream(method):
+                    continue
+                h_content.append("")
+                h_content.append(f"  // {method.name} streams (handle_{method.name} opens and closes them)")
+                h_content.append(
+                    f"  static zenoh_rpc::RpcStatus receive_{method.name}(void* context, zenoh_rpc::StreamPort& port, "
+                    "pb_istream_t* in);"
+                )
+                h_content.append(f"  static void closed_{method.name}(void* context, uint32_t stream_id);")
+                h_content.append(f"  zenoh_rpc::StreamTable {to_snake_case(method.name)}_streams_;")
+
+            h_content.append("};")
+            h_content.append("")
+
+            # On-device client: structs to a local implementation, else encoded over the channel
+            h_content.append(f"// On-device client for {service.name}: calls the implementation served on the")
+            h_content.append("// same channel directly with the structs (caller's thread, no encoding),")
+            h_content.append("// otherwise encodes the call and sends it through the router.")
+            h_content.append("// Responses with FT_POINTER fields must be released with pb_release().")
+            h_content.append(f"class {service.name}Client {{")
+            h_content.append(" public:")
+            h_content.append(f"  explicit {service.name}Client(zenoh_rpc::ZenohRpcChannel& channel) : channel_(channel) {{}}")
+            h_content.append("")
+            for method in service.method:
+                if is_stream(method):
+                    continue  # host clients only
+                req_type = get_nanopb_type_name(package, method.input_type.split(".")[-1])
+                res_type = get_nanopb_type_name(package, method.output_type.split(".")[-1])
+                h_content.append(
+                    f"  zenoh_rpc::RpcStatus {method.name}(const {req_type}& req, {res_type}* resp, "
+                    "uint32_t timeout_ms = 5000);"
+                )
+            h_content.append("")
+            h_content.append(" private:")
+            h_content.append("  zenoh_rpc::ZenohRpcChannel& channel_;")
+            h_content.append(f'  static constexpr const char* kServiceName = "{service.name}";')
             h_content.append("};")
             h_content.append("")
 
@@ -215,7 +311,10 @@ def generate_code(request, response):
         c_content.append("#include <pb_encode.h>")
         c_content.append("#include <pb_decode.h>")
         c_content.append("#include <pb_common.h>")
+        c_content.append("#include <cstring>")
+        c_content.append('#include "alloc_guard.h"')
         c_content.append('#include "log_wrapper.h"')
+        c_content.append('#include "message_pool.h"')
         c_content.append("")
         # Module registration (create unique name from filename)
         module_name = os.path.basename(proto_file.name).replace(".proto", "_server").replace(".", "_")
@@ -226,12 +325,45 @@ def generate_code(request, response):
         c_content.append(f"namespace {cpp_namespace} {{")
         c_content.append("")
 
+        # Handler message storage: one union per service, so a pool slot fits the largest request/response pair
+        c_content.append("namespace {")
+        c_content.append("")
+        for service in proto_file.service:
+            c_content.append(f"// Request and response of one running {service.name} handler (message_pool.h)")
+            c_content.append(f"union {service.name}Messages {{")
+            for method in service.method:
+                req_type = get_nanopb_type_name(package, method.input_type.split(".")[-1])
+                res_type = get_nanopb_type_name(package, method.output_type.split(".")[-1])
+                c_content.append("  struct {")
+                c_content.append(f"    {req_type} request;")
+                c_content.append(f"    {res_type} response;")
+                c_content.append(f"  }} {method.name};")
+            c_content.append("};")
+            c_content.append(
+                f"zenoh_rpc::MessagePool<{service.name}Messages, zenoh_rpc::kHandlerSlots> "
+                f"{to_snake_case(service.name)}_messages;"
+            )
+            c_content.append("")
+        c_content.append("}  // namespace")
+        c_content.append("")
+
         for service in proto_file.service:
             # Constructor
             c_content.append(
                 f"{service.name}Server::{service.name}Server(zenoh_rpc::ZenohRpcChannel& channel, {service.name}& impl)"
             )
-            c_content.append("    : channel_(channel), impl_(impl) {}")
+            stream_members = [
+                f"{to_snake_case(m.name)}_streams_(channel, receive_{m.name}, closed_{m.name}, this)"
+                for m in service.method
+                if is_stream(m)
+            ]
+            if stream_members:
+                c_content.append("    : channel_(channel),")
+                c_content.append("      impl_(impl),")
+                for i, member in enumerate(stream_members):
+                    c_content.append(f"      {member}{',' if i + 1 < len(stream_members) else ' {}'}")
+            else:
+                c_content.append("    : channel_(channel), impl_(impl) {}")
             c_content.append("")
 
             # register_handlers
@@ -239,15 +371,26 @@ def generate_code(request, response):
             c_content.append("  bool success = true;")
             c_content.append("")
 
+            time_budget_value = find_time_budget(request)
             for method in service.method:
+                budget_ms = get_option_int(method.options, time_budget_value)
                 c_content.append(f"  // {method.name}")
                 c_content.append(f"  success &= channel_.register_handler(")
                 c_content.append(f'      kServiceName, "{method.name}",')
-                c_content.append(f"      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream) {{")
-                c_content.append(f"        return handle_{method.name}(req_stream, resp_stream);")
-                c_content.append(f"      }});")
+                c_content.append(
+                    f"      [this](pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {{"
+                )
+                c_content.append(f"        return handle_{method.name}(req_stream, resp_stream, ctx);")
+                if budget_ms:
+                    c_content.append(f"      }},")
+                    c_content.append(f"      {budget_ms});  // time_budget_ms")
+                else:
+                    c_content.append(f"      }});")
                 c_content.append("")
 
+            c_content.append("  // On-device callers (" + service.name + "Client) call impl_ directly")
+            c_content.append("  success &= channel_.register_local_service(kServiceName, &impl_);")
+            c_content.append("")
             c_content.append("  if (success) {")
             c_content.append(f'    LOG_INF("All {service.name} handlers registered");')
             c_content.append("  } else {")
@@ -268,22 +411,52 @@ def generate_code(request, response):
                 req_needs_release = req_msg_name in messages_with_pointers
                 res_needs_release = res_msg_name in messages_with_pointers
 
+                if is_stream(method):
+                    c_content.extend(
+                        generate_stream_handlers(
+                            service, method, req_type, res_type, control_type, req_needs_release, res_needs_release
+                        )
+                    )
+                    continue
+
                 c_content.append(f"zenoh_rpc::RpcStatus {service.name}Server::handle_{method.name}(")
-                c_content.append("    pb_istream_t* req_stream, pb_ostream_t* resp_stream) {")
+                c_content.append(
+                    "    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {"
+                )
+                c_content.append("  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);")
+
+                # Storage from the pool (not the stack of the calling task)
+                c_content.append(
+                    f"  zenoh_rpc::PooledMessage<{service.name}Messages, zenoh_rpc::kHandlerSlots> "
+                    f"slot({to_snake_case(service.name)}_messages);"
+                )
+                c_content.append("  if (!slot) {")
+                c_content.append(f'    LOG_ERR("No free message slot for {method.name}");')
+                c_content.append("    return zenoh_rpc::RpcStatus::BUSY;")
+                c_content.append("  }")
+                c_content.append(f"  memset(&slot->{method.name}, 0, sizeof(slot->{method.name}));  // *_init_zero")
+                c_content.append(f"  {req_type}& request = slot->{method.name}.request;")
+                c_content.append(f"  {res_type}& response = slot->{method.name}.response;")
+                c_content.append("")
 
                 # Decode
                 c_content.append("  // Decode request")
-                c_content.append(f"  {req_type} request = {req_type}_init_zero;")
                 c_content.append(f"  if (!pb_decode(req_stream, {req_type}_fields, &request)) {{")
                 c_content.append(f'    LOG_ERR("Failed to decode {method.input_type.split(".")[-1]}");')
                 c_content.append("    return zenoh_rpc::RpcStatus::DECODE_ERROR;")
                 c_content.append("  }")
+                c_content.append("  if (ctx.cancelled()) {")
+                if req_needs_release:
+                    c_content.append(f"    pb_release({req_type}_fields, &request);")
+                c_content.append("    return zenoh_rpc::RpcStatus::TIMEOUT;")
+                c_content.append("  }")
+                c_content.append("  // Timed call (EXECUTE_AT_US): decoded ahead, runs at the target time")
+                c_content.append("  ctx.wait_until_start();")
                 c_content.append("")
 
                 # Call Implementation
                 c_content.append("  // Call implementation")
-                c_content.append(f"  {res_type} response = {res_type}_init_zero;")
-                c_content.append(f"  zenoh_rpc::RpcStatus status = impl_.{method.name}(request, &response);")
+                c_content.append(f"  zenoh_rpc::RpcStatus status = impl_.{method.name}(request, &response, ctx);")
                 c_content.append("  if (status != zenoh_rpc::RpcStatus::OK) {")
                 if req_needs_release:
                     c_content.append(f"    pb_release({req_type}_fields, &request);")
@@ -292,8 +465,12 @@ def generate_code(request, response):
                 c_content.append("")
 
                 # Encode
-                c_content.append("  // Encode response directly to stream (zero-copy)")
-                c_content.append(f"  if (!pb_encode(resp_stream, {res_type}_fields, &response)) {{")
+                c_content.append("  // Encode response directly to stream (zero-copy), selected fields only")
+                # Pointer fields must survive masking for pb_release (masks a shallow copy)
+                encode_fn = "encode_response" if res_needs_release else "encode_response_in_place"
+                c_content.append(
+                    f"  if (!zenoh_rpc::{encode_fn}(resp_stream, {res_type}_fields, response, ctx)) {{"
+                )
                 c_content.append(f'    LOG_ERR("Failed to encode {method.output_type.split(".")[-1]}");')
                 if req_needs_release:
                     c_content.append(f"    pb_release({req_type}_fields, &request);")
@@ -316,9 +493,166 @@ def generate_code(request, response):
                 c_content.append("}")
                 c_content.append("")
 
+            # Client methods
+            for method in service.method:
+                if is_stream(method):
+                    continue
+                req_type = get_nanopb_type_name(package, method.input_type.split(".")[-1])
+                res_type = get_nanopb_type_name(package, method.output_type.split(".")[-1])
+                req_size = (
+                    "zenoh_rpc::kMaxDynamicMessageSize"
+                    if method.input_type.split(".")[-1] in messages_with_pointers
+                    else f"{req_type}_size"
+                )
+                res_size = (
+                    "zenoh_rpc::kMaxDynamicMessageSize"
+                    if method.output_type.split(".")[-1] in messages_with_pointers
+                    else f"{res_type}_size"
+                )
+                c_content.append(f"zenoh_rpc::RpcStatus {service.name}Client::{method.name}(")
+                c_content.append(f"    const {req_type}& req, {res_type}* resp, uint32_t timeout_ms) {{")
+                c_content.append(f"  auto* impl = static_cast<{service.name}*>(channel_.local_service(kServiceName));")
+                c_content.append("  if (impl != nullptr) {")
+                c_content.append(f"    return impl->{method.name}(req, resp, zenoh_rpc::kDefaultRpcContext);")
+                c_content.append("  }")
+                c_content.append(f"  return channel_.call_message<{req_size}, {res_size}>(")
+                c_content.append(f'      kServiceName, "{method.name}", {req_type}_fields, &req,')
+                c_content.append(f"      {res_type}_fields, resp, timeout_ms);")
+                c_content.append("}")
+                c_content.append("")
+
         c_content.append(f"}}  // namespace {cpp_namespace}")
         f_cpp.content = "\n".join(c_content)
 
+        generate_settings(request, response, proto_file, messages_with_pointers)
+
+
+def generate_stream_handlers(service, method, req_type, res_type, control_type, req_needs_release, res_needs_release):
+    """Handshake handler and stream callbacks of a bidirectional stream method (rpc/zenoh_stream.h)."""
+    if res_needs_release:
+        raise ValueError(f"{method.name}: stream responses must be statically allocated (no FT_POINTER)")
+    streams = f"{to_snake_case(method.name)}_streams_"
+    c = []
+    c.append(f"// {method.name}: open or close a stream; the messages flow on the stream keys")
+    c.append(f"zenoh_rpc::RpcStatus {service.name}Server::handle_{method.name}(")
+    c.append("    pb_istream_t* req_stream, pb_ostream_t* resp_stream, const zenoh_rpc::RpcContext& ctx) {")
+    c.append("  zenoh_rpc::AllocScope alloc_scope(zenoh_rpc::AllocPath::HANDLER);")
+    c.append("  (void)ctx;")
+    c.append(f"  {control_type} control = {control_type}_init_zero;")
+    c.append(f"  if (!pb_decode(req_stream, {control_type}_fields, &control)) {{")
+    c.append('    LOG_ERR("Failed to decode StreamControl");')
+    c.append("    return zenoh_rpc::RpcStatus::DECODE_ERROR;")
+    c.append("  }")
+    c.append("")
+    c.append(f"  {control_type} reply = {control_type}_init_zero;")
+    c.append("  reply.stream_id = control.stream_id;")
+    c.append("  if (control.close) {")
+    c.append(f"    reply.close = {streams}.close(control.stream_id);")
+    c.append("  } else {")
+    c.append(f"    zenoh_rpc::StreamPort* port = {streams}.open(control.window > 0 ? control.window : 1);")
+    c.append("    if (port == nullptr) {")
+    c.append(f'      LOG_WRN("No free {method.name} stream");')
+    c.append("      return zenoh_rpc::RpcStatus::BUSY;")
+    c.append("    }")
+    c.append("    reply.stream_id = port->id();")
+    c.append("    reply.window = zenoh_rpc::kStreamWindow;")
+    c.append("  }")
+    c.append(f"  if (!pb_encode(resp_stream, {control_type}_fields, &reply)) {{")
+    c.append('    LOG_ERR("Failed to encode StreamControl");')
+    c.append("    return zenoh_rpc::RpcStatus::ENCODE_ERROR;")
+    c.append("  }")
+    c.append("  return zenoh_rpc::RpcStatus::OK;")
+    c.append("}")
+    c.append("")
+
+    c.append(f"zenoh_rpc::RpcStatus {service.name}Server::receive_{method.name}(")
+    c.append("    void* context, zenoh_rpc::StreamPort& port, pb_istream_t* in) {")
+    c.append(f"  auto* self = static_cast<{service.name}Server*>(context);")
+    c.append(
+        f"  zenoh_rpc::PooledMessage<{service.name}Messages, zenoh_rpc::kHandlerSlots> "
+        f"slot({to_snake_case(service.name)}_messages);"
+    )
+    c.append("  if (!slot) {")
+    c.append(f'    LOG_ERR("No free message slot for {method.name}");')
+    c.append("    return zenoh_rpc::RpcStatus::BUSY;")
+    c.append("  }")
+    c.append(f"  memset(&slot->{method.name}, 0, sizeof(slot->{method.name}));  // *_init_zero")
+    c.append(f"  {req_type}& request = slot->{method.name}.request;")
+    c.append(f"  if (!pb_decode(in, {req_type}_fields, &request)) {{")
+    c.append(f'    LOG_ERR("Failed to decode {method.input_type.split(".")[-1]}");')
+    c.append("    return zenoh_rpc::RpcStatus::DECODE_ERROR;")
+    c.append("  }")
+    c.append(f"  zenoh_rpc::StreamWriter<{res_type}> writer(&port, {res_type}_fields);")
+    c.append(f"  zenoh_rpc::RpcStatus status = self->impl_.{method.name}(request, writer);")
+    if req_needs_release:
+        c.append(f"  pb_release({req_type}_fields, &request);")
+    c.append("  return status;")
+    c.append("}")
+    c.append("")
+
+    c.append(f"void {service.name}Server::closed_{method.name}(void* context, uint32_t stream_id) {{")
+    c.append(f"  static_cast<{service.name}Server*>(context)->impl_.{method.name}Closed(stream_id);")
+    c.append("}")
+    c.append("")
+    return c
+
+
+def generate_settings(request, response, proto_file, messages_with_pointers):
+    """Generate <proto>_settings.h: a typed settings cache for messages with the settings_key option."""
+    settings_key_value = find_settings_key(request)
+    settings_msgs = []
+    for msg in proto_file.message_type:
+        key = get_option_value(msg.options, settings_key_value)
+        if not key:
+            continue
+        if msg.name in messages_with_pointers:
+            raise ValueError(f"{msg.name}: settings messages must be statically allocated (no FT_POINTER)")
+        settings_msgs.append((msg, key))
+    if not settings_msgs:
+        return
+
+    package = proto_file.package
+    cpp_namespace = package.replace(".", "::")
+    pkg_prefix = package.replace(".", "_").upper() if package else ""
+    base_name = os.path.basename(proto_file.name).replace(".proto", "")
+    struct_name = f"{base_name.title().replace('_', '')}Settings"
+
+    f = response.file.add()
+    f.name = f"{base_name}_settings.h"
+    guard_name = f.name.upper().replace(".", "_")
+
+    content = []
+    content.append(f"#ifndef {guard_name}")
+    content.append(f"#define {guard_name}")
+    content.append("")
+    content.append('#include "settings_store.h"')
+    content.append(f'#include "{base_name}.pb.h"')
+    content.append("")
+    for msg, key in settings_msgs:
+        macro_name = f"{pkg_prefix + '_' if pkg_prefix else ''}{to_snake_case(msg.name).upper()}_SETTINGS_KEY"
+        content.append(f'#define {macro_name} "{key}"')
+    content.append("")
+    content.append(f"namespace {cpp_namespace} {{")
+    content.append("")
+    content.append("// Settings cache for messages with the settings_key option")
+    content.append(f"struct {struct_name} {{")
+    for msg, _ in settings_msgs:
+        c_type = get_nanopb_type_name(package, msg.name)
+        macro_name = f"{pkg_prefix + '_' if pkg_prefix else ''}{to_snake_case(msg.name).upper()}_SETTINGS_KEY"
+        content.append(f"  config::SettingsEntry<{c_type}, {c_type}_size> {to_snake_case(msg.name)}{{")
+        content.append(f"      {macro_name}, {c_type}_fields}};")
+    content.append("")
+    content.append("  // Register all entries (call before SettingsStore::load())")
+    content.append("  void register_all(config::SettingsStore& store) {")
+    for msg, _ in settings_msgs:
+        content.append(f"    store.add({to_snake_case(msg.name)});")
+    content.append("  }")
+    content.append("};")
+    content.append("")
+    content.append(f"}}  // namespace {cpp_namespace}")
+    content.append(f"#endif  // {guard_name}")
+    f.content = "\n".join(content)
+
 
 if __name__ == "__main__":
     data = sys.stdin.buffer.read()
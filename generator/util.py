@@ -10,13 +10,84 @@ def to_snake_case(name):
     return re.sub("([a-z0-9])([A-Z])", r"\1_\2", s1).lower()
 
 
-def find_zenoh_key(request):
+def find_extension_number(request, name, default):
     for proto_file in request.proto_file:
         for ext in proto_file.extension:
-            if ext.name.endswith("zenoh_key"):
-                # sys.stderr.write(f"Found zenoh_key extension with field number {ext.number}\n")
+            if ext.name.endswith(name):
                 return ext.number
-    return 50001
+    return default
+
+
+def find_zenoh_key(request):
+    return find_extension_number(request, "zenoh_key", 50001)
+
+
+def find_settings_key(request):
+    return find_extension_number(request, "settings_key", 50002)
+
+
+def find_state_key(request):
+    return find_extension_number(request, "state_key", 50003)
+
+
+def find_time_budget(request):
+    return find_extension_number(request, "time_budget_ms", 50004)
+
+
+def find_max_rate(request):
+    return find_extension_number(request, "max_rate", 50005)
+
+
+def find_max_payload(request):
+    return find_extension_number(request, "max_payload", 50006)
+
+
+def find_max_interval(request):
+    return find_extension_number(request, "max_interval_ms", 50007)
+
+
+def find_max_batch(request):
+    return find_extension_number(request, "max_batch", 50008)
+
+
+def telemetry_key(request, msg):
+    """Topic suffix of a telemetry message (zenoh_key option or /telemetry/<name>)."""
+    # Extract zenoh_key from custom options (field number 50001)
+    zenoh_key = get_option_value(msg.options, find_zenoh_key(request))
+    # Use default key if not specified
+    if not zenoh_key:
+        zenoh_key = f"/telemetry/{to_snake_case(msg.name.replace('Telemetry', ''))}"
+    return zenoh_key
+
+
+def is_stream(method):
+    """True for a bidirectional stream method; one-sided streaming is not supported."""
+    if method.client_streaming and method.server_streaming:
+        return True
+    if method.client_streaming or method.server_streaming:
+        raise ValueError(f"{method.name}: only bidirectional streams (stream Req) returns (stream Res) are supported")
+    return False
+
+
+def get_option_int(options_obj, field_number):
+    """Value of a varint custom option (see get_option_value), None if not set."""
+    data = options_obj.SerializeToString()
+    position = 0
+    while position < len(data):
+        (tag, position) = decoder._DecodeVarint32(data, position)
+        wire_type = tag & 0x07
+        if wire_type == 0:
+            (value, position) = decoder._DecodeVarint(data, position)
+            if tag >> 3 == field_number:
+                return value
+        elif wire_type == 1:
+            position += 8
+        elif wire_type == 2:
+            (length, position) = decoder._DecodeVarint32(data, position)
+            position += length
+        elif wire_type == 5:
+            position += 4
+    return None
 
 
 def get_option_value(options_obj, field_number):
@@ -51,7 +122,7 @@ def get_option_value(options_obj, field_number):
 
         # If not the target, skip to the next tag according to wire type
         if wire_type == 0:  # Varint
-            (temp, position) = decoder._DecodeVarint64(data, position)
+            (temp, position) = decoder._DecodeVarint(data, position)
         elif wire_type == 1:  # 64-bit
             position += 8
         elif wire_type == 2:  # Length Delimited
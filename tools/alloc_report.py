@@ -0,0 +1,202 @@
+"""
+Alloc report - heap allocations per operation on the device's RPC and telemetry paths.
+
+Needs a firmware built with alloc_guard.conf (CONFIG_APP_ALLOC_GUARD, see apps/zenoh_rpc/rpc/alloc_guard.h). The
+device publishes its allocation counters every 10 s on <device>/log ("alloc_guard" module). This script takes one
+report as the baseline, drives Echo calls and the sensor stream, waits for the next report and prints per path:
+
+    query       RPC dispatch (ZenohRpcChannel::query_callback / handle_query)
+    handler     generated DeviceServiceServer::handle_*
+    telemetry   TelemetryPublisher::publish
+
+the operations, the allocations after the warm-up and the allocations per operation, and the allocating call sites
+(resolved with addr2line when --elf is given). Exit code 1 with --fail if a path allocated.
+
+Usage:
+    uv run python tools/alloc_report.py -n 500
+    uv run python tools/alloc_report.py -n 500 --elf build/zephyr/zephyr.elf --fail --label wifi --json alloc.jsonl
+"""
+
+import argparse
+import json
+import logging
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_rpc_client import LogSubscriber, ZenohRpcClient, ZenohSubscriberClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+DEFAULT_ADDR2LINE = os.path.join(
+    os.environ.get("ZEPHYR_SDK_INSTALL_DIR", "/opt/zephyr-sdk-0.17.0"), "arm-zephyr-eabi/bin/arm-zephyr-eabi-addr2line"
+)
+# Device report interval is 10 s
+REPORT_TIMEOUT_S = 25.0
+
+PATHS = ("query", "handler", "telemetry")
+# Written by log_alloc_stats() in rpc/alloc_guard.cpp
+PATH_LINE = re.compile(r"alloc_guard: (\w+) ops=(\d+) allocs=(\d+) bytes=(\d+) warmup_allocs=(\d+)")
+SITE_LINE = re.compile(r"alloc_guard: (\w+) site=(0x[0-9a-fA-F]+) allocs=(\d+)")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Report heap allocations per operation of the device hot paths")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("-n", "--count", type=int, default=200, help="Echo calls (default: 200)")
+    parser.add_argument("--stream-s", type=float, default=5.0, help="Seconds of sensor streaming (default: 5)")
+    parser.add_argument("--elf", type=str, help="zephyr.elf of the firmware, to resolve the call sites")
+    parser.add_argument(
+        "--addr2line",
+        type=str,
+        default=DEFAULT_ADDR2LINE,
+        help=f"addr2line of the toolchain (default: {DEFAULT_ADDR2LINE})",
+    )
+    parser.add_argument("--fail", action="store_true", help="Exit with code 1 if a path allocated")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. build variant)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+class AllocReports:
+    """Latest counters from the device log; reports counts the complete reports (last path line seen)."""
+
+    def __init__(self):
+        self.paths: dict[str, dict] = {}
+        self.sites: dict[tuple[str, str], int] = {}
+        self.reports = 0
+        self._cond = threading.Condition()
+
+    def on_log(self, message: str):
+        match = PATH_LINE.search(message)
+        if match:
+            path, ops, allocs, size, warmup = match.groups()
+            with self._cond:
+                self.paths[path] = {"ops": int(ops), "allocs": int(allocs), "bytes": int(size), "warmup": int(warmup)}
+                if path == PATHS[-1]:
+                    self.reports += 1
+                    self._cond.notify_all()
+            return
+        match = SITE_LINE.search(message)
+        if match:
+            path, address, allocs = match.groups()
+            with self._cond:
+                self.sites[(path, address)] = int(allocs)
+
+    def wait_report(self, after: int, timeout: float) -> bool:
+        with self._cond:
+            return self._cond.wait_for(lambda: self.reports > after, timeout)
+
+    def snapshot(self) -> dict[str, dict]:
+        with self._cond:
+            return {path: dict(values) for path, values in self.paths.items()}
+
+
+def resolve_sites(addr2line: str, elf: str, addresses: list[str]) -> dict[str, str]:
+    """Function and source line of each return address (Thumb: bit 0 set, points after the call)."""
+    if not addresses:
+        return {}
+    call_sites = [hex((int(a, 16) & ~1) - 1) for a in addresses]
+    try:
+        out = subprocess.run(
+            [addr2line, "-f", "-C", "-e", elf] + call_sites, capture_output=True, text=True, check=True
+        ).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError) as e:
+        logger.warning(f"addr2line failed: {e}")
+        return {}
+    return {address: f"{out[2 * i]} ({out[2 * i + 1]})" for i, address in enumerate(addresses) if 2 * i + 1 < len(out)}
+
+
+def drive_load(service: DeviceServiceClient, count: int, stream_s: float):
+    request = pb.EchoRequest(msg="alloc")
+    response = pb.EchoResponse()
+    failures = sum(1 for _ in range(count) if not service.echo_into(request, response).success)
+    if failures:
+        logger.warning(f"{failures} of {count} Echo calls failed")
+    if stream_s > 0:
+        if service.start_sensor_stream(batch_size=1).success:
+            time.sleep(stream_s)
+            service.stop_sensor_stream()
+        else:
+            logger.warning("StartSensorStream failed: no telemetry operations")
+
+
+def main():
+    args = parse_args()
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    reports = AllocReports()
+    log_sub = LogSubscriber(ZenohSubscriberClient(session), args.device_id)
+    log_sub.subscribe(reports.on_log)
+
+    try:
+        logger.info("Waiting for an alloc_guard report (firmware built with alloc_guard.conf?)")
+        if not reports.wait_report(0, REPORT_TIMEOUT_S):
+            logger.error("No alloc_guard report from the device")
+            sys.exit(1)
+        baseline = reports.snapshot()
+        drive_load(DeviceServiceClient(ZenohRpcClient(session, args.device_id)), args.count, args.stream_s)
+        seen = reports.reports
+        if not reports.wait_report(seen, REPORT_TIMEOUT_S):
+            logger.error("No alloc_guard report after the load")
+            sys.exit(1)
+        # Site lines follow the path lines
+        time.sleep(0.5)
+        final = reports.snapshot()
+        sites = dict(reports.sites)
+    finally:
+        log_sub.unsubscribe()
+        session.close()
+
+    result = {"label": args.label, "count": args.count, "stream_s": args.stream_s, "paths": {}}
+    allocated = False
+    for path in PATHS:
+        before = baseline.get(path, {"ops": 0, "allocs": 0, "bytes": 0})
+        after = final.get(path, before)
+        ops = after["ops"] - before["ops"]
+        allocs = after["allocs"] - before["allocs"]
+        result["paths"][path] = {
+            "ops": ops,
+            "allocs": allocs,
+            "bytes": after["bytes"] - before["bytes"],
+            "allocs_per_op": round(allocs / ops, 3) if ops else None,
+        }
+        allocated |= allocs > 0
+        logger.info(f"{path:10s} {result['paths'][path]}")
+
+    names = resolve_sites(args.addr2line, args.elf, [address for _, address in sites]) if args.elf else {}
+    result["sites"] = [
+        {"path": path, "address": address, "allocs": allocs, "function": names.get(address)}
+        for (path, address), allocs in sorted(sites.items())
+    ]
+    for site in result["sites"]:
+        logger.info(f"{site['path']:10s} {site['address']} {site['allocs']} allocs {site['function'] or ''}")
+
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+    if args.fail and allocated:
+        logger.error("Allocations on the hot paths after the warm-up")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
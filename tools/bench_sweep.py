@@ -0,0 +1,244 @@
+"""
+Bench sweep - latency and throughput of the device link against payload size, with the built-in BenchService.
+
+Needs a firmware built with bench.conf (CONFIG_APP_BENCH_SERVICE, see apps/zenoh_rpc/bench/bench_service.h). The device
+handlers do no work beyond decoding and encoding and allocate nothing, so the numbers describe the transport and the
+RPC layer. Run once per transport (USB serial, Wi-Fi, ...) with its --label and compare the JSON lines:
+
+    ping        round trip of an empty call
+    sink        request of N bytes, 4-byte reply      (host -> device throughput)
+    source      4-byte request, reply of N bytes      (device -> host throughput)
+    publish     samples of N bytes on <device>/bench/data at --rate; received rate, loss and inter-arrival jitter
+
+Requests are encoded once per size and sent with the *_raw calls, so host-side protobuf work stays out of the loop.
+
+Usage:
+    uv run python tools/bench_sweep.py --label usb
+    uv run python tools/bench_sweep.py --sizes 0,256,1024,2048 -n 200 --rate 500 --express \
+        --label wifi --json bench.jsonl
+"""
+
+import argparse
+import json
+import logging
+import statistics
+import threading
+import time
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.service_client import BenchServiceClient
+from rpc.zenoh_attachment import Attachment
+from rpc.zenoh_rpc_client import ZenohRpcClient, ZenohSubscriberClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+DEFAULT_SIZES = "0,16,64,256,512,1024,2048"
+# kBenchDataSuffix in bench/bench_service.h
+BENCH_TOPIC = "/bench/data"
+# BenchPayload.data max_size in service.options
+MAX_PAYLOAD = 2048
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Map device link latency and throughput against payload size")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("--sizes", type=str, default=DEFAULT_SIZES, help=f"Payload sizes (default: {DEFAULT_SIZES})")
+    parser.add_argument(
+        "-n", "--count", type=int, default=100, help="Measured calls per method and size (default: 100)"
+    )
+    parser.add_argument("--warmup", type=int, default=5, help="Unmeasured calls before measuring (default: 5)")
+    parser.add_argument("--rate", type=int, default=100, help="Publisher samples per second (default: 100, 0: skip)")
+    parser.add_argument("--duration", type=float, default=3.0, help="Seconds of publishing per size (default: 3)")
+    parser.add_argument("--express", action="store_true", help="Publish each sample right away (no batching)")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. transport)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def percentile(sorted_values: list[float], q: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(q * len(sorted_values)))]
+
+
+def timed_calls(call, payload: bytes, count: int, warmup: int) -> tuple[list[float], int, float, bytes]:
+    """RTTs [ms] of the successful calls, failures, elapsed seconds and the data of the last reply."""
+    for _ in range(warmup):
+        call(payload)
+    rtts_ms = []
+    failures = 0
+    data = b""
+    start = time.perf_counter()
+    for _ in range(count):
+        t0 = time.perf_counter()
+        result = call(payload)
+        t1 = time.perf_counter()
+        if result.success:
+            rtts_ms.append((t1 - t0) * 1000.0)
+            data = result.data
+        else:
+            failures += 1
+    return rtts_ms, failures, time.perf_counter() - start, data
+
+
+def summarize(method: str, size: int, rtts_ms: list[float], failures: int, elapsed: float) -> dict:
+    rtts_ms.sort()
+    ok = len(rtts_ms)
+    row = {"method": method, "size": size, "calls": ok, "failures": failures}
+    if ok:
+        row.update(
+            {
+                "calls_per_s": round(ok / elapsed, 1),
+                "bytes_per_s": round(ok * size / elapsed),
+                "mean_ms": round(statistics.fmean(rtts_ms), 3),
+                "p50_ms": round(percentile(rtts_ms, 0.50), 3),
+                "p90_ms": round(percentile(rtts_ms, 0.90), 3),
+                "p99_ms": round(percentile(rtts_ms, 0.99), 3),
+                "max_ms": round(rtts_ms[-1], 3),
+            }
+        )
+    return row
+
+
+def check_pattern(data: bytes, size: int) -> bool:
+    """Source replies and samples carry bytes i = i % 256."""
+    return len(data) == size and all(b == i % 256 for i, b in enumerate(data))
+
+
+class SampleCounter:
+    """Arrivals on the bench topic: sequence numbers, payload sizes and receive times."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self.reset()
+
+    def reset(self):
+        with self._lock:
+            self.sequences: set[int] = set()
+            self.arrivals: list[float] = []
+            self.bytes = 0
+            self.bad = 0
+
+    def on_sample(self, key_expr: str, payload: bytes, attachment: bytes | None):
+        now = time.perf_counter()
+        sequence = Attachment.decode(attachment).sequence
+        with self._lock:
+            if sequence is not None:
+                self.sequences.add(sequence)
+            self.arrivals.append(now)
+            self.bytes += len(payload)
+            # First byte only: full checks are for Source, the callback must keep up
+            if payload and payload[0] != 0:
+                self.bad += 1
+
+    def snapshot(self) -> tuple[list[float], int, int, int]:
+        """Arrival times, distinct sequence numbers, payload bytes and bad payloads."""
+        with self._lock:
+            return list(self.arrivals), len(self.sequences), self.bytes, self.bad
+
+
+def measure_publisher(
+    service: BenchServiceClient, counter: SampleCounter, size: int, rate: int, duration: float, express: bool
+) -> dict:
+    counter.reset()
+    response = service.start_publisher(rate_hz=rate, size=size, duration_ms=int(duration * 1000), express=express)
+    row = {"method": "publish", "size": size, "rate_hz": rate, "express": express}
+    if not response.success:
+        row["error"] = response.error
+        return row
+    # The device stops by itself; the margin lets the last samples arrive
+    time.sleep(duration + 0.5)
+    response, stats = service.stop_publisher()
+    if not response.success or stats is None:
+        row["error"] = response.error
+        return row
+
+    arrivals, received, received_bytes, bad = counter.snapshot()
+    span = arrivals[-1] - arrivals[0] if len(arrivals) > 1 else 0.0
+    gaps_ms = sorted((b - a) * 1000.0 for a, b in zip(arrivals, arrivals[1:]))
+    device_s = stats.elapsed_us / 1e6
+    row.update(
+        {
+            "published": stats.published,
+            "failed": stats.failed,
+            "received": received,
+            "lost": max(stats.published - received, 0),
+            "bad_payloads": bad,
+            "device_rate_hz": round((stats.published - 1) / device_s, 1) if device_s > 0 else None,
+            "received_rate_hz": round((len(arrivals) - 1) / span, 1) if span > 0 else None,
+            "bytes_per_s": round(received_bytes / span) if span > 0 else None,
+        }
+    )
+    if gaps_ms:
+        row.update(
+            {
+                "gap_p50_ms": round(percentile(gaps_ms, 0.50), 3),
+                "gap_p99_ms": round(percentile(gaps_ms, 0.99), 3),
+                "gap_max_ms": round(gaps_ms[-1], 3),
+            }
+        )
+    return row
+
+
+def main():
+    args = parse_args()
+    sizes = [int(s) for s in args.sizes.split(",") if s.strip()]
+    if any(size < 0 or size > MAX_PAYLOAD for size in sizes):
+        raise SystemExit(f"Sizes must be within 0..{MAX_PAYLOAD} (BenchPayload.data max_size)")
+
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    service = BenchServiceClient(ZenohRpcClient(session, args.device_id))
+    sub_client = ZenohSubscriberClient(session)
+    counter = SampleCounter()
+    rows = []
+
+    try:
+        if not service.ping().success:
+            logger.error("No BenchService on the device (firmware built with bench.conf?)")
+            raise SystemExit(1)
+
+        empty = pb.Empty().SerializeToString()
+        rows.append(summarize("ping", 0, *timed_calls(service.ping_raw, empty, args.count, args.warmup)[:3]))
+
+        for size in sizes:
+            sink_request = pb.BenchPayload(data=bytes(i % 256 for i in range(size))).SerializeToString()
+            rtts, failures, elapsed, _ = timed_calls(service.sink_raw, sink_request, args.count, args.warmup)
+            rows.append(summarize("sink", size, rtts, failures, elapsed))
+
+            source_request = pb.BenchSourceRequest(size=size).SerializeToString()
+            rtts, failures, elapsed, data = timed_calls(service.source_raw, source_request, args.count, args.warmup)
+            row = summarize("source", size, rtts, failures, elapsed)
+            if rtts:
+                row["pattern_ok"] = check_pattern(pb.BenchPayload.FromString(data).data, size)
+            rows.append(row)
+
+        if args.rate > 0:
+            sub_client.subscribe_sample(args.device_id + BENCH_TOPIC, counter.on_sample)
+            for size in sizes:
+                rows.append(measure_publisher(service, counter, size, args.rate, args.duration, args.express))
+    finally:
+        sub_client.unsubscribe_all()
+        session.close()
+
+    for row in rows:
+        values = ", ".join(f"{k}={v}" for k, v in row.items() if k not in ("method", "size"))
+        logger.info(f"{row['method']:8s} {row['size']:5d} B  {values}")
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps({"label": args.label, "count": args.count, "rows": rows}) + "\n")
+
+
+if __name__ == "__main__":
+    main()
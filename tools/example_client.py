@@ -10,6 +10,12 @@ Usage:
 
     # Use multicast scouting (auto-discover router)
     uv run python tools/example_client.py --scouting
+
+    # Go through a running tools/rpc_gateway.py instead of opening a zenoh session
+    uv run python tools/example_client.py --gateway http://127.0.0.1:7450
+
+    # Stream sensor data as compressed batches of 5 samples
+    uv run python tools/example_client.py --batch-size 5
 """
 
 import argparse
@@ -19,7 +25,10 @@ import time
 import zenoh
 import rpc.service_pb2 as pb
 from rpc.zenoh_rpc_client import ZenohRpcClient, ZenohSubscriberClient, LogSubscriber
+from rpc.gateway_client import GatewayRpcClient, GatewaySubscriberClient
 from rpc.service_client import DeviceServiceClient, TelemetrySubscriber
+from rpc.telemetry_batch import TelemetryColumns
+from rpc.telemetry_stats import TelemetryStats
 
 logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
 logger = logging.getLogger(__name__)
@@ -40,9 +49,15 @@ def parse_args():
     parser.add_argument(
         "-s", "--scouting", action="store_true", help="Use multicast scouting to discover router (ignores --connect)"
     )
+    parser.add_argument(
+        "-g", "--gateway", type=str, help="Use a local RPC gateway (http://host:port or unix:///path) instead of zenoh"
+    )
     parser.add_argument(
         "-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID for telemetry topics (default: {DEVICE_ID})"
     )
+    parser.add_argument(
+        "-b", "--batch-size", type=int, default=0, help="Stream sensor data in compressed batches of N samples"
+    )
     return parser.parse_args()
 
 
@@ -51,6 +66,14 @@ def on_sensor_data(data: pb.SensorTelemetry):
     logger.info(f"Sensor: temp={data.temperature:.2f}°C, humidity={data.humidity:.2f}%")
 
 
+def on_sensor_batch(batch: TelemetryColumns):
+    """Callback for compressed sensor telemetry batches."""
+    for row in batch.rows():
+        logger.info(
+            f"Sensor @{row['timestamp_ms']} ms: temp={row['temperature']:.2f}°C, humidity={row['humidity']:.2f}%"
+        )
+
+
 def on_log_message(message: str):
     """Callback for log messages."""
     logger.info(f"Device Log: {message}")
@@ -61,6 +84,14 @@ def main():
 
     logger.info("Starting Zenoh RPC Example Client")
 
+    if args.gateway:
+        logger.info(f"Using RPC gateway: {args.gateway}")
+        rpc_client = GatewayRpcClient(args.gateway, args.device_id)
+        sub_client = GatewaySubscriberClient(args.gateway)
+        run_examples(rpc_client, sub_client, args.device_id, args.batch_size)
+        sub_client.unsubscribe_all()
+        return
+
     # Configure Zenoh
     config = zenoh.Config()
 
@@ -82,78 +113,86 @@ def main():
         # Create RPC and Subscriber clients
         rpc_client = ZenohRpcClient(session, args.device_id)
         sub_client = ZenohSubscriberClient(session)
-
-        # Create service client and telemetry subscriber
-        device_service = DeviceServiceClient(rpc_client)
-        telemetry = TelemetrySubscriber(sub_client, args.device_id)
-        log = LogSubscriber(sub_client, args.device_id)
-        # Subscribe to telemetry and logs
-        telemetry.subscribe_sensor(on_sensor_data)
-        log.subscribe(on_log_message)
-        logger.info("Subscribed to telemetry and logs")
-
-        # Example RPC calls
-        logger.info("--- RPC Examples ---")
-
-        # Echo
-        logger.info("Calling Echo...")
-        response, echo_msg = device_service.echo(msg="Hello, Pico!")
-        if response.success:
-            logger.info(f"Echo response: {echo_msg}")
-        else:
-            logger.error(f"Echo failed: {response.error}")
-
-        logger.info("Calling EchoMalloc...")
-        response, echo_msg = device_service.echo_malloc(msg=b"Hello malloc!" * 50)
-        if response.success and echo_msg is not None:
-            logger.info(f"EchoMalloc response: {len(echo_msg.msg)}")
-        else:
-            logger.error(f"EchoMalloc failed: {response.error}")
-
-        # Set LED
-        logger.info("Calling SetLed(on=True)...")
-        response, _ = device_service.set_led(on=True)
-        if response.success:
-            logger.info("LED turned ON")
-        else:
-            logger.error(f"SetLed failed: {response.error}")
-
-        # Start sensor stream
-        logger.info("Calling StartSensorStream...")
-        response = device_service.start_sensor_stream()
-        if response.success:
-            logger.info("Sensor stream started")
-        else:
-            logger.error(f"StartSensorStream failed: {response.error}")
-
-        # Wait and receive telemetry
-        logger.info("Receiving telemetry for 10 seconds with LED on/off async...")
-        for i in range(10):
-            time.sleep(0.5)
-            device_service.set_led(on=False)
-            time.sleep(0.5)
-            device_service.set_led(on=True)
-
-        # Stop sensor stream
-        logger.info("Calling StopSensorStream...")
-        response = device_service.stop_sensor_stream()
-        if response.success:
-            logger.info("Sensor stream stopped")
-
-        # Turn LED off
-        logger.info("Calling SetLed(on=False)...")
-        response, _ = device_service.set_led(on=False)
-        if response.success:
-            logger.info("LED turned OFF")
-
-        # Cleanup
-        telemetry.unsubscribe_all()
-        logger.info("Unsubscribed from all topics")
-
+        run_examples(rpc_client, sub_client, args.device_id, args.batch_size)
     finally:
         session.close()
         logger.info("Zenoh session closed")
 
 
+def run_examples(rpc_client, sub_client, device_id: str, batch_size: int = 0):
+    """Run the example RPC calls with the given transport."""
+    # Create service client and telemetry subscriber
+    device_service = DeviceServiceClient(rpc_client)
+    stats = TelemetryStats()
+    telemetry = TelemetrySubscriber(sub_client, device_id, stats=stats)
+    log = LogSubscriber(sub_client, device_id)
+    # Subscribe to telemetry and logs
+    telemetry.subscribe_sensor(on_sensor_data)
+    telemetry.subscribe_sensor_batch(on_sensor_batch)
+    log.subscribe(on_log_message)
+    logger.info("Subscribed to telemetry and logs")
+
+    # Example RPC calls
+    logger.info("--- RPC Examples ---")
+
+    # Echo
+    logger.info("Calling Echo...")
+    response, echo_msg = device_service.echo(msg="Hello, Pico!")
+    if response.success:
+        logger.info(f"Echo response: {echo_msg}")
+    else:
+        logger.error(f"Echo failed: {response.error}")
+
+    logger.info("Calling EchoMalloc...")
+    response, echo_msg = device_service.echo_malloc(msg=b"Hello malloc!" * 50)
+    if response.success and echo_msg is not None:
+        logger.info(f"EchoMalloc response: {len(echo_msg.msg)}")
+    else:
+        logger.error(f"EchoMalloc failed: {response.error}")
+
+    # Set LED
+    logger.info("Calling SetLed(on=True)...")
+    response, _ = device_service.set_led(on=True)
+    if response.success:
+        logger.info("LED turned ON")
+    else:
+        logger.error(f"SetLed failed: {response.error}")
+
+    # Start sensor stream
+    logger.info("Calling StartSensorStream...")
+    response = device_service.start_sensor_stream(batch_size=batch_size)
+    if response.success:
+        logger.info("Sensor stream started")
+    else:
+        logger.error(f"StartSensorStream failed: {response.error}")
+
+    # Wait and receive telemetry
+    logger.info("Receiving telemetry for 10 seconds with LED on/off async...")
+    for i in range(10):
+        time.sleep(0.5)
+        device_service.set_led(on=False)
+        time.sleep(0.5)
+        device_service.set_led(on=True)
+
+    # Stop sensor stream
+    logger.info("Calling StopSensorStream...")
+    response = device_service.stop_sensor_stream()
+    if response.success:
+        logger.info("Sensor stream stopped")
+    for summary in stats.summary():
+        logger.info(f"Telemetry stats: {summary}")
+
+    # Turn LED off
+    logger.info("Calling SetLed(on=False)...")
+    response, _ = device_service.set_led(on=False)
+    if response.success:
+        logger.info("LED turned OFF")
+
+    # Cleanup
+    telemetry.unsubscribe_all()
+    log.unsubscribe()
+    logger.info("Unsubscribed from all topics")
+
+
 if __name__ == "__main__":
     main()
@@ -0,0 +1,105 @@
+"""
+Field mask payload sizes - encoded size of each message with all fields vs. one selected field.
+
+Every field is filled with a worst-case value (strings and bytes at their max_size from service.options, repeated
+fields at max_count, 32-bit varints at 5 bytes), the same bound the device buffers are sized for. The masked size is
+what the device sends for a call with fields=[<field>]; the request grows by the field mask attachment.
+
+Only messages with two or more fields are listed (a single field cannot be trimmed); RPC responses are marked with
+"*", the others show what a field mask would save if they were returned by an RPC. Runs offline (no device needed).
+
+Usage:
+    uv run python tools/field_mask_sizes.py
+"""
+
+import os
+
+from google.protobuf.descriptor import FieldDescriptor
+from google.protobuf.message import Message
+from google.protobuf.message_factory import GetMessageClass
+from rpc import service_pb2 as pb
+from rpc.proto_fields import is_repeated
+from rpc.zenoh_attachment import field_mask_attachment
+
+OPTIONS_FILE = os.path.join(os.path.dirname(__file__), "..", "apps", "zenoh_rpc", "service.options")
+# Length of unbounded strings/bytes (FT_POINTER or no max_size)
+DEFAULT_LEN = 64
+DEFAULT_COUNT = 4
+
+
+def load_options(path: str) -> dict[str, dict[str, str]]:
+    """nanopb options per field: {"practice.rpc.Msg.field": {"max_size": "32", ...}}"""
+    options: dict[str, dict[str, str]] = {}
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if not parts or parts[0].startswith("#"):
+                continue
+            options[parts[0]] = dict(p.split(":", 1) for p in parts[1:] if ":" in p)
+    return options
+
+
+def worst_case_value(fd: FieldDescriptor, opts: dict[str, str]):
+    if fd.type == FieldDescriptor.TYPE_STRING:
+        # max_size includes the terminating NUL
+        return "x" * (int(opts.get("max_size", DEFAULT_LEN + 1)) - 1)
+    if fd.type == FieldDescriptor.TYPE_BYTES:
+        return b"\xa5" * int(opts.get("max_size", DEFAULT_LEN))
+    if fd.type == FieldDescriptor.TYPE_BOOL:
+        return True
+    if fd.type in (FieldDescriptor.TYPE_FLOAT, FieldDescriptor.TYPE_DOUBLE):
+        return 21.5
+    if fd.type == FieldDescriptor.TYPE_ENUM:
+        return fd.enum_type.values[-1].number
+    if fd.type in (FieldDescriptor.TYPE_INT64, FieldDescriptor.TYPE_UINT64, FieldDescriptor.TYPE_SINT64):
+        return 2**63 - 1
+    return 2**31 - 1
+
+
+def fill(msg: Message, options: dict[str, dict[str, str]]) -> Message:
+    for fd in msg.DESCRIPTOR.fields:
+        opts = options.get(fd.full_name, {})
+        if fd.type == FieldDescriptor.TYPE_MESSAGE:
+            if is_repeated(fd):
+                for _ in range(int(opts.get("max_count", DEFAULT_COUNT))):
+                    fill(getattr(msg, fd.name).add(), options)
+            else:
+                fill(getattr(msg, fd.name), options)
+        elif is_repeated(fd):
+            value = worst_case_value(fd, opts)
+            getattr(msg, fd.name).extend([value] * int(opts.get("max_count", DEFAULT_COUNT)))
+        else:
+            setattr(msg, fd.name, worst_case_value(fd, opts))
+    return msg
+
+
+def masked(msg: Message, keep: str) -> Message:
+    """Copy of msg with only the named field, as encoded by the device (zenoh_rpc::mask_fields)."""
+    out = type(msg)()
+    out.CopyFrom(msg)
+    for fd in msg.DESCRIPTOR.fields:
+        if fd.name != keep and fd.number <= 64:
+            out.ClearField(fd.name)
+    return out
+
+
+def main():
+    options = load_options(OPTIONS_FILE)
+    responses = {m.output_type.name for s in pb.DESCRIPTOR.services_by_name.values() for m in s.methods}
+
+    print(f"{'message':<22} {'full':>5}  {'field':<16} {'masked':>6} {'mask att.':>9} {'saved':>6}")
+    for name, desc in sorted(pb.DESCRIPTOR.message_types_by_name.items()):
+        if len(desc.fields) < 2:
+            continue
+        label = f"{name}{' *' if name in responses else ''}"
+        msg = fill(GetMessageClass(desc)(), options)
+        full = msg.ByteSize()
+        for fd in desc.fields:
+            size = masked(msg, fd.name).ByteSize()
+            attachment = len(field_mask_attachment(type(msg), [fd.name]))
+            saved = full - size - attachment
+            print(f"{label:<22} {full:>5}  {fd.name:<16} {size:>6} {attachment:>9} {saved:>6}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,144 @@
+"""
+GPIO events - prints the edges of the device event inputs and measures their latency.
+
+The device stamps every edge in its GPIO interrupt and publishes it right away on <device>/events/gpio (express,
+real-time priority; firmware option CONFIG_APP_GPIO_EVENTS, inputs under /event-inputs in the board overlay, GP15 on
+the Pico 2 W). Reported per event and summarized at the end:
+
+    queued        interrupt to publish on the device (GpioEvent.queued_us)
+    delay         host arrival minus device timestamp, minus the smallest such difference seen: the network and
+                  publish delay above the best case (the clocks are not synchronized, so not the absolute latency)
+    dropped       edges lost to the device queue (GpioEvent.dropped) and samples lost on the way (sequence gaps)
+
+Usage:
+    uv run python tools/gpio_events.py -d pico2w-001
+    uv run python tools/gpio_events.py --count 200 --quiet --label wifi --json gpio_events.jsonl
+"""
+
+import argparse
+import json
+import statistics
+import threading
+import time
+from typing import Optional
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.zenoh_attachment import Attachment
+from rpc.zenoh_rpc_client import ZenohSubscriberClient
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+EVENT_KEY = "/events/gpio"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Print GPIO events and measure their latency")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("--count", type=int, default=0, help="Stop after this many events (default: until Ctrl-C)")
+    parser.add_argument("--quiet", action="store_true", help="Print the summary only")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. link type)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def percentile(values: list[float], p: float) -> Optional[float]:
+    if not values:
+        return None
+    values = sorted(values)
+    return round(values[min(len(values) - 1, int(p / 100 * len(values)))], 1)
+
+
+class EventStats:
+    """Latency and loss of the received events."""
+
+    def __init__(self, quiet: bool):
+        self.quiet = quiet
+        self.events = 0
+        self.dropped = 0
+        self.lost = 0
+        self.queued_us: list[float] = []
+        self.offsets_us: list[float] = []
+        self._next_seq: Optional[int] = None
+        self._lock = threading.Lock()
+        self.done = threading.Event()
+
+    def on_sample(self, _key: str, payload: bytes, attachment: Optional[bytes]):
+        receive_us = time.monotonic_ns() / 1000
+        event = pb.GpioEvent()
+        event.ParseFromString(payload)
+        seq = Attachment.decode(attachment).sequence
+        with self._lock:
+            self.events += 1
+            self.dropped += event.dropped
+            if seq is not None:
+                if self._next_seq is not None and seq > self._next_seq:
+                    self.lost += seq - self._next_seq
+                self._next_seq = seq + 1
+            self.queued_us.append(event.queued_us)
+            self.offsets_us.append(receive_us - event.timestamp_us)
+            delay_ms = (self.offsets_us[-1] - min(self.offsets_us)) / 1000
+        if not self.quiet:
+            print(
+                f"line {event.line} {'high' if event.level else 'low '} t={event.timestamp_us} us "
+                f"queued {event.queued_us} us, delay {delay_ms:.2f} ms"
+                + (f", {event.dropped} dropped" if event.dropped else "")
+            )
+
+    def summary(self) -> dict:
+        with self._lock:
+            best = min(self.offsets_us) if self.offsets_us else 0.0
+            delays_ms = [(o - best) / 1000 for o in self.offsets_us]
+            return {
+                "events": self.events,
+                "dropped": self.dropped,
+                "lost": self.lost,
+                "queued_p50_us": percentile(self.queued_us, 50),
+                "queued_max_us": max(self.queued_us) if self.queued_us else None,
+                "delay_p50_ms": round(statistics.median(delays_ms), 2) if delays_ms else None,
+                "delay_p99_ms": percentile(delays_ms, 99),
+            }
+
+
+def main():
+    args = parse_args()
+    key_expr = f"{args.device_id}{EVENT_KEY}"
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    sub_client = ZenohSubscriberClient(session)
+    stats = EventStats(args.quiet)
+
+    def on_sample(key: str, payload: bytes, attachment: Optional[bytes]):
+        stats.on_sample(key, payload, attachment)
+        if args.count and stats.events >= args.count:
+            stats.done.set()
+
+    sub_client.subscribe_sample(key_expr, on_sample)
+    print(f"Waiting for events on {key_expr}...")
+    try:
+        while not stats.done.wait(0.5):
+            pass
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sub_client.unsubscribe_all()
+        session.close()
+
+    result = {"label": args.label, "key_expr": key_expr, **stats.summary()}
+    print(result)
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+
+if __name__ == "__main__":
+    main()
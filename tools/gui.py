@@ -37,6 +37,11 @@ def main():
     def index():
         service_gui.create_ui(zenoh_client, args.device_id)
 
+    @ui.page("/fleet")
+    def fleet():
+        # All devices publishing telemetry; a row click shows one device
+        service_gui.create_fleet_ui(zenoh_client)
+
     script_dir = os.path.dirname(__file__)
     ui.run(
         title="Zenoh RPC GUI",
@@ -0,0 +1,280 @@
+"""
+Pool scaling - host RPC calls/s and telemetry decode throughput against worker process count (rpc/client_pool.py).
+
+Runs against a simulated fleet answering Echo on every device and publishing SensorTelemetry (tools/sim_fleet.py
+--rpc). For every --workers entry, two phases of --duration seconds each:
+
+    calls       Echo to the devices round robin, --in-flight outstanding per worker; the response is decoded in
+                the worker and only its length comes back
+    telemetry   decoded samples and rows per second; the rows stay in the workers (counted there) unless --deliver
+                sends every row to this process
+
+Workers 0 is the single-process baseline: the generated DeviceServiceClient on --in-flight threads and the same
+decoder on the subscription callbacks of one session. The simulator is one Python process as well: run several (each
+with its own --prefix) when a single one becomes the ceiling; its log shows the samples/s it actually published.
+
+Usage:
+    uv run python tools/sim_fleet.py -n 1000 --rate 20 --rpc
+    uv run python tools/pool_scaling.py -n 1000
+    uv run python tools/pool_scaling.py -n 1000 --workers 0,1,2,4,8 --mode calls --label 8core --json pool.jsonl
+"""
+
+import argparse
+import json
+import logging
+import os
+import threading
+import time
+from concurrent.futures import Future, ThreadPoolExecutor
+from typing import Optional
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.client_pool import ClientPool, TelemetryDecoder, keep_row
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_rpc_client import ZenohRpcClient, ZenohSubscriberClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+MODES = ("calls", "telemetry")
+# Telemetry subscriptions settle before the telemetry phase counts
+SETTLE_S = 1.0
+
+
+def parse_args():
+    cpus = os.cpu_count() or 1
+    default_workers = [0] + [1 << i for i in range(cpus.bit_length()) if 1 << i <= cpus]
+    parser = argparse.ArgumentParser(description="Measure client pool throughput against worker count")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-n", "--devices", type=int, default=1000, help="Simulated devices (default: 1000)")
+    parser.add_argument(
+        "--prefix", action="append", dest="prefixes", help="Device ID prefix of sim_fleet.py, repeatable (default: sim)"
+    )
+    parser.add_argument(
+        "--workers",
+        type=str,
+        default=",".join(map(str, default_workers)),
+        help=f"Worker counts, 0: single process (default: {','.join(map(str, default_workers))})",
+    )
+    parser.add_argument("--mode", choices=MODES + ("both",), default="both", help="Phases to run (default: both)")
+    parser.add_argument("--duration", type=float, default=10.0, help="Seconds per phase (default: 10)")
+    parser.add_argument("--in-flight", type=int, default=64, help="Outstanding calls per worker (default: 64)")
+    parser.add_argument("--size", type=int, default=16, help="Echo message length in bytes (default: 16)")
+    parser.add_argument("--deliver", action="store_true", help="Send every telemetry row to this process")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. host)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def sim_device_ids(prefix: str, count: int) -> list[str]:
+    # Same names as sim_fleet.py
+    width = len(str(count - 1))
+    return [f"{prefix}-{i:0{width}d}" for i in range(count)]
+
+
+def percentile(sorted_values: list[float], q: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(q * len(sorted_values)))]
+
+
+# Worker-side response callback (module level: pickled by name)
+def echo_length(device_id: str, method: str, response: pb.EchoResponse) -> int:
+    return len(response.msg)
+
+
+class CallCounter:
+    """Completed calls and their latencies, from any thread."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.ok = 0
+        self.errors: dict[str, int] = {}
+        self.latencies_ms: list[float] = []
+
+    def add(self, started: float, error: Optional[str]):
+        latency_ms = (time.perf_counter() - started) * 1000.0
+        with self.lock:
+            if error is None:
+                self.ok += 1
+                self.latencies_ms.append(latency_ms)
+            else:
+                self.errors[error] = self.errors.get(error, 0) + 1
+
+    def result(self, elapsed: float) -> dict:
+        latencies = sorted(self.latencies_ms)
+        return {
+            "calls_per_s": round(self.ok / elapsed, 1),
+            "errors": self.errors,
+            "p50_ms": round(percentile(latencies, 0.50), 2) if latencies else None,
+            "p99_ms": round(percentile(latencies, 0.99), 2) if latencies else None,
+        }
+
+
+def calls_in_process(session: zenoh.Session, device_ids: list[str], args) -> dict:
+    clients = [DeviceServiceClient(ZenohRpcClient(session, d)) for d in device_ids]
+    msg = "x" * args.size
+    counter = CallCounter()
+    deadline = time.monotonic() + args.duration
+
+    def run(first: int):
+        i = first
+        while time.monotonic() < deadline:
+            started = time.perf_counter()
+            status, response = clients[i % len(clients)].echo(msg=msg)
+            if not status.success:
+                counter.add(started, status.error or "failed")
+            else:
+                counter.add(started, None if len(response.msg) == args.size else "wrong length")
+            i += args.in_flight
+
+    start = time.monotonic()
+    with ThreadPoolExecutor(max_workers=args.in_flight) as threads:
+        list(threads.map(run, range(args.in_flight)))
+    return counter.result(time.monotonic() - start)
+
+
+def calls_pool(pool: ClientPool, device_ids: list[str], args) -> dict:
+    request = {"msg": "x" * args.size}
+    counter = CallCounter()
+    slots = threading.BoundedSemaphore(args.in_flight * pool.workers)
+
+    def done(started: float, future: Future):
+        error = None
+        try:
+            if future.result() != args.size:
+                error = "wrong length"
+        except Exception as e:
+            error = str(e)
+        counter.add(started, error)
+        slots.release()
+
+    start = time.monotonic()
+    deadline = start + args.duration
+    i = 0
+    while time.monotonic() < deadline:
+        if not slots.acquire(timeout=0.1):
+            continue
+        started = time.perf_counter()
+        future = pool.submit(device_ids[i % len(device_ids)], "DeviceService", "Echo", request)
+        future.add_done_callback(lambda f, started=started: done(started, f))
+        i += 1
+    # Outstanding calls complete (or time out) before the next phase
+    for _ in range(args.in_flight * pool.workers):
+        slots.acquire()
+    return counter.result(time.monotonic() - start)
+
+
+def rates(before: tuple[int, int, int], after: tuple[int, int, int], elapsed: float) -> dict:
+    return {
+        "samples_per_s": round((after[0] - before[0]) / elapsed, 1),
+        "rows_per_s": round((after[1] - before[1]) / elapsed, 1),
+        "undecoded": after[2] - before[2],
+    }
+
+
+def telemetry_in_process(session: zenoh.Session, device_ids: list[str], args) -> dict:
+    decoder = TelemetryDecoder(None)
+    subscribers = ZenohSubscriberClient(session)
+    for device_id in device_ids:
+        subscribers.subscribe_sample(
+            f"{device_id}/telemetry/**", lambda k, p, a, d=device_id: decoder.decode(d, k, p, a)
+        )
+    try:
+        time.sleep(SETTLE_S)
+        before = (decoder.samples, decoder.rows, decoder.undecoded)
+        time.sleep(args.duration)
+        return rates(before, (decoder.samples, decoder.rows, decoder.undecoded), args.duration)
+    finally:
+        subscribers.unsubscribe_all()
+
+
+def telemetry_pool(pool: ClientPool, args) -> dict:
+    time.sleep(SETTLE_S)
+    if args.deliver:
+        before = pool.rows_delivered
+        time.sleep(args.duration)
+        rows_per_s = (pool.rows_delivered - before) / args.duration
+        return {"rows_per_s": round(rows_per_s, 1), "delivered": True}
+    # Worker totals arrive once per second: the lag is the same at both ends
+    before = pool.telemetry_totals()
+    time.sleep(args.duration)
+    return rates(before, pool.telemetry_totals(), args.duration)
+
+
+def run_workers(workers: int, device_ids: list[str], modes: list[str], args) -> dict:
+    row = {"workers": workers}
+    if workers == 0:
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        session = zenoh.open(config)
+        try:
+            if "calls" in modes:
+                row["calls"] = calls_in_process(session, device_ids, args)
+            if "telemetry" in modes:
+                row["telemetry"] = telemetry_in_process(session, device_ids, args)
+        finally:
+            session.close()
+        return row
+
+    pool = ClientPool(
+        args.connect,
+        device_ids,
+        workers=workers,
+        max_in_flight=args.in_flight,
+        on_response=echo_length,
+        telemetry="telemetry" in modes,
+        # Without --deliver the rows are only counted in the workers
+        on_telemetry=keep_row if args.deliver else None,
+    )
+    with pool:
+        if "calls" in modes:
+            row["calls"] = calls_pool(pool, device_ids, args)
+        if "telemetry" in modes:
+            row["telemetry"] = telemetry_pool(pool, args)
+    return row
+
+
+def main():
+    args = parse_args()
+    device_ids = [d for prefix in args.prefixes or ["sim"] for d in sim_device_ids(prefix, args.devices)]
+    worker_counts = [int(w) for w in args.workers.split(",")]
+    modes = list(MODES) if args.mode == "both" else [args.mode]
+
+    rows = []
+    for workers in worker_counts:
+        row = run_workers(workers, device_ids, modes, args)
+        rows.append(row)
+        logger.info(f"workers={workers} calls={row.get('calls')} telemetry={row.get('telemetry')}")
+
+    print(f"\n{'workers':>7s} {'calls/s':>10s} {'p50 ms':>8s} {'p99 ms':>8s} {'errors':>7s} {'rows/s':>10s}")
+    for row in rows:
+        calls = row.get("calls") or {}
+        telemetry = row.get("telemetry") or {}
+        print(
+            f"{row['workers']:7d} {calls.get('calls_per_s', 0):10.1f} {calls.get('p50_ms') or 0:8.2f} "
+            f"{calls.get('p99_ms') or 0:8.2f} {sum(calls.get('errors', {}).values()):7d} "
+            f"{telemetry.get('rows_per_s', 0):10.1f}"
+        )
+    if args.json:
+        with open(args.json, "a") as f:
+            record = {
+                "label": args.label,
+                "cpus": os.cpu_count(),
+                "devices": len(device_ids),
+                "in_flight": args.in_flight,
+                "size": args.size,
+                "rows": rows,
+            }
+            f.write(json.dumps(record) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,520 @@
+"""
+Client pool - RPC calls and telemetry decoding for many devices, sharded across worker processes.
+
+One interpreter decodes protobuf and runs callbacks on one core (the GIL), so a host talking to a large fleet
+plateaus there however many cores it has. The pool starts worker processes (spawned), each with its own zenoh
+session and a share of the devices (device i of the list goes to worker i % workers). Requests and results cross
+between the caller and a worker through a pair of shared-memory rings (shm_ring.py), pickled:
+
+    submit()        the worker builds the request (from a dict of fields, or takes it encoded) and sends the query
+                    with a callback handler: up to max_in_flight calls per worker are outstanding at once
+    on_response     runs in the worker on the decoded response; only its return value crosses back to the caller.
+                    None: the encoded response is returned undecoded
+    telemetry       each worker subscribes to <device>/telemetry/** of its devices and decodes the samples and
+                    compressed batches; on_telemetry runs there on every TelemetryRow (numeric fields) and what it
+                    returns, unless None, is handed to telemetry_sink in the caller, in chunks every few ms
+
+on_response and on_telemetry must be module-level functions: they are pickled by name for the workers. Results
+resolve concurrent.futures.Future objects from a collector thread, which also runs telemetry_sink.
+
+Usage:
+    with ClientPool("tcp/127.0.0.1:7447", device_ids, workers=4, on_response=echo_length) as pool:
+        futures = [pool.submit(d, "DeviceService", "Echo", {"msg": "hi"}) for d in device_ids]
+        lengths = [f.result() for f in futures]
+"""
+
+import functools
+import logging
+import math
+import multiprocessing
+import os
+import pickle
+import threading
+import time
+from concurrent.futures import Future
+from typing import Any, Callable, NamedTuple, Optional, Sequence, Union
+
+import zenoh
+from google.protobuf.message import Message
+
+from . import service_pb2 as pb
+from .service_client import TELEMETRY_TOPICS
+from .shm_ring import ShmRing
+from .telemetry_batch import BATCH_SUFFIX, decode_batch_payload
+from .telemetry_bus import numeric_columns
+from .zenoh_attachment import Attachment
+from .zenoh_rpc_client import ZenohRpcClient, ZenohSubscriberClient
+
+logger = logging.getLogger(__name__)
+
+# Message kinds (first item of the pickled tuple)
+_CALL = 0  # caller -> worker: (call_id, device_id, service, method, request, timeout_ms)
+_STOP = 1  # caller -> worker
+_RESULT = 2  # worker -> caller: (call_id, ok, value or error)
+_ROWS = 3  # worker -> caller: (list of on_telemetry results,)
+_READY = 4  # worker -> caller: (index, error or None)
+_STATS = 5  # worker -> caller: (index, samples, rows, undecoded)
+
+# Waits of an idle side before it looks again without a doorbell (missed wake-up bound)
+_IDLE_WAIT_S = 0.01
+# Retry interval of a put into a full ring
+_FULL_RETRY_S = 0.0005
+# Telemetry rows per chunk, and the longest a row waits in the worker
+_ROW_CHUNK = 256
+_ROW_FLUSH_S = 0.005
+_STATS_INTERVAL_S = 1.0
+
+
+class PoolCallError(Exception):
+    """A call failed in the worker (error reply, no reply, or an exception in on_response)."""
+
+
+class TelemetryRow(NamedTuple):
+    """One decoded telemetry sample (one per sample of a batch)."""
+
+    device_id: str
+    topic: str  # e.g. /telemetry/sensor
+    device_us: int  # SOURCE_TIMESTAMP_US, or the batch sample timestamp
+    sequence: int
+    values: tuple[float, ...]  # telemetry_columns(topic) order
+
+
+def telemetry_columns(topic: str) -> list[str]:
+    """Names of the TelemetryRow values of a topic."""
+    msg_cls = next((cls for suffix, cls in TELEMETRY_TOPICS.items() if topic.endswith(suffix)), None)
+    return numeric_columns(msg_cls) if msg_cls is not None else []
+
+
+def keep_row(row: TelemetryRow) -> TelemetryRow:
+    """Default on_telemetry: every row goes to the caller."""
+    return row
+
+
+class TelemetryDecoder:
+    """Decodes telemetry samples and batches into TelemetryRows (in the workers, or in-process for comparison)."""
+
+    def __init__(self, on_telemetry: Optional[Callable[[TelemetryRow], Any]] = keep_row):
+        self.on_telemetry = on_telemetry
+        self.samples = 0
+        self.rows = 0
+        self.undecoded = 0
+        self._columns: dict[type, list[str]] = {}
+
+    def decode(self, device_id: str, key_expr: str, payload: bytes, attachment: Optional[bytes]) -> list:
+        """on_telemetry results of the rows of one sample (None results left out)."""
+        is_batch = key_expr.endswith(BATCH_SUFFIX)
+        topic = key_expr[len(device_id) : -len(BATCH_SUFFIX) if is_batch else None]
+        msg_cls = next((cls for suffix, cls in TELEMETRY_TOPICS.items() if topic.endswith(suffix)), None)
+        if msg_cls is None:
+            self.undecoded += 1
+            return []
+        columns = self._columns.get(msg_cls)
+        if columns is None:
+            columns = self._columns[msg_cls] = numeric_columns(msg_cls)
+        att = Attachment.decode(attachment)
+        sequence = att.sequence or 0
+        try:
+            if is_batch:
+                batch = decode_batch_payload(payload, msg_cls)
+                series = [batch.columns.get(c) for c in columns]
+                rows = [
+                    TelemetryRow(
+                        device_id,
+                        topic,
+                        ts_ms * 1000,
+                        sequence,
+                        tuple(float(v[i]) if v is not None else math.nan for v in series),
+                    )
+                    for i, ts_ms in enumerate(batch.timestamps_ms)
+                ]
+            else:
+                msg = msg_cls()
+                msg.ParseFromString(payload)
+                values = tuple(float(getattr(msg, c)) for c in columns)
+                rows = [TelemetryRow(device_id, topic, att.source_timestamp_us or 0, sequence, values)]
+        except Exception as e:
+            logger.error(f"Failed to decode {msg_cls.__name__} from {key_expr}: {e}")
+            self.undecoded += 1
+            return []
+        self.samples += 1
+        self.rows += len(rows)
+        if self.on_telemetry is None:
+            return []
+        results = [self.on_telemetry(row) for row in rows]
+        return [r for r in results if r is not None]
+
+
+@functools.lru_cache(maxsize=None)
+def _method_types(service: str, method: str) -> tuple[type, type]:
+    """Request and response classes of a method of service.proto."""
+    desc = pb.DESCRIPTOR.services_by_name[service].methods_by_name[method]
+    return getattr(pb, desc.input_type.name), getattr(pb, desc.output_type.name)
+
+
+def _dumps(message: tuple) -> bytes:
+    return pickle.dumps(message, protocol=pickle.HIGHEST_PROTOCOL)
+
+
+def _put(ring: ShmRing, data: bytes):
+    """Put, waiting while the ring is full (the other side is behind)."""
+    while not ring.put(data):
+        time.sleep(_FULL_RETRY_S)
+
+
+class _Worker:
+    """Worker process side: one zenoh session for its share of the devices."""
+
+    def __init__(self, index: int, connect: str, device_ids: Sequence[str], client_id: str, requests, responses, opts):
+        self.index = index
+        self.requests = requests
+        self.responses = responses
+        self.on_response = opts["on_response"]
+        self.max_in_flight = opts["max_in_flight"]
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        self.session = zenoh.open(config)
+        self.clients = {d: ZenohRpcClient(self.session, d, client_id=client_id) for d in device_ids}
+        self.subscribers = ZenohSubscriberClient(self.session)
+        self.decoder = TelemetryDecoder(opts["on_telemetry"])
+        # Ring writes come from the zenoh callback threads and the main loop
+        self._send_lock = threading.Lock()
+        self._in_flight = threading.BoundedSemaphore(self.max_in_flight)
+        self._rows: list = []
+        self._rows_since = 0.0
+        if opts["telemetry"]:
+            for device_id in device_ids:
+                self.subscribers.subscribe_sample(
+                    f"{device_id}/telemetry/**", functools.partial(self.on_sample, device_id)
+                )
+
+    def send(self, message: tuple):
+        data = _dumps(message)
+        with self._send_lock:
+            _put(self.responses, data)
+
+    def call(self, call_id: int, device_id: str, service: str, method: str, request, timeout_ms: int):
+        client = self.clients.get(device_id)
+        if client is None:
+            self.send((_RESULT, call_id, False, f"{device_id} is not served by worker {self.index}"))
+            return
+        try:
+            request_cls, response_cls = _method_types(service, method)
+            payload = request_cls(**request).SerializeToString() if isinstance(request, dict) else request
+        except Exception as e:
+            self.send((_RESULT, call_id, False, f"Bad request: {e}"))
+            return
+
+        replied = False
+
+        def on_reply(reply):
+            nonlocal replied
+            if replied:
+                return
+            replied = True
+            if not reply.ok:
+                reason = bytes(reply.err.payload).decode("utf-8", errors="replace")
+                self.send((_RESULT, call_id, False, f"Reply error: {reason}"))
+                return
+            data = bytes(reply.ok.payload)
+            if self.on_response is None:
+                self.send((_RESULT, call_id, True, data))
+                return
+            try:
+                response = response_cls()
+                response.ParseFromString(data)
+                value = self.on_response(device_id, method, response)
+            except Exception as e:
+                self.send((_RESULT, call_id, False, f"on_response failed: {e}"))
+                return
+            self.send((_RESULT, call_id, True, value))
+
+        def on_done():
+            if not replied:
+                self.send((_RESULT, call_id, False, "No reply received"))
+            self._in_flight.release()
+
+        # The main loop stops taking requests while max_in_flight calls are outstanding
+        self._in_flight.acquire()
+        try:
+            self.session.get(
+                client.method_key(service, method),
+                zenoh.handlers.Callback(on_reply, on_done),
+                payload=payload,
+                timeout=timeout_ms / 1000.0,
+                attachment=client.attachment_for(None, timeout_ms),
+            )
+        except Exception as e:
+            self._in_flight.release()
+            self.send((_RESULT, call_id, False, str(e)))
+
+    def on_sample(self, device_id: str, key_expr: str, payload: bytes, attachment: Optional[bytes]):
+        results = self.decoder.decode(device_id, key_expr, payload, attachment)
+        if not results:
+            return
+        chunk = None
+        with self._send_lock:
+            if not self._rows:
+                self._rows_since = time.monotonic()
+            self._rows.extend(results)
+            if len(self._rows) >= _ROW_CHUNK:
+                chunk, self._rows = self._rows, []
+        if chunk:
+            self.send((_ROWS, chunk))
+
+    def flush_rows(self, force: bool = False):
+        with self._send_lock:
+            if not self._rows or (not force and time.monotonic() - self._rows_since < _ROW_FLUSH_S):
+                return
+            chunk, self._rows = self._rows, []
+        self.send((_ROWS, chunk))
+
+    def send_stats(self):
+        d = self.decoder
+        self.send((_STATS, self.index, d.samples, d.rows, d.undecoded))
+
+    def run(self):
+        self.send((_READY, self.index, None))
+        next_stats = time.monotonic() + _STATS_INTERVAL_S
+        while True:
+            data = self.requests.get()
+            now = time.monotonic()
+            if now >= next_stats:
+                next_stats = now + _STATS_INTERVAL_S
+                self.send_stats()
+            if data is None:
+                self.flush_rows()
+                self.requests.wait(_ROW_FLUSH_S if self._rows else _IDLE_WAIT_S)
+                continue
+            message = pickle.loads(data)
+            if message[0] == _STOP:
+                break
+            self.call(*message[1:])
+            self.flush_rows()
+
+    def close(self):
+        # Outstanding calls finish (reply or timeout) before the session goes
+        for _ in range(self.max_in_flight):
+            self._in_flight.acquire()
+        self.subscribers.unsubscribe_all()
+        self.flush_rows(force=True)
+        self.send_stats()
+        self.session.close()
+
+
+def _worker_main(index, connect, device_ids, client_id, request_spec, request_bell, response_spec, response_bell, opts):
+    requests = ShmRing.attach(request_spec, request_bell)
+    responses = ShmRing.attach(response_spec, response_bell)
+    try:
+        worker = _Worker(index, connect, device_ids, client_id, requests, responses, opts)
+    except Exception as e:
+        _put(responses, _dumps((_READY, index, str(e))))
+        return
+    try:
+        worker.run()
+    finally:
+        worker.close()
+        requests.close()
+        responses.close()
+
+
+class ClientPool:
+    """Calls and telemetry of many devices, served by worker processes (see the module docstring)."""
+
+    def __init__(
+        self,
+        connect: str,
+        device_ids: Sequence[str],
+        workers: Optional[int] = None,
+        max_in_flight: int = 64,
+        on_response: Optional[Callable[[str, str, Message], Any]] = None,
+        telemetry: bool = False,
+        on_telemetry: Optional[Callable[[TelemetryRow], Any]] = keep_row,
+        telemetry_sink: Optional[Callable[[Any], None]] = None,
+        client_id: Optional[str] = None,
+        ring_bytes: int = 1 << 22,
+    ):
+        if not device_ids:
+            raise ValueError("no devices")
+        self.connect = connect
+        self.device_ids = list(device_ids)
+        self.workers = max(1, min(workers or os.cpu_count() or 1, len(self.device_ids)))
+        self.telemetry_sink = telemetry_sink
+        self._opts = {
+            "on_response": on_response,
+            "on_telemetry": on_telemetry,
+            "telemetry": telemetry,
+            "max_in_flight": max_in_flight,
+        }
+        # One CLIENT_ID for the whole pool: the devices schedule it as one client
+        self._client_id = client_id or f"pool-{os.getpid()}"
+        self._ring_bytes = ring_bytes
+        self._worker_of = {d: i % self.workers for i, d in enumerate(self.device_ids)}
+        self._processes: list = []
+        self._requests: list[ShmRing] = []
+        self._request_locks = [threading.Lock() for _ in range(self.workers)]
+        self._responses: list[ShmRing] = []
+        self._futures: dict[int, Future] = {}
+        self._futures_lock = threading.Lock()
+        self._next_id = 0
+        self._ready: dict[int, Optional[str]] = {}
+        self._ready_event = threading.Event()
+        self._collector: Optional[threading.Thread] = None
+        self._stopping = False
+        # Totals of the workers (telemetry decoded there) and rows delivered to telemetry_sink
+        self.worker_stats: list[tuple[int, int, int]] = [(0, 0, 0)] * self.workers
+        self.rows_delivered = 0
+
+    def __enter__(self) -> "ClientPool":
+        self.start()
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def worker_of(self, device_id: str) -> int:
+        return self._worker_of[device_id]
+
+    def start(self, timeout: float = 30.0):
+        """Start the workers and wait until each has opened its session."""
+        ctx = multiprocessing.get_context("spawn")
+        response_bell = ctx.Semaphore(0)
+        shards = [self.device_ids[i :: self.workers] for i in range(self.workers)]
+        for index in range(self.workers):
+            request_bell = ctx.Semaphore(0)
+            requests = ShmRing.create(self._ring_bytes, request_bell)
+            responses = ShmRing.create(self._ring_bytes, response_bell)
+            self._requests.append(requests)
+            self._responses.append(responses)
+            args = (
+                index,
+                self.connect,
+                shards[index],
+                self._client_id,
+                requests.spec(),
+                request_bell,
+                responses.spec(),
+                response_bell,
+                self._opts,
+            )
+            process = ctx.Process(target=_worker_main, args=args, name=f"client-pool-{index}", daemon=True)
+            process.start()
+            self._processes.append(process)
+        self._response_bell = response_bell
+        self._collector = threading.Thread(target=self._collect, name="client-pool-collector", daemon=True)
+        self._collector.start()
+
+        deadline = time.monotonic() + timeout
+        while len(self._ready) < self.workers and time.monotonic() < deadline:
+            self._ready_event.wait(0.1)
+            self._ready_event.clear()
+        failed = {i: e for i, e in self._ready.items() if e is not None}
+        if len(self._ready) < self.workers or failed:
+            self.close()
+            raise RuntimeError(f"client pool workers did not start: {failed or 'timeout'}")
+        logger.info(f"Client pool: {self.workers} workers for {len(self.device_ids)} devices")
+
+    def submit(
+        self, device_id: str, service: str, method: str, request: Union[bytes, dict], timeout_ms: int = 5000
+    ) -> Future:
+        """
+        Call a method on a device; request is the encoded request or a dict of its fields (encoded in the worker).
+
+        The future resolves to the on_response result (or the encoded response), or raises PoolCallError.
+        """
+        index = self._worker_of[device_id]
+        future: Future = Future()
+        with self._futures_lock:
+            call_id = self._next_id
+            self._next_id += 1
+            self._futures[call_id] = future
+        data = _dumps((_CALL, call_id, device_id, service, method, request, timeout_ms))
+        with self._request_locks[index]:
+            _put(self._requests[index], data)
+        return future
+
+    def call(
+        self, device_id: str, service: str, method: str, request: Union[bytes, dict], timeout_ms: int = 5000
+    ) -> Any:
+        """Blocking submit()."""
+        return self.submit(device_id, service, method, request, timeout_ms).result()
+
+    def telemetry_totals(self) -> tuple[int, int, int]:
+        """Samples and rows decoded by the workers, and samples they could not decode (last reports)."""
+        return tuple(sum(s[i] for s in self.worker_stats) for i in range(3))
+
+    def _dispatch(self, message: tuple):
+        kind = message[0]
+        if kind == _RESULT:
+            _, call_id, ok, value = message
+            with self._futures_lock:
+                future = self._futures.pop(call_id, None)
+            if future is None:
+                return
+            if ok:
+                future.set_result(value)
+            else:
+                future.set_exception(PoolCallError(value))
+        elif kind == _ROWS:
+            rows = message[1]
+            self.rows_delivered += len(rows)
+            if self.telemetry_sink is not None:
+                for row in rows:
+                    self.telemetry_sink(row)
+        elif kind == _STATS:
+            _, index, samples, rows, undecoded = message
+            self.worker_stats[index] = (samples, rows, undecoded)
+        elif kind == _READY:
+            _, index, error = message
+            self._ready[index] = error
+            self._ready_event.set()
+
+    def _collect(self):
+        rings = self._responses
+        while True:
+            got = False
+            for ring in rings:
+                # A few messages per ring and turn: one busy worker does not hold up the others
+                for _ in range(64):
+                    data = ring.get()
+                    if data is None:
+                        break
+                    got = True
+                    try:
+                        self._dispatch(pickle.loads(data))
+                    except Exception as e:
+                        logger.error(f"Client pool: {e}")
+            if got:
+                continue
+            if self._stopping and not any(p.is_alive() for p in self._processes):
+                return
+            for ring in rings:
+                ring.set_waiting(True)
+            if all(ring.empty() for ring in rings):
+                self._response_bell.acquire(timeout=_IDLE_WAIT_S)
+            for ring in rings:
+                ring.set_waiting(False)
+
+    def close(self, timeout: float = 10.0):
+        """Stop the workers after their outstanding calls; calls still queued fail."""
+        if self._stopping:
+            return
+        self._stopping = True
+        stop = _dumps((_STOP,))
+        for index, ring in enumerate(self._requests):
+            if self._processes[index].is_alive():
+                with self._request_locks[index]:
+                    _put(ring, stop)
+        deadline = time.monotonic() + timeout
+        for process in self._processes:
+            process.join(max(0.0, deadline - time.monotonic()))
+            if process.is_alive():
+                process.terminate()
+        if self._collector is not None:
+            self._collector.join()
+        with self._futures_lock:
+            futures, self._futures = self._futures, {}
+        for future in futures.values():
+            future.set_exception(PoolCallError("client pool closed"))
+        for ring in self._requests + self._responses:
+            ring.close()
@@ -0,0 +1,93 @@
+"""
+Device Clock - host estimate of a device's monotonic clock, for timed RPC calls.
+
+The device answers <device>/rpc/clock with its monotonic time [us] in the SOURCE_TIMESTAMP_US reply attachment
+(ZenohRpcChannel::serve_clock()). The device read its clock somewhere within the round trip of the query, so each
+sample gives the offset to within half of the round trip; sync() keeps the sample with the shortest one. The offset
+drifts with the two oscillators (tens of ppm, i.e. tens of us per second): sync again before scheduling when the last
+sync is more than a few seconds old.
+
+Host times are time.monotonic_ns() // 1000 (host_us()), shared by all processes on the host.
+"""
+
+import time
+from dataclasses import dataclass
+from typing import Optional
+
+from .zenoh_attachment import Attachment
+from .zenoh_rpc_client import ZenohRpcClient
+
+CLOCK_KEY_SUFFIX = "rpc/clock"
+
+
+def host_us() -> int:
+    """Host monotonic time [us]."""
+    return time.monotonic_ns() // 1000
+
+
+@dataclass
+class ClockSample:
+    offset_us: float  # device clock - host clock at the same instant
+    rtt_us: int
+
+
+class DeviceClock:
+    """Offset between the host clock and one device's clock."""
+
+    def __init__(self, client: ZenohRpcClient):
+        self.client = client
+        self.offset_us: Optional[float] = None
+        # Bound of the offset error (half the round trip of the sample used)
+        self.error_us: Optional[float] = None
+        self.synced_at_us: Optional[int] = None
+
+    @property
+    def key_expr(self) -> str:
+        device_id = self.client.device_id
+        return f"{device_id}/{CLOCK_KEY_SUFFIX}" if device_id else CLOCK_KEY_SUFFIX
+
+    @property
+    def synced(self) -> bool:
+        return self.offset_us is not None
+
+    def sample(self, timeout_ms: int = 1000) -> Optional[ClockSample]:
+        """One clock query; None if the device did not answer (firmware without serve_clock())."""
+        t0 = host_us()
+        result = self.client.query(self.key_expr, timeout_ms=timeout_ms)
+        t1 = host_us()
+        if not result.success:
+            return None
+        device_us = Attachment.decode(result.attachment).source_timestamp_us
+        if device_us is None:
+            return None
+        return ClockSample(offset_us=device_us - (t0 + t1) / 2, rtt_us=t1 - t0)
+
+    def sync(self, samples: int = 8, timeout_ms: int = 1000) -> bool:
+        """Estimate the offset from the shortest of several round trips."""
+        best: Optional[ClockSample] = None
+        for _ in range(samples):
+            s = self.sample(timeout_ms)
+            if s is not None and (best is None or s.rtt_us < best.rtt_us):
+                best = s
+        if best is None:
+            return False
+        self.offset_us = best.offset_us
+        self.error_us = best.rtt_us / 2
+        self.synced_at_us = host_us()
+        return True
+
+    def age_s(self) -> Optional[float]:
+        """Seconds since the last sync."""
+        return None if self.synced_at_us is None else (host_us() - self.synced_at_us) / 1e6
+
+    def to_device_us(self, at_host_us: float) -> int:
+        """Device time of a host time (sync() first)."""
+        if self.offset_us is None:
+            raise RuntimeError(f"Clock of {self.client.device_id} not synced")
+        return int(round(at_host_us + self.offset_us))
+
+    def from_device_us(self, device_us: int) -> float:
+        """Host time of a device time (sync() first)."""
+        if self.offset_us is None:
+            raise RuntimeError(f"Clock of {self.client.device_id} not synced")
+        return device_us - self.offset_us
@@ -0,0 +1,110 @@
+"""
+Fleet View - latest telemetry of every device from one wildcard subscription per topic.
+
+A dashboard of thousands of devices cannot redraw on every sample: the subscription callbacks (zenoh threads) only
+keep the newest raw payload per device and topic, and the UI drains them at its frame rate. A device that published
+ten samples between two frames costs one decode and one row update; a device that published nothing costs nothing.
+"""
+
+import logging
+import threading
+import time
+from dataclasses import dataclass
+from typing import Dict, List, Optional, Tuple, Type
+
+from google.protobuf.message import Message
+
+from .proto_fields import is_repeated
+from .zenoh_rpc_client import ZenohSubscriberClient
+
+logger = logging.getLogger(__name__)
+
+# Digits of the float columns (float32 values otherwise show as 23.100000381)
+FLOAT_DIGITS = 3
+
+
+@dataclass
+class FleetStats:
+    samples: int = 0  # samples received
+    coalesced: int = 0  # samples replaced by a newer one before a frame drained them
+    decoded: int = 0  # samples decoded into row updates
+    errors: int = 0  # undecodable samples
+
+
+def row_values(message: Message) -> dict:
+    """Scalar fields of a telemetry message as table columns."""
+    values = {}
+    for fd in message.DESCRIPTOR.fields:
+        if fd.message_type is not None or is_repeated(fd):
+            continue
+        value = getattr(message, fd.name)
+        values[fd.name] = round(value, FLOAT_DIGITS) if isinstance(value, float) else value
+    return values
+
+
+class FleetTable:
+    """
+    Rows keyed by device ID, updated from `*<topic>` subscriptions.
+
+    drain() returns the rows added and changed since the previous call; call it from the UI loop at a fixed rate.
+    """
+
+    def __init__(self, sub_client: ZenohSubscriberClient, topics: Dict[str, Type[Message]]):
+        self.sub_client = sub_client
+        self.topics = topics
+        self.stats = FleetStats()
+        self.rows: Dict[str, dict] = {}
+        # (device ID, topic) -> (newest payload, samples since the last drain)
+        self._pending: Dict[Tuple[str, str], Tuple[bytes, int]] = {}
+        self._lock = threading.Lock()
+        self._sub_ids: List[str] = []
+
+    def subscribe(self):
+        for topic in self.topics:
+            key_expr = "*" + topic
+
+            def handler(key: str, data: bytes, attachment: Optional[bytes], topic=topic):
+                # Runs for every sample of every device: no decoding here
+                device_id = key[: -len(topic)]
+                with self._lock:
+                    self.stats.samples += 1
+                    previous = self._pending.get((device_id, topic))
+                    if previous is None:
+                        self._pending[(device_id, topic)] = (data, 1)
+                    else:
+                        self.stats.coalesced += 1
+                        self._pending[(device_id, topic)] = (data, previous[1] + 1)
+
+            self._sub_ids.append(self.sub_client.subscribe_sample(key_expr, handler))
+            logger.info(f"Fleet: subscribed to {key_expr}")
+
+    def unsubscribe(self):
+        for sub_id in self._sub_ids:
+            self.sub_client.unsubscribe(sub_id)
+        self._sub_ids.clear()
+
+    def drain(self) -> Tuple[List[dict], List[dict]]:
+        """Decode the newest pending sample per device and topic; returns (added rows, changed rows)."""
+        with self._lock:
+            pending, self._pending = self._pending, {}
+        added, changed = {}, {}
+        now = time.strftime("%H:%M:%S")
+        for (device_id, topic), (data, count) in pending.items():
+            try:
+                message = self.topics[topic]()
+                message.ParseFromString(data)
+            except Exception as e:
+                self.stats.errors += 1
+                logger.debug(f"Fleet: {device_id}{topic}: {e}")
+                continue
+            self.stats.decoded += 1
+            row = self.rows.get(device_id)
+            if row is None:
+                row = self.rows[device_id] = {"device_id": device_id, "samples": 0}
+                added[device_id] = row
+            elif device_id not in added:
+                changed[device_id] = row
+            row.update(row_values(message))
+            row["samples"] += count
+            row["last_seen"] = now
+        return list(added.values()), list(changed.values())
@@ -0,0 +1,255 @@
+"""
+RPC Gateway Client - talks to tools/rpc_gateway.py instead of opening a zenoh session.
+
+GatewayRpcClient and GatewaySubscriberClient expose the same interface as ZenohRpcClient and
+ZenohSubscriberClient, so the generated DeviceServiceClient / TelemetrySubscriber work unchanged.
+"""
+
+import http.client
+import logging
+import socket
+import struct
+import threading
+import urllib.parse
+from typing import BinaryIO, Callable, Iterator, Optional, Tuple
+
+from .zenoh_attachment import client_id_bytes, with_client_id
+from .zenoh_rpc_client import RpcResult
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_GATEWAY_URL = "http://127.0.0.1:7450"
+
+# Telemetry stream framing, little endian:
+# <u16 key_len><u32 payload_len><u16 attachment_len><key><payload><attachment>
+STREAM_CONTENT_TYPE = "application/x-zenoh-rpc-stream"
+# Query attachment of an RPC and attachment of the reply (hex)
+ATTACHMENT_HEADER = "X-Zenoh-Attachment"
+_FRAME_HEADER = struct.Struct("<HIH")
+
+
+def encode_frame(key_expr: str, payload: bytes, attachment: Optional[bytes] = None) -> bytes:
+    """Encode one telemetry sample for the gateway stream."""
+    key = key_expr.encode("utf-8")
+    attachment = attachment or b""
+    return _FRAME_HEADER.pack(len(key), len(payload), len(attachment)) + key + payload + attachment
+
+
+def read_frames(stream: BinaryIO) -> Iterator[Tuple[str, bytes, Optional[bytes]]]:
+    """Yield (key_expr, payload, attachment) frames until the stream is closed."""
+    while True:
+        header = stream.read(_FRAME_HEADER.size)
+        if len(header) < _FRAME_HEADER.size:
+            return
+        key_len, payload_len, attachment_len = _FRAME_HEADER.unpack(header)
+        key = stream.read(key_len)
+        payload = stream.read(payload_len)
+        attachment = stream.read(attachment_len)
+        if len(key) < key_len or len(payload) < payload_len or len(attachment) < attachment_len:
+            return
+        yield key.decode("utf-8"), payload, attachment or None
+
+
+class _UnixHTTPConnection(http.client.HTTPConnection):
+    """HTTPConnection over a Unix domain socket."""
+
+    def __init__(self, path: str, timeout: Optional[float] = None):
+        super().__init__("localhost", timeout=timeout)
+        self._path = path
+
+    def connect(self):
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        if self.timeout is not None:
+            sock.settimeout(self.timeout)
+        sock.connect(self._path)
+        self.sock = sock
+
+
+def _connect(base_url: str, timeout: Optional[float]) -> http.client.HTTPConnection:
+    """Open a connection to the gateway (http://host:port or unix:///path/to.sock)."""
+    url = urllib.parse.urlparse(base_url)
+    if url.scheme == "unix":
+        return _UnixHTTPConnection(url.path, timeout=timeout)
+    return http.client.HTTPConnection(url.hostname or "127.0.0.1", url.port or 80, timeout=timeout)
+
+
+class GatewayRpcClient:
+    """RPC client that forwards calls to the local gateway daemon."""
+
+    def __init__(self, base_url: str = DEFAULT_GATEWAY_URL, device_id: str = "", client_id: Optional[str] = None):
+        self.base_url = base_url
+        self.device_id = device_id
+        # Forwarded by the gateway: the device schedules per calling script, not per gateway
+        self.client_id = client_id_bytes(client_id)
+        self._local = threading.local()
+
+    def set_device_id(self, device_id: str):
+        """Set or clear the target device ID."""
+        self.device_id = device_id
+
+    def _connection(self, timeout: float) -> http.client.HTTPConnection:
+        # Keep one persistent connection per calling thread
+        conn = getattr(self._local, "conn", None)
+        if conn is None:
+            conn = _connect(self.base_url, timeout)
+            self._local.conn = conn
+        conn.timeout = timeout
+        return conn
+
+    def call(
+        self,
+        service_name: str,
+        method_name: str,
+        request_data: bytes,
+        timeout_ms: int = 5000,
+        attachment: Optional[bytes] = None,
+    ) -> RpcResult:
+        """Synchronous RPC call through the gateway."""
+        device = urllib.parse.quote(self.device_id or "-", safe="")
+        path = f"/rpc/{device}/{service_name}/{method_name}?timeout_ms={timeout_ms}"
+        headers = {"Content-Type": "application/x-protobuf"}
+        headers[ATTACHMENT_HEADER] = with_client_id(attachment, self.client_id).hex()
+        return self._request("POST", path, request_data, headers, timeout_ms)
+
+    def method(self, service_name: str, method_name: str, timeout_ms: int = 5000) -> "GatewayRpcMethod":
+        """Prepared calls of one method (same interface as ZenohRpcClient.method())."""
+        return GatewayRpcMethod(self, service_name, method_name, timeout_ms)
+
+    def query(self, key_expr: str, timeout_ms: int = 5000) -> RpcResult:
+        """Query an arbitrary key expression through the gateway (first reply, with its attachment)."""
+        path = f"/query/{urllib.parse.quote(key_expr, safe='/')}?timeout_ms={timeout_ms}"
+        headers = {ATTACHMENT_HEADER: with_client_id(None, self.client_id).hex()}
+        return self._request("GET", path, None, headers, timeout_ms)
+
+    def _request(
+        self, method: str, path: str, body: Optional[bytes], headers: dict[str, str], timeout_ms: int
+    ) -> RpcResult:
+        # Leave the gateway time to report its own upstream timeout
+        timeout = timeout_ms / 1000.0 + 1.0
+
+        for attempt in range(2):
+            conn = self._connection(timeout)
+            try:
+                conn.request(method, path, body=body, headers=headers)
+                resp = conn.getresponse()
+                data = resp.read()
+            except (http.client.HTTPException, OSError) as e:
+                conn.close()
+                self._local.conn = None
+                # A kept-alive connection may have been closed by the gateway; retry once
+                if attempt == 0:
+                    continue
+                logger.error(f"Gateway call failed: {e}")
+                return RpcResult(success=False, data=b"", error=str(e))
+
+            if resp.status == 200:
+                reply_attachment = resp.getheader(ATTACHMENT_HEADER)
+                return RpcResult(
+                    success=True, data=data, attachment=bytes.fromhex(reply_attachment) if reply_attachment else None
+                )
+            return RpcResult(success=False, data=b"", error=data.decode("utf-8", errors="replace") or resp.reason)
+
+        return RpcResult(success=False, data=b"", error="Gateway unreachable")
+
+
+class GatewayRpcMethod:
+    """Prepared calls of one method through the gateway: URL path and default headers built once."""
+
+    def __init__(self, client: GatewayRpcClient, service_name: str, method_name: str, timeout_ms: int = 5000):
+        self.client = client
+        self.service_name = service_name
+        self.method_name = method_name
+        self.timeout_ms = timeout_ms
+        self._device_id: Optional[str] = None
+        self._path = ""
+        self._headers: dict[str, str] = {}
+
+    def __call__(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """Call with an encoded request; attachment as for GatewayRpcClient.call()."""
+        client = self.client
+        if self._device_id != client.device_id:
+            self._device_id = client.device_id
+            device = urllib.parse.quote(client.device_id or "-", safe="")
+            self._path = f"/rpc/{device}/{self.service_name}/{self.method_name}?timeout_ms={self.timeout_ms}"
+            self._headers = {
+                "Content-Type": "application/x-protobuf",
+                ATTACHMENT_HEADER: with_client_id(None, client.client_id).hex(),
+            }
+        headers = self._headers
+        if attachment is not None:
+            headers = dict(headers)
+            headers[ATTACHMENT_HEADER] = with_client_id(attachment, client.client_id).hex()
+        return client._request("POST", self._path, payload, headers, self.timeout_ms)
+
+    def close(self):
+        pass
+
+
+class GatewaySubscriberClient:
+    """Subscriber that receives telemetry fanned out by the local gateway daemon."""
+
+    def __init__(self, base_url: str = DEFAULT_GATEWAY_URL):
+        self.base_url = base_url
+        self._subscribers: dict[str, Tuple[socket.socket, http.client.HTTPResponse]] = {}
+        self._lock = threading.Lock()
+        self._next_id = 0
+
+    def subscribe(self, key_expr: str, callback: Callable[[bytes], None], advanced=None) -> str:
+        """Subscribe to a topic."""
+        return self.subscribe_sample(key_expr, lambda _key, payload, _attachment: callback(payload), advanced)
+
+    def subscribe_sample(
+        self, key_expr: str, callback: Callable[[str, bytes, Optional[bytes]], None], advanced=None
+    ) -> str:
+        """
+        Subscribe to a topic; callback receives (key_expr, payload, attachment).
+
+        advanced (AdvancedSubscription) is not supported: the gateway shares one plain subscription per key
+        expression between its clients, so there is no history and no recovery.
+        """
+        if advanced is not None:
+            logger.warning(f"Gateway subscription to {key_expr} has no history/recovery")
+        conn = _connect(self.base_url, timeout=None)
+        conn.request("GET", "/sub/" + urllib.parse.quote(key_expr, safe="/*"))
+        # The response takes over the socket (Connection: close); keep it to interrupt the reader
+        sock = conn.sock
+        resp = conn.getresponse()
+        if resp.status != 200:
+            error = resp.read().decode("utf-8", errors="replace")
+            conn.close()
+            raise RuntimeError(f"Gateway subscribe failed: {resp.status} {error}")
+
+        def reader():
+            try:
+                for key, payload, attachment in read_frames(resp):
+                    callback(key, payload, attachment)
+            except (OSError, ValueError):
+                # Connection closed by unsubscribe()
+                pass
+
+        thread = threading.Thread(target=reader, name=f"gateway-sub-{key_expr}", daemon=True)
+        with self._lock:
+            self._next_id += 1
+            sub_id = str(self._next_id)
+            self._subscribers[sub_id] = (sock, resp)
+        thread.start()
+        return sub_id
+
+    def unsubscribe(self, sub_id: str):
+        """Unsubscribe from a topic."""
+        with self._lock:
+            entry = self._subscribers.pop(sub_id, None)
+        if entry:
+            sock, resp = entry
+            try:
+                sock.shutdown(socket.SHUT_RDWR)
+            except OSError:
+                pass
+            resp.close()
+
+    def unsubscribe_all(self):
+        """Unsubscribe from all topics."""
+        with self._lock:
+            sub_ids = list(self._subscribers.keys())
+        for sub_id in sub_ids:
+            self.unsubscribe(sub_id)
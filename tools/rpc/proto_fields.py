@@ -0,0 +1,11 @@
+"""
+Proto fields - descriptor helpers shared by the host tools (telemetry columns, state deltas, field masks).
+"""
+
+from google.protobuf.descriptor import FieldDescriptor
+
+
+def is_repeated(fd: FieldDescriptor) -> bool:
+    """True for repeated fields, across protobuf releases."""
+    # FieldDescriptor.label was removed in protobuf 7 (is_repeated replaces it)
+    return fd.is_repeated if hasattr(fd, "is_repeated") else fd.label == FieldDescriptor.LABEL_REPEATED
@@ -0,0 +1,22 @@
+"""
+Router limits of the telemetry topics per consumer class (generated from the max_rate / max_payload
+options in service.proto). tools/start_router.py turns them into zenohd configuration.
+"""
+
+# Consumer class -> [(key expression, samples per second)]
+DOWNSAMPLING = {
+    "lan": [
+        ("*/telemetry/sensor", 10.0),
+    ],
+    "wan": [
+        ("*/telemetry/sensor", 1.0),
+    ],
+}
+
+# Consumer class -> [(key expression, largest payload in bytes)]
+LOW_PASS = {
+    "wan": [
+        ("*/telemetry/sensor", 256),
+        ("*/telemetry/sensor/batch", 256),
+    ],
+}
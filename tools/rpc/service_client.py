@@ -1,7 +1,12 @@
 import logging
 from dataclasses import dataclass
-from typing import Callable, Optional, Tuple, Union, List
-from .zenoh_rpc_client import ZenohRpcClient, ZenohSubscriberClient, RpcResult, RpcResponse
+from typing import Callable, Optional, Sequence, Tuple, Union, List
+from .zenoh_rpc_client import AdvancedSubscription, ZenohRpcClient, ZenohSubscriberClient, RpcResult, RpcResponse
+from .zenoh_attachment import field_mask_attachment
+from .telemetry_stats import TelemetryStats
+from .telemetry_batch import BATCH_SUFFIX, TelemetryColumns, decode_batch_payload
+from .state_mirror import StateMirror
+from .zenoh_stream import BidiStream, DEFAULT_WINDOW
 from . import service_pb2 as pb
 
 
@@ -10,88 +15,321 @@ class DeviceServiceClient:
 
     def __init__(self, rpc_client: ZenohRpcClient):
         self.rpc_client = rpc_client
+        # Prepared calls: key expression (and querier) set up once per method
+        self._set_led = rpc_client.method(self.SERVICE_NAME, "SetLed")
+        self._echo = rpc_client.method(self.SERVICE_NAME, "Echo")
+        self._echo_malloc = rpc_client.method(self.SERVICE_NAME, "EchoMalloc")
+        self._start_sensor_stream = rpc_client.method(self.SERVICE_NAME, "StartSensorStream")
+        self._stop_sensor_stream = rpc_client.method(self.SERVICE_NAME, "StopSensorStream")
+        self._configure_wifi = rpc_client.method(self.SERVICE_NAME, "ConfigureWifi")
+        self._set_log_level = rpc_client.method(self.SERVICE_NAME, "SetLogLevel")
+        self._set_rules = rpc_client.method(self.SERVICE_NAME, "SetRules")
 
-    def set_led(self, request: Optional[pb.LedRequest] = None, *, on: Optional[bool] = None) -> tuple[RpcResponse, Optional[pb.LedResponse]]:
-        """SetLed RPC call."""
+    def set_led(self, request: Optional[pb.LedRequest] = None, *, on: Optional[bool] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.LedResponse]]:
+        """SetLed RPC call; fields limits the response to the named fields."""
         if request is None:
             request = pb.LedRequest(on=on)
 
-        result = self.rpc_client.call(self.SERVICE_NAME, "SetLed", request.SerializeToString())
+        result = self._set_led(request.SerializeToString(), field_mask_attachment(pb.LedResponse, fields))
         if result.success:
             response = pb.LedResponse()
             response.ParseFromString(result.data)
             return RpcResponse(success=True), response
         return RpcResponse(success=False, error=result.error), None
 
-    def echo(self, request: Optional[pb.EchoRequest] = None, *, msg: Optional[str] = None) -> tuple[RpcResponse, Optional[pb.EchoResponse]]:
-        """Echo RPC call."""
+    def set_led_into(self, request: pb.LedRequest, response: pb.LedResponse, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """SetLed with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._set_led(request.SerializeToString(), field_mask_attachment(pb.LedResponse, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def set_led_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """SetLed with an encoded LedRequest; result.data is the encoded LedResponse."""
+        return self._set_led(payload, attachment)
+
+    def echo(self, request: Optional[pb.EchoRequest] = None, *, msg: Optional[str] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.EchoResponse]]:
+        """Echo RPC call; fields limits the response to the named fields."""
         if request is None:
             request = pb.EchoRequest(msg=msg)
 
-        result = self.rpc_client.call(self.SERVICE_NAME, "Echo", request.SerializeToString())
+        result = self._echo(request.SerializeToString(), field_mask_attachment(pb.EchoResponse, fields))
         if result.success:
             response = pb.EchoResponse()
             response.ParseFromString(result.data)
             return RpcResponse(success=True), response
         return RpcResponse(success=False, error=result.error), None
 
-    def echo_malloc(self, request: Optional[pb.EchoRequestMalloc] = None, *, msg: Optional[bytes] = None) -> tuple[RpcResponse, Optional[pb.EchoResponseMalloc]]:
-        """EchoMalloc RPC call."""
+    def echo_into(self, request: pb.EchoRequest, response: pb.EchoResponse, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """Echo with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._echo(request.SerializeToString(), field_mask_attachment(pb.EchoResponse, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def echo_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """Echo with an encoded EchoRequest; result.data is the encoded EchoResponse."""
+        return self._echo(payload, attachment)
+
+    def echo_malloc(self, request: Optional[pb.EchoRequestMalloc] = None, *, msg: Optional[bytes] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.EchoResponseMalloc]]:
+        """EchoMalloc RPC call; fields limits the response to the named fields."""
         if request is None:
             request = pb.EchoRequestMalloc(msg=msg)
 
-        result = self.rpc_client.call(self.SERVICE_NAME, "EchoMalloc", request.SerializeToString())
+        result = self._echo_malloc(request.SerializeToString(), field_mask_attachment(pb.EchoResponseMalloc, fields))
         if result.success:
             response = pb.EchoResponseMalloc()
             response.ParseFromString(result.data)
             return RpcResponse(success=True), response
         return RpcResponse(success=False, error=result.error), None
 
-    def start_sensor_stream(self, request: Optional[pb.SensorRequest] = None) -> RpcResponse:
+    def echo_malloc_into(self, request: pb.EchoRequestMalloc, response: pb.EchoResponseMalloc, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """EchoMalloc with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._echo_malloc(request.SerializeToString(), field_mask_attachment(pb.EchoResponseMalloc, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def echo_malloc_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """EchoMalloc with an encoded EchoRequestMalloc; result.data is the encoded EchoResponseMalloc."""
+        return self._echo_malloc(payload, attachment)
+
+    def start_sensor_stream(self, request: Optional[pb.SensorRequest] = None, *, batch_size: Optional[int] = None) -> RpcResponse:
         """StartSensorStream RPC call."""
         if request is None:
-            request = pb.SensorRequest()
+            request = pb.SensorRequest(batch_size=batch_size)
 
-        result = self.rpc_client.call(self.SERVICE_NAME, "StartSensorStream", request.SerializeToString())
+        result = self._start_sensor_stream(request.SerializeToString())
         if result.success:
             return RpcResponse(success=True)
         return RpcResponse(success=False, error=result.error)
 
+    def start_sensor_stream_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """StartSensorStream with an encoded SensorRequest; result.data is the encoded Empty."""
+        return self._start_sensor_stream(payload, attachment)
+
     def stop_sensor_stream(self, request: Optional[pb.Empty] = None) -> RpcResponse:
         """StopSensorStream RPC call."""
         if request is None:
             request = pb.Empty()
 
-        result = self.rpc_client.call(self.SERVICE_NAME, "StopSensorStream", request.SerializeToString())
+        result = self._stop_sensor_stream(request.SerializeToString())
         if result.success:
             return RpcResponse(success=True)
         return RpcResponse(success=False, error=result.error)
 
+    def stop_sensor_stream_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """StopSensorStream with an encoded Empty; result.data is the encoded Empty."""
+        return self._stop_sensor_stream(payload, attachment)
+
     def configure_wifi(self, request: Optional[pb.WifiSettings] = None, *, ssid: Optional[str] = None, password: Optional[str] = None) -> RpcResponse:
         """ConfigureWifi RPC call."""
         if request is None:
             request = pb.WifiSettings(ssid=ssid, password=password)
 
-        result = self.rpc_client.call(self.SERVICE_NAME, "ConfigureWifi", request.SerializeToString())
+        result = self._configure_wifi(request.SerializeToString())
+        if result.success:
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def configure_wifi_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """ConfigureWifi with an encoded WifiSettings; result.data is the encoded Empty."""
+        return self._configure_wifi(payload, attachment)
+
+    def set_log_level(self, request: Optional[pb.LogLevelRequest] = None, *, module: Optional[str] = None, level: Optional[Union[int, str]] = None, rate_per_s: Optional[int] = None, burst: Optional[int] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.LogLevelResponse]]:
+        """SetLogLevel RPC call; fields limits the response to the named fields."""
+        if request is None:
+            request = pb.LogLevelRequest(module=module, level=level, rate_per_s=rate_per_s, burst=burst)
+
+        result = self._set_log_level(request.SerializeToString(), field_mask_attachment(pb.LogLevelResponse, fields))
+        if result.success:
+            response = pb.LogLevelResponse()
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True), response
+        return RpcResponse(success=False, error=result.error), None
+
+    def set_log_level_into(self, request: pb.LogLevelRequest, response: pb.LogLevelResponse, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """SetLogLevel with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._set_log_level(request.SerializeToString(), field_mask_attachment(pb.LogLevelResponse, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def set_log_level_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """SetLogLevel with an encoded LogLevelRequest; result.data is the encoded LogLevelResponse."""
+        return self._set_log_level(payload, attachment)
+
+    def set_rules(self, request: Optional[pb.RuleSet] = None, *, rules: Optional[Sequence[pb.Rule]] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.SetRulesResponse]]:
+        """SetRules RPC call; fields limits the response to the named fields."""
+        if request is None:
+            request = pb.RuleSet(rules=rules)
+
+        result = self._set_rules(request.SerializeToString(), field_mask_attachment(pb.SetRulesResponse, fields))
+        if result.success:
+            response = pb.SetRulesResponse()
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True), response
+        return RpcResponse(success=False, error=result.error), None
+
+    def set_rules_into(self, request: pb.RuleSet, response: pb.SetRulesResponse, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """SetRules with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._set_rules(request.SerializeToString(), field_mask_attachment(pb.SetRulesResponse, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def set_rules_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """SetRules with an encoded RuleSet; result.data is the encoded SetRulesResponse."""
+        return self._set_rules(payload, attachment)
+
+    def open_echo_stream(self, on_message: Optional[Callable[[pb.EchoResponse], None]] = None, window: int = DEFAULT_WINDOW) -> BidiStream:
+        """Open a stream of EchoStream: send() EchoRequests, receive EchoResponses (on_message or recv())."""
+        return BidiStream.open(self.rpc_client, self.SERVICE_NAME, "EchoStream", pb.StreamControl, pb.EchoResponse, on_message, window)
+
+class BenchServiceClient:
+    SERVICE_NAME = "BenchService"
+
+    def __init__(self, rpc_client: ZenohRpcClient):
+        self.rpc_client = rpc_client
+        # Prepared calls: key expression (and querier) set up once per method
+        self._ping = rpc_client.method(self.SERVICE_NAME, "Ping")
+        self._sink = rpc_client.method(self.SERVICE_NAME, "Sink")
+        self._source = rpc_client.method(self.SERVICE_NAME, "Source")
+        self._start_publisher = rpc_client.method(self.SERVICE_NAME, "StartPublisher")
+        self._stop_publisher = rpc_client.method(self.SERVICE_NAME, "StopPublisher")
+
+    def ping(self, request: Optional[pb.Empty] = None) -> RpcResponse:
+        """Ping RPC call."""
+        if request is None:
+            request = pb.Empty()
+
+        result = self._ping(request.SerializeToString())
+        if result.success:
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def ping_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """Ping with an encoded Empty; result.data is the encoded Empty."""
+        return self._ping(payload, attachment)
+
+    def sink(self, request: Optional[pb.BenchPayload] = None, *, data: Optional[bytes] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.BenchSinkResponse]]:
+        """Sink RPC call; fields limits the response to the named fields."""
+        if request is None:
+            request = pb.BenchPayload(data=data)
+
+        result = self._sink(request.SerializeToString(), field_mask_attachment(pb.BenchSinkResponse, fields))
+        if result.success:
+            response = pb.BenchSinkResponse()
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True), response
+        return RpcResponse(success=False, error=result.error), None
+
+    def sink_into(self, request: pb.BenchPayload, response: pb.BenchSinkResponse, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """Sink with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._sink(request.SerializeToString(), field_mask_attachment(pb.BenchSinkResponse, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def sink_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """Sink with an encoded BenchPayload; result.data is the encoded BenchSinkResponse."""
+        return self._sink(payload, attachment)
+
+    def source(self, request: Optional[pb.BenchSourceRequest] = None, *, size: Optional[int] = None, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.BenchPayload]]:
+        """Source RPC call; fields limits the response to the named fields."""
+        if request is None:
+            request = pb.BenchSourceRequest(size=size)
+
+        result = self._source(request.SerializeToString(), field_mask_attachment(pb.BenchPayload, fields))
+        if result.success:
+            response = pb.BenchPayload()
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True), response
+        return RpcResponse(success=False, error=result.error), None
+
+    def source_into(self, request: pb.BenchSourceRequest, response: pb.BenchPayload, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """Source with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._source(request.SerializeToString(), field_mask_attachment(pb.BenchPayload, fields))
+        if result.success:
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def source_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """Source with an encoded BenchSourceRequest; result.data is the encoded BenchPayload."""
+        return self._source(payload, attachment)
+
+    def start_publisher(self, request: Optional[pb.BenchPublishRequest] = None, *, rate_hz: Optional[int] = None, size: Optional[int] = None, duration_ms: Optional[int] = None, express: Optional[bool] = None) -> RpcResponse:
+        """StartPublisher RPC call."""
+        if request is None:
+            request = pb.BenchPublishRequest(rate_hz=rate_hz, size=size, duration_ms=duration_ms, express=express)
+
+        result = self._start_publisher(request.SerializeToString())
+        if result.success:
+            return RpcResponse(success=True)
+        return RpcResponse(success=False, error=result.error)
+
+    def start_publisher_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """StartPublisher with an encoded BenchPublishRequest; result.data is the encoded Empty."""
+        return self._start_publisher(payload, attachment)
+
+    def stop_publisher(self, request: Optional[pb.Empty] = None, *, fields: Optional[Sequence[str]] = None) -> tuple[RpcResponse, Optional[pb.BenchPublisherStats]]:
+        """StopPublisher RPC call; fields limits the response to the named fields."""
+        if request is None:
+            request = pb.Empty()
+
+        result = self._stop_publisher(request.SerializeToString(), field_mask_attachment(pb.BenchPublisherStats, fields))
+        if result.success:
+            response = pb.BenchPublisherStats()
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True), response
+        return RpcResponse(success=False, error=result.error), None
+
+    def stop_publisher_into(self, request: pb.Empty, response: pb.BenchPublisherStats, fields: Optional[Sequence[str]] = None) -> RpcResponse:
+        """StopPublisher with caller-owned messages, reusable across calls (response is parsed in place)."""
+        result = self._stop_publisher(request.SerializeToString(), field_mask_attachment(pb.BenchPublisherStats, fields))
         if result.success:
+            response.ParseFromString(result.data)
             return RpcResponse(success=True)
         return RpcResponse(success=False, error=result.error)
 
+    def stop_publisher_raw(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """StopPublisher with an encoded Empty; result.data is the encoded BenchPublisherStats."""
+        return self._stop_publisher(payload, attachment)
+
+TELEMETRY_TOPICS = {
+    "/telemetry/sensor": pb.SensorTelemetry,
+}
+
+
 class TelemetrySubscriber:
     """Subscriber for telemetry data from device."""
 
-    def __init__(self, sub_client: ZenohSubscriberClient, device_id: str, logger: Optional[logging.Logger] = None):
+    def __init__(self, sub_client: ZenohSubscriberClient, device_id: str, logger: Optional[logging.Logger] = None,
+                 stats: Optional[TelemetryStats] = None, advanced: Optional[AdvancedSubscription] = None):
         self.sub_client = sub_client
         self.device_id = device_id
         self._sub_ids: List[str] = []
         self.logger = logger or logging.getLogger(__name__)
+        # Sequence/latency accounting from the sample attachments (optional)
+        self.stats = stats
+        # Late-joiner history / gap recovery from the device publication cache
+        self.advanced = advanced
 
     def subscribe_sensor(self, callback: Callable[[pb.SensorTelemetry], None]):
         """Subscribe to sensor telemetry."""
         key_expr = f"{self.device_id}/telemetry/sensor"
         self.logger.info(f"Subscribing to: {key_expr}")
 
-        def handler(data: bytes):
+        def handler(key: str, data: bytes, attachment: Optional[bytes]):
+            if self.stats is not None:
+                self.stats.observe(key, attachment)
             try:
                 payload = pb.SensorTelemetry()
                 payload.ParseFromString(data)
@@ -99,7 +337,25 @@ class TelemetrySubscriber:
             except Exception as e:
                 self.logger.error(f"Failed to parse SensorTelemetry: {e}")
 
-        sub_id = self.sub_client.subscribe(key_expr, handler)
+        sub_id = self.sub_client.subscribe_sample(key_expr, handler, advanced=self.advanced)
+        self._sub_ids.append(sub_id)
+
+    def subscribe_sensor_batch(self, callback: Callable[[TelemetryColumns], None]):
+        """Subscribe to compressed sensor telemetry batches (decoded per column)."""
+        key_expr = f"{self.device_id}/telemetry/sensor{BATCH_SUFFIX}"
+        self.logger.info(f"Subscribing to: {key_expr}")
+
+        def handler(key: str, data: bytes, attachment: Optional[bytes]):
+            if self.stats is not None:
+                self.stats.observe(key, attachment)
+            try:
+                columns = decode_batch_payload(data, pb.SensorTelemetry)
+            except Exception as e:
+                self.logger.error(f"Failed to decode SensorTelemetry batch: {e}")
+                return
+            callback(columns)
+
+        sub_id = self.sub_client.subscribe_sample(key_expr, handler, advanced=self.advanced)
         self._sub_ids.append(sub_id)
 
     def unsubscribe_all(self):
@@ -108,3 +364,18 @@ class TelemetrySubscriber:
             self.sub_client.unsubscribe(sid)
         self._sub_ids.clear()
         self.logger.info("Unsubscribed from all telemetry topics")
+
+
+STATE_TOPICS = {
+    "/state": pb.DeviceState,
+}
+
+
+def mirror_device_state(
+    rpc_client: ZenohRpcClient,
+    sub_client: ZenohSubscriberClient,
+    device_id: str,
+    on_change: Optional[Callable[[pb.DeviceState, List[str]], None]] = None,
+) -> StateMirror:
+    """Local copy of the device DeviceState, kept up to date from deltas (call start())."""
+    return StateMirror(rpc_client, sub_client, device_id, "/state", pb.DeviceState, on_change)
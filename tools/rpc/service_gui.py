@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 import asyncio
 import json
+import time
 from datetime import datetime
 from functools import partial
 from google.protobuf.json_format import MessageToDict
@@ -10,6 +11,7 @@ from nicegui import app, ui
 from . import service_client as service_client
 from . import service_pb2 as pb
 from .zenoh_rpc_client import ZenohSubscriberClient, LogSubscriber
+from .fleet_view import FleetTable
 
 def create_ui(zenoh_client, default_device_id='pico2w-001'):
     # Subscriber Client
@@ -117,13 +119,22 @@ def create_ui(zenoh_client, default_device_id='pico2w-001'):
 
                     with ui.column().classes('w-full p-0'):
                         with ui.expansion('StartSensorStream', icon='api').classes('w-full').bind_value(app.storage.user, 'DeviceService.StartSensorStream.expansion'):
+                            inputs_start_sensor_stream = {}
+                            with ui.column().classes('w-full gap-2 p-2'):
+                                inputs_start_sensor_stream['batch_size'] = ui.number(label='Batch size', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'DeviceService.StartSensorStream.batch_size')
                             result_area_start_sensor_stream = ui.markdown().classes('w-full mt-2 text-sm')
 
                             async def call_start_sensor_stream():
                                 zenoh_client.set_device_id(device_id_input.value)
                                 result_area_start_sensor_stream.set_content('⏳ Calling RPC...')
                                 await asyncio.sleep(0.01) # Allow UI to update
-                                call_func = device_service_client.start_sensor_stream
+                                kwargs = {}
+                                try:
+                                    kwargs['batch_size'] = int(inputs_start_sensor_stream['batch_size'].value)
+                                except (ValueError, TypeError):
+                                    result_area_start_sensor_stream.set_content('❌ Invalid input for `batch_size`')
+                                    return
+                                call_func = partial(device_service_client.start_sensor_stream, **kwargs)
                                 call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
                                 response, payload = call_result, None
                                 if response.success:
@@ -188,6 +199,204 @@ def create_ui(zenoh_client, default_device_id='pico2w-001'):
 
                             ui.button('Execute', on_click=call_configure_wifi).classes('w-full mt-2')
 
+                    with ui.column().classes('w-full p-0'):
+                        with ui.expansion('SetLogLevel', icon='api').classes('w-full').bind_value(app.storage.user, 'DeviceService.SetLogLevel.expansion'):
+                            inputs_set_log_level = {}
+                            with ui.column().classes('w-full gap-2 p-2'):
+                                inputs_set_log_level['module'] = ui.input(label='Module').classes('w-full').bind_value(app.storage.user, 'DeviceService.SetLogLevel.module')
+                                inputs_set_log_level['level'] = ui.select(['LOG_LEVEL_DEBUG', 'LOG_LEVEL_INFO', 'LOG_LEVEL_WARN', 'LOG_LEVEL_ERROR', 'LOG_LEVEL_OFF'], label='Level', value='LOG_LEVEL_DEBUG').classes('w-full').bind_value(app.storage.user, 'DeviceService.SetLogLevel.level')
+                                inputs_set_log_level['rate_per_s'] = ui.number(label='Rate per s', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'DeviceService.SetLogLevel.rate_per_s')
+                                inputs_set_log_level['burst'] = ui.number(label='Burst', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'DeviceService.SetLogLevel.burst')
+                            result_area_set_log_level = ui.markdown().classes('w-full mt-2 text-sm')
+
+                            async def call_set_log_level():
+                                zenoh_client.set_device_id(device_id_input.value)
+                                result_area_set_log_level.set_content('⏳ Calling RPC...')
+                                await asyncio.sleep(0.01) # Allow UI to update
+                                kwargs = {}
+                                kwargs['module'] = inputs_set_log_level['module'].value
+                                kwargs['level'] = inputs_set_log_level['level'].value
+                                try:
+                                    kwargs['rate_per_s'] = int(inputs_set_log_level['rate_per_s'].value)
+                                except (ValueError, TypeError):
+                                    result_area_set_log_level.set_content('❌ Invalid input for `rate_per_s`')
+                                    return
+                                try:
+                                    kwargs['burst'] = int(inputs_set_log_level['burst'].value)
+                                except (ValueError, TypeError):
+                                    result_area_set_log_level.set_content('❌ Invalid input for `burst`')
+                                    return
+                                call_func = partial(device_service_client.set_log_level, **kwargs)
+                                call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
+                                response, payload = call_result
+                                if response.success:
+                                    md_content = '##### ✅ Success\n\n'
+                                    if payload:
+                                        md_content += '```\n' + str(payload).strip() + '\n```'
+                                    result_area_set_log_level.set_content(md_content)
+                                else:
+                                    md_content = f'##### ❌ Error\n\n{response.error}'
+                                    result_area_set_log_level.set_content(md_content)
+
+                            ui.button('Execute', on_click=call_set_log_level).classes('w-full mt-2')
+
+            # --- BenchService Service --- 
+            bench_service_client = service_client.BenchServiceClient(zenoh_client)
+
+            with ui.card().classes('w-full mb-2'):
+                ui.label('BenchService').classes('text-xl font-semibold')
+                with ui.grid(columns=3).classes('w-full gap-4'):
+                    with ui.column().classes('w-full p-0'):
+                        with ui.expansion('Ping', icon='api').classes('w-full').bind_value(app.storage.user, 'BenchService.Ping.expansion'):
+                            result_area_ping = ui.markdown().classes('w-full mt-2 text-sm')
+
+                            async def call_ping():
+                                zenoh_client.set_device_id(device_id_input.value)
+                                result_area_ping.set_content('⏳ Calling RPC...')
+                                await asyncio.sleep(0.01) # Allow UI to update
+                                call_func = bench_service_client.ping
+                                call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
+                                response, payload = call_result, None
+                                if response.success:
+                                    md_content = '##### ✅ Success\n\n'
+                                    if payload:
+                                        md_content += '```\n' + str(payload).strip() + '\n```'
+                                    result_area_ping.set_content(md_content)
+                                else:
+                                    md_content = f'##### ❌ Error\n\n{response.error}'
+                                    result_area_ping.set_content(md_content)
+
+                            ui.button('Execute', on_click=call_ping).classes('w-full mt-2')
+
+                    with ui.column().classes('w-full p-0'):
+                        with ui.expansion('Sink', icon='api').classes('w-full').bind_value(app.storage.user, 'BenchService.Sink.expansion'):
+                            inputs_sink = {}
+                            with ui.column().classes('w-full gap-2 p-2'):
+                                inputs_sink['data'] = ui.input(label='Data').classes('w-full').bind_value(app.storage.user, 'BenchService.Sink.data')
+                            result_area_sink = ui.markdown().classes('w-full mt-2 text-sm')
+
+                            async def call_sink():
+                                zenoh_client.set_device_id(device_id_input.value)
+                                result_area_sink.set_content('⏳ Calling RPC...')
+                                await asyncio.sleep(0.01) # Allow UI to update
+                                kwargs = {}
+                                val_data = inputs_sink['data'].value
+                                if val_data.startswith('0x'):
+                                    kwargs['data'] = bytes.fromhex(val_data[2:])
+                                else:
+                                    kwargs['data'] = val_data.encode('utf-8')
+                                call_func = partial(bench_service_client.sink, **kwargs)
+                                call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
+                                response, payload = call_result
+                                if response.success:
+                                    md_content = '##### ✅ Success\n\n'
+                                    if payload:
+                                        md_content += '```\n' + str(payload).strip() + '\n```'
+                                    result_area_sink.set_content(md_content)
+                                else:
+                                    md_content = f'##### ❌ Error\n\n{response.error}'
+                                    result_area_sink.set_content(md_content)
+
+                            ui.button('Execute', on_click=call_sink).classes('w-full mt-2')
+
+                    with ui.column().classes('w-full p-0'):
+                        with ui.expansion('Source', icon='api').classes('w-full').bind_value(app.storage.user, 'BenchService.Source.expansion'):
+                            inputs_source = {}
+                            with ui.column().classes('w-full gap-2 p-2'):
+                                inputs_source['size'] = ui.number(label='Size', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'BenchService.Source.size')
+                            result_area_source = ui.markdown().classes('w-full mt-2 text-sm')
+
+                            async def call_source():
+                                zenoh_client.set_device_id(device_id_input.value)
+                                result_area_source.set_content('⏳ Calling RPC...')
+                                await asyncio.sleep(0.01) # Allow UI to update
+                                kwargs = {}
+                                try:
+                                    kwargs['size'] = int(inputs_source['size'].value)
+                                except (ValueError, TypeError):
+                                    result_area_source.set_content('❌ Invalid input for `size`')
+                                    return
+                                call_func = partial(bench_service_client.source, **kwargs)
+                                call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
+                                response, payload = call_result
+                                if response.success:
+                                    md_content = '##### ✅ Success\n\n'
+                                    if payload:
+                                        md_content += '```\n' + str(payload).strip() + '\n```'
+                                    result_area_source.set_content(md_content)
+                                else:
+                                    md_content = f'##### ❌ Error\n\n{response.error}'
+                                    result_area_source.set_content(md_content)
+
+                            ui.button('Execute', on_click=call_source).classes('w-full mt-2')
+
+                    with ui.column().classes('w-full p-0'):
+                        with ui.expansion('StartPublisher', icon='api').classes('w-full').bind_value(app.storage.user, 'BenchService.StartPublisher.expansion'):
+                            inputs_start_publisher = {}
+                            with ui.column().classes('w-full gap-2 p-2'):
+                                inputs_start_publisher['rate_hz'] = ui.number(label='Rate hz', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'BenchService.StartPublisher.rate_hz')
+                                inputs_start_publisher['size'] = ui.number(label='Size', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'BenchService.StartPublisher.size')
+                                inputs_start_publisher['duration_ms'] = ui.number(label='Duration ms', value=0, format='%.2f').classes('w-full').bind_value(app.storage.user, 'BenchService.StartPublisher.duration_ms')
+                                inputs_start_publisher['express'] = ui.switch('Express').bind_value(app.storage.user, 'BenchService.StartPublisher.express')
+                            result_area_start_publisher = ui.markdown().classes('w-full mt-2 text-sm')
+
+                            async def call_start_publisher():
+                                zenoh_client.set_device_id(device_id_input.value)
+                                result_area_start_publisher.set_content('⏳ Calling RPC...')
+                                await asyncio.sleep(0.01) # Allow UI to update
+                                kwargs = {}
+                                try:
+                                    kwargs['rate_hz'] = int(inputs_start_publisher['rate_hz'].value)
+                                except (ValueError, TypeError):
+                                    result_area_start_publisher.set_content('❌ Invalid input for `rate_hz`')
+                                    return
+                                try:
+                                    kwargs['size'] = int(inputs_start_publisher['size'].value)
+                                except (ValueError, TypeError):
+                                    result_area_start_publisher.set_content('❌ Invalid input for `size`')
+                                    return
+                                try:
+                                    kwargs['duration_ms'] = int(inputs_start_publisher['duration_ms'].value)
+                                except (ValueError, TypeError):
+                                    result_area_start_publisher.set_content('❌ Invalid input for `duration_ms`')
+                                    return
+                                kwargs['express'] = inputs_start_publisher['express'].value
+                                call_func = partial(bench_service_client.start_publisher, **kwargs)
+                                call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
+                                response, payload = call_result, None
+                                if response.success:
+                                    md_content = '##### ✅ Success\n\n'
+                                    if payload:
+                                        md_content += '```\n' + str(payload).strip() + '\n```'
+                                    result_area_start_publisher.set_content(md_content)
+                                else:
+                                    md_content = f'##### ❌ Error\n\n{response.error}'
+                                    result_area_start_publisher.set_content(md_content)
+
+                            ui.button('Execute', on_click=call_start_publisher).classes('w-full mt-2')
+
+                    with ui.column().classes('w-full p-0'):
+                        with ui.expansion('StopPublisher', icon='api').classes('w-full').bind_value(app.storage.user, 'BenchService.StopPublisher.expansion'):
+                            result_area_stop_publisher = ui.markdown().classes('w-full mt-2 text-sm')
+
+                            async def call_stop_publisher():
+                                zenoh_client.set_device_id(device_id_input.value)
+                                result_area_stop_publisher.set_content('⏳ Calling RPC...')
+                                await asyncio.sleep(0.01) # Allow UI to update
+                                call_func = bench_service_client.stop_publisher
+                                call_result = await asyncio.get_running_loop().run_in_executor(None, call_func)
+                                response, payload = call_result
+                                if response.success:
+                                    md_content = '##### ✅ Success\n\n'
+                                    if payload:
+                                        md_content += '```\n' + str(payload).strip() + '\n```'
+                                    result_area_stop_publisher.set_content(md_content)
+                                else:
+                                    md_content = f'##### ❌ Error\n\n{response.error}'
+                                    result_area_stop_publisher.set_content(md_content)
+
+                            ui.button('Execute', on_click=call_stop_publisher).classes('w-full mt-2')
+
         # --- Right Column: Logs & Telemetry --- 
         with ui.column().classes('w-[400px] p-2'):
             with ui.row().classes('w-full items-center justify-between'):
@@ -229,4 +438,95 @@ def create_ui(zenoh_client, default_device_id='pico2w-001'):
     # Hook up update
     device_id_input.on('change', update_subscriptions)
     # Initial subscription
-    update_subscriptions()
\ No newline at end of file
+    update_subscriptions()
+
+
+# Fleet table refresh interval (batched row updates)
+FLEET_FRAME_S = 0.25
+
+
+def create_fleet_ui(zenoh_client):
+    sub_client = ZenohSubscriberClient(zenoh_client.session)
+    fleet = FleetTable(sub_client, service_client.TELEMETRY_TOPICS)
+    detail_subs = []
+    selected = {'device_id': None}
+    rate = {'time': time.monotonic(), 'samples': 0}
+
+    with ui.row().classes('w-full items-start flex-nowrap'):
+        # --- Left Column: Devices --- 
+        with ui.column().classes('flex-grow p-2'):
+            summary = ui.label('Waiting for telemetry...').classes('text-sm text-gray-600')
+            # AG Grid renders only the visible rows; rows are identified by device ID for updates
+            grid = ui.aggrid({
+                'columnDefs': [
+                    {'headerName': 'Device ID', 'field': 'device_id', 'sortable': True, 'filter': True},
+                    {'headerName': 'Temperature', 'field': 'temperature', 'sortable': True, 'filter': True},
+                    {'headerName': 'Humidity', 'field': 'humidity', 'sortable': True, 'filter': True},
+                    {'headerName': 'Samples', 'field': 'samples', 'sortable': True, 'filter': True},
+                    {'headerName': 'Last seen', 'field': 'last_seen', 'sortable': True, 'filter': True},
+                ],
+                'rowData': [],
+                ':getRowId': '(params) => params.data.device_id',
+                'animateRows': False,
+            }).classes('w-full h-[calc(100vh-120px)]')
+
+        # --- Right Column: Selected Device --- 
+        with ui.column().classes('w-[400px] p-2'):
+            with ui.row().classes('w-full items-center justify-between'):
+                detail_title = ui.label('Select a device').classes('text-xl font-bold')
+                open_button = ui.button('Open', on_click=lambda: open_device()).props('dense flat icon=open_in_new')
+                open_button.set_visibility(False)
+            detail_view = ui.log(max_lines=500).classes('w-full h-[calc(100vh-100px)] bg-gray-900 text-white font-mono text-xs')
+
+    def flush():
+        added, changed = fleet.drain()
+        if added or changed:
+            grid.run_grid_method('applyTransaction', {'add': added, 'update': changed})
+        now = time.monotonic()
+        if now - rate['time'] >= 1.0:
+            samples_per_s = (fleet.stats.samples - rate['samples']) / (now - rate['time'])
+            rate.update(time=now, samples=fleet.stats.samples)
+            summary.set_text(
+                f'{len(fleet.rows)} devices, {samples_per_s:.0f} samples/s, '
+                f'{fleet.stats.coalesced} coalesced, {fleet.stats.errors} errors'
+            )
+
+    def detail_message(msg):
+        ts = datetime.now().strftime('%H:%M:%S.%f')[:-3]
+        detail_view.push(f'[{ts}] {msg}')
+
+    def select(event):
+        device_id = event.args['data']['device_id']
+        if device_id == selected['device_id']:
+            return
+        # Per-device subscriptions only for the selected device
+        for sub in detail_subs:
+            if hasattr(sub, 'unsubscribe'): sub.unsubscribe()
+            if hasattr(sub, 'unsubscribe_all'): sub.unsubscribe_all()
+        detail_subs.clear()
+        selected['device_id'] = device_id
+        detail_title.set_text(device_id)
+        open_button.set_visibility(True)
+        detail_view.clear()
+        log_sub = LogSubscriber(sub_client, device_id)
+        log_sub.subscribe(lambda msg: detail_message(f'[LOG] {msg}'))
+        detail_subs.append(log_sub)
+        tel_sub = service_client.TelemetrySubscriber(sub_client, device_id)
+        tel_sub.subscribe_sensor(
+            lambda data: detail_message(f'[TEL] SensorTelemetry: {json.dumps(MessageToDict(data, preserving_proto_field_name=True))}')
+        )
+        detail_subs.append(tel_sub)
+
+    def open_device():
+        # The device page reads its device ID from the user storage
+        app.storage.user['device_id'] = selected['device_id']
+        ui.navigate.to('/')
+
+    def close():
+        fleet.unsubscribe()
+        sub_client.unsubscribe_all()
+
+    grid.on('cellClicked', select)
+    fleet.subscribe()
+    ui.timer(FLEET_FRAME_S, flush)
+    ui.context.client.on_disconnect(close)
\ No newline at end of file
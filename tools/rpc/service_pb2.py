@@ -25,35 +25,87 @@ _sym_db = _symbol_database.Default()
 from google.protobuf import descriptor_pb2 as google_dot_protobuf_dot_descriptor__pb2
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\rservice.proto\x12\x0cpractice.rpc\x1a google/protobuf/descriptor.proto\".\n\x0cWifiSettings\x12\x0c\n\x04ssid\x18\x01 \x01(\t\x12\x10\n\x08password\x18\x02 \x01(\t\"\x18\n\nLedRequest\x12\n\n\x02on\x18\x01 \x01(\x08\"\r\n\x0bLedResponse\"\x1a\n\x0b\x45\x63hoRequest\x12\x0b\n\x03msg\x18\x01 \x01(\t\"\x1b\n\x0c\x45\x63hoResponse\x12\x0b\n\x03msg\x18\x01 \x01(\t\" \n\x11\x45\x63hoRequestMalloc\x12\x0b\n\x03msg\x18\x01 \x01(\x0c\"!\n\x12\x45\x63hoResponseMalloc\x12\x0b\n\x03msg\x18\x01 \x01(\x0c\"\x0f\n\rSensorRequest\"O\n\x0fSensorTelemetry\x12\x13\n\x0btemperature\x18\x01 \x01(\x02\x12\x10\n\x08humidity\x18\x02 \x01(\x02:\x15\x8a\xb5\x18\x11/telemetry/sensor\"\x07\n\x05\x45mpty2\xa5\x03\n\rDeviceService\x12=\n\x06SetLed\x12\x18.practice.rpc.LedRequest\x1a\x19.practice.rpc.LedResponse\x12=\n\x04\x45\x63ho\x12\x19.practice.rpc.EchoRequest\x1a\x1a.practice.rpc.EchoResponse\x12O\n\nEchoMalloc\x12\x1f.practice.rpc.EchoRequestMalloc\x1a .practice.rpc.EchoResponseMalloc\x12\x45\n\x11StartSensorStream\x12\x1b.practice.rpc.SensorRequest\x1a\x13.practice.rpc.Empty\x12<\n\x10StopSensorStream\x12\x13.practice.rpc.Empty\x1a\x13.practice.rpc.Empty\x12@\n\rConfigureWifi\x12\x1a.practice.rpc.WifiSettings\x1a\x13.practice.rpc.Empty:4\n\tzenoh_key\x12\x1f.google.protobuf.MessageOptions\x18\xd1\x86\x03 \x01(\tb\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\rservice.proto\x12\x0cpractice.rpc\x1a google/protobuf/descriptor.proto\"8\n\x0cWifiSettings\x12\x0c\n\x04ssid\x18\x01 \x01(\t\x12\x10\n\x08password\x18\x02 \x01(\t:\x08\x92\xb5\x18\x04wifi\"\x18\n\nLedRequest\x12\n\n\x02on\x18\x01 \x01(\x08\"\r\n\x0bLedResponse\"\x1a\n\x0b\x45\x63hoRequest\x12\x0b\n\x03msg\x18\x01 \x01(\t\"\x1b\n\x0c\x45\x63hoResponse\x12\x0b\n\x03msg\x18\x01 \x01(\t\" \n\x11\x45\x63hoRequestMalloc\x12\x0b\n\x03msg\x18\x01 \x01(\x0c\"!\n\x12\x45\x63hoResponseMalloc\x12\x0b\n\x03msg\x18\x01 \x01(\x0c\"#\n\rSensorRequest\x12\x12\n\nbatch_size\x18\x01 \x01(\r\"s\n\x0fSensorTelemetry\x12\x13\n\x0btemperature\x18\x01 \x01(\x02\x12\x10\n\x08humidity\x18\x02 \x01(\x02:9\x8a\xb5\x18\x11/telemetry/sensor\xaa\xb5\x18\x0cwan=1,lan=10\xb2\xb5\x18\x07wan=256\xb8\xb5\x18\x90N\xc0\xb5\x18\x08\"A\n\x0eTelemetryBatch\x12\r\n\x05\x63ount\x18\x01 \x01(\r\x12\x12\n\nfield_tags\x18\x02 \x03(\r\x12\x0c\n\x04\x64\x61ta\x18\x03 \x01(\x0c\"t\n\tGpioEvent\x12\x0c\n\x04line\x18\x01 \x01(\r\x12\r\n\x05level\x18\x02 \x01(\x08\x12\x14\n\x0ctimestamp_us\x18\x03 \x01(\x04\x12\x11\n\tqueued_us\x18\x04 \x01(\r\x12\x0f\n\x07\x64ropped\x18\x05 \x01(\r:\x10\x8a\xb5\x18\x0c/events/gpio\"k\n\x0fLogLevelRequest\x12\x0e\n\x06module\x18\x01 \x01(\t\x12%\n\x05level\x18\x02 \x01(\x0e\x32\x16.practice.rpc.LogLevel\x12\x12\n\nrate_per_s\x18\x03 \x01(\r\x12\r\n\x05\x62urst\x18\x04 \x01(\r\"?\n\x10LogLevelResponse\x12\x13\n\x0blog_modules\x18\x01 \x01(\r\x12\x16\n\x0ezephyr_modules\x18\x02 \x01(\r\"\xca\x01\n\x04Rule\x12\r\n\x05\x66ield\x18\x01 \x01(\r\x12.\n\tcondition\x18\x02 \x01(\x0e\x32\x1b.practice.rpc.RuleCondition\x12\x11\n\tthreshold\x18\x03 \x01(\x02\x12\x12\n\nhysteresis\x18\x04 \x01(\x02\x12(\n\x06\x61\x63tion\x18\x05 \x01(\x0e\x32\x18.practice.rpc.RuleAction\x12\r\n\x05value\x18\x06 \x01(\r\x12\x0f\n\x07on_exit\x18\x07 \x01(\x08\x12\x12\n\nexit_value\x18\x08 \x01(\r\"7\n\x07RuleSet\x12!\n\x05rules\x18\x01 \x03(\x0b\x32\x12.practice.rpc.Rule:\t\x92\xb5\x18\x05rules\"%\n\x10SetRulesResponse\x12\x11\n\tinstalled\x18\x01 \x01(\r\"{\n\x0b\x44\x65viceState\x12\x0e\n\x06led_on\x18\x01 \x01(\x08\x12\x11\n\tstreaming\x18\x02 \x01(\x08\x12\x12\n\nbatch_size\x18\x03 \x01(\r\x12\x16\n\x0ewifi_connected\x18\x04 \x01(\x08\x12\x11\n\twifi_ssid\x18\x05 \x01(\t:\n\x9a\xb5\x18\x06/state\"A\n\rStreamControl\x12\x11\n\tstream_id\x18\x01 \x01(\r\x12\x0e\n\x06window\x18\x02 \x01(\r\x12\r\n\x05\x63lose\x18\x03 \x01(\x08\"\x07\n\x05\x45mpty\"\x1c\n\x0c\x42\x65nchPayload\x12\x0c\n\x04\x64\x61ta\x18\x01 \x01(\x0c\"%\n\x11\x42\x65nchSinkResponse\x12\x10\n\x08received\x18\x01 \x01(\r\"\"\n\x12\x42\x65nchSourceRequest\x12\x0c\n\x04size\x18\x01 \x01(\r\"Z\n\x13\x42\x65nchPublishRequest\x12\x0f\n\x07rate_hz\x18\x01 \x01(\r\x12\x0c\n\x04size\x18\x02 \x01(\r\x12\x13\n\x0b\x64uration_ms\x18\x03 \x01(\r\x12\x0f\n\x07\x65xpress\x18\x04 \x01(\x08\"L\n\x13\x42\x65nchPublisherStats\x12\x11\n\tpublished\x18\x01 \x01(\r\x12\x0e\n\x06\x66\x61iled\x18\x02 \x01(\r\x12\x12\n\nelapsed_us\x18\x03 \x01(\x04*o\n\x08LogLevel\x12\x13\n\x0fLOG_LEVEL_DEBUG\x10\x00\x12\x12\n\x0eLOG_LEVEL_INFO\x10\x01\x12\x12\n\x0eLOG_LEVEL_WARN\x10\x02\x12\x13\n\x0fLOG_LEVEL_ERROR\x10\x03\x12\x11\n\rLOG_LEVEL_OFF\x10\x04*R\n\rRuleCondition\x12\x0e\n\nRULE_ABOVE\x10\x00\x12\x0e\n\nRULE_BELOW\x10\x01\x12\x0f\n\x0bRULE_RISING\x10\x02\x12\x10\n\x0cRULE_FALLING\x10\x03*P\n\nRuleAction\x12\x14\n\x10RULE_ACTION_NONE\x10\x00\x12\x17\n\x13RULE_ACTION_SET_LED\x10\x01\x12\x13\n\x0fRULE_ACTION_LOG\x10\x02\x32\x9a\x05\n\rDeviceService\x12\x43\n\x06SetLed\x12\x18.practice.rpc.LedRequest\x1a\x19.practice.rpc.LedResponse\"\x04\xa0\xb5\x18\x14\x12\x46\n\x04\x45\x63ho\x12\x19.practice.rpc.EchoRequest\x1a\x1a.practice.rpc.EchoResponse\"\x07\x90\x02\x01\xa0\xb5\x18\x14\x12U\n\nEchoMalloc\x12\x1f.practice.rpc.EchoRequestMalloc\x1a .practice.rpc.EchoResponseMalloc\"\x04\xa0\xb5\x18\x32\x12\x45\n\x11StartSensorStream\x12\x1b.practice.rpc.SensorRequest\x1a\x13.practice.rpc.Empty\x12<\n\x10StopSensorStream\x12\x13.practice.rpc.Empty\x1a\x13.practice.rpc.Empty\x12@\n\rConfigureWifi\x12\x1a.practice.rpc.WifiSettings\x1a\x13.practice.rpc.Empty\x12L\n\x0bSetLogLevel\x12\x1d.practice.rpc.LogLevelRequest\x1a\x1e.practice.rpc.LogLevelResponse\x12G\n\x08SetRules\x12\x15.practice.rpc.RuleSet\x1a\x1e.practice.rpc.SetRulesResponse\"\x04\xa0\xb5\x18\x14\x12G\n\nEchoStream\x12\x19.practice.rpc.EchoRequest\x1a\x1a.practice.rpc.EchoResponse(\x01\x30\x01\x32\xe0\x02\n\x0c\x42\x65nchService\x12\x30\n\x04Ping\x12\x13.practice.rpc.Empty\x1a\x13.practice.rpc.Empty\x12\x43\n\x04Sink\x12\x1a.practice.rpc.BenchPayload\x1a\x1f.practice.rpc.BenchSinkResponse\x12\x46\n\x06Source\x12 .practice.rpc.BenchSourceRequest\x1a\x1a.practice.rpc.BenchPayload\x12H\n\x0eStartPublisher\x12!.practice.rpc.BenchPublishRequest\x1a\x13.practice.rpc.Empty\x12G\n\rStopPublisher\x12\x13.practice.rpc.Empty\x1a!.practice.rpc.BenchPublisherStats:4\n\tzenoh_key\x12\x1f.google.protobuf.MessageOptions\x18\xd1\x86\x03 \x01(\t:7\n\x0csettings_key\x12\x1f.google.protobuf.MessageOptions\x18\xd2\x86\x03 \x01(\t:4\n\tstate_key\x12\x1f.google.protobuf.MessageOptions\x18\xd3\x86\x03 \x01(\t:3\n\x08max_rate\x12\x1f.google.protobuf.MessageOptions\x18\xd5\x86\x03 \x01(\t:6\n\x0bmax_payload\x12\x1f.google.protobuf.MessageOptions\x18\xd6\x86\x03 \x01(\t::\n\x0fmax_interval_ms\x12\x1f.google.protobuf.MessageOptions\x18\xd7\x86\x03 \x01(\r:4\n\tmax_batch\x12\x1f.google.protobuf.MessageOptions\x18\xd8\x86\x03 \x01(\r:8\n\x0etime_budget_ms\x12\x1e.google.protobuf.MethodOptions\x18\xd4\x86\x03 \x01(\rb\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'service_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   DESCRIPTOR._loaded_options = None
+  _globals['_WIFISETTINGS']._loaded_options = None
+  _globals['_WIFISETTINGS']._serialized_options = b'\222\265\030\004wifi'
   _globals['_SENSORTELEMETRY']._loaded_options = None
-  _globals['_SENSORTELEMETRY']._serialized_options = b'\212\265\030\021/telemetry/sensor'
+  _globals['_SENSORTELEMETRY']._serialized_options = b'\212\265\030\021/telemetry/sensor\252\265\030\014wan=1,lan=10\262\265\030\007wan=256\270\265\030\220N\300\265\030\010'
+  _globals['_GPIOEVENT']._loaded_options = None
+  _globals['_GPIOEVENT']._serialized_options = b'\212\265\030\014/events/gpio'
+  _globals['_RULESET']._loaded_options = None
+  _globals['_RULESET']._serialized_options = b'\222\265\030\005rules'
+  _globals['_DEVICESTATE']._loaded_options = None
+  _globals['_DEVICESTATE']._serialized_options = b'\232\265\030\006/state'
+  _globals['_DEVICESERVICE'].methods_by_name['SetLed']._loaded_options = None
+  _globals['_DEVICESERVICE'].methods_by_name['SetLed']._serialized_options = b'\240\265\030\024'
+  _globals['_DEVICESERVICE'].methods_by_name['Echo']._loaded_options = None
+  _globals['_DEVICESERVICE'].methods_by_name['Echo']._serialized_options = b'\220\002\001\240\265\030\024'
+  _globals['_DEVICESERVICE'].methods_by_name['EchoMalloc']._loaded_options = None
+  _globals['_DEVICESERVICE'].methods_by_name['EchoMalloc']._serialized_options = b'\240\265\0302'
+  _globals['_DEVICESERVICE'].methods_by_name['SetRules']._loaded_options = None
+  _globals['_DEVICESERVICE'].methods_by_name['SetRules']._serialized_options = b'\240\265\030\024'
+  _globals['_LOGLEVEL']._serialized_start=1580
+  _globals['_LOGLEVEL']._serialized_end=1691
+  _globals['_RULECONDITION']._serialized_start=1693
+  _globals['_RULECONDITION']._serialized_end=1775
+  _globals['_RULEACTION']._serialized_start=1777
+  _globals['_RULEACTION']._serialized_end=1857
   _globals['_WIFISETTINGS']._serialized_start=65
-  _globals['_WIFISETTINGS']._serialized_end=111
-  _globals['_LEDREQUEST']._serialized_start=113
-  _globals['_LEDREQUEST']._serialized_end=137
-  _globals['_LEDRESPONSE']._serialized_start=139
-  _globals['_LEDRESPONSE']._serialized_end=152
-  _globals['_ECHOREQUEST']._serialized_start=154
-  _globals['_ECHOREQUEST']._serialized_end=180
-  _globals['_ECHORESPONSE']._serialized_start=182
-  _globals['_ECHORESPONSE']._serialized_end=209
-  _globals['_ECHOREQUESTMALLOC']._serialized_start=211
-  _globals['_ECHOREQUESTMALLOC']._serialized_end=243
-  _globals['_ECHORESPONSEMALLOC']._serialized_start=245
-  _globals['_ECHORESPONSEMALLOC']._serialized_end=278
-  _globals['_SENSORREQUEST']._serialized_start=280
-  _globals['_SENSORREQUEST']._serialized_end=295
-  _globals['_SENSORTELEMETRY']._serialized_start=297
-  _globals['_SENSORTELEMETRY']._serialized_end=376
-  _globals['_EMPTY']._serialized_start=378
-  _globals['_EMPTY']._serialized_end=385
-  _globals['_DEVICESERVICE']._serialized_start=388
-  _globals['_DEVICESERVICE']._serialized_end=809
+  _globals['_WIFISETTINGS']._serialized_end=121
+  _globals['_LEDREQUEST']._serialized_start=123
+  _globals['_LEDREQUEST']._serialized_end=147
+  _globals['_LEDRESPONSE']._serialized_start=149
+  _globals['_LEDRESPONSE']._serialized_end=162
+  _globals['_ECHOREQUEST']._serialized_start=164
+  _globals['_ECHOREQUEST']._serialized_end=190
+  _globals['_ECHORESPONSE']._serialized_start=192
+  _globals['_ECHORESPONSE']._serialized_end=219
+  _globals['_ECHOREQUESTMALLOC']._serialized_start=221
+  _globals['_ECHOREQUESTMALLOC']._serialized_end=253
+  _globals['_ECHORESPONSEMALLOC']._serialized_start=255
+  _globals['_ECHORESPONSEMALLOC']._serialized_end=288
+  _globals['_SENSORREQUEST']._serialized_start=290
+  _globals['_SENSORREQUEST']._serialized_end=325
+  _globals['_SENSORTELEMETRY']._serialized_start=327
+  _globals['_SENSORTELEMETRY']._serialized_end=442
+  _globals['_TELEMETRYBATCH']._serialized_start=444
+  _globals['_TELEMETRYBATCH']._serialized_end=509
+  _globals['_GPIOEVENT']._serialized_start=511
+  _globals['_GPIOEVENT']._serialized_end=627
+  _globals['_LOGLEVELREQUEST']._serialized_start=629
+  _globals['_LOGLEVELREQUEST']._serialized_end=736
+  _globals['_LOGLEVELRESPONSE']._serialized_start=738
+  _globals['_LOGLEVELRESPONSE']._serialized_end=801
+  _globals['_RULE']._serialized_start=804
+  _globals['_RULE']._serialized_end=1006
+  _globals['_RULESET']._serialized_start=1008
+  _globals['_RULESET']._serialized_end=1063
+  _globals['_SETRULESRESPONSE']._serialized_start=1065
+  _globals['_SETRULESRESPONSE']._serialized_end=1102
+  _globals['_DEVICESTATE']._serialized_start=1104
+  _globals['_DEVICESTATE']._serialized_end=1227
+  _globals['_STREAMCONTROL']._serialized_start=1229
+  _globals['_STREAMCONTROL']._serialized_end=1294
+  _globals['_EMPTY']._serialized_start=1296
+  _globals['_EMPTY']._serialized_end=1303
+  _globals['_BENCHPAYLOAD']._serialized_start=1305
+  _globals['_BENCHPAYLOAD']._serialized_end=1333
+  _globals['_BENCHSINKRESPONSE']._serialized_start=1335
+  _globals['_BENCHSINKRESPONSE']._serialized_end=1372
+  _globals['_BENCHSOURCEREQUEST']._serialized_start=1374
+  _globals['_BENCHSOURCEREQUEST']._serialized_end=1408
+  _globals['_BENCHPUBLISHREQUEST']._serialized_start=1410
+  _globals['_BENCHPUBLISHREQUEST']._serialized_end=1500
+  _globals['_BENCHPUBLISHERSTATS']._serialized_start=1502
+  _globals['_BENCHPUBLISHERSTATS']._serialized_end=1578
+  _globals['_DEVICESERVICE']._serialized_start=1860
+  _globals['_DEVICESERVICE']._serialized_end=2526
+  _globals['_BENCHSERVICE']._serialized_start=2529
+  _globals['_BENCHSERVICE']._serialized_end=2881
 # @@protoc_insertion_point(module_scope)
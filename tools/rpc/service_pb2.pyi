@@ -1,11 +1,58 @@
 from google.protobuf import descriptor_pb2 as _descriptor_pb2
+from google.protobuf.internal import containers as _containers
+from google.protobuf.internal import enum_type_wrapper as _enum_type_wrapper
 from google.protobuf import descriptor as _descriptor
 from google.protobuf import message as _message
-from typing import ClassVar as _ClassVar, Optional as _Optional
+from typing import ClassVar as _ClassVar, Iterable as _Iterable, Mapping as _Mapping, Optional as _Optional, Union as _Union
 
 DESCRIPTOR: _descriptor.FileDescriptor
+
+class LogLevel(int, metaclass=_enum_type_wrapper.EnumTypeWrapper):
+    __slots__ = ()
+    LOG_LEVEL_DEBUG: _ClassVar[LogLevel]
+    LOG_LEVEL_INFO: _ClassVar[LogLevel]
+    LOG_LEVEL_WARN: _ClassVar[LogLevel]
+    LOG_LEVEL_ERROR: _ClassVar[LogLevel]
+    LOG_LEVEL_OFF: _ClassVar[LogLevel]
+class RuleCondition(int, metaclass=_enum_type_wrapper.EnumTypeWrapper):
+    __slots__ = ()
+    RULE_ABOVE: _ClassVar[RuleCondition]
+    RULE_BELOW: _ClassVar[RuleCondition]
+    RULE_RISING: _ClassVar[RuleCondition]
+    RULE_FALLING: _ClassVar[RuleCondition]
+class RuleAction(int, metaclass=_enum_type_wrapper.EnumTypeWrapper):
+    __slots__ = ()
+    RULE_ACTION_NONE: _ClassVar[RuleAction]
+    RULE_ACTION_SET_LED: _ClassVar[RuleAction]
+    RULE_ACTION_LOG: _ClassVar[RuleAction]
+LOG_LEVEL_DEBUG: LogLevel
+LOG_LEVEL_INFO: LogLevel
+LOG_LEVEL_WARN: LogLevel
+LOG_LEVEL_ERROR: LogLevel
+LOG_LEVEL_OFF: LogLevel
+RULE_ABOVE: RuleCondition
+RULE_BELOW: RuleCondition
+RULE_RISING: RuleCondition
+RULE_FALLING: RuleCondition
+RULE_ACTION_NONE: RuleAction
+RULE_ACTION_SET_LED: RuleAction
+RULE_ACTION_LOG: RuleAction
 ZENOH_KEY_FIELD_NUMBER: _ClassVar[int]
 zenoh_key: _descriptor.FieldDescriptor
+SETTINGS_KEY_FIELD_NUMBER: _ClassVar[int]
+settings_key: _descriptor.FieldDescriptor
+STATE_KEY_FIELD_NUMBER: _ClassVar[int]
+state_key: _descriptor.FieldDescriptor
+MAX_RATE_FIELD_NUMBER: _ClassVar[int]
+max_rate: _descriptor.FieldDescriptor
+MAX_PAYLOAD_FIELD_NUMBER: _ClassVar[int]
+max_payload: _descriptor.FieldDescriptor
+MAX_INTERVAL_MS_FIELD_NUMBER: _ClassVar[int]
+max_interval_ms: _descriptor.FieldDescriptor
+MAX_BATCH_FIELD_NUMBER: _ClassVar[int]
+max_batch: _descriptor.FieldDescriptor
+TIME_BUDGET_MS_FIELD_NUMBER: _ClassVar[int]
+time_budget_ms: _descriptor.FieldDescriptor
 
 class WifiSettings(_message.Message):
     __slots__ = ("ssid", "password")
@@ -50,8 +97,10 @@ class EchoResponseMalloc(_message.Message):
     def __init__(self, msg: _Optional[bytes] = ...) -> None: ...
 
 class SensorRequest(_message.Message):
-    __slots__ = ()
-    def __init__(self) -> None: ...
+    __slots__ = ("batch_size",)
+    BATCH_SIZE_FIELD_NUMBER: _ClassVar[int]
+    batch_size: int
+    def __init__(self, batch_size: _Optional[int] = ...) -> None: ...
 
 class SensorTelemetry(_message.Message):
     __slots__ = ("temperature", "humidity")
@@ -61,6 +110,146 @@ class SensorTelemetry(_message.Message):
     humidity: float
     def __init__(self, temperature: _Optional[float] = ..., humidity: _Optional[float] = ...) -> None: ...
 
+class TelemetryBatch(_message.Message):
+    __slots__ = ("count", "field_tags", "data")
+    COUNT_FIELD_NUMBER: _ClassVar[int]
+    FIELD_TAGS_FIELD_NUMBER: _ClassVar[int]
+    DATA_FIELD_NUMBER: _ClassVar[int]
+    count: int
+    field_tags: _containers.RepeatedScalarFieldContainer[int]
+    data: bytes
+    def __init__(self, count: _Optional[int] = ..., field_tags: _Optional[_Iterable[int]] = ..., data: _Optional[bytes] = ...) -> None: ...
+
+class GpioEvent(_message.Message):
+    __slots__ = ("line", "level", "timestamp_us", "queued_us", "dropped")
+    LINE_FIELD_NUMBER: _ClassVar[int]
+    LEVEL_FIELD_NUMBER: _ClassVar[int]
+    TIMESTAMP_US_FIELD_NUMBER: _ClassVar[int]
+    QUEUED_US_FIELD_NUMBER: _ClassVar[int]
+    DROPPED_FIELD_NUMBER: _ClassVar[int]
+    line: int
+    level: bool
+    timestamp_us: int
+    queued_us: int
+    dropped: int
+    def __init__(self, line: _Optional[int] = ..., level: bool = ..., timestamp_us: _Optional[int] = ..., queued_us: _Optional[int] = ..., dropped: _Optional[int] = ...) -> None: ...
+
+class LogLevelRequest(_message.Message):
+    __slots__ = ("module", "level", "rate_per_s", "burst")
+    MODULE_FIELD_NUMBER: _ClassVar[int]
+    LEVEL_FIELD_NUMBER: _ClassVar[int]
+    RATE_PER_S_FIELD_NUMBER: _ClassVar[int]
+    BURST_FIELD_NUMBER: _ClassVar[int]
+    module: str
+    level: LogLevel
+    rate_per_s: int
+    burst: int
+    def __init__(self, module: _Optional[str] = ..., level: _Optional[_Union[LogLevel, str]] = ..., rate_per_s: _Optional[int] = ..., burst: _Optional[int] = ...) -> None: ...
+
+class LogLevelResponse(_message.Message):
+    __slots__ = ("log_modules", "zephyr_modules")
+    LOG_MODULES_FIELD_NUMBER: _ClassVar[int]
+    ZEPHYR_MODULES_FIELD_NUMBER: _ClassVar[int]
+    log_modules: int
+    zephyr_modules: int
+    def __init__(self, log_modules: _Optional[int] = ..., zephyr_modules: _Optional[int] = ...) -> None: ...
+
+class Rule(_message.Message):
+    __slots__ = ("field", "condition", "threshold", "hysteresis", "action", "value", "on_exit", "exit_value")
+    FIELD_FIELD_NUMBER: _ClassVar[int]
+    CONDITION_FIELD_NUMBER: _ClassVar[int]
+    THRESHOLD_FIELD_NUMBER: _ClassVar[int]
+    HYSTERESIS_FIELD_NUMBER: _ClassVar[int]
+    ACTION_FIELD_NUMBER: _ClassVar[int]
+    VALUE_FIELD_NUMBER: _ClassVar[int]
+    ON_EXIT_FIELD_NUMBER: _ClassVar[int]
+    EXIT_VALUE_FIELD_NUMBER: _ClassVar[int]
+    field: int
+    condition: RuleCondition
+    threshold: float
+    hysteresis: float
+    action: RuleAction
+    value: int
+    on_exit: bool
+    exit_value: int
+    def __init__(self, field: _Optional[int] = ..., condition: _Optional[_Union[RuleCondition, str]] = ..., threshold: _Optional[float] = ..., hysteresis: _Optional[float] = ..., action: _Optional[_Union[RuleAction, str]] = ..., value: _Optional[int] = ..., on_exit: bool = ..., exit_value: _Optional[int] = ...) -> None: ...
+
+class RuleSet(_message.Message):
+    __slots__ = ("rules",)
+    RULES_FIELD_NUMBER: _ClassVar[int]
+    rules: _containers.RepeatedCompositeFieldContainer[Rule]
+    def __init__(self, rules: _Optional[_Iterable[_Union[Rule, _Mapping]]] = ...) -> None: ...
+
+class SetRulesResponse(_message.Message):
+    __slots__ = ("installed",)
+    INSTALLED_FIELD_NUMBER: _ClassVar[int]
+    installed: int
+    def __init__(self, installed: _Optional[int] = ...) -> None: ...
+
+class DeviceState(_message.Message):
+    __slots__ = ("led_on", "streaming", "batch_size", "wifi_connected", "wifi_ssid")
+    LED_ON_FIELD_NUMBER: _ClassVar[int]
+    STREAMING_FIELD_NUMBER: _ClassVar[int]
+    BATCH_SIZE_FIELD_NUMBER: _ClassVar[int]
+    WIFI_CONNECTED_FIELD_NUMBER: _ClassVar[int]
+    WIFI_SSID_FIELD_NUMBER: _ClassVar[int]
+    led_on: bool
+    streaming: bool
+    batch_size: int
+    wifi_connected: bool
+    wifi_ssid: str
+    def __init__(self, led_on: bool = ..., streaming: bool = ..., batch_size: _Optional[int] = ..., wifi_connected: bool = ..., wifi_ssid: _Optional[str] = ...) -> None: ...
+
+class StreamControl(_message.Message):
+    __slots__ = ("stream_id", "window", "close")
+    STREAM_ID_FIELD_NUMBER: _ClassVar[int]
+    WINDOW_FIELD_NUMBER: _ClassVar[int]
+    CLOSE_FIELD_NUMBER: _ClassVar[int]
+    stream_id: int
+    window: int
+    close: bool
+    def __init__(self, stream_id: _Optional[int] = ..., window: _Optional[int] = ..., close: bool = ...) -> None: ...
+
 class Empty(_message.Message):
     __slots__ = ()
     def __init__(self) -> None: ...
+
+class BenchPayload(_message.Message):
+    __slots__ = ("data",)
+    DATA_FIELD_NUMBER: _ClassVar[int]
+    data: bytes
+    def __init__(self, data: _Optional[bytes] = ...) -> None: ...
+
+class BenchSinkResponse(_message.Message):
+    __slots__ = ("received",)
+    RECEIVED_FIELD_NUMBER: _ClassVar[int]
+    received: int
+    def __init__(self, received: _Optional[int] = ...) -> None: ...
+
+class BenchSourceRequest(_message.Message):
+    __slots__ = ("size",)
+    SIZE_FIELD_NUMBER: _ClassVar[int]
+    size: int
+    def __init__(self, size: _Optional[int] = ...) -> None: ...
+
+class BenchPublishRequest(_message.Message):
+    __slots__ = ("rate_hz", "size", "duration_ms", "express")
+    RATE_HZ_FIELD_NUMBER: _ClassVar[int]
+    SIZE_FIELD_NUMBER: _ClassVar[int]
+    DURATION_MS_FIELD_NUMBER: _ClassVar[int]
+    EXPRESS_FIELD_NUMBER: _ClassVar[int]
+    rate_hz: int
+    size: int
+    duration_ms: int
+    express: bool
+    def __init__(self, rate_hz: _Optional[int] = ..., size: _Optional[int] = ..., duration_ms: _Optional[int] = ..., express: bool = ...) -> None: ...
+
+class BenchPublisherStats(_message.Message):
+    __slots__ = ("published", "failed", "elapsed_us")
+    PUBLISHED_FIELD_NUMBER: _ClassVar[int]
+    FAILED_FIELD_NUMBER: _ClassVar[int]
+    ELAPSED_US_FIELD_NUMBER: _ClassVar[int]
+    published: int
+    failed: int
+    elapsed_us: int
+    def __init__(self, published: _Optional[int] = ..., failed: _Optional[int] = ..., elapsed_us: _Optional[int] = ...) -> None: ...
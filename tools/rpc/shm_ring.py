@@ -0,0 +1,150 @@
+"""
+Shared-memory ring - single-producer single-consumer queue of byte messages between processes.
+
+The queue behind client_pool.py: messages are copied into a multiprocessing.shared_memory block and out again, with
+no pipe or socket in between. Both sides keep running counters of the bytes written and read; a message is a u32
+length and the data, 8-byte aligned, and one that does not fit before the end of the buffer is preceded by a padding
+marker and written at the start.
+
+Layout (little endian):
+
+    0   u64 write position (bytes published; producer)
+    8   u64 read position (bytes consumed; consumer)
+    16  u32 waiting (consumer blocked in wait())
+    64  data (capacity bytes, a power of two)
+
+A consumer with nothing to read sets waiting and blocks on a doorbell (multiprocessing semaphore) that the producer
+releases after a put() seeing the flag; under load neither side makes a system call. Like the telemetry bus, the ring
+relies on stores becoming visible in program order (x86-64). The positions are copied as whole 8-byte slices (one
+aligned load or store) rather than with struct, which writes them a byte at a time: a reader could see a torn value.
+A store passing a load can make a wake-up go missing; the consumer then notices the message when its wait times out.
+"""
+
+import struct
+from multiprocessing import shared_memory
+from typing import Optional
+
+HEADER_SIZE = 64
+PAD = 0xFFFFFFFF
+
+_U32 = struct.Struct("<I")
+_WRITE_OFFSET = 0
+_READ_OFFSET = 8
+_WAITING_OFFSET = 16
+
+
+def _aligned(n: int) -> int:
+    return (n + 7) & ~7
+
+
+def _load_u64(buf: memoryview, offset: int) -> int:
+    return int.from_bytes(buf[offset : offset + 8], "little")
+
+
+def _store_u64(buf: memoryview, offset: int, value: int):
+    buf[offset : offset + 8] = value.to_bytes(8, "little")
+
+
+class ShmRing:
+    """One direction of a process pair; create() in the parent, attach() in the child with spec()."""
+
+    def __init__(self, shm: shared_memory.SharedMemory, capacity: int, doorbell, owner: bool):
+        self._shm = shm
+        self._buf = shm.buf
+        self.capacity = capacity
+        self.max_message = capacity // 4
+        self.doorbell = doorbell
+        self._owner = owner
+        # Own side's position, mirrored into the header
+        self._write = _load_u64(self._buf, _WRITE_OFFSET)
+        self._read = _load_u64(self._buf, _READ_OFFSET)
+
+    @classmethod
+    def create(cls, capacity: int, doorbell) -> "ShmRing":
+        if capacity & (capacity - 1) or capacity < 4096:
+            raise ValueError("capacity must be a power of two of at least 4096")
+        shm = shared_memory.SharedMemory(create=True, size=HEADER_SIZE + capacity)
+        shm.buf[:HEADER_SIZE] = bytes(HEADER_SIZE)
+        return cls(shm, capacity, doorbell, owner=True)
+
+    @classmethod
+    def attach(cls, spec: tuple[str, int], doorbell) -> "ShmRing":
+        name, capacity = spec
+        try:
+            # The creator unlinks it (Python >= 3.13)
+            shm = shared_memory.SharedMemory(name=name, track=False)
+        except TypeError:
+            # Spawned children share the creator's resource tracker: the second registration is a no-op
+            shm = shared_memory.SharedMemory(name=name)
+        return cls(shm, capacity, doorbell, owner=False)
+
+    def spec(self) -> tuple[str, int]:
+        """Arguments of attach() in another process (with the doorbell)."""
+        return self._shm.name, self.capacity
+
+    def put(self, data: bytes) -> bool:
+        """Append a message; False if the ring is full (the consumer is behind)."""
+        n = len(data)
+        if n > self.max_message:
+            raise ValueError(f"message of {n} bytes exceeds {self.max_message}")
+        size = _aligned(4 + n)
+        buf = self._buf
+        read = _load_u64(buf, _READ_OFFSET)
+        write = self._write
+        pos = write & (self.capacity - 1)
+        pad = self.capacity - pos if pos + size > self.capacity else 0
+        if write + pad + size - read > self.capacity:
+            return False
+        if pad:
+            _U32.pack_into(buf, HEADER_SIZE + pos, PAD)
+            write += pad
+            pos = 0
+        offset = HEADER_SIZE + pos
+        _U32.pack_into(buf, offset, n)
+        buf[offset + 4 : offset + 4 + n] = data
+        self._write = write + size
+        # Published by the position store
+        _store_u64(buf, _WRITE_OFFSET, self._write)
+        if _U32.unpack_from(buf, _WAITING_OFFSET)[0]:
+            _U32.pack_into(buf, _WAITING_OFFSET, 0)
+            self.doorbell.release()
+        return True
+
+    def get(self) -> Optional[bytes]:
+        """Next message, or None if the ring is empty."""
+        buf = self._buf
+        read = self._read
+        if read == _load_u64(buf, _WRITE_OFFSET):
+            return None
+        pos = read & (self.capacity - 1)
+        n = _U32.unpack_from(buf, HEADER_SIZE + pos)[0]
+        if n == PAD:
+            read += self.capacity - pos
+            pos = 0
+            n = _U32.unpack_from(buf, HEADER_SIZE)[0]
+        offset = HEADER_SIZE + pos
+        data = bytes(buf[offset + 4 : offset + 4 + n])
+        self._read = read + _aligned(4 + n)
+        _store_u64(buf, _READ_OFFSET, self._read)
+        return data
+
+    def empty(self) -> bool:
+        return self._read == _load_u64(self._buf, _WRITE_OFFSET)
+
+    def set_waiting(self, waiting: bool):
+        """Ask the producer to ring the doorbell on its next put() (consumer side)."""
+        _U32.pack_into(self._buf, _WAITING_OFFSET, 1 if waiting else 0)
+
+    def wait(self, timeout: float) -> bool:
+        """Block until a message is available or timeout [s] passes; True if one is."""
+        self.set_waiting(True)
+        if self.empty():
+            self.doorbell.acquire(timeout=timeout)
+        self.set_waiting(False)
+        return not self.empty()
+
+    def close(self):
+        self._buf = None
+        self._shm.close()
+        if self._owner:
+            self._shm.unlink()
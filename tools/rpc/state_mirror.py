@@ -0,0 +1,223 @@
+"""
+State Mirror - local copy of a versioned device state (messages with the state_key option).
+
+The device publishes only the changed fields on <device><state_key>, with the state version and the changed-field mask
+in the attachment. Deltas are applied in version order; on a gap (lost delta, device reboot, late join) the full
+state is fetched from <device><state_key>/snapshot and the deltas received meanwhile are replayed on top of it.
+Protocol: see apps/zenoh_rpc/rpc/state_sync.h (keep in sync).
+"""
+
+import logging
+import threading
+from dataclasses import dataclass
+from typing import Callable, List, Optional, Type
+
+from google.protobuf.message import Message
+
+from .proto_fields import is_repeated
+from .zenoh_attachment import Attachment, AttachmentKey
+
+SNAPSHOT_SUFFIX = "/snapshot"
+# Deltas kept while a snapshot is being fetched
+MAX_PENDING_DELTAS = 64
+
+
+@dataclass
+class StateMirrorStats:
+    deltas: int = 0  # deltas applied
+    snapshots: int = 0  # snapshots applied
+    gaps: int = 0  # version gaps that triggered a snapshot
+    stale: int = 0  # deltas ignored (already covered by a snapshot)
+
+
+def apply_delta(state: Message, delta: Message, changed_mask: int) -> List[str]:
+    """Copy the fields selected by changed_mask from delta to state; returns their names."""
+    changed = []
+    for fd in state.DESCRIPTOR.fields:
+        if fd.number > 64 or not (changed_mask >> (fd.number - 1)) & 1:
+            continue
+        changed.append(fd.name)
+        if is_repeated(fd):
+            getattr(state, fd.name).clear()
+            getattr(state, fd.name).extend(getattr(delta, fd.name))
+        elif fd.message_type is not None or fd.has_presence:
+            # Absent from the delta: cleared on the device
+            if delta.HasField(fd.name):
+                if fd.message_type is not None:
+                    getattr(state, fd.name).CopyFrom(getattr(delta, fd.name))
+                else:
+                    setattr(state, fd.name, getattr(delta, fd.name))
+            else:
+                state.ClearField(fd.name)
+        else:
+            # proto3 scalars: an absent field is the default value
+            setattr(state, fd.name, getattr(delta, fd.name))
+    return changed
+
+
+class StateMirror:
+    """
+    Local copy of one device state message.
+
+    rpc_client needs query(key_expr, timeout_ms=...) (ZenohRpcClient or GatewayRpcClient), sub_client
+    subscribe_sample() (ZenohSubscriberClient or GatewaySubscriberClient). on_change(state, changed_field_names) is
+    called after every applied delta or snapshot, from the subscriber or snapshot thread.
+    """
+
+    def __init__(
+        self,
+        rpc_client,
+        sub_client,
+        device_id: str,
+        state_key: str,
+        msg_cls: Type[Message],
+        on_change: Optional[Callable[[Message, List[str]], None]] = None,
+        logger: Optional[logging.Logger] = None,
+        snapshot_timeout_ms: int = 2000,
+    ):
+        self.rpc_client = rpc_client
+        self.sub_client = sub_client
+        self.key_expr = f"{device_id}{state_key}"
+        self.msg_cls = msg_cls
+        self.on_change = on_change
+        self.logger = logger or logging.getLogger(__name__)
+        self.snapshot_timeout_ms = snapshot_timeout_ms
+        self.stats = StateMirrorStats()
+
+        self._lock = threading.Lock()
+        self._state = msg_cls()
+        self._version: Optional[int] = None  # None until the first snapshot
+        self._pending: dict[int, tuple[Message, int]] = {}  # version -> (delta, mask), while resyncing
+        self._resync = threading.Event()
+        self._synced = threading.Event()
+        self._stopped = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+        self._sub_id: Optional[str] = None
+
+    @property
+    def version(self) -> Optional[int]:
+        with self._lock:
+            return self._version
+
+    @property
+    def state(self) -> Message:
+        """Copy of the mirrored state."""
+        with self._lock:
+            copy = self.msg_cls()
+            copy.CopyFrom(self._state)
+            return copy
+
+    def start(self):
+        """Subscribe to the deltas and fetch the initial snapshot in the background."""
+        self._stopped.clear()
+        self._sub_id = self.sub_client.subscribe_sample(self.key_expr, self._on_delta)
+        # Snapshots are fetched on a separate thread: blocking queries must not run in subscriber callbacks
+        self._thread = threading.Thread(target=self._snapshot_loop, name="state-mirror", daemon=True)
+        self._thread.start()
+        self._resync.set()
+
+    def stop(self):
+        self._stopped.set()
+        self._resync.set()
+        if self._sub_id is not None:
+            self.sub_client.unsubscribe(self._sub_id)
+            self._sub_id = None
+        if self._thread is not None:
+            self._thread.join(timeout=1.0)
+            self._thread = None
+
+    def wait_synced(self, timeout: float = 5.0) -> bool:
+        """Block until the first snapshot was applied."""
+        return self._synced.wait(timeout)
+
+    def _on_delta(self, key: str, data: bytes, attachment: Optional[bytes]):
+        att = Attachment.decode(attachment)
+        version = att.get_u32(AttachmentKey.STATE_VERSION)
+        mask = att.field_mask
+        if version is None or mask is None:
+            self.logger.warning(f"State delta on {key} without version/field mask")
+            return
+        delta = self.msg_cls()
+        try:
+            delta.ParseFromString(data)
+        except Exception as e:
+            self.logger.error(f"Failed to parse {self.msg_cls.__name__} delta: {e}")
+            return
+
+        with self._lock:
+            if self._version is not None and version == (self._version + 1) & 0xFFFFFFFF:
+                changed = apply_delta(self._state, delta, mask)
+                self._version = version
+                self.stats.deltas += 1
+                state = self._copy_locked()
+            else:
+                # Gap, reboot or snapshot pending: keep the delta for the replay and resync
+                if len(self._pending) < MAX_PENDING_DELTAS:
+                    self._pending[version] = (delta, mask)
+                if self._version is not None and not self._resync.is_set():
+                    self.stats.gaps += 1
+                    self.logger.info(f"State version gap on {key}: have {self._version}, got {version}")
+                self._resync.set()
+                return
+        self._notify(state, changed)
+
+    def _snapshot_loop(self):
+        while not self._stopped.is_set():
+            self._resync.wait()
+            if self._stopped.is_set():
+                return
+            result = self.rpc_client.query(self.key_expr + SNAPSHOT_SUFFIX, timeout_ms=self.snapshot_timeout_ms)
+            if not result.success:
+                self.logger.warning(f"State snapshot of {self.key_expr} failed: {result.error}")
+                self._stopped.wait(1.0)
+                continue
+            version = Attachment.decode(result.attachment).get_u32(AttachmentKey.STATE_VERSION)
+            snapshot = self.msg_cls()
+            try:
+                snapshot.ParseFromString(result.data)
+            except Exception as e:
+                self.logger.error(f"Failed to parse {self.msg_cls.__name__} snapshot: {e}")
+                self._stopped.wait(1.0)
+                continue
+            if version is None:
+                self.logger.error(f"State snapshot of {self.key_expr} without version")
+                self._stopped.wait(1.0)
+                continue
+            self._apply_snapshot(snapshot, version)
+
+    def _apply_snapshot(self, snapshot: Message, version: int):
+        with self._lock:
+            self._state = snapshot
+            self._version = version
+            self.stats.snapshots += 1
+            # Replay the deltas that arrived while the snapshot was in flight
+            pending, self._pending = self._pending, {}
+            ahead = False
+            for v in sorted(pending):
+                if v == (self._version + 1) & 0xFFFFFFFF:
+                    delta, mask = pending[v]
+                    apply_delta(self._state, delta, mask)
+                    self._version = v
+                    self.stats.deltas += 1
+                elif v > self._version:
+                    ahead = True
+                else:
+                    self.stats.stale += 1
+            # Still a hole after the replay (lost delta after the snapshot): fetch another one
+            if not ahead:
+                self._resync.clear()
+            self._synced.set()
+            state = self._copy_locked()
+        self._notify(state, [fd.name for fd in self.msg_cls.DESCRIPTOR.fields])
+
+    def _copy_locked(self) -> Message:
+        copy = self.msg_cls()
+        copy.CopyFrom(self._state)
+        return copy
+
+    def _notify(self, state: Message, changed: List[str]):
+        if self.on_change is not None:
+            try:
+                self.on_change(state, changed)
+            except Exception as e:
+                self.logger.error(f"State change callback failed: {e}")
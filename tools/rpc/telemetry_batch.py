@@ -0,0 +1,170 @@
+"""
+Decoder for TelemetryBatch messages - compressed batches of telemetry samples.
+
+The device compresses the 32-bit fields of a telemetry message per column: delta-of-delta timestamps and XOR-delta
+values (Gorilla). Wire format: see apps/zenoh_rpc/rpc/gorilla_codec.h (keep in sync).
+
+The bit stream is parsed sample by sample; the reconstruction (prefix sums of the timestamps, prefix XOR of the values)
+is vectorized with numpy when it is installed, otherwise plain Python is used.
+"""
+
+import itertools
+import operator
+import struct
+from dataclasses import dataclass, field
+from typing import Dict, Iterator, List, Sequence, Type
+
+from google.protobuf.descriptor import FieldDescriptor
+from google.protobuf.message import Message
+
+from . import service_pb2 as pb
+
+try:
+    import numpy as np
+except ImportError:  # pragma: no cover - optional dependency
+    np = None
+
+# Topic of the batches of a telemetry message: <zenoh_key>/batch
+BATCH_SUFFIX = "/batch"
+
+_NUMPY_TYPES = {
+    FieldDescriptor.TYPE_FLOAT: "float32",
+    FieldDescriptor.TYPE_FIXED32: "uint32",
+    FieldDescriptor.TYPE_SFIXED32: "int32",
+}
+_STRUCT_TYPES = {
+    FieldDescriptor.TYPE_FLOAT: "f",
+    FieldDescriptor.TYPE_FIXED32: "I",
+    FieldDescriptor.TYPE_SFIXED32: "i",
+}
+
+
+@dataclass
+class TelemetryColumns:
+    """Decoded batch: one timestamp and one value per column and sample."""
+
+    timestamps_ms: Sequence[int]  # device uptime, wraps at 2^32
+    columns: Dict[str, Sequence] = field(default_factory=dict)  # field name -> values
+
+    def __len__(self) -> int:
+        return len(self.timestamps_ms)
+
+    def rows(self) -> Iterator[dict]:
+        """Per-sample dicts ({"timestamp_ms": ..., <field>: ...})."""
+        names = list(self.columns)
+        for i, ts in enumerate(self.timestamps_ms):
+            row = {"timestamp_ms": int(ts)}
+            for name in names:
+                row[name] = self.columns[name][i].item() if np is not None else self.columns[name][i]
+            yield row
+
+    def to_messages(self, msg_cls: Type[Message]) -> List[Message]:
+        """Rebuild the telemetry messages (timestamps are dropped)."""
+        return [msg_cls(**{k: v for k, v in row.items() if k != "timestamp_ms"}) for row in self.rows()]
+
+
+class _BitReader:
+    def __init__(self, data: bytes):
+        self._value = int.from_bytes(data, "big")
+        self._bits = len(data) * 8
+        self._pos = 0
+
+    def read(self, nbits: int) -> int:
+        if self._pos + nbits > self._bits:
+            raise ValueError("Truncated batch")
+        self._pos += nbits
+        return (self._value >> (self._bits - self._pos)) & ((1 << nbits) - 1)
+
+    def read_signed(self, nbits: int) -> int:
+        v = self.read(nbits)
+        return v - (1 << nbits) if v & (1 << (nbits - 1)) else v
+
+
+def _read_dod(reader: _BitReader) -> int:
+    # '0' | '10' int7 | '110' int9 | '1110' int12 | '1111' int32
+    if reader.read(1) == 0:
+        return 0
+    if reader.read(1) == 0:
+        return reader.read_signed(7)
+    if reader.read(1) == 0:
+        return reader.read_signed(9)
+    if reader.read(1) == 0:
+        return reader.read_signed(12)
+    return reader.read_signed(32)
+
+
+def _parse(data: bytes, count: int, ncols: int):
+    """Parse the bit stream into timestamp delta-of-deltas and per-column XOR deltas."""
+    reader = _BitReader(data)
+    dods = [0] * count
+    xors = [[0] * count for _ in range(ncols)]
+    windows = [None] * ncols  # (leading, trailing) of the last explicit window
+
+    for i in range(count):
+        if i == 0:
+            first_ts = reader.read(32)
+            for c in range(ncols):
+                xors[c][0] = reader.read(32)
+            continue
+        dods[i] = _read_dod(reader)
+        for c in range(ncols):
+            if reader.read(1) == 0:
+                continue
+            if reader.read(1) == 0:
+                if windows[c] is None:
+                    raise ValueError("Window reuse before first window")
+                leading, trailing = windows[c]
+            else:
+                leading = reader.read(5)
+                trailing = 32 - leading - (reader.read(5) + 1)
+                if trailing < 0:
+                    raise ValueError("Invalid XOR window")
+                windows[c] = (leading, trailing)
+            xors[c][i] = reader.read(32 - leading - trailing) << trailing
+    return (first_ts if count else 0), dods, xors
+
+
+def decode_batch(batch: pb.TelemetryBatch, msg_cls: Type[Message]) -> TelemetryColumns:
+    """
+    Decode a TelemetryBatch of msg_cls samples.
+
+    Raises:
+        ValueError: malformed batch
+    """
+    fields = msg_cls.DESCRIPTOR.fields_by_number
+    count = batch.count
+    ncols = len(batch.field_tags)
+    if count == 0:
+        return TelemetryColumns([], {})
+    first_ts, dods, xors = _parse(batch.data, count, ncols)
+
+    names = []
+    types = []
+    for tag in batch.field_tags:
+        fd = fields.get(tag)
+        names.append(fd.name if fd is not None else f"field_{tag}")
+        types.append(fd.type if fd is not None and fd.type in _NUMPY_TYPES else FieldDescriptor.TYPE_FIXED32)
+
+    if np is not None:
+        deltas = np.cumsum(np.asarray(dods, dtype=np.int64))
+        timestamps = (first_ts + np.cumsum(deltas)) & 0xFFFFFFFF
+        columns = {
+            name: np.bitwise_xor.accumulate(np.asarray(col, dtype=np.uint32)).view(_NUMPY_TYPES[t])
+            for name, t, col in zip(names, types, xors)
+        }
+        return TelemetryColumns(timestamps, columns)
+
+    deltas = list(itertools.accumulate(dods))
+    timestamps = [(first_ts + s) & 0xFFFFFFFF for s in itertools.accumulate(deltas)]
+    columns = {}
+    for name, t, col in zip(names, types, xors):
+        raw = list(itertools.accumulate(col, operator.xor))
+        columns[name] = list(struct.unpack(f"<{count}{_STRUCT_TYPES[t]}", struct.pack(f"<{count}I", *raw)))
+    return TelemetryColumns(timestamps, columns)
+
+
+def decode_batch_payload(payload: bytes, msg_cls: Type[Message]) -> TelemetryColumns:
+    """Parse a serialized TelemetryBatch and decode it."""
+    batch = pb.TelemetryBatch()
+    batch.ParseFromString(payload)
+    return decode_batch(batch, msg_cls)
@@ -0,0 +1,272 @@
+"""
+Telemetry bus - decoded telemetry of all devices in a shared-memory ring for local readers.
+
+One writer (tools/telemetry_bus.py) subscribes to the telemetry once, decodes every sample once and appends it as a
+fixed-size record of float64 columns; any number of readers map the same file and follow the ring without locks or
+copies through the kernel. The C++ reader (tools/telemetry_bus_reader.h) reads the same layout.
+
+File layout (little endian), default /dev/shm/zenoh_rpc_telemetry:
+
+    header        64 KiB
+      0   u32 magic "ZTB1"            16  u32 max_values           32  u64 epoch (writer start, ns)
+      4   u16 version                 20  u32 stream_count
+      6   u16 header_size / 4096      24  u64 write_index (records published)
+      8   u32 slot_count (2^n)
+     12   u32 slot_size
+    streams       at 4096, MAX_STREAMS entries of 256 bytes: one per telemetry key expression
+      0   u32 state (1: valid, written last)
+      4   u16 column count
+      6   u16 key length
+      8   key expression (120 bytes), then the column names, comma separated (128 bytes)
+    slots         at header_size, slot_count records of slot_size bytes
+      0   u64 seq                     seqlock: 2*i+1 while record i is written, 2*i+2 once complete
+      8   u64 receive time [ns]       host time.time_ns()
+     16   i64 device time [us]        SOURCE_TIMESTAMP_US, or the batch sample timestamp
+     24   u32 sample sequence         SEQUENCE attachment entry of the (batch) sample
+     28   u16 stream index
+     30   u16 value count
+     32   f64 values[max_values]      numeric fields of the message, in stream column order
+
+A reader copies a record and accepts it if the slot seq was 2*i+2 before and after the copy; otherwise the writer
+lapped it and the record counts as lost. The writer relies on stores becoming visible in program order (x86-64);
+on weakly ordered hosts a torn record can go undetected. The seq words and write_index are copied as whole 8-byte
+slices (as in shm_ring.py): struct writes and reads them a byte at a time, so a reader could see a torn counter.
+CPython copies such a slice with memcpy, which is one aligned 8-byte move on the supported hosts but is not an atomic
+operation by contract.
+"""
+
+import mmap
+import os
+import struct
+import time
+from dataclasses import dataclass, field
+from typing import Optional, Sequence
+
+from google.protobuf.descriptor import FieldDescriptor
+
+from .proto_fields import is_repeated
+
+DEFAULT_PATH = "/dev/shm/zenoh_rpc_telemetry"
+MAGIC = 0x5A544231  # "ZTB1"
+VERSION = 1
+HEADER_SIZE = 65536
+STREAMS_OFFSET = 4096
+STREAM_ENTRY_SIZE = 256
+MAX_STREAMS = (HEADER_SIZE - STREAMS_OFFSET) // STREAM_ENTRY_SIZE
+MAX_KEY_LEN = 120
+MAX_COLUMNS_LEN = 128
+SLOT_HEADER_SIZE = 32
+
+_HEADER = struct.Struct("<IHHIIIIQQ")
+_WRITE_INDEX_OFFSET = 24
+_STREAM = struct.Struct("<IHH")
+_SLOT_BODY = struct.Struct("<QqIHH")  # slot header without seq
+
+
+def _load_u64(buf, offset: int) -> int:
+    return int.from_bytes(buf[offset : offset + 8], "little")
+
+
+def _store_u64(buf, offset: int, value: int):
+    buf[offset : offset + 8] = value.to_bytes(8, "little")
+
+
+# Fields stored as float64 columns
+NUMERIC_TYPES = {
+    FieldDescriptor.TYPE_DOUBLE,
+    FieldDescriptor.TYPE_FLOAT,
+    FieldDescriptor.TYPE_INT64,
+    FieldDescriptor.TYPE_UINT64,
+    FieldDescriptor.TYPE_INT32,
+    FieldDescriptor.TYPE_UINT32,
+    FieldDescriptor.TYPE_SINT32,
+    FieldDescriptor.TYPE_SINT64,
+    FieldDescriptor.TYPE_FIXED32,
+    FieldDescriptor.TYPE_FIXED64,
+    FieldDescriptor.TYPE_SFIXED32,
+    FieldDescriptor.TYPE_SFIXED64,
+    FieldDescriptor.TYPE_BOOL,
+    FieldDescriptor.TYPE_ENUM,
+}
+
+
+def numeric_columns(msg_cls) -> list[str]:
+    """Scalar numeric fields: the value columns of the message's stream."""
+    return [fd.name for fd in msg_cls.DESCRIPTOR.fields if fd.type in NUMERIC_TYPES and not is_repeated(fd)]
+
+
+@dataclass
+class TelemetryStream:
+    """Telemetry key expression and the names of its value columns."""
+
+    key_expr: str
+    columns: list[str] = field(default_factory=list)
+
+
+@dataclass
+class TelemetryRecord:
+    """One decoded sample."""
+
+    stream: int
+    receive_ns: int
+    device_us: int
+    sequence: int
+    values: tuple[float, ...]
+
+
+class TelemetryBusWriter:
+    """Creates the ring and appends records (single writer)."""
+
+    def __init__(self, path: str = DEFAULT_PATH, slot_count: int = 65536, max_values: int = 8):
+        if slot_count & (slot_count - 1):
+            raise ValueError("slot_count must be a power of two")
+        self.path = path
+        self.slot_count = slot_count
+        self.max_values = max_values
+        self.slot_size = SLOT_HEADER_SIZE + 8 * max_values
+        self._streams: dict[str, int] = {}
+        self._index = 0
+        self._values = struct.Struct(f"<{max_values}d")
+
+        # A new file (not truncating the old one): readers still mapping it notice the new inode and reopen
+        tmp = f"{path}.{os.getpid()}"
+        with open(tmp, "wb") as f:
+            f.truncate(HEADER_SIZE + slot_count * self.slot_size)
+        self._file = open(tmp, "r+b")
+        self._mm = mmap.mmap(self._file.fileno(), 0)
+        header = (MAGIC, VERSION, HEADER_SIZE // 4096, slot_count, self.slot_size, max_values, 0, 0, time.time_ns())
+        _HEADER.pack_into(self._mm, 0, *header)
+        os.replace(tmp, path)
+
+    def stream(self, key_expr: str, columns: Sequence[str]) -> int:
+        """Index of the stream of key_expr (added on first use)."""
+        index = self._streams.get(key_expr)
+        if index is not None:
+            return index
+        index = len(self._streams)
+        if index >= MAX_STREAMS:
+            raise RuntimeError("telemetry bus: stream table full")
+        key = key_expr.encode("utf-8")[:MAX_KEY_LEN]
+        names = ",".join(columns[: self.max_values]).encode("utf-8")[:MAX_COLUMNS_LEN]
+        offset = STREAMS_OFFSET + index * STREAM_ENTRY_SIZE
+        self._mm[offset + 8 : offset + 8 + len(key)] = key
+        self._mm[offset + 8 + MAX_KEY_LEN : offset + 8 + MAX_KEY_LEN + len(names)] = names
+        struct.pack_into("<HH", self._mm, offset + 4, min(len(columns), self.max_values), len(key))
+        # Valid flag last, then the count readers scan up to
+        struct.pack_into("<I", self._mm, offset, 1)
+        struct.pack_into("<I", self._mm, 20, index + 1)
+        self._streams[key_expr] = index
+        return index
+
+    def write(self, stream: int, values: Sequence[float], device_us: int = 0, sequence: int = 0, receive_ns: int = 0):
+        """Append one record; values beyond max_values are dropped."""
+        i = self._index
+        offset = HEADER_SIZE + (i & (self.slot_count - 1)) * self.slot_size
+        n = min(len(values), self.max_values)
+        padded = tuple(values[:n]) + (0.0,) * (self.max_values - n)
+        # Odd seq first: a reader of the overwritten record sees the change
+        _store_u64(self._mm, offset, 2 * i + 1)
+        _SLOT_BODY.pack_into(
+            self._mm, offset + 8, receive_ns or time.time_ns(), device_us, sequence & 0xFFFFFFFF, stream, n
+        )
+        self._values.pack_into(self._mm, offset + SLOT_HEADER_SIZE, *padded)
+        _store_u64(self._mm, offset, 2 * i + 2)
+        self._index = i + 1
+        _store_u64(self._mm, _WRITE_INDEX_OFFSET, self._index)
+
+    @property
+    def written(self) -> int:
+        return self._index
+
+    def close(self, unlink: bool = False):
+        self._mm.close()
+        self._file.close()
+        if unlink:
+            try:
+                os.unlink(self.path)
+            except FileNotFoundError:
+                pass
+
+
+class TelemetryBusReader:
+    """Follows the ring; poll() returns the records written since the last call."""
+
+    def __init__(self, path: str = DEFAULT_PATH, from_start: bool = False):
+        self.path = path
+        self.lost = 0
+        self.streams: list[TelemetryStream] = []
+        self._mm: Optional[mmap.mmap] = None
+        self._open(from_start)
+
+    def _open(self, from_start: bool):
+        if self._mm is not None:
+            self._mm.close()
+        with open(self.path, "rb") as f:
+            self._inode = os.fstat(f.fileno()).st_ino
+            self._mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, _, slot_count, slot_size, max_values, _, _, _ = _HEADER.unpack_from(self._mm, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"{self.path}: not a telemetry bus (version {VERSION})")
+        self.slot_count = slot_count
+        self.slot_size = slot_size
+        self.max_values = max_values
+        self._values = struct.Struct(f"<{max_values}d")
+        self.streams = []
+        write_index = self._write_index()
+        self._cursor = max(0, write_index - slot_count) if from_start else write_index
+
+    def _write_index(self) -> int:
+        return _load_u64(self._mm, _WRITE_INDEX_OFFSET)
+
+    def _refresh_streams(self):
+        count = struct.unpack_from("<I", self._mm, 20)[0]
+        for index in range(len(self.streams), count):
+            offset = STREAMS_OFFSET + index * STREAM_ENTRY_SIZE
+            state, n_columns, key_len = _STREAM.unpack_from(self._mm, offset)
+            if state != 1:
+                break
+            key = bytes(self._mm[offset + 8 : offset + 8 + key_len]).decode("utf-8")
+            names = bytes(self._mm[offset + 8 + MAX_KEY_LEN : offset + 8 + MAX_KEY_LEN + MAX_COLUMNS_LEN])
+            columns = names.rstrip(b"\0").decode("utf-8").split(",")[:n_columns] if n_columns else []
+            self.streams.append(TelemetryStream(key, columns))
+
+    def stream(self, index: int) -> Optional[TelemetryStream]:
+        """Stream of a record (key expression and column names)."""
+        if index >= len(self.streams):
+            self._refresh_streams()
+        return self.streams[index] if index < len(self.streams) else None
+
+    def poll(self, max_records: Optional[int] = None) -> list[TelemetryRecord]:
+        """Records written since the last call (oldest first); overwritten ones are added to lost."""
+        write_index = self._write_index()
+        if write_index == self._cursor:
+            # Writer restarted: the path now names a new ring
+            try:
+                if os.stat(self.path).st_ino != self._inode:
+                    self._open(from_start=True)
+                    write_index = self._write_index()
+            except FileNotFoundError:
+                pass
+        if write_index - self._cursor > self.slot_count:
+            self.lost += write_index - self._cursor - self.slot_count
+            self._cursor = write_index - self.slot_count
+        end = write_index if max_records is None else min(write_index, self._cursor + max_records)
+
+        records = []
+        mm = self._mm
+        for i in range(self._cursor, end):
+            offset = HEADER_SIZE + (i & (self.slot_count - 1)) * self.slot_size
+            seq = _load_u64(mm, offset)
+            receive_ns, device_us, sequence, stream, n = _SLOT_BODY.unpack_from(mm, offset + 8)
+            values = self._values.unpack_from(mm, offset + SLOT_HEADER_SIZE)[:n]
+            if seq != 2 * i + 2 or _load_u64(mm, offset) != seq:
+                self.lost += 1
+                continue
+            records.append(TelemetryRecord(stream, receive_ns, device_us, sequence, values))
+        self._cursor = end
+        return records
+
+    def close(self):
+        if self._mm is not None:
+            self._mm.close()
+            self._mm = None
@@ -0,0 +1,214 @@
+"""
+Telemetry Stats - per-stream loss, reordering and latency accounting.
+
+Every sample published by TelemetryPublisher carries a sequence number and the device's monotonic
+timestamp in its attachment. Gaps in the sequence are counted as loss (and un-counted if the sample
+arrives late), and the latency is estimated as the one-way delay above the smallest delay seen
+recently. The device clock is only an uptime counter, so the absolute latency is unknown; the
+"age" reported here is the queueing/retransmission delay on top of the best-case path, which is
+what grows when the network or router backs up. The baseline is a sliding-window minimum so that
+slow drift between the device and host clocks does not accumulate.
+"""
+
+import threading
+import time
+from collections import OrderedDict, deque
+from dataclasses import dataclass, field
+from typing import Optional
+
+from .zenoh_attachment import Attachment
+
+_SEQ_MOD = 1 << 32
+_SEQ_HALF = 1 << 31
+
+# Missing sequence numbers remembered to recognise late (reordered) samples
+MAX_TRACKED_GAPS = 4096
+# Age samples kept for percentiles
+AGE_WINDOW = 1024
+# Window of the minimum-delay baseline [s]
+BASELINE_WINDOW_S = 60.0
+
+
+def host_monotonic_us() -> int:
+    return time.monotonic_ns() // 1000
+
+
+@dataclass
+class StreamStats:
+    """Counters for one telemetry stream (key expression)."""
+
+    key_expr: str
+    received: int = 0
+    lost: int = 0
+    reordered: int = 0
+    duplicates: int = 0
+    restarts: int = 0
+    last_age_us: int = 0
+    max_age_us: int = 0
+    highest_seq: Optional[int] = None
+    _last_source_us: Optional[int] = None
+    _run_start_us: Optional[int] = None
+    _missing: OrderedDict = field(default_factory=OrderedDict)
+    _ages: deque = field(default_factory=lambda: deque(maxlen=AGE_WINDOW))
+    _baseline: deque = field(default_factory=deque)  # (arrival_us, offset_us), increasing offsets
+
+    @property
+    def loss_ratio(self) -> float:
+        total = self.received + self.lost
+        return self.lost / total if total else 0.0
+
+    def age_percentile(self, q: float) -> int:
+        if not self._ages:
+            return 0
+        ages = sorted(self._ages)
+        return ages[min(len(ages) - 1, int(q * len(ages)))]
+
+    def observe(self, seq: int, source_us: Optional[int], arrival_us: int):
+        restarted = self.highest_seq is not None and self._is_restart(seq, source_us)
+        if restarted:
+            self._reset()
+
+        if self.highest_seq is None:
+            self.highest_seq = seq
+            self._run_start_us = source_us
+            if restarted:
+                # The new run starts at 0: anything before this sample was lost
+                self.lost += seq
+        else:
+            delta = (seq - self.highest_seq) % _SEQ_MOD
+            if delta == 0:
+                self.duplicates += 1
+                return
+            if delta < _SEQ_HALF:
+                # In order or ahead: everything skipped is (for now) lost
+                first = self.highest_seq + max(1, delta - MAX_TRACKED_GAPS)
+                for missing in range(first, self.highest_seq + delta):
+                    self._missing[missing % _SEQ_MOD] = None
+                self.lost += delta - 1
+                while len(self._missing) > MAX_TRACKED_GAPS:
+                    self._missing.popitem(last=False)
+                self.highest_seq = seq
+            elif seq in self._missing:
+                # Late arrival of a sample already counted as lost
+                del self._missing[seq]
+                self.lost -= 1
+                self.reordered += 1
+            else:
+                self.duplicates += 1
+                return
+
+        self.received += 1
+        if source_us is not None:
+            self._last_source_us = max(source_us, self._last_source_us or 0)
+            self._update_age(arrival_us - source_us, arrival_us)
+
+    def _is_restart(self, seq: int, source_us: Optional[int]) -> bool:
+        # The device clock is its uptime and the sequence restarts at 0 after a reboot
+        delta = (seq - self.highest_seq) % _SEQ_MOD
+        if delta < _SEQ_HALF:
+            # Same or newer sequence number with an older timestamp
+            return source_us is not None and self._last_source_us is not None and source_us < self._last_source_us
+        if seq in self._missing:
+            return False
+        # Older sequence number that is not a late sample
+        if source_us is not None and self._run_start_us is not None:
+            return source_us < self._run_start_us
+        return seq == 0
+
+    def _reset(self):
+        self.restarts += 1
+        self.highest_seq = None
+        self._last_source_us = None
+        self._run_start_us = None
+        self._missing.clear()
+        self._baseline.clear()
+
+    def _update_age(self, offset_us: int, arrival_us: int):
+        # Monotonic deque: front is the minimum offset within the window
+        while self._baseline and self._baseline[-1][1] >= offset_us:
+            self._baseline.pop()
+        self._baseline.append((arrival_us, offset_us))
+        while arrival_us - self._baseline[0][0] > BASELINE_WINDOW_S * 1e6:
+            self._baseline.popleft()
+
+        age = offset_us - self._baseline[0][1]
+        self.last_age_us = age
+        self.max_age_us = max(self.max_age_us, age)
+        self._ages.append(age)
+
+    def summary(self) -> dict:
+        return {
+            "key_expr": self.key_expr,
+            "received": self.received,
+            "lost": self.lost,
+            "loss_ratio": round(self.loss_ratio, 6),
+            "reordered": self.reordered,
+            "duplicates": self.duplicates,
+            "restarts": self.restarts,
+            "age_us": {
+                "last": self.last_age_us,
+                "p50": self.age_percentile(0.50),
+                "p99": self.age_percentile(0.99),
+                "max": self.max_age_us,
+            },
+        }
+
+
+class TelemetryStats:
+    """Thread-safe registry of StreamStats keyed by key expression (device + topic)."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._streams: dict[str, StreamStats] = {}
+        self.untagged = 0
+
+    def observe(self, key_expr: str, attachment: Optional[bytes], arrival_us: Optional[int] = None):
+        """Record one received sample. Samples without a sequence number are only counted."""
+        if arrival_us is None:
+            arrival_us = host_monotonic_us()
+        att = Attachment.decode(attachment)
+        seq = att.sequence
+        with self._lock:
+            if seq is None:
+                self.untagged += 1
+                return
+            stream = self._streams.get(key_expr)
+            if stream is None:
+                stream = self._streams[key_expr] = StreamStats(key_expr)
+            stream.observe(seq, att.source_timestamp_us, arrival_us)
+
+    def stream(self, key_expr: str) -> Optional[StreamStats]:
+        with self._lock:
+            return self._streams.get(key_expr)
+
+    def streams(self) -> list[StreamStats]:
+        with self._lock:
+            return list(self._streams.values())
+
+    def summary(self) -> list[dict]:
+        with self._lock:
+            return [s.summary() for s in self._streams.values()]
+
+    def to_prometheus(self, prefix: str = "zenoh_telemetry") -> str:
+        """Render the counters in the Prometheus text exposition format."""
+        counters = [
+            ("received_total", "counter", "Samples received", lambda s: s.received),
+            ("lost_total", "counter", "Samples missing from the sequence", lambda s: s.lost),
+            ("reordered_total", "counter", "Samples that arrived after a later one", lambda s: s.reordered),
+            ("duplicates_total", "counter", "Duplicate samples", lambda s: s.duplicates),
+            ("restarts_total", "counter", "Publisher restarts detected", lambda s: s.restarts),
+            ("age_p50_seconds", "gauge", "Median delay above the best observed", lambda s: s.age_percentile(0.5) / 1e6),
+            ("age_p99_seconds", "gauge", "p99 delay above the best observed", lambda s: s.age_percentile(0.99) / 1e6),
+            ("age_max_seconds", "gauge", "Max delay above the best observed", lambda s: s.max_age_us / 1e6),
+        ]
+        streams = self.streams()
+        lines = []
+        with self._lock:
+            for name, kind, help_text, getter in counters:
+                lines.append(f"# HELP {prefix}_{name} {help_text}")
+                lines.append(f"# TYPE {prefix}_{name} {kind}")
+                for s in streams:
+                    lines.append(f'{prefix}_{name}{{key_expr="{s.key_expr}"}} {getter(s)}')
+            lines.append(f"# TYPE {prefix}_untagged_total counter")
+            lines.append(f"{prefix}_untagged_total {self.untagged}")
+        return "\n".join(lines) + "\n"
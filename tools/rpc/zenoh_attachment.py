@@ -0,0 +1,165 @@
+"""
+Zenoh Attachment - compact key/value metadata sent alongside payloads.
+
+Wire format: repeated [key:u8][len:u8][value:len bytes, little endian].
+Keep in sync with apps/zenoh_rpc/rpc/zenoh_attachment.h.
+"""
+
+import os
+import struct
+from enum import IntEnum
+from typing import Iterable, Optional, Type
+
+from google.protobuf.message import Message
+
+
+class AttachmentKey(IntEnum):
+    """Attachment entry keys."""
+
+    SEQUENCE = 1  # u32: per-publisher sample sequence number
+    SOURCE_TIMESTAMP_US = 2  # u64: publisher monotonic clock [us]
+    FIELD_MASK = 3  # 1..8 bytes: response fields requested by the client / fields changed in a state delta
+    STATE_VERSION = 4  # u32: version of a state delta or snapshot
+    CLIENT_ID = 5  # 1..16 bytes: opaque id of the calling client (per-client scheduling on the device)
+    TIMEOUT_MS = 6  # u32: client timeout of a query [ms]; the device drops or cuts short work nobody waits for
+    CREDITS = 7  # u32: messages the peer may send on a stream (zenoh_stream.py)
+    EXECUTE_AT_US = 8  # u64: device monotonic time to run the handler at (0: on arrival); reply: time it started
+
+
+MAX_CLIENT_ID_LEN = 16
+
+_U32 = struct.Struct("<I")
+_U64 = struct.Struct("<Q")
+
+
+class Attachment:
+    """Decoded attachment entries."""
+
+    def __init__(self, entries: Optional[dict[int, bytes]] = None):
+        self.entries: dict[int, bytes] = entries or {}
+
+    @classmethod
+    def decode(cls, data: Optional[bytes]) -> "Attachment":
+        """Parse an attachment; malformed trailing entries are ignored."""
+        entries: dict[int, bytes] = {}
+        if data:
+            pos = 0
+            while pos + 2 <= len(data):
+                key, length = data[pos], data[pos + 1]
+                if pos + 2 + length > len(data):
+                    break
+                entries[key] = bytes(data[pos + 2 : pos + 2 + length])
+                pos += 2 + length
+        return cls(entries)
+
+    def encode(self) -> bytes:
+        out = bytearray()
+        for key, value in self.entries.items():
+            out += bytes((key, len(value))) + value
+        return bytes(out)
+
+    def get_u32(self, key: int) -> Optional[int]:
+        value = self.entries.get(key)
+        return _U32.unpack(value)[0] if value is not None and len(value) == _U32.size else None
+
+    def get_u64(self, key: int) -> Optional[int]:
+        value = self.entries.get(key)
+        return _U64.unpack(value)[0] if value is not None and len(value) == _U64.size else None
+
+    def put_u32(self, key: int, value: int) -> "Attachment":
+        self.entries[key] = _U32.pack(value)
+        return self
+
+    def put_u64(self, key: int, value: int) -> "Attachment":
+        self.entries[key] = _U64.pack(value)
+        return self
+
+    @property
+    def sequence(self) -> Optional[int]:
+        return self.get_u32(AttachmentKey.SEQUENCE)
+
+    @property
+    def source_timestamp_us(self) -> Optional[int]:
+        return self.get_u64(AttachmentKey.SOURCE_TIMESTAMP_US)
+
+    @property
+    def execute_at_us(self) -> Optional[int]:
+        return self.get_u64(AttachmentKey.EXECUTE_AT_US)
+
+    @property
+    def field_mask(self) -> Optional[int]:
+        value = self.entries.get(AttachmentKey.FIELD_MASK)
+        return int.from_bytes(value, "little") if value else None
+
+
+def field_mask(msg_cls: Type[Message], fields: Iterable[str]) -> int:
+    """
+    Mask selecting the named fields of msg_cls (bit n-1 for field number n).
+
+    Fields numbered above 64 cannot be masked; the device always sends them.
+
+    Raises:
+        ValueError: unknown field name
+    """
+    by_name = msg_cls.DESCRIPTOR.fields_by_name
+    mask = 0
+    for name in fields:
+        fd = by_name.get(name)
+        if fd is None:
+            raise ValueError(f"{msg_cls.DESCRIPTOR.name} has no field {name!r}")
+        if fd.number <= 64:
+            mask |= 1 << (fd.number - 1)
+    return mask
+
+
+def field_mask_attachment(msg_cls: Type[Message], fields: Optional[Iterable[str]]) -> Optional[bytes]:
+    """Query attachment asking for only the named response fields (None: all fields)."""
+    if fields is None:
+        return None
+    mask = field_mask(msg_cls, fields)
+    # Little endian, just wide enough for the message's field numbers: the device sends fields beyond the mask width
+    highest = max((fd.number for fd in msg_cls.DESCRIPTOR.fields), default=1)
+    width = min((min(highest, 64) + 7) // 8, 8)
+    return bytes((AttachmentKey.FIELD_MASK, width)) + mask.to_bytes(8, "little")[:width]
+
+
+def execute_at_attachment(device_us: int) -> bytes:
+    """Query attachment running the handler at device_us on the device clock (device_clock.py); 0 runs it on arrival
+    but still reports the start in the reply."""
+    return bytes((AttachmentKey.EXECUTE_AT_US, _U64.size)) + _U64.pack(max(int(device_us), 0))
+
+
+def client_id_bytes(name: Optional[str] = None) -> bytes:
+    """CLIENT_ID value: the UTF-8 name (truncated), or 8 random bytes for an anonymous client instance."""
+    if name:
+        return name.encode("utf-8")[:MAX_CLIENT_ID_LEN]
+    return os.urandom(8)
+
+
+def with_client_id(attachment: Optional[bytes], client_id: Optional[bytes]) -> Optional[bytes]:
+    """Append the CLIENT_ID entry unless the attachment already carries one (e.g. forwarded by the gateway)."""
+    if not client_id:
+        return attachment
+    if attachment and AttachmentKey.CLIENT_ID in Attachment.decode(attachment).entries:
+        return attachment
+    return (attachment or b"") + bytes((AttachmentKey.CLIENT_ID, len(client_id))) + client_id
+
+
+def with_timeout(attachment: Optional[bytes], timeout_ms: Optional[int]) -> Optional[bytes]:
+    """Append the TIMEOUT_MS entry unless the attachment already carries one (e.g. forwarded by the gateway)."""
+    if not timeout_ms:
+        return attachment
+    if attachment and AttachmentKey.TIMEOUT_MS in Attachment.decode(attachment).entries:
+        return attachment
+    return (attachment or b"") + bytes((AttachmentKey.TIMEOUT_MS, 4)) + _U32.pack(min(int(timeout_ms), 0xFFFFFFFF))
+
+
+def without_key(attachment: Optional[bytes], key: int) -> Optional[bytes]:
+    """Attachment without the entry for key (None if nothing is left)."""
+    if not attachment:
+        return attachment
+    decoded = Attachment.decode(attachment)
+    if key not in decoded.entries:
+        return attachment
+    del decoded.entries[key]
+    return decoded.encode() or None
@@ -8,6 +8,8 @@ from typing import Callable, Optional
 
 import zenoh
 
+from .zenoh_attachment import client_id_bytes, with_client_id, with_timeout
+
 logger = logging.getLogger(__name__)
 
 
@@ -18,6 +20,7 @@ class RpcResult:
     success: bool
     data: bytes
     error: Optional[str] = None
+    attachment: Optional[bytes] = None  # reply attachment
 
 
 @dataclass
@@ -28,39 +31,157 @@ class RpcResponse:
     error: Optional[str] = None
 
 
+@dataclass
+class AdvancedSubscription:
+    """
+    Late-joiner history and gap recovery from the publisher's cache (zenoh.ext advanced subscriber).
+
+    Works with publishers declared with a publication cache (CONFIG_APP_ZENOH_ADVANCED_PUBLICATION on the device,
+    PublicationCache in zenoh_pubsub.h); with plain publishers the subscription behaves like a normal one.
+    """
+
+    history: int = 0  # cached samples per publisher delivered on subscribe (0: none)
+    history_max_age_s: Optional[float] = None  # ... and only those younger than this
+    recovery: bool = True  # query the samples missing in the publisher's sequence numbers
+    # Also poll the cache at this period: recovers a lost last sample without waiting for the next one
+    query_period_s: Optional[float] = None
+
+
 class ZenohRpcClient:
-    """Zenoh RPC client for Query/Queryable pattern."""
+    """
+    Zenoh RPC client for Query/Queryable pattern.
+
+    Every query carries a CLIENT_ID attachment entry: the device queues and schedules RPCs per client, so a client
+    flooding the device only slows down itself. Pass client_id to keep the same identity across processes. Queries
+    also carry their timeout (TIMEOUT_MS): the device skips calls that waited in its queue past it and handlers can
+    stop early (RpcContext::cancelled()).
+    """
 
-    def __init__(self, session: zenoh.Session, device_id: str):
+    def __init__(self, session: zenoh.Session, device_id: str, client_id: Optional[str] = None):
         self.session = session
         self.device_id = device_id
+        self.client_id = client_id_bytes(client_id)
+        # Query attachment of calls without metadata of their own
+        self.default_attachment = with_client_id(None, self.client_id)
+        self._keys: dict[tuple[str, str], str] = {}
 
     def set_device_id(self, device_id: str):
         """Set or clear the target device ID."""
         self.device_id = device_id
+        self._keys.clear()
+
+    def attachment_for(self, attachment: Optional[bytes], timeout_ms: Optional[int] = None) -> Optional[bytes]:
+        """Query attachment with this client's CLIENT_ID entry (and the TIMEOUT_MS entry) added."""
+        attachment = self.default_attachment if attachment is None else with_client_id(attachment, self.client_id)
+        return with_timeout(attachment, timeout_ms)
+
+    def method_key(self, service_name: str, method_name: str) -> str:
+        """Key expression of an RPC method on the target device (cached)."""
+        key = self._keys.get((service_name, method_name))
+        if key is None:
+            if self.device_id:
+                key = f"{self.device_id}/rpc/{service_name}/{method_name}"
+            else:
+                key = f"rpc/{service_name}/{method_name}"
+            self._keys[(service_name, method_name)] = key
+        return key
+
+    def method(self, service_name: str, method_name: str, timeout_ms: int = 5000) -> "RpcMethod":
+        """Prepared calls of one method (for repeated calls, see RpcMethod)."""
+        return RpcMethod(self, service_name, method_name, timeout_ms)
+
+    def call(
+        self,
+        service_name: str,
+        method_name: str,
+        request_data: bytes,
+        timeout_ms: int = 5000,
+        attachment: Optional[bytes] = None,
+    ) -> RpcResult:
+        """Synchronous RPC call; attachment carries query metadata (e.g. the response field mask)."""
+        return self.query(self.method_key(service_name, method_name), request_data, timeout_ms, attachment)
+
+    def query(
+        self, key_expr: str, payload: bytes = b"", timeout_ms: int = 5000, attachment: Optional[bytes] = None
+    ) -> RpcResult:
+        """Query an arbitrary key expression; returns the first reply and its attachment."""
+        try:
+            replies = self.session.get(
+                key_expr,
+                payload=payload,
+                timeout=timeout_ms / 1000.0,
+                attachment=self.attachment_for(attachment, timeout_ms),
+            )
+            return first_reply(replies)
+        except Exception as e:
+            logger.error(f"RPC call failed: {e}")
+            return RpcResult(success=False, data=b"", error=str(e))
 
-    def call(self, service_name: str, method_name: str, request_data: bytes, timeout_ms: int = 5000) -> RpcResult:
-        """Synchronous RPC call."""
-        if self.device_id:
-            key_expr = f"{self.device_id}/rpc/{service_name}/{method_name}"
-        else:
-            key_expr = f"rpc/{service_name}/{method_name}"
 
-        try:
-            replies = self.session.get(key_expr, payload=request_data, timeout=timeout_ms / 1000.0)
+def first_reply(replies) -> RpcResult:
+    """RpcResult of the first reply of a get."""
+    for reply in replies:
+        if reply.ok:
+            sample = reply.ok
+            reply_attachment = bytes(sample.attachment) if sample.attachment is not None else None
+            return RpcResult(success=True, data=bytes(sample.payload), attachment=reply_attachment)
+        # e.g. "busy" / "rate limited" from the device scheduler
+        reason = bytes(reply.err.payload).decode("utf-8", errors="replace")
+        return RpcResult(success=False, data=b"", error=f"Reply error: {reason}")
+    return RpcResult(success=False, data=b"", error="No reply received")
+
 
-            for reply in replies:
-                if reply.ok:
-                    return RpcResult(success=True, data=bytes(reply.ok.payload))
-                else:
-                    return RpcResult(success=False, data=b"", error=f"Reply error: {reply.err}")
+class RpcMethod:
+    """
+    Prepared calls of one RPC method, for clients calling it at a high rate.
 
-            return RpcResult(success=False, data=b"", error="No reply received")
+    The key expression is built once and, with zenoh >= 1.2, a querier is declared for it, so a call skips key
+    formatting and key expression resolution in the session. Rebound when the client's device ID changes. The
+    timeout is fixed per method (querier option).
+    """
 
+    def __init__(self, client: ZenohRpcClient, service_name: str, method_name: str, timeout_ms: int = 5000):
+        self.client = client
+        self.service_name = service_name
+        self.method_name = method_name
+        self.timeout_ms = timeout_ms
+        self._device_id: Optional[str] = None
+        self._key_expr = ""
+        self._querier = None
+        self._attachment = client.attachment_for(None, timeout_ms)
+
+    def _bind(self):
+        self.close()
+        self._device_id = self.client.device_id
+        self._key_expr = self.client.method_key(self.service_name, self.method_name)
+        declare_querier = getattr(self.client.session, "declare_querier", None)
+        if declare_querier is not None:
+            self._querier = declare_querier(self._key_expr, timeout=self.timeout_ms / 1000.0)
+
+    def __call__(self, payload: bytes, attachment: Optional[bytes] = None) -> RpcResult:
+        """Call with an encoded request; attachment as for ZenohRpcClient.call()."""
+        if self._device_id != self.client.device_id:
+            self._bind()
+        if self._querier is None:
+            return self.client.query(self._key_expr, payload, self.timeout_ms, attachment)
+        try:
+            if attachment is None:
+                replies = self._querier.get(payload=payload, attachment=self._attachment)
+            else:
+                replies = self._querier.get(
+                    payload=payload, attachment=self.client.attachment_for(attachment, self.timeout_ms)
+                )
+            return first_reply(replies)
         except Exception as e:
             logger.error(f"RPC call failed: {e}")
             return RpcResult(success=False, data=b"", error=str(e))
 
+    def close(self):
+        """Undeclare the querier (also done when the method is rebound)."""
+        if self._querier is not None:
+            self._querier.undeclare()
+            self._querier = None
+
 
 class ZenohSubscriberClient:
     """Zenoh subscriber for Pub/Sub pattern."""
@@ -68,26 +189,97 @@ class ZenohSubscriberClient:
     def __init__(self, session: zenoh.Session):
         self.session = session
         self._subscribers: dict[str, zenoh.Subscriber] = {}
-
-    def subscribe(self, key_expr: str, callback: Callable[[bytes], None]) -> str:
+        # Sample miss listeners of advanced subscribers, by sub_id
+        self._miss_listeners: dict[str, object] = {}
+        # Samples an advanced subscriber detected as missing and could not recover
+        self.unrecovered = 0
+
+    def subscribe(
+        self, key_expr: str, callback: Callable[[bytes], None], advanced: Optional[AdvancedSubscription] = None
+    ) -> str:
         """Subscribe to a topic."""
 
         def handler(sample: zenoh.Sample):
             callback(bytes(sample.payload))
 
-        subscriber = self.session.declare_subscriber(key_expr, handler)
+        return self._declare(key_expr, handler, advanced)
+
+    def subscribe_sample(
+        self,
+        key_expr: str,
+        callback: Callable[[str, bytes, Optional[bytes]], None],
+        advanced: Optional[AdvancedSubscription] = None,
+    ) -> str:
+        """Subscribe to a topic; callback receives (key_expr, payload, attachment)."""
+
+        def handler(sample: zenoh.Sample):
+            attachment = bytes(sample.attachment) if sample.attachment is not None else None
+            callback(str(sample.key_expr), bytes(sample.payload), attachment)
+
+        return self._declare(key_expr, handler, advanced)
+
+    def _declare(
+        self, key_expr: str, handler: Callable[[zenoh.Sample], None], advanced: Optional[AdvancedSubscription]
+    ) -> str:
+        listener = None
+        if advanced is not None:
+            subscriber, listener = self._declare_advanced(key_expr, handler, advanced)
+        else:
+            subscriber = self.session.declare_subscriber(key_expr, handler)
         sub_id = str(id(subscriber))
         self._subscribers[sub_id] = subscriber
+        if listener is not None:
+            self._miss_listeners[sub_id] = listener
         return sub_id
 
+    def _declare_advanced(
+        self, key_expr: str, handler: Callable[[zenoh.Sample], None], advanced: AdvancedSubscription
+    ) -> tuple[zenoh.Subscriber, Optional[object]]:
+        try:
+            import zenoh.ext as zext
+
+            zext.declare_advanced_subscriber
+        except (ImportError, AttributeError):
+            logger.warning(f"zenoh.ext advanced subscriber not available, plain subscription for {key_expr}")
+            return self.session.declare_subscriber(key_expr, handler), None
+
+        history = None
+        if advanced.history > 0:
+            history = zext.HistoryConfig(
+                detect_late_publishers=True, max_samples=advanced.history, max_age=advanced.history_max_age_s
+            )
+        recovery = None
+        if advanced.recovery:
+            recovery = (
+                zext.RecoveryConfig(periodic_queries=advanced.query_period_s)
+                if advanced.query_period_s
+                else zext.RecoveryConfig()
+            )
+        subscriber = zext.declare_advanced_subscriber(
+            self.session, key_expr, handler, history=history, recovery=recovery
+        )
+
+        def on_miss(miss):
+            self.unrecovered += miss.nb
+            logger.warning(f"{key_expr}: {miss.nb} samples of {miss.source} not recovered")
+
+        listener = subscriber.sample_miss_listener(on_miss) if recovery is not None else None
+        return subscriber, listener
+
     def unsubscribe(self, sub_id: str):
         """Unsubscribe from a topic."""
+        listener = self._miss_listeners.pop(sub_id, None)
+        if listener is not None:
+            listener.undeclare()
         if sub_id in self._subscribers:
             self._subscribers[sub_id].undeclare()
             del self._subscribers[sub_id]
 
     def unsubscribe_all(self):
         """Unsubscribe from all topics."""
+        for listener in self._miss_listeners.values():
+            listener.undeclare()
+        self._miss_listeners.clear()
         for subscriber in self._subscribers.values():
             subscriber.undeclare()
         self._subscribers.clear()
@@ -100,11 +292,17 @@ class LogSubscriber:
     """
 
     def __init__(
-        self, subscriber_client: ZenohSubscriberClient, device_id: str, logger: Optional[logging.Logger] = None
+        self,
+        subscriber_client: ZenohSubscriberClient,
+        device_id: str,
+        logger: Optional[logging.Logger] = None,
+        advanced: Optional[AdvancedSubscription] = None,
     ):
         self.sub_client = subscriber_client
         self.device_id = device_id
         self.logger = logger or logging.getLogger(__name__)
+        # e.g. AdvancedSubscription(history=32): the device's cached logs from before the subscription
+        self.advanced = advanced
         self._sub_id: Optional[str] = None
 
     def subscribe(self, callback: Callable[[str], None]):
@@ -122,7 +320,7 @@ class LogSubscriber:
             except Exception as e:
                 self.logger.error(f"Failed to decode log message: {e}")
 
-        self._sub_id = self.sub_client.subscribe(key_expr, handler)
+        self._sub_id = self.sub_client.subscribe(key_expr, handler, advanced=self.advanced)
 
     def unsubscribe(self):
         """Stop subscribing to logs."""
@@ -0,0 +1,209 @@
+"""
+Zenoh Stream - bidirectional message streams with credit-based flow control (host side).
+
+For steady flows of small messages each way (jogging an actuator, live tuning) without a query per message. The
+stream is opened with one query on the method key and then runs on two plain keys:
+
+    <device>/stream/<id>/in     requests, host to device (express publisher)
+    <device>/stream/<id>/out    responses, device to host
+
+Each data sample carries a SEQUENCE attachment entry. A sender may have at most the receiver's window of messages
+outstanding; the receiver returns credits with a CREDITS entry, on its own data or on an empty sample (no SEQUENCE)
+once half its window was consumed. A stream the device found idle for 10 s may be reused for another client; sends
+then stall without credit. Protocol: see apps/zenoh_rpc/rpc/zenoh_stream.h (keep in sync).
+"""
+
+import logging
+import queue
+import threading
+from dataclasses import dataclass
+from typing import Callable, Optional, Type
+
+from google.protobuf.message import Message
+
+from .zenoh_attachment import Attachment, AttachmentKey
+
+logger = logging.getLogger(__name__)
+
+# Messages the host accepts ahead of its on_message / recv() (its receive window)
+DEFAULT_WINDOW = 8
+
+
+@dataclass
+class StreamStats:
+    sent: int = 0
+    received: int = 0
+    lost: int = 0  # sequence gaps in the received messages
+    stale: int = 0  # messages behind the expected sequence (duplicates, reordered; dropped)
+    stalls: int = 0  # send() calls that timed out without credit
+
+
+class BidiStream:
+    """
+    One open stream: send() requests, receive responses with on_message (subscriber thread) or recv().
+
+    Needs a direct zenoh session (ZenohRpcClient); the HTTP gateway does not relay streams.
+    """
+
+    def __init__(
+        self,
+        rpc_client,
+        control_key: str,
+        control_cls: Type[Message],
+        stream_id: int,
+        device_window: int,
+        msg_cls: Type[Message],
+        on_message: Optional[Callable[[Message], None]] = None,
+        window: int = DEFAULT_WINDOW,
+    ):
+        self.rpc_client = rpc_client
+        self.control_key = control_key
+        self.control_cls = control_cls
+        self.stream_id = stream_id
+        self.msg_cls = msg_cls
+        self.on_message = on_message
+        self.window = window
+        self.stats = StreamStats()
+        self._credits = device_window
+        self._owed = 0
+        self._next_seq = 0
+        self._expected_seq = 0
+        self._closed = False
+        self._cond = threading.Condition()
+        self._received: "queue.Queue[Message]" = queue.Queue()
+
+        prefix = f"{rpc_client.device_id}/stream/{stream_id}"
+        session = rpc_client.session
+        self._publisher = session.declare_publisher(f"{prefix}/in", express=True)
+        self._subscriber = session.declare_subscriber(f"{prefix}/out", self._on_sample)
+
+    @classmethod
+    def open(
+        cls,
+        rpc_client,
+        service_name: str,
+        method_name: str,
+        control_cls: Type[Message],
+        msg_cls: Type[Message],
+        on_message: Optional[Callable[[Message], None]] = None,
+        window: int = DEFAULT_WINDOW,
+        timeout_ms: int = 5000,
+    ) -> "BidiStream":
+        """
+        Open a stream of a bidirectional method.
+
+        Raises:
+            NotImplementedError: the client has no zenoh session (gateway client)
+            RuntimeError: the device refused the stream (e.g. "busy": every stream slot in use)
+        """
+        if getattr(rpc_client, "session", None) is None or not rpc_client.device_id:
+            raise NotImplementedError("streams need a zenoh session and a device ID (not the gateway)")
+        control_key = rpc_client.method_key(service_name, method_name)
+        result = rpc_client.query(control_key, control_cls(window=window).SerializeToString(), timeout_ms)
+        if not result.success:
+            raise RuntimeError(f"{method_name}: stream not opened: {result.error}")
+        reply = control_cls()
+        reply.ParseFromString(result.data)
+        logger.info(f"{method_name}: stream {reply.stream_id} open (device window {reply.window})")
+        return cls(rpc_client, control_key, control_cls, reply.stream_id, reply.window, msg_cls, on_message, window)
+
+    @property
+    def credits(self) -> int:
+        """Messages that may be sent before the device returns credits."""
+        with self._cond:
+            return self._credits
+
+    def send(self, message: Message, timeout: Optional[float] = 1.0) -> bool:
+        """Send one request; waits up to timeout for credit (None: forever). False without credit or if closed."""
+        payload = message.SerializeToString()
+        with self._cond:
+            if not self._cond.wait_for(lambda: self._credits > 0 or self._closed, timeout):
+                self.stats.stalls += 1
+                return False
+            if self._closed:
+                return False
+            self._credits -= 1
+            attachment = Attachment().put_u32(AttachmentKey.SEQUENCE, self._next_seq)
+            self._next_seq += 1
+            self._take_owed(attachment)
+            # Under the lock: samples leave in sequence order
+            self._publisher.put(payload, attachment=attachment.encode())
+            self.stats.sent += 1
+        return True
+
+    def recv(self, timeout: Optional[float] = None) -> Optional[Message]:
+        """Next response (without on_message); None on timeout."""
+        try:
+            message = self._received.get(timeout=timeout)
+        except queue.Empty:
+            return None
+        self._consumed()
+        return message
+
+    def close(self, timeout_ms: int = 2000):
+        """Close the stream on the device and undeclare its keys."""
+        with self._cond:
+            if self._closed:
+                return
+            self._closed = True
+            self._cond.notify_all()
+        control = self.control_cls(stream_id=self.stream_id, close=True)
+        result = self.rpc_client.query(self.control_key, control.SerializeToString(), timeout_ms)
+        if not result.success:
+            logger.warning(f"Stream {self.stream_id}: close failed: {result.error}")
+        self._subscriber.undeclare()
+        self._publisher.undeclare()
+
+    def __enter__(self) -> "BidiStream":
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _take_owed(self, attachment: Attachment):
+        if self._owed:
+            attachment.put_u32(AttachmentKey.CREDITS, self._owed)
+            self._owed = 0
+
+    def _on_sample(self, sample):
+        attachment = Attachment.decode(bytes(sample.attachment) if sample.attachment is not None else None)
+        granted = attachment.get_u32(AttachmentKey.CREDITS)
+        seq = attachment.sequence
+        with self._cond:
+            if granted:
+                self._credits += granted
+                self._cond.notify_all()
+            if seq is None:
+                return  # credits only
+            ahead = (seq - self._expected_seq) & 0xFFFFFFFF
+            stale = ahead >= 0x80000000
+            if stale:
+                self.stats.stale += 1
+            else:
+                self.stats.lost += ahead
+                self._expected_seq = (seq + 1) & 0xFFFFFFFF
+                self.stats.received += 1
+        if stale:
+            self._consumed()
+            return
+
+        message = self.msg_cls()
+        try:
+            message.ParseFromString(bytes(sample.payload))
+            if self.on_message is None:
+                self._received.put(message)
+                return  # consumed by recv()
+            self.on_message(message)
+        except Exception as e:
+            logger.error(f"Stream {self.stream_id}: message not handled: {e}")
+        self._consumed()
+
+    def _consumed(self):
+        # The message left the window: return credits once half of it was consumed
+        with self._cond:
+            self._owed += 1
+            if self._owed < max(1, self.window // 2) or self._closed:
+                return
+            attachment = Attachment()
+            self._take_owed(attachment)
+            self._publisher.put(b"", attachment=attachment.encode())
@@ -0,0 +1,130 @@
+"""
+RPC client overhead - Python-side cost per call of the generated client, without a device.
+
+The zenoh session is replaced by a stub that answers every query with a canned Echo reply, so the time per call is
+what the client itself spends: building and encoding the request, the key expression, the attachment, reply handling
+and decoding. With --connect a real session is used instead (no device needed); the calls then also include the
+session's per-query work, e.g. key expression resolution, which the declared queriers skip. Compared variants:
+
+    call      the generated echo() before prepared methods: key expression built per call
+    echo      DeviceServiceClient.echo(msg=...): prepared method, new request/response per call
+    into      DeviceServiceClient.echo_into(request, response): messages reused across calls
+    raw       DeviceServiceClient.echo_raw(payload): encoded bytes in and out
+
+Usage:
+    uv run python tools/rpc_client_overhead.py
+    uv run python tools/rpc_client_overhead.py -n 2000 -c tcp/127.0.0.1:7447
+    uv run python tools/rpc_client_overhead.py -n 200000 --size 100 --label py312 --json overhead.jsonl
+"""
+
+import argparse
+import json
+import time
+from types import SimpleNamespace
+
+from rpc import service_pb2 as pb
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_attachment import field_mask_attachment, with_client_id
+from rpc.zenoh_rpc_client import RpcResponse, ZenohRpcClient, first_reply
+
+DEVICE_ID = "pico2w-001"
+
+
+class StubSession:
+    """Answers every get (session or querier) with the same reply."""
+
+    def __init__(self, reply_payload: bytes):
+        self._replies = [SimpleNamespace(ok=SimpleNamespace(payload=reply_payload, attachment=None))]
+
+    def close(self):
+        pass
+
+    def get(self, key_expr, payload=None, timeout=None, attachment=None):
+        return self._replies
+
+    def declare_querier(self, key_expr, timeout=None):
+        return SimpleNamespace(get=lambda payload=None, attachment=None: self._replies, undeclare=lambda: None)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Measure the Python-side overhead per RPC call")
+    parser.add_argument("-n", "--count", type=int, default=50000, help="Calls per variant (default: 50000)")
+    parser.add_argument("--size", type=int, default=16, help="Echo message length in bytes (default: 16)")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        help="Use a real session to this router instead of the stub (no device: calls get no reply, but the "
+        "session's own per-query cost is included)",
+    )
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. Python version)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def run(fn, count: int) -> float:
+    """Mean time per call [us]"""
+    for _ in range(min(count, 1000)):
+        fn()
+    t0 = time.perf_counter()
+    for _ in range(count):
+        fn()
+    return (time.perf_counter() - t0) / count * 1e6
+
+
+def main():
+    args = parse_args()
+    msg = "x" * args.size
+    if args.connect:
+        import zenoh
+
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        session = zenoh.open(config)
+    else:
+        session = StubSession(pb.EchoResponse(msg=msg).SerializeToString())
+    rpc_client = ZenohRpcClient(session, DEVICE_ID, client_id="overhead")
+    service = DeviceServiceClient(rpc_client)
+
+    def call():
+        # What echo() did before: key expression, attachment and session.get() per call
+        request = pb.EchoRequest(msg=msg)
+        replies = session.get(
+            f"{DEVICE_ID}/rpc/DeviceService/Echo",
+            payload=request.SerializeToString(),
+            timeout=5.0,
+            attachment=with_client_id(field_mask_attachment(pb.EchoResponse, None), rpc_client.client_id),
+        )
+        result = first_reply(replies)
+        if result.success:
+            response = pb.EchoResponse()
+            response.ParseFromString(result.data)
+            return RpcResponse(success=True), response
+        return RpcResponse(success=False, error=result.error), None
+
+    request = pb.EchoRequest(msg=msg)
+    response = pb.EchoResponse()
+    payload = request.SerializeToString()
+    variants = {
+        "call": call,
+        "echo": lambda: service.echo(msg=msg),
+        "into": lambda: service.echo_into(request, response),
+        "raw": lambda: service.echo_raw(payload),
+    }
+
+    result = {"label": args.label, "count": args.count, "size": args.size}
+    for name, fn in variants.items():
+        us = run(fn, args.count)
+        result[f"{name}_us"] = round(us, 3)
+        print(f"{name:5s} {us:8.2f} us/call  {1e6 / us:10.0f} calls/s")
+
+    session.close()
+
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,172 @@
+"""
+RPC fairness check - latency of a well-behaved client while another client floods the device.
+
+The probe client sends one Echo every --interval-ms and records the round-trip time. The flood client (its own
+client id, --flood-threads concurrent callers) sends Echo back to back with a large payload. The probe is measured
+alone first, then under the flood; with the device scheduler (rpc/rpc_scheduler.h) its p99 should stay close to the
+baseline while the flood gets "busy" replies once it exceeds its in-flight limit.
+
+Usage:
+    uv run python tools/rpc_fairness.py -n 300
+    uv run python tools/rpc_fairness.py -n 300 --flood-threads 8 --flood-size 120 --json fairness.jsonl
+"""
+
+import argparse
+import json
+import logging
+import threading
+import time
+
+import zenoh
+from rpc.gateway_client import GatewayRpcClient
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_rpc_client import ZenohRpcClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Probe RPC latency with and without a flooding client")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument(
+        "-g", "--gateway", type=str, help="Use a local RPC gateway (http://host:port or unix:///path) instead of zenoh"
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("-n", "--count", type=int, default=200, help="Probe calls per phase (default: 200)")
+    parser.add_argument("--interval-ms", type=float, default=20.0, help="Probe call interval (default: 20)")
+    parser.add_argument("--flood-threads", type=int, default=4, help="Concurrent flooding callers (default: 4)")
+    parser.add_argument("--flood-size", type=int, default=120, help="Flood Echo message length, max 127 (default: 120)")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. build variant)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def percentile(sorted_values: list[float], q: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(q * len(sorted_values)))]
+
+
+def probe(service: DeviceServiceClient, count: int, interval_ms: float) -> dict:
+    rtts_ms = []
+    failures = 0
+    next_call = time.perf_counter()
+    for _ in range(count):
+        t0 = time.perf_counter()
+        response, _ = service.echo(msg="probe")
+        t1 = time.perf_counter()
+        if response.success:
+            rtts_ms.append((t1 - t0) * 1000.0)
+        else:
+            failures += 1
+        next_call += interval_ms / 1000.0
+        time.sleep(max(0.0, next_call - time.perf_counter()))
+
+    rtts_ms.sort()
+    result = {"count": count, "failures": failures}
+    if rtts_ms:
+        result.update(
+            {
+                "p50_ms": round(percentile(rtts_ms, 0.50), 3),
+                "p90_ms": round(percentile(rtts_ms, 0.90), 3),
+                "p99_ms": round(percentile(rtts_ms, 0.99), 3),
+                "max_ms": round(rtts_ms[-1], 3),
+            }
+        )
+    return result
+
+
+class Flood:
+    """Back-to-back Echo calls from several threads sharing one client id."""
+
+    def __init__(self, make_client, threads: int, size: int):
+        self.make_client = make_client
+        self.threads = threads
+        self.msg = "f" * size
+        self.stop = threading.Event()
+        self.lock = threading.Lock()
+        self.ok = 0
+        self.rejected = 0
+        self.failed = 0
+        self._workers: list[threading.Thread] = []
+
+    def start(self):
+        for _ in range(self.threads):
+            worker = threading.Thread(target=self._run, daemon=True)
+            worker.start()
+            self._workers.append(worker)
+
+    def join(self):
+        self.stop.set()
+        for worker in self._workers:
+            worker.join(timeout=10.0)
+
+    def _run(self):
+        service = DeviceServiceClient(self.make_client())
+        while not self.stop.is_set():
+            response, _ = service.echo(msg=self.msg)
+            with self.lock:
+                if response.success:
+                    self.ok += 1
+                elif response.error and ("busy" in response.error or "rate limited" in response.error):
+                    self.rejected += 1
+                else:
+                    self.failed += 1
+
+
+def main():
+    args = parse_args()
+
+    session = None
+    if args.gateway:
+
+        def make_client(client_id: str):
+            return GatewayRpcClient(args.gateway, args.device_id, client_id=client_id)
+
+    else:
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        session = zenoh.open(config)
+
+        def make_client(client_id: str):
+            return ZenohRpcClient(session, args.device_id, client_id=client_id)
+
+    try:
+        service = DeviceServiceClient(make_client("probe"))
+        service.echo(msg="warmup")
+        baseline = probe(service, args.count, args.interval_ms)
+        logger.info(f"Probe alone: {baseline}")
+
+        flood = Flood(lambda: make_client("flood"), args.flood_threads, args.flood_size)
+        flood.start()
+        time.sleep(0.5)
+        flooded = probe(service, args.count, args.interval_ms)
+        flood.join()
+        logger.info(f"Probe under flood: {flooded}")
+        logger.info(f"Flood: {flood.ok} served, {flood.rejected} rejected, {flood.failed} failed")
+    finally:
+        if session is not None:
+            session.close()
+
+    result = {
+        "label": args.label,
+        "baseline": baseline,
+        "flooded": flooded,
+        "flood": {"threads": args.flood_threads, "ok": flood.ok, "rejected": flood.rejected, "failed": flood.failed},
+    }
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+
+if __name__ == "__main__":
+    main()
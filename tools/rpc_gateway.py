@@ -0,0 +1,483 @@
+"""
+Local RPC gateway daemon.
+
+Owns a single zenoh session and serves RPCs and telemetry to any number of local clients over
+HTTP (TCP or Unix socket), so device and router load stays constant as local consumers are added.
+
+- Identical in-flight RPCs (same key expression, payload and attachment) are coalesced into one zenoh query.
+  The client id entry of the attachment is forwarded (per-client scheduling on the device) but does not count.
+- Results of side-effect free methods (idempotency_level = NO_SIDE_EFFECTS in service.proto)
+  are cached for --cache-ms.
+- Each telemetry key expression is subscribed once and fanned out to every local subscriber.
+
+HTTP API:
+    POST /rpc/<device_id>/<service>/<method>?timeout_ms=5000
+        Body: protobuf request (application/x-protobuf) or JSON (application/json).
+        Reply: protobuf or JSON response, matching the request content type.
+        Use "-" as device_id for calls without a device prefix.
+        Optional X-Zenoh-Attachment header (hex): query attachment, e.g. the response field mask.
+    GET  /query/<key_expr>?timeout_ms=5000
+        Optional X-Zenoh-Attachment header (hex): query attachment.
+        Raw zenoh query (e.g. a state snapshot), coalesced like RPCs. Reply: first reply payload, its attachment
+        in X-Zenoh-Attachment.
+    GET  /sub/<key_expr>
+        Stream of length-prefixed samples (see rpc/gateway_client.py).
+    GET  /stats
+        Gateway counters as JSON.
+
+Usage:
+    uv run tools/rpc_gateway.py --router tcp/127.0.0.1:7447
+    uv run tools/rpc_gateway.py --unix /tmp/zenoh_rpc_gateway.sock
+"""
+
+import argparse
+import json
+import logging
+import os
+import queue
+import select
+import socket
+import socketserver
+import threading
+import time
+import urllib.parse
+from dataclasses import dataclass, field
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Optional
+
+import zenoh
+from google.protobuf import descriptor_pb2, json_format
+from google.protobuf.message_factory import GetMessageClass
+
+import rpc.service_pb2 as pb
+from rpc.gateway_client import ATTACHMENT_HEADER, STREAM_CONTENT_TYPE, encode_frame
+from rpc.zenoh_attachment import AttachmentKey, with_timeout, without_key
+from rpc.zenoh_rpc_client import RpcResult
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+DEFAULT_LISTEN = "127.0.0.1:7450"
+
+
+@dataclass
+class GatewayStats:
+    """Counters reported by GET /stats."""
+
+    calls: int = 0
+    upstream_queries: int = 0
+    coalesced: int = 0
+    cache_hits: int = 0
+    errors: int = 0
+    subscribers: int = 0
+    upstream_subscriptions: int = 0
+    samples_in: int = 0
+    samples_out: int = 0
+    samples_dropped: int = 0
+
+
+class _InflightCall:
+    """A zenoh query shared by every caller that asked for the same request."""
+
+    def __init__(self):
+        self.done = threading.Event()
+        self.result: Optional[RpcResult] = None
+
+
+@dataclass
+class _Fanout:
+    """One upstream subscriber and the queues of the local clients attached to it."""
+
+    subscriber: Optional[zenoh.Subscriber] = None
+    queues: set = field(default_factory=set)
+
+
+class RpcGateway:
+    """Multiplexes local RPC and telemetry clients onto one zenoh session."""
+
+    def __init__(self, session: zenoh.Session, cache_ms: int = 200, queue_size: int = 256):
+        self.session = session
+        self.cache_s = cache_ms / 1000.0
+        self.queue_size = queue_size
+        self.stats = GatewayStats()
+        self._lock = threading.Lock()
+        # Keyed by (key_expr, payload, attachment)
+        self._inflight: dict[tuple[str, bytes, Optional[bytes]], _InflightCall] = {}
+        self._cache: dict[tuple[str, bytes, Optional[bytes]], tuple[float, RpcResult]] = {}
+        self._fanouts: dict[str, _Fanout] = {}
+        self.cacheable_methods = self._find_cacheable_methods()
+
+    @staticmethod
+    def _find_cacheable_methods() -> set[tuple[str, str]]:
+        """Collect (service, method) pairs declared free of side effects in the proto."""
+        cacheable = set()
+        for service in pb.DESCRIPTOR.services_by_name.values():
+            for method in service.methods:
+                if method.GetOptions().idempotency_level == descriptor_pb2.MethodOptions.NO_SIDE_EFFECTS:
+                    cacheable.add((service.name, method.name))
+        return cacheable
+
+    @staticmethod
+    def build_key_expr(device_id: str, service_name: str, method_name: str) -> str:
+        """Same key layout as ZenohRpcClient.call()."""
+        if device_id:
+            return f"{device_id}/rpc/{service_name}/{method_name}"
+        return f"rpc/{service_name}/{method_name}"
+
+    # ------------------------------------------------------------------
+    # RPC
+    # ------------------------------------------------------------------
+    def call(
+        self,
+        device_id: str,
+        service_name: str,
+        method_name: str,
+        request_data: bytes,
+        timeout_ms: int,
+        attachment: Optional[bytes] = None,
+    ) -> RpcResult:
+        """Forward an RPC, reusing a cached result or an identical in-flight query when possible."""
+        key_expr = self.build_key_expr(device_id, service_name, method_name)
+        cacheable = self.cache_s > 0 and (service_name, method_name) in self.cacheable_methods
+        return self.forward(key_expr, request_data, timeout_ms, attachment, cacheable)
+
+    def forward(
+        self,
+        key_expr: str,
+        request_data: bytes,
+        timeout_ms: int,
+        attachment: Optional[bytes] = None,
+        cacheable: bool = False,
+    ) -> RpcResult:
+        """Forward a query on any key expression, coalescing identical in-flight queries."""
+        # The attachment selects the response fields: part of the identity of a call. The client id is not: the
+        # coalesced query carries the id of the first caller.
+        key = (key_expr, request_data, without_key(attachment, AttachmentKey.CLIENT_ID))
+
+        deadline = time.monotonic() + timeout_ms / 1000.0
+
+        with self._lock:
+            self.stats.calls += 1
+            if cacheable:
+                cached = self._cache.get(key)
+                if cached and cached[0] > time.monotonic():
+                    self.stats.cache_hits += 1
+                    return cached[1]
+
+        while True:
+            with self._lock:
+                inflight = self._inflight.get(key)
+                leader = inflight is None
+                if leader:
+                    inflight = _InflightCall()
+                    self._inflight[key] = inflight
+                    self.stats.upstream_queries += 1
+                else:
+                    self.stats.coalesced += 1
+            if leader:
+                break
+            if not inflight.done.wait(max(deadline - time.monotonic(), 0.0)):
+                return RpcResult(success=False, data=b"", error="No reply received")
+            # The leader's query may have had a shorter timeout than this caller: ask again with the time left
+            timeout_ms = int((deadline - time.monotonic()) * 1000)
+            if inflight.result.error != "No reply received" or timeout_ms <= 0:
+                return inflight.result
+
+        result = self._query(key_expr, request_data, timeout_ms, attachment)
+        with self._lock:
+            if not result.success:
+                self.stats.errors += 1
+            elif cacheable:
+                now = time.monotonic()
+                self._cache[key] = (now + self.cache_s, result)
+                if len(self._cache) > 1024:
+                    self._cache = {k: v for k, v in self._cache.items() if v[0] > now}
+            del self._inflight[key]
+        inflight.result = result
+        inflight.done.set()
+        return result
+
+    def _query(self, key_expr: str, request_data: bytes, timeout_ms: int, attachment: Optional[bytes]) -> RpcResult:
+        try:
+            # The device drops the call if it is still queued when this query times out
+            replies = self.session.get(
+                key_expr,
+                payload=request_data,
+                timeout=timeout_ms / 1000.0,
+                attachment=with_timeout(attachment, timeout_ms),
+            )
+            for reply in replies:
+                if reply.ok:
+                    sample = reply.ok
+                    reply_attachment = bytes(sample.attachment) if sample.attachment is not None else None
+                    return RpcResult(success=True, data=bytes(sample.payload), attachment=reply_attachment)
+                reason = bytes(reply.err.payload).decode("utf-8", errors="replace")
+                return RpcResult(success=False, data=b"", error=f"Reply error: {reason}")
+            return RpcResult(success=False, data=b"", error="No reply received")
+        except Exception as e:
+            logger.error(f"RPC call failed: {e}")
+            return RpcResult(success=False, data=b"", error=str(e))
+
+    # ------------------------------------------------------------------
+    # Telemetry fan-out
+    # ------------------------------------------------------------------
+    def attach(self, key_expr: str) -> queue.Queue:
+        """Attach a local subscriber; the upstream subscription is declared on first use."""
+        q: queue.Queue = queue.Queue(maxsize=self.queue_size)
+        with self._lock:
+            fanout = self._fanouts.get(key_expr)
+            if fanout is None:
+                fanout = _Fanout()
+                self._fanouts[key_expr] = fanout
+                fanout.subscriber = self.session.declare_subscriber(
+                    key_expr, lambda sample, f=fanout: self._on_sample(f, sample)
+                )
+                self.stats.upstream_subscriptions += 1
+                logger.info(f"Subscribed upstream: {key_expr}")
+            fanout.queues.add(q)
+            self.stats.subscribers += 1
+        return q
+
+    def detach(self, key_expr: str, q: queue.Queue):
+        """Detach a local subscriber; the upstream subscription is dropped with the last one."""
+        with self._lock:
+            fanout = self._fanouts.get(key_expr)
+            if fanout is None or q not in fanout.queues:
+                return
+            fanout.queues.discard(q)
+            self.stats.subscribers -= 1
+            if fanout.queues:
+                return
+            del self._fanouts[key_expr]
+            self.stats.upstream_subscriptions -= 1
+        fanout.subscriber.undeclare()
+        logger.info(f"Unsubscribed upstream: {key_expr}")
+
+    def sample_delivered(self):
+        """Count a sample written to a local client (HTTP handler threads)."""
+        with self._lock:
+            self.stats.samples_out += 1
+
+    def _on_sample(self, fanout: _Fanout, sample: zenoh.Sample):
+        attachment = bytes(sample.attachment) if sample.attachment is not None else None
+        frame = encode_frame(str(sample.key_expr), bytes(sample.payload), attachment)
+        with self._lock:
+            self.stats.samples_in += 1
+            queues = list(fanout.queues)
+        for q in queues:
+            try:
+                q.put_nowait(frame)
+            except queue.Full:
+                # Slow consumer: drop its oldest sample so the others are not held back
+                try:
+                    q.get_nowait()
+                except queue.Empty:
+                    pass
+                q.put_nowait(frame)
+                with self._lock:
+                    self.stats.samples_dropped += 1
+
+
+class GatewayRequestHandler(BaseHTTPRequestHandler):
+    """HTTP front end of RpcGateway."""
+
+    protocol_version = "HTTP/1.1"
+    server_version = "ZenohRpcGateway/0.1"
+
+    @property
+    def gateway(self) -> RpcGateway:
+        return self.server.gateway
+
+    def address_string(self):
+        # Unix socket peers have no (host, port) tuple
+        return self.client_address[0] if isinstance(self.client_address, tuple) else "unix"
+
+    def log_message(self, format, *args):
+        logger.debug(f"{self.address_string()} - {format % args}")
+
+    def _send(
+        self,
+        status: int,
+        body: bytes,
+        content_type: str = "text/plain; charset=utf-8",
+        attachment: Optional[bytes] = None,
+    ):
+        self.send_response(status)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        if attachment:
+            self.send_header(ATTACHMENT_HEADER, attachment.hex())
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_POST(self):
+        url = urllib.parse.urlparse(self.path)
+        parts = url.path.strip("/").split("/")
+        if len(parts) != 4 or parts[0] != "rpc":
+            self._send(404, b"Expected /rpc/<device_id>/<service>/<method>")
+            return
+        device_id = urllib.parse.unquote(parts[1])
+        device_id = "" if device_id == "-" else device_id
+        service_name, method_name = parts[2], parts[3]
+        options = self._request_options(urllib.parse.parse_qs(url.query))
+        if options is None:
+            return
+        timeout_ms, attachment = options
+
+        body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        use_json = self.headers.get("Content-Type", "").startswith("application/json")
+        if use_json:
+            try:
+                method = pb.DESCRIPTOR.services_by_name[service_name].methods_by_name[method_name]
+                request = json_format.Parse(body or b"{}", GetMessageClass(method.input_type)())
+            except KeyError:
+                self._send(404, f"Unknown method {service_name}/{method_name}".encode())
+                return
+            except json_format.ParseError as e:
+                self._send(400, str(e).encode())
+                return
+            body = request.SerializeToString()
+
+        result = self.gateway.call(device_id, service_name, method_name, body, timeout_ms, attachment)
+        if not result.success:
+            status = 504 if result.error == "No reply received" else 502
+            self._send(status, (result.error or "").encode())
+            return
+        if use_json:
+            response = GetMessageClass(method.output_type)()
+            response.ParseFromString(result.data)
+            self._send(200, json_format.MessageToJson(response).encode(), "application/json")
+        else:
+            self._send(200, result.data, "application/x-protobuf", result.attachment)
+
+    def _request_options(self, query: dict[str, list[str]]) -> Optional[tuple[int, Optional[bytes]]]:
+        """Parse timeout_ms and the attachment header; sends 400 and returns None if either is malformed."""
+        try:
+            timeout_ms = int(query.get("timeout_ms", ["5000"])[0])
+        except ValueError:
+            self._send(400, b"Malformed timeout_ms")
+            return None
+        try:
+            attachment = bytes.fromhex(self.headers.get(ATTACHMENT_HEADER, "")) or None
+        except ValueError:
+            self._send(400, f"Malformed {ATTACHMENT_HEADER} header".encode())
+            return None
+        return timeout_ms, attachment
+
+    def do_GET(self):
+        url = urllib.parse.urlparse(self.path)
+        if url.path == "/stats":
+            self._send(200, json.dumps(self.gateway.stats.__dict__).encode(), "application/json")
+        elif url.path.startswith("/sub/"):
+            self._stream(urllib.parse.unquote(url.path[len("/sub/") :]))
+        elif url.path.startswith("/query/"):
+            self._query(urllib.parse.unquote(url.path[len("/query/") :]), urllib.parse.parse_qs(url.query))
+        else:
+            self._send(404, b"Not found")
+
+    def _peer_closed(self) -> bool:
+        readable, _, _ = select.select([self.connection], [], [], 0)
+        if not readable:
+            return False
+        try:
+            return self.connection.recv(1, socket.MSG_PEEK) == b""
+        except OSError:
+            return True
+
+    def _query(self, key_expr: str, query: dict[str, list[str]]):
+        options = self._request_options(query)
+        if options is None:
+            return
+        timeout_ms, attachment = options
+        result = self.gateway.forward(key_expr, b"", timeout_ms, attachment)
+        if not result.success:
+            status = 504 if result.error == "No reply received" else 502
+            self._send(status, (result.error or "").encode())
+            return
+        self._send(200, result.data, "application/x-protobuf", result.attachment)
+
+    def _stream(self, key_expr: str):
+        self.send_response(200)
+        self.send_header("Content-Type", STREAM_CONTENT_TYPE)
+        self.send_header("Connection", "close")
+        self.end_headers()
+        self.close_connection = True
+
+        q = self.gateway.attach(key_expr)
+        try:
+            while True:
+                try:
+                    frame = q.get(timeout=1.0)
+                except queue.Empty:
+                    if self._peer_closed():
+                        break
+                    continue
+                self.wfile.write(frame)
+                self.wfile.flush()
+                self.gateway.sample_delivered()
+        except OSError:
+            pass
+        finally:
+            self.gateway.detach(key_expr, q)
+
+
+class ThreadingUnixHTTPServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Local RPC gateway sharing one zenoh session")
+    parser.add_argument(
+        "--router", default=DEFAULT_ROUTER, help=f"Zenoh router endpoint (default: {DEFAULT_ROUTER})"
+    )
+    parser.add_argument(
+        "--listen", default=DEFAULT_LISTEN, help=f"HTTP listen address host:port (default: {DEFAULT_LISTEN})"
+    )
+    parser.add_argument("--unix", help="Serve on this Unix socket path instead of TCP")
+    parser.add_argument(
+        "--cache-ms", type=int, default=200, help="Cache lifetime of side-effect free results (default: 200)"
+    )
+    parser.add_argument(
+        "--queue-size", type=int, default=256, help="Telemetry samples buffered per local subscriber (default: 256)"
+    )
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    conf = zenoh.Config()
+    conf.insert_json5("mode", '"client"')
+    conf.insert_json5("connect/endpoints", f'["{args.router}"]')
+    logger.info(f"Opening Zenoh session to {args.router}...")
+    session = zenoh.open(conf)
+
+    gateway = RpcGateway(session, cache_ms=args.cache_ms, queue_size=args.queue_size)
+    if gateway.cacheable_methods:
+        logger.info(f"Cacheable methods: {sorted(f'{s}/{m}' for s, m in gateway.cacheable_methods)}")
+
+    if args.unix:
+        if os.path.exists(args.unix):
+            os.unlink(args.unix)
+        server = ThreadingUnixHTTPServer(args.unix, GatewayRequestHandler)
+        logger.info(f"Gateway listening on unix://{args.unix}")
+    else:
+        host, port = args.listen.rsplit(":", 1)
+        server = ThreadingHTTPServer((host, int(port)), GatewayRequestHandler)
+        logger.info(f"Gateway listening on http://{args.listen}")
+    server.gateway = gateway
+
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        logger.info("Shutting down...")
+    finally:
+        server.server_close()
+        session.close()
+        if args.unix and os.path.exists(args.unix):
+            os.unlink(args.unix)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+"""
+RPC latency measurement - round-trip time of the Echo RPC.
+
+Used to compare firmware builds (e.g. multi-threaded vs. --single-thread zenoh-pico):
+run it against each build with the same transport and payload and compare the percentiles.
+
+Usage:
+    uv run python tools/rpc_latency.py -n 500
+    uv run python tools/rpc_latency.py -n 500 --size 200 --label single-thread --json results.jsonl
+"""
+
+import argparse
+import json
+import logging
+import statistics
+import time
+
+import zenoh
+from rpc.gateway_client import GatewayRpcClient
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_rpc_client import ZenohRpcClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Measure Echo RPC round-trip latency")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument(
+        "-g", "--gateway", type=str, help="Use a local RPC gateway (http://host:port or unix:///path) instead of zenoh"
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("-n", "--count", type=int, default=200, help="Number of measured calls (default: 200)")
+    parser.add_argument("--warmup", type=int, default=10, help="Unmeasured calls before measuring (default: 10)")
+    parser.add_argument("--size", type=int, default=16, help="Echo message length in bytes (default: 16)")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. build variant)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def percentile(sorted_values: list[float], q: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(q * len(sorted_values)))]
+
+
+def measure(service: DeviceServiceClient, count: int, warmup: int, size: int) -> dict:
+    msg = "x" * size
+    for _ in range(warmup):
+        service.echo(msg=msg)
+
+    rtts_ms = []
+    failures = 0
+    start = time.perf_counter()
+    for _ in range(count):
+        t0 = time.perf_counter()
+        response, _ = service.echo(msg=msg)
+        t1 = time.perf_counter()
+        if response.success:
+            rtts_ms.append((t1 - t0) * 1000.0)
+        else:
+            failures += 1
+    elapsed = time.perf_counter() - start
+
+    rtts_ms.sort()
+    result = {"count": count, "failures": failures, "size": size, "calls_per_s": round(count / elapsed, 1)}
+    if rtts_ms:
+        result.update(
+            {
+                "mean_ms": round(statistics.fmean(rtts_ms), 3),
+                "p50_ms": round(percentile(rtts_ms, 0.50), 3),
+                "p90_ms": round(percentile(rtts_ms, 0.90), 3),
+                "p99_ms": round(percentile(rtts_ms, 0.99), 3),
+                "max_ms": round(rtts_ms[-1], 3),
+            }
+        )
+    return result
+
+
+def main():
+    args = parse_args()
+
+    session = None
+    if args.gateway:
+        rpc_client = GatewayRpcClient(args.gateway, args.device_id)
+    else:
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        session = zenoh.open(config)
+        rpc_client = ZenohRpcClient(session, args.device_id)
+
+    try:
+        result = measure(DeviceServiceClient(rpc_client), args.count, args.warmup, args.size)
+    finally:
+        if session is not None:
+            session.close()
+
+    result["label"] = args.label
+    logger.info(f"Echo latency: {result}")
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,123 @@
+"""
+Set rules - installs the device's local reactions to its sensor samples (SetRules).
+
+Each rule is one argument:
+
+    <field> <condition> <threshold>[~<hysteresis>] <action> [<value> [<exit value>]]
+
+    field       SensorTelemetry field name (temperature, humidity)
+    condition   >  <  rising  falling   (rising/falling: change per second)
+    action      led (SetLed, value 1 = on) | log (warning on <device>/log) | none
+    exit value  also run the action with this value when the condition clears
+
+The rules replace the installed ones and are kept across reboots; no argument removes all rules. The device evaluates
+them on every sensor sample (also with streaming off) and acts without a host round trip.
+
+Usage:
+    uv run python tools/set_rules.py "humidity > 70~5 led 1 0"
+    uv run python tools/set_rules.py "temperature rising 0.5 log" "humidity < 30 led 1 0"
+    uv run python tools/set_rules.py            # remove all rules
+"""
+
+import argparse
+import logging
+import sys
+
+import zenoh
+import rpc.service_pb2 as pb
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_rpc_client import ZenohRpcClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+
+CONDITIONS = {
+    ">": pb.RULE_ABOVE,
+    "<": pb.RULE_BELOW,
+    "rising": pb.RULE_RISING,
+    "falling": pb.RULE_FALLING,
+}
+ACTIONS = {
+    "none": pb.RULE_ACTION_NONE,
+    "led": pb.RULE_ACTION_SET_LED,
+    "log": pb.RULE_ACTION_LOG,
+}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Install local rules on the device")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("rules", nargs="*", help='Rules, e.g. "humidity > 70~5 led 1 0"')
+    return parser.parse_args()
+
+
+def parse_rule(spec: str) -> pb.Rule:
+    """
+    Rule from its text form (see the module docstring).
+
+    Raises:
+        ValueError: malformed rule, unknown field, condition or action
+    """
+    words = spec.split()
+    if len(words) < 4 or len(words) > 6:
+        raise ValueError(f"expected '<field> <condition> <threshold>[~<hysteresis>] <action> [...]': {spec!r}")
+    field_name, condition, threshold, action = words[:4]
+    field = pb.SensorTelemetry.DESCRIPTOR.fields_by_name.get(field_name)
+    if field is None:
+        raise ValueError(f"unknown field {field_name!r}")
+    if condition not in CONDITIONS:
+        raise ValueError(f"unknown condition {condition!r} (one of {', '.join(CONDITIONS)})")
+    if action not in ACTIONS:
+        raise ValueError(f"unknown action {action!r} (one of {', '.join(ACTIONS)})")
+    threshold, _, hysteresis = threshold.partition("~")
+    rule = pb.Rule(
+        field=field.number,
+        condition=CONDITIONS[condition],
+        threshold=float(threshold),
+        hysteresis=float(hysteresis or 0),
+        action=ACTIONS[action],
+    )
+    if len(words) > 4:
+        rule.value = int(words[4])
+    if len(words) > 5:
+        rule.on_exit = True
+        rule.exit_value = int(words[5])
+    return rule
+
+
+def main():
+    args = parse_args()
+    try:
+        rules = [parse_rule(spec) for spec in args.rules]
+    except ValueError as e:
+        logger.error(f"Invalid rule: {e}")
+        sys.exit(1)
+
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    try:
+        response, payload = DeviceServiceClient(ZenohRpcClient(session, args.device_id)).set_rules(rules=rules)
+    finally:
+        session.close()
+    if not response.success:
+        # A rule the device cannot compile rejects the whole set with "invalid argument" (the installed rules stay);
+        # the device logs the index of the rejected rule on <device>/log
+        logger.error(f"SetRules failed: {response.error}")
+        sys.exit(1)
+    logger.info(f"{payload.installed} rules installed")
+
+
+if __name__ == "__main__":
+    main()
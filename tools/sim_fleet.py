@@ -0,0 +1,113 @@
+"""
+Simulated fleet - publishes SensorTelemetry for many device IDs, to load the fleet view and other fleet tools.
+
+Each simulated device publishes on <prefix>-<n>/telemetry/sensor at --rate samples per second, with its publications
+spread evenly over the period so the load is steady rather than one burst per second. With --rpc the fleet also
+answers DeviceService/Echo on every simulated device (one queryable on <prefix>-*), as the counterpart of the host
+throughput benchmarks (tools/pool_scaling.py); --rate 0 serves the calls only.
+
+Usage:
+    uv run python tools/sim_fleet.py -n 2000
+    uv run python tools/sim_fleet.py -n 5000 --rate 2 --prefix sim
+    uv run python tools/sim_fleet.py -n 1000 --rate 0 --rpc
+"""
+
+import argparse
+import logging
+import math
+import random
+import time
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.service_client import TELEMETRY_TOPICS
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+SENSOR_TOPIC = next(topic for topic, cls in TELEMETRY_TOPICS.items() if cls is pb.SensorTelemetry)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Publish telemetry of simulated devices")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-n", "--devices", type=int, default=1000, help="Simulated devices (default: 1000)")
+    parser.add_argument("--rate", type=float, default=1.0, help="Samples per second per device, 0: none (default: 1)")
+    parser.add_argument("--prefix", type=str, default="sim", help="Device ID prefix (default: sim)")
+    parser.add_argument("--duration", type=float, default=0, help="Seconds to run (default: until interrupted)")
+    parser.add_argument("--rpc", action="store_true", help="Answer DeviceService/Echo on every simulated device")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+
+    width = len(str(args.devices - 1))
+    publishers = [
+        session.declare_publisher(f"{args.prefix}-{i:0{width}d}{SENSOR_TOPIC}") for i in range(args.devices)
+    ]
+    # Per device: base temperature/humidity and a phase, so the rows differ and change
+    bases = [(random.uniform(18, 28), random.uniform(30, 70), random.uniform(0, 2 * math.pi)) for _ in publishers]
+    interval = 1.0 / (args.rate * args.devices) if args.rate > 0 else 0
+    logger.info(f"{args.devices} devices on {args.prefix}-*{SENSOR_TOPIC}, {args.rate * args.devices:.0f} samples/s")
+
+    echo = None
+    answered = 0
+    if args.rpc:
+        # EchoRequest and EchoResponse have the same fields: the request bytes are the response
+        def on_echo(query: zenoh.Query):
+            nonlocal answered
+            query.reply(query.key_expr, query.payload.to_bytes() if query.payload else b"")
+            answered += 1
+
+        echo = session.declare_queryable(f"{args.prefix}-*/rpc/DeviceService/Echo", on_echo)
+        logger.info(f"Answering {args.prefix}-*/rpc/DeviceService/Echo")
+
+    start = time.monotonic()
+    sent = 0
+    reported = start
+    try:
+        while not args.duration or time.monotonic() - start < args.duration:
+            if not interval:
+                time.sleep(1.0)
+                continue
+            i = sent % args.devices
+            t = time.monotonic() - start
+            temperature, humidity, phase = bases[i]
+            sample = pb.SensorTelemetry(
+                temperature=temperature + 2.0 * math.sin(t / 30.0 + phase),
+                humidity=humidity + 5.0 * math.sin(t / 45.0 + phase),
+            )
+            publishers[i].put(sample.SerializeToString())
+            sent += 1
+            # Behind schedule: publish the next one right away
+            delay = start + sent * interval - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            if time.monotonic() - reported >= 10.0:
+                reported = time.monotonic()
+                logger.info(f"{sent} samples, {sent / (reported - start):.0f} samples/s")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if echo is not None:
+            echo.undeclare()
+        for publisher in publishers:
+            publisher.undeclare()
+        session.close()
+    logger.info(f"{sent} samples published, {answered} calls answered")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,153 @@
+"""
+Stack report - stack frames of the RPC handler path from a firmware build.
+
+Reads the per-function stack usage files (*.su, CONFIG_STACK_USAGE=y in prj.conf) of a build directory and lists
+the frames of the functions that run inside the zenoh read task / RPC worker for every call: the channel dispatch,
+the generated DeviceServiceServer::handle_* functions and the DeviceServiceImpl methods. The generated handlers keep
+their request/response in static slots (rpc/message_pool.h), so their frames must not grow with max_size in
+service.options; the check fails (exit code 1) if one is above --max-handler-frame or has a dynamic frame.
+
+With --elf, the static handler message pool is listed with its size (RAM that replaced the stack usage).
+
+Usage:
+    uv run python tools/stack_report.py -b build
+    uv run python tools/stack_report.py -b build --elf build/zephyr/zephyr.elf --label single-thread --json stack.jsonl
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+DEFAULT_NM = os.path.join(
+    os.environ.get("ZEPHYR_SDK_INSTALL_DIR", "/opt/zephyr-sdk-0.17.0"), "arm-zephyr-eabi/bin/arm-zephyr-eabi-nm"
+)
+
+# Functions on the handler path, by group
+GROUPS = {
+    "dispatch": re.compile(r"ZenohRpcChannel::(query_callback|handle_query|call_local)|RpcScheduler::run"),
+    "handler": re.compile(r"Server::handle_\w+"),
+    "implementation": re.compile(r"ServiceImpl::[A-Z]\w*\("),
+    "nanopb": re.compile(r"^(pb_decode|pb_encode|pb_decode_inner|encode_field|decode_field)\b"),
+}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Report stack frames of the RPC handler path")
+    parser.add_argument("-b", "--build-dir", type=str, default="build", help="Build directory (default: build)")
+    parser.add_argument("--elf", type=str, help="zephyr.elf, to list the static handler message pool")
+    parser.add_argument("--nm", type=str, default=DEFAULT_NM, help=f"nm of the toolchain (default: {DEFAULT_NM})")
+    parser.add_argument(
+        "--max-handler-frame", type=int, default=256, help="Largest allowed handle_* frame [bytes] (default: 256)"
+    )
+    parser.add_argument("--top", type=int, default=10, help="Also list the N largest frames of the build (default: 10)")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. build variant)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def read_stack_usage(build_dir: Path) -> list[tuple[str, int, str]]:
+    """(function, frame bytes, qualifier) of every *.su line below build_dir"""
+    frames = []
+    for su in build_dir.rglob("*.su"):
+        with open(su) as f:
+            for line in f:
+                parts = line.rstrip("\n").split("\t")
+                if len(parts) != 3:
+                    continue
+                # "<file>:<line>:<col>:<function>"; the function may contain "::"
+                location = parts[0].split(":", 3)
+                function = location[3] if len(location) == 4 else parts[0]
+                frames.append((function, int(parts[1]), parts[2]))
+    return frames
+
+
+def read_config(build_dir: Path) -> dict[str, str]:
+    config = {}
+    path = build_dir / "zephyr" / ".config"
+    if path.exists():
+        with open(path) as f:
+            for line in f:
+                if line.startswith("CONFIG_") and "=" in line:
+                    key, value = line.strip().split("=", 1)
+                    config[key] = value.strip('"')
+    return config
+
+
+def pool_symbols(nm: str, elf: str) -> list[tuple[str, int]]:
+    """(symbol, size) of the handler message pools"""
+    out = subprocess.run([nm, "-C", "-S", elf], capture_output=True, text=True, check=True).stdout
+    pools = []
+    for line in out.splitlines():
+        parts = line.split(maxsplit=3)
+        # Generated as "<service>_messages" (anonymous namespace in service_server.cpp)
+        if len(parts) == 4 and parts[2] in "bBdD" and parts[3].endswith("_messages"):
+            pools.append((parts[3], int(parts[1], 16)))
+    return pools
+
+
+def short_name(function: str) -> str:
+    """Drop return type and parameters: "practice::rpc::X::handle_Echo" """
+    name = function.split("(", 1)[0]
+    return name.rsplit(" ", 1)[-1]
+
+
+def main():
+    args = parse_args()
+    build_dir = Path(args.build_dir)
+    frames = read_stack_usage(build_dir)
+    if not frames:
+        print(f"No *.su files below {build_dir}; build with CONFIG_STACK_USAGE=y", file=sys.stderr)
+        sys.exit(2)
+
+    config = read_config(build_dir)
+    print(
+        f"Main stack: {config.get('CONFIG_MAIN_STACK_SIZE', '?')} bytes, "
+        f"handler slots: {config.get('CONFIG_APP_RPC_HANDLER_SLOTS', '?')}"
+    )
+
+    result = {"label": args.label, "groups": {}, "violations": []}
+    for group, pattern in GROUPS.items():
+        matched = sorted(
+            {(short_name(f), size, qual) for f, size, qual in frames if pattern.search(f)}, key=lambda x: -x[1]
+        )
+        result["groups"][group] = {name: size for name, size, _ in matched}
+        print(f"\n{group}:")
+        for name, size, qual in matched:
+            print(f"  {size:6d}  {qual:8s}  {name}")
+            if group == "handler" and (size > args.max_handler_frame or qual != "static"):
+                result["violations"].append(name)
+
+    # Rough depth of one call: dispatch frames + deepest handler + deepest implementation + deepest nanopb frame
+    # (nanopb recursion per submessage level comes on top)
+    estimate = sum(result["groups"]["dispatch"].values()) + sum(
+        max(result["groups"][g].values(), default=0) for g in ("handler", "implementation", "nanopb")
+    )
+    result["path_estimate"] = estimate
+    print(f"\nHandler path estimate: {estimate} bytes (without nanopb recursion)")
+
+    if args.elf:
+        pools = pool_symbols(args.nm, args.elf)
+        result["pools"] = dict(pools)
+        for name, size in pools:
+            print(f"Static message pool: {size} bytes  {name}")
+
+    if args.top > 0:
+        print(f"\nLargest {args.top} frames:")
+        for function, size, qual in sorted(frames, key=lambda x: -x[1])[: args.top]:
+            print(f"  {size:6d}  {qual:8s}  {short_name(function)}")
+
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+    if result["violations"]:
+        print(f"\nHandler frames above {args.max_handler_frame} bytes or dynamic: {', '.join(result['violations'])}")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -4,17 +4,30 @@ Zenoh Router startup script.
 Starts zenohd router that listens on TCP port 7447.
 Devices (USB-ECM or Wi-Fi) connect to this router.
 
+Telemetry limits: the max_rate / max_payload options of the telemetry messages in service.proto give per consumer
+class (e.g. wan, lan) the samples per second and the largest payload forwarded to that class (rpc/router_limits.py).
+--consumer maps a class to the network interfaces its subscribers are reached on; zenohd then downsamples and
+filters what leaves the router on those interfaces. Without --consumer every subscriber receives the full rate.
+
+zenohd keeps one rate per rule: a wildcard rule (*/telemetry/sensor) shares it among all devices. With --device the
+rules are written per device instead.
+
 Usage:
     python start_router.py
+    python start_router.py --consumer wan=eth1 --consumer lan=wlan0 --device pico2w-001 --device pico2w-002
 """
 
 import argparse
+import json
 import logging
 import shutil
 import subprocess
 import sys
+import tempfile
 from pathlib import Path
 
+from rpc import router_limits
+
 try:
     import serial.tools.list_ports
 except ImportError:
@@ -65,9 +78,83 @@ def parse_args():
         default="tcp/192.168.10.2:7447",
         help="Device endpoint to connect to (default: tcp/192.168.10.2:7447)",
     )
+    parser.add_argument(
+        "--consumer",
+        action="append",
+        default=[],
+        metavar="CLASS=IFACE[,IFACE]",
+        help="Apply the telemetry limits of a consumer class on these interfaces ('all': every interface)",
+    )
+    parser.add_argument(
+        "--device",
+        action="append",
+        default=[],
+        help="Device ID: limit the rate per device instead of per topic (repeat for each device)",
+    )
     return parser.parse_args()
 
 
+def parse_consumers(specs):
+    """['wan=eth1,tun0', 'lan=all'] -> {'wan': ['eth1', 'tun0'], 'lan': None}"""
+    consumers = {}
+    for spec in specs:
+        consumer, _, interfaces = spec.partition("=")
+        if not consumer or not interfaces:
+            raise ValueError(f"expected CLASS=IFACE[,IFACE]: {spec!r}")
+        consumers[consumer] = None if interfaces == "all" else interfaces.split(",")
+    return consumers
+
+
+def expand_key_expr(key_expr, device_ids):
+    """Rules for */<topic>: one per device if device IDs are given."""
+    if not device_ids or not key_expr.startswith("*/"):
+        return [key_expr]
+    return [device_id + key_expr[1:] for device_id in device_ids]
+
+
+def build_limits_config(consumers, device_ids):
+    """zenohd downsampling and low_pass_filter configuration of the consumer classes (egress only)."""
+    downsampling = []
+    low_pass = []
+    for consumer, interfaces in consumers.items():
+        # Absent: all interfaces
+        selector = {} if interfaces is None else {"interfaces": interfaces}
+        rates = router_limits.DOWNSAMPLING.get(consumer, [])
+        sizes = router_limits.LOW_PASS.get(consumer, [])
+        if not rates and not sizes:
+            logger.warning(f"No telemetry limits for consumer class '{consumer}' in service.proto")
+            continue
+        if rates:
+            rules = [
+                {"key_expr": key, "freq": hz}
+                for key_expr, hz in rates
+                for key in expand_key_expr(key_expr, device_ids)
+            ]
+            downsampling.append(
+                {"id": f"{consumer}-rate", **selector, "flows": ["egress"], "messages": ["push"], "rules": rules}
+            )
+        # One filter per size limit
+        by_size = {}
+        for key_expr, size in sizes:
+            by_size.setdefault(size, []).append(key_expr)
+        for size, key_exprs in sorted(by_size.items()):
+            low_pass.append(
+                {
+                    "id": f"{consumer}-size-{size}",
+                    **selector,
+                    "flows": ["egress"],
+                    "messages": ["put"],
+                    "key_exprs": key_exprs,
+                    "size_limit": size,
+                }
+            )
+        for key_expr, hz in rates:
+            logger.info(f"  - {consumer} ({', '.join(interfaces or ['all'])}): {key_expr} at most {hz:g}/s")
+        for key_expr, size in sizes:
+            logger.info(f"  - {consumer} ({', '.join(interfaces or ['all'])}): {key_expr} at most {size} bytes")
+    return {"downsampling": downsampling, "low_pass_filter": low_pass}
+
+
 def check_dependencies():
     """Check if required dependencies are available."""
     zenohd = find_zenohd()
@@ -82,11 +169,15 @@ def check_dependencies():
     return zenohd
 
 
-def build_zenohd_args(connect_device=None, serial_port=None):
+def build_zenohd_args(connect_device=None, serial_port=None, config_file=None):
     """Build zenohd command-line arguments."""
     # Listen on TCP for all devices (Python client, USB-ECM, Wi-Fi)
     args = ["-l", "tcp/0.0.0.0:7447"]
 
+    # Telemetry limits (JSON is valid JSON5)
+    if config_file:
+        args.extend(["-c", config_file])
+
     # Add serial listener if device is connected
     if serial_port:
         args.extend(["-l", f"serial/{serial_port}#baudrate=115200"])
@@ -101,6 +192,11 @@ def build_zenohd_args(connect_device=None, serial_port=None):
 def main():
     """Main entry point."""
     args = parse_args()
+    try:
+        consumers = parse_consumers(args.consumer)
+    except ValueError as e:
+        logger.error(f"Invalid --consumer: {e}")
+        sys.exit(1)
     zenohd_path = check_dependencies()
 
     # Check for USB device
@@ -120,10 +216,17 @@ def main():
         logger.info("  - Pico devices: tcp/<router_ip>:7447 or multicast scouting")
     logger.info("")
     logger.info("Multicast scouting enabled for device auto-discovery")
+    config_file = None
+    if consumers:
+        logger.info("Telemetry limits:")
+        config = build_limits_config(consumers, args.device)
+        with tempfile.NamedTemporaryFile("w", suffix=".json5", prefix="zenohd-", delete=False) as f:
+            json.dump(config, f, indent=2)
+            config_file = f.name
     logger.info("=" * 60)
     logger.info("")
 
-    zenohd_args = build_zenohd_args(args.connect_device, serial_port)
+    zenohd_args = build_zenohd_args(args.connect_device, serial_port, config_file)
     logger.info(f"Running: {zenohd_path} {' '.join(zenohd_args)}")
     logger.info("")
 
@@ -135,6 +238,10 @@ def main():
     except Exception as e:
         logger.error(f"Failed to run zenohd: {e}")
         sys.exit(1)
+    finally:
+        # zenohd read the generated config at startup
+        if config_file:
+            Path(config_file).unlink(missing_ok=True)
 
 
 if __name__ == "__main__":
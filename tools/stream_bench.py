@@ -0,0 +1,173 @@
+"""
+Stream benchmark - Echo over a query per message versus the EchoStream bidirectional stream.
+
+Measured for both, with the same payload:
+
+    ping-pong     one message in flight: round-trip time percentiles
+    pipelined     messages sent as fast as credits allow (stream) or back to back (unary): messages per second
+
+The stream pays its setup once (one query) and then sends plain samples each way, so the difference is the per-query
+cost: query routing, reply matching and timeout bookkeeping on both ends.
+
+Usage:
+    uv run python tools/stream_bench.py -n 500
+    uv run python tools/stream_bench.py -n 500 --size 64 --label wifi --json stream_bench.jsonl
+"""
+
+import argparse
+import json
+import logging
+import statistics
+import threading
+import time
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_rpc_client import ZenohRpcClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Compare unary Echo with the EchoStream stream")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("-n", "--count", type=int, default=200, help="Messages per measurement (default: 200)")
+    parser.add_argument("--warmup", type=int, default=10, help="Unmeasured messages before measuring (default: 10)")
+    parser.add_argument("--size", type=int, default=16, help="Echo message length in bytes (default: 16)")
+    parser.add_argument("--window", type=int, default=8, help="Host receive window of the stream (default: 8)")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. link type)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def percentile(sorted_values: list[float], q: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(q * len(sorted_values)))]
+
+
+def summarize(rtts_ms: list[float], count: int, elapsed_s: float) -> dict:
+    rtts_ms = sorted(rtts_ms)
+    result = {"failures": count - len(rtts_ms), "msgs_per_s": round(count / elapsed_s, 1) if elapsed_s else None}
+    if rtts_ms:
+        result.update(
+            {
+                "mean_ms": round(statistics.fmean(rtts_ms), 3),
+                "p50_ms": round(percentile(rtts_ms, 0.50), 3),
+                "p99_ms": round(percentile(rtts_ms, 0.99), 3),
+            }
+        )
+    return result
+
+
+def unary_ping_pong(service: DeviceServiceClient, count: int, warmup: int, msg: str) -> dict:
+    request = pb.EchoRequest(msg=msg)
+    response = pb.EchoResponse()
+    for _ in range(warmup):
+        service.echo_into(request, response)
+    rtts_ms = []
+    start = time.perf_counter()
+    for _ in range(count):
+        t0 = time.perf_counter()
+        if service.echo_into(request, response).success:
+            rtts_ms.append((time.perf_counter() - t0) * 1000.0)
+    return summarize(rtts_ms, count, time.perf_counter() - start)
+
+
+def unary_pipelined(service: DeviceServiceClient, count: int, msg: str, threads: int = 4) -> dict:
+    """Calls from several threads: the closest unary equivalent of several messages in flight."""
+    request = pb.EchoRequest(msg=msg)
+    ok = [0] * threads
+
+    def worker(i: int):
+        response = pb.EchoResponse()
+        for _ in range(count // threads):
+            if service.echo_into(request, response).success:
+                ok[i] += 1
+
+    workers = [threading.Thread(target=worker, args=(i,)) for i in range(threads)]
+    start = time.perf_counter()
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    elapsed = time.perf_counter() - start
+    sent = count // threads * threads
+    return {"failures": sent - sum(ok), "msgs_per_s": round(sum(ok) / elapsed, 1)}
+
+
+def stream_ping_pong(service: DeviceServiceClient, count: int, warmup: int, msg: str, window: int) -> dict:
+    request = pb.EchoRequest(msg=msg)
+    with service.open_echo_stream(window=window) as stream:
+        for _ in range(warmup):
+            if stream.send(request):
+                stream.recv(timeout=1.0)
+        rtts_ms = []
+        start = time.perf_counter()
+        for _ in range(count):
+            t0 = time.perf_counter()
+            if stream.send(request) and stream.recv(timeout=1.0) is not None:
+                rtts_ms.append((time.perf_counter() - t0) * 1000.0)
+        result = summarize(rtts_ms, count, time.perf_counter() - start)
+        result.update({"lost": stream.stats.lost, "stalls": stream.stats.stalls})
+    return result
+
+
+def stream_pipelined(service: DeviceServiceClient, count: int, msg: str, window: int) -> dict:
+    request = pb.EchoRequest(msg=msg)
+    received = threading.Semaphore(0)
+    with service.open_echo_stream(on_message=lambda _: received.release(), window=window) as stream:
+        start = time.perf_counter()
+        sent = sum(1 for _ in range(count) if stream.send(request, timeout=1.0))
+        replies = sum(1 for _ in range(sent) if received.acquire(timeout=1.0))
+        elapsed = time.perf_counter() - start
+        return {
+            "failures": count - replies,
+            "msgs_per_s": round(replies / elapsed, 1),
+            "lost": stream.stats.lost,
+            "stalls": stream.stats.stalls,
+        }
+
+
+def main():
+    args = parse_args()
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    service = DeviceServiceClient(ZenohRpcClient(session, args.device_id))
+    msg = "x" * args.size
+
+    try:
+        result = {
+            "label": args.label,
+            "count": args.count,
+            "size": args.size,
+            "window": args.window,
+            "unary_ping_pong": unary_ping_pong(service, args.count, args.warmup, msg),
+            "stream_ping_pong": stream_ping_pong(service, args.count, args.warmup, msg, args.window),
+            "unary_pipelined": unary_pipelined(service, args.count, msg),
+            "stream_pipelined": stream_pipelined(service, args.count, msg, args.window),
+        }
+    finally:
+        session.close()
+
+    for name in ("unary_ping_pong", "stream_ping_pong", "unary_pipelined", "stream_pipelined"):
+        logger.info(f"{name}: {result[name]}")
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,152 @@
+// Telemetry batch benchmark - compression ratio and encoder cost of the
+// Gorilla codec (apps/zenoh_rpc/rpc/gorilla_codec.h) on the host
+//
+// The input is a synthetic DHT22-like series: 1 s period with timer jitter,
+// temperature and humidity in 0.1 steps that change now and then.
+// The device reports the same statistics for real data (see README).
+//
+// Build and run:
+//   g++ -O2 -std=c++17 -I apps/zenoh_rpc/rpc -o /tmp/telemetry_batch_bench
+//       tools/telemetry_batch_bench.cpp
+//   /tmp/telemetry_batch_bench [samples] [batch_size] [jitter_ms]
+//   /tmp/telemetry_batch_bench 600 60 2 --dump   # hex of the first batch
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER 1
+static inline uint64_t cycles() { return __rdtsc(); }
+#else
+#define HAVE_CYCLE_COUNTER 0
+static inline uint64_t cycles() { return 0; }
+#endif
+
+#include "gorilla_codec.h"
+
+namespace {
+
+constexpr size_t kColumns = 2;
+// TelemetryBatch.data max_size (service.options)
+constexpr size_t kBatchDataSize = 192;
+// Per-sample SensorTelemetry: two float fields (tag + 4 bytes each)
+constexpr size_t kSensorTelemetrySize = 2 * (1 + 4);
+// Attachment per publication: sequence (2 + 4) + source timestamp (2 + 8)
+constexpr size_t kAttachmentSize = (2 + 4) + (2 + 8);
+
+struct Sample {
+  uint32_t timestamp_ms;
+  uint32_t values[kColumns];
+};
+
+uint32_t float_bits(float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+size_t varint_size(uint32_t v) {
+  size_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    n++;
+  }
+  return n;
+}
+
+// Encoded TelemetryBatch size for the given data length
+size_t batch_message_size(size_t count, size_t data_len) {
+  return (1 + varint_size(count)) + (1 + 1 + kColumns) +
+         (1 + varint_size(data_len) + data_len);
+}
+
+std::vector<Sample> make_series(size_t n, int jitter_ms) {
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> jitter(-jitter_ms, jitter_ms);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<Sample> series(n);
+  uint32_t t = 12345;
+  int temp = 215;  // 0.1 deg C
+  int hum = 480;   // 0.1 %
+  for (auto& s : series) {
+    t += 1000 + jitter(rng);
+    if (u(rng) < 0.15) temp += u(rng) < 0.5 ? -1 : 1;
+    if (u(rng) < 0.30) hum += u(rng) < 0.5 ? -1 : 1;
+    s.timestamp_ms = t;
+    s.values[0] = float_bits(temp / 10.0f);
+    s.values[1] = float_bits(hum / 10.0f);
+  }
+  return series;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t samples = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+  size_t batch_size = argc > 2 ? strtoul(argv[2], nullptr, 0) : 60;
+  int jitter_ms = argc > 3 ? atoi(argv[3]) : 2;
+  bool dump = argc > 4 && strcmp(argv[4], "--dump") == 0;
+
+  std::vector<Sample> series = make_series(samples, jitter_ms);
+  uint8_t buf[kBatchDataSize];
+  zenoh_rpc::GorillaEncoder encoder(buf, sizeof(buf), kColumns);
+
+  size_t batches = 0;
+  size_t data_bytes = 0;
+  size_t message_bytes = 0;
+  uint64_t total_cycles = 0;
+  auto flush = [&]() {
+    if (dump && batches == 0) {
+      printf("count=%zu data=", encoder.count());
+      for (size_t i = 0; i < encoder.size(); ++i) printf("%02x", buf[i]);
+      printf("\n");
+    }
+    batches++;
+    data_bytes += encoder.size();
+    message_bytes += batch_message_size(encoder.count(), encoder.size());
+    encoder.reset();
+  };
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (const Sample& s : series) {
+    uint64_t c0 = cycles();
+    bool ok = encoder.append(s.timestamp_ms, s.values);
+    total_cycles += cycles() - c0;
+    if (!ok) {
+      flush();
+      encoder.append(s.timestamp_ms, s.values);
+    }
+    if (encoder.count() >= batch_size) {
+      flush();
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  if (encoder.count() > 0) {
+    flush();
+  }
+
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  size_t raw_bytes = samples * (4 + 4 * kColumns);
+  size_t per_sample_bytes = samples * (kSensorTelemetrySize + kAttachmentSize);
+  size_t batched_bytes = message_bytes + batches * kAttachmentSize;
+
+  printf("samples=%zu batch_size=%zu jitter=%dms batches=%zu\n", samples,
+         batch_size, jitter_ms, batches);
+  printf("bit stream:       %.2f bytes/sample (raw columns %.1fx smaller)\n",
+         double(data_bytes) / samples, double(raw_bytes) / data_bytes);
+  printf("on the wire:      %.2f bytes/sample batched vs %zu per sample "
+         "(%.1fx, payload + attachment)\n",
+         double(batched_bytes) / samples, kSensorTelemetrySize + kAttachmentSize,
+         double(per_sample_bytes) / batched_bytes);
+  printf("encoder:          %.1f ns/sample", ns / samples);
+  if (HAVE_CYCLE_COUNTER) {
+    printf(", %.1f TSC cycles/sample", double(total_cycles) / samples);
+  }
+  printf("\n");
+  return 0;
+}
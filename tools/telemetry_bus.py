@@ -0,0 +1,167 @@
+"""
+Telemetry bus - subscribes to the telemetry of all devices once and shares it with local processes in shared memory.
+
+The GUI, the recorder and control/alarm processes on the same host would otherwise each subscribe and decode the
+same samples. This daemon subscribes to <device>/telemetry/** once, decodes every sample (and every compressed
+batch) once and appends it to a shared-memory ring (rpc/telemetry_bus.py) that any number of local readers map:
+Python with rpc.telemetry_bus.TelemetryBusReader, C++ with tools/telemetry_bus_reader.h.
+
+Usage:
+    # Writer (one per host)
+    uv run python tools/telemetry_bus.py -c tcp/127.0.0.1:7447
+    uv run python tools/telemetry_bus.py -g unix:///tmp/zenoh_rpc_gateway.sock --slots 262144
+
+    # Print the records of a running bus
+    uv run python tools/telemetry_bus.py --tail
+"""
+
+import argparse
+import logging
+import math
+import threading
+import time
+from typing import Optional
+
+import zenoh
+from rpc.gateway_client import GatewaySubscriberClient
+from rpc.service_client import TELEMETRY_TOPICS
+from rpc.telemetry_batch import BATCH_SUFFIX, decode_batch_payload
+from rpc.telemetry_bus import DEFAULT_PATH, TelemetryBusReader, TelemetryBusWriter, numeric_columns
+from rpc.zenoh_attachment import Attachment
+from rpc.zenoh_rpc_client import ZenohSubscriberClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+def parse_args():
+    parser = argparse.ArgumentParser(description="Share decoded device telemetry with local processes")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument(
+        "-g", "--gateway", type=str, help="Use a local RPC gateway (http://host:port or unix:///path) instead of zenoh"
+    )
+    parser.add_argument("-d", "--device-id", type=str, default="*", help="Device ID, or * for all devices (default: *)")
+    parser.add_argument("--path", type=str, default=DEFAULT_PATH, help=f"Shared memory file (default: {DEFAULT_PATH})")
+    parser.add_argument("--slots", type=int, default=65536, help="Ring size in records, power of two (default: 65536)")
+    parser.add_argument("--values", type=int, default=8, help="Value columns per record (default: 8)")
+    parser.add_argument("--stats-interval", type=float, default=10.0, help="Stats log interval in seconds")
+    parser.add_argument("--tail", action="store_true", help="Print the records of a running bus instead")
+    return parser.parse_args()
+
+
+class TelemetryFanIn:
+    """Decodes samples once and appends them to the bus."""
+
+    def __init__(self, writer: TelemetryBusWriter):
+        self.writer = writer
+        self.samples = 0
+        self.records = 0
+        self.undecoded = 0
+        # Subscription callbacks may run concurrently; the ring has a single writer
+        self._lock = threading.Lock()
+
+    def on_sample(self, key_expr: str, payload: bytes, attachment: Optional[bytes]):
+        receive_ns = time.time_ns()
+        is_batch = key_expr.endswith(BATCH_SUFFIX)
+        topic = key_expr[: -len(BATCH_SUFFIX)] if is_batch else key_expr
+        msg_cls = next((cls for suffix, cls in TELEMETRY_TOPICS.items() if topic.endswith(suffix)), None)
+        if msg_cls is None:
+            self.undecoded += 1
+            return
+        columns = numeric_columns(msg_cls)
+        att = Attachment.decode(attachment)
+        sequence = att.sequence or 0
+        try:
+            if is_batch:
+                batch = decode_batch_payload(payload, msg_cls)
+                values = [batch.columns.get(c) for c in columns]
+                rows = [
+                    (ts_ms * 1000, [float(v[i]) if v is not None else math.nan for v in values])
+                    for i, ts_ms in enumerate(batch.timestamps_ms)
+                ]
+            else:
+                msg = msg_cls()
+                msg.ParseFromString(payload)
+                rows = [(att.source_timestamp_us or 0, [float(getattr(msg, c)) for c in columns])]
+        except Exception as e:
+            logger.error(f"Failed to decode {msg_cls.__name__} from {key_expr}: {e}")
+            self.undecoded += 1
+            return
+
+        with self._lock:
+            # Batches and single samples of a topic share the stream (same columns)
+            stream = self.writer.stream(topic, columns)
+            for device_us, values in rows:
+                self.writer.write(stream, values, device_us, sequence, receive_ns)
+            self.samples += 1
+            self.records += len(rows)
+
+
+def tail(path: str):
+    reader = TelemetryBusReader(path)
+    logger.info(f"Following {path}")
+    try:
+        while True:
+            records = reader.poll()
+            for record in records:
+                stream = reader.stream(record.stream)
+                values = dict(zip(stream.columns, record.values)) if stream else record.values
+                key = stream.key_expr if stream else record.stream
+                print(
+                    f"{record.receive_ns / 1e9:.6f} {key} seq={record.sequence} device_us={record.device_us} {values}"
+                )
+            if not records:
+                time.sleep(0.05)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        logger.info(f"Lost (overwritten before read): {reader.lost}")
+        reader.close()
+
+
+def main():
+    args = parse_args()
+    if args.tail:
+        tail(args.path)
+        return
+
+    key_expr = f"{args.device_id}/telemetry/**"
+    session = None
+    if args.gateway:
+        logger.info(f"Using RPC gateway: {args.gateway}")
+        sub_client = GatewaySubscriberClient(args.gateway)
+    else:
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        logger.info(f"Connecting to router: {args.connect}")
+        session = zenoh.open(config)
+        sub_client = ZenohSubscriberClient(session)
+
+    writer = TelemetryBusWriter(args.path, args.slots, args.values)
+    fan_in = TelemetryFanIn(writer)
+    try:
+        sub_client.subscribe_sample(key_expr, fan_in.on_sample)
+        logger.info(f"Writing {key_expr} to {args.path} ({args.slots} records of {args.values} values)")
+        while True:
+            time.sleep(args.stats_interval)
+            logger.info(
+                f"Telemetry bus: {fan_in.samples} samples, {fan_in.records} records, {fan_in.undecoded} undecoded"
+            )
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sub_client.unsubscribe_all()
+        writer.close(unlink=True)
+        if session is not None:
+            session.close()
+
+
+if __name__ == "__main__":
+    main()
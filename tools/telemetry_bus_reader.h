@@ -0,0 +1,242 @@
+// Telemetry bus reader - C++ reader of the shared-memory telemetry ring
+//
+// Header-only counterpart of TelemetryBusReader in tools/rpc/telemetry_bus.py
+// (the file layout is documented there). Maps the ring read-only and copies
+// records out under the per-slot seqlock; a record overwritten while it was
+// read, or before poll() got to it, is counted in lost(). Linux only.
+//
+//   zenoh_rpc::TelemetryBusReader bus;
+//   if (!bus.open()) { ... }
+//   zenoh_rpc::TelemetryRecord records[64];
+//   size_t n = bus.poll(records, 64);
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace zenoh_rpc {
+
+constexpr const char* kTelemetryBusPath = "/dev/shm/zenoh_rpc_telemetry";
+constexpr uint32_t kTelemetryBusMagic = 0x5A544231;  // "ZTB1"
+constexpr uint16_t kTelemetryBusVersion = 1;
+constexpr size_t kTelemetryBusStreamsOffset = 4096;
+constexpr size_t kTelemetryBusStreamEntrySize = 256;
+constexpr size_t kTelemetryBusMaxKeyLen = 120;
+constexpr size_t kTelemetryBusMaxColumnsLen = 128;
+constexpr size_t kTelemetryBusSlotHeaderSize = 32;
+// Values copied per record; columns beyond are dropped
+constexpr size_t kTelemetryBusMaxValues = 16;
+
+struct TelemetryStream {
+  std::string key_expr;
+  std::vector<std::string> columns;
+};
+
+struct TelemetryRecord {
+  uint64_t receive_ns;  // Host time of the sample
+  int64_t device_us;    // Device time (source timestamp)
+  uint32_t sequence;    // Sample sequence number
+  uint16_t stream;      // Index for TelemetryBusReader::stream()
+  uint16_t count;       // Valid entries of values
+  double values[kTelemetryBusMaxValues];
+};
+
+class TelemetryBusReader {
+ public:
+  TelemetryBusReader() = default;
+  ~TelemetryBusReader() { close(); }
+
+  // Non-copyable
+  TelemetryBusReader(const TelemetryBusReader&) = delete;
+  TelemetryBusReader& operator=(const TelemetryBusReader&) = delete;
+
+  // Map the ring; from_start also returns the records still in it
+  bool open(const char* path = kTelemetryBusPath, bool from_start = false) {
+    path_ = path;
+    return map(from_start);
+  }
+
+  void close() {
+    if (base_ != nullptr) {
+      munmap(const_cast<uint8_t*>(base_), size_);
+      base_ = nullptr;
+    }
+  }
+
+  // Copy up to max records written since the last call, oldest first
+  size_t poll(TelemetryRecord* out, size_t max) {
+    if (base_ == nullptr) {
+      return 0;
+    }
+    uint64_t write_index = load_u64(kWriteIndexOffset);
+    if (write_index == cursor_ && writer_restarted()) {
+      // The path names a new ring: follow it from its start
+      if (!map(true)) {
+        return 0;
+      }
+      write_index = load_u64(kWriteIndexOffset);
+    }
+    if (write_index - cursor_ > slot_count_) {
+      lost_ += write_index - cursor_ - slot_count_;
+      cursor_ = write_index - slot_count_;
+    }
+
+    size_t n = 0;
+    for (; cursor_ < write_index && n < max; ++cursor_) {
+      const uint8_t* slot =
+          base_ + header_size_ + (cursor_ & (slot_count_ - 1)) * slot_size_;
+      const uint64_t expected = 2 * cursor_ + 2;
+      if (__atomic_load_n(reinterpret_cast<const uint64_t*>(slot),
+                          __ATOMIC_ACQUIRE) != expected) {
+        ++lost_;
+        continue;
+      }
+      TelemetryRecord& r = out[n];
+      std::memcpy(&r.receive_ns, slot + 8, 8);
+      std::memcpy(&r.device_us, slot + 16, 8);
+      std::memcpy(&r.sequence, slot + 24, 4);
+      std::memcpy(&r.stream, slot + 28, 2);
+      std::memcpy(&r.count, slot + 30, 2);
+      if (r.count > kTelemetryBusMaxValues) {
+        r.count = kTelemetryBusMaxValues;
+      }
+      std::memcpy(r.values, slot + kTelemetryBusSlotHeaderSize,
+                  r.count * sizeof(double));
+      // Seq unchanged after the copy: the writer did not lap the slot
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(reinterpret_cast<const uint64_t*>(slot),
+                          __ATOMIC_RELAXED) != expected) {
+        ++lost_;
+        continue;
+      }
+      ++n;
+    }
+    return n;
+  }
+
+  // Key expression and column names of a record's stream, NULL if unknown
+  const TelemetryStream* stream(uint16_t index) {
+    if (index >= streams_.size()) {
+      refresh_streams();
+    }
+    return index < streams_.size() ? &streams_[index] : nullptr;
+  }
+
+  uint64_t lost() const { return lost_; }
+  bool is_open() const { return base_ != nullptr; }
+
+ private:
+  static constexpr size_t kStreamCountOffset = 20;
+  static constexpr size_t kWriteIndexOffset = 24;
+
+  bool map(bool from_start) {
+    close();
+    streams_.clear();
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < kTelemetryBusStreamsOffset) {
+      ::close(fd);
+      return false;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+      return false;
+    }
+    base_ = static_cast<const uint8_t*>(p);
+    size_ = st.st_size;
+    inode_ = st.st_ino;
+
+    uint32_t magic;
+    uint16_t version, header_pages;
+    std::memcpy(&magic, base_, 4);
+    std::memcpy(&version, base_ + 4, 2);
+    std::memcpy(&header_pages, base_ + 6, 2);
+    std::memcpy(&slot_count_, base_ + 8, 4);
+    std::memcpy(&slot_size_, base_ + 12, 4);
+    header_size_ = static_cast<size_t>(header_pages) * 4096;
+    if (magic != kTelemetryBusMagic || version != kTelemetryBusVersion ||
+        slot_count_ == 0 || (slot_count_ & (slot_count_ - 1)) != 0 ||
+        header_size_ + static_cast<size_t>(slot_count_) * slot_size_ >
+            size_) {
+      close();
+      return false;
+    }
+    const uint64_t write_index = load_u64(kWriteIndexOffset);
+    cursor_ = !from_start              ? write_index
+              : write_index > slot_count_ ? write_index - slot_count_
+                                          : 0;
+    return true;
+  }
+
+  bool writer_restarted() const {
+    struct stat st;
+    return stat(path_.c_str(), &st) == 0 && st.st_ino != inode_;
+  }
+
+  void refresh_streams() {
+    const uint32_t count = __atomic_load_n(
+        reinterpret_cast<const uint32_t*>(base_ + kStreamCountOffset),
+        __ATOMIC_ACQUIRE);
+    for (size_t i = streams_.size(); i < count; ++i) {
+      const uint8_t* entry =
+          base_ + kTelemetryBusStreamsOffset + i * kTelemetryBusStreamEntrySize;
+      uint16_t n_columns, key_len;
+      if (__atomic_load_n(reinterpret_cast<const uint32_t*>(entry),
+                          __ATOMIC_ACQUIRE) != 1) {
+        break;
+      }
+      std::memcpy(&n_columns, entry + 4, 2);
+      std::memcpy(&key_len, entry + 6, 2);
+      TelemetryStream s;
+      s.key_expr.assign(reinterpret_cast<const char*>(entry + 8),
+                        key_len < kTelemetryBusMaxKeyLen
+                            ? key_len
+                            : kTelemetryBusMaxKeyLen);
+      const char* names = reinterpret_cast<const char*>(
+          entry + 8 + kTelemetryBusMaxKeyLen);
+      const size_t names_len = strnlen(names, kTelemetryBusMaxColumnsLen);
+      size_t start = 0;
+      while (s.columns.size() < n_columns && start <= names_len) {
+        size_t end = start;
+        while (end < names_len && names[end] != ',') {
+          ++end;
+        }
+        s.columns.emplace_back(names + start, end - start);
+        start = end + 1;
+      }
+      streams_.push_back(std::move(s));
+    }
+  }
+
+  uint64_t load_u64(size_t offset) const {
+    return __atomic_load_n(reinterpret_cast<const uint64_t*>(base_ + offset),
+                           __ATOMIC_ACQUIRE);
+  }
+
+  std::string path_;
+  const uint8_t* base_ = nullptr;
+  size_t size_ = 0;
+  ino_t inode_ = 0;
+  size_t header_size_ = 0;
+  uint32_t slot_count_ = 0;
+  uint32_t slot_size_ = 0;
+  uint64_t cursor_ = 0;
+  uint64_t lost_ = 0;
+  std::vector<TelemetryStream> streams_;
+};
+
+}  // namespace zenoh_rpc
@@ -0,0 +1,67 @@
+// Telemetry bus tail - prints the records of the shared-memory telemetry bus
+//
+// Example reader for tools/telemetry_bus_reader.h; run next to the writer
+// (tools/telemetry_bus.py). Reports the records per second and the lost
+// count every second instead with --rate.
+//
+// Build and run:
+//   g++ -O2 -std=c++17 -o /tmp/telemetry_bus_tail tools/telemetry_bus_tail.cpp
+//   /tmp/telemetry_bus_tail [path] [--rate]
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "telemetry_bus_reader.h"
+
+int main(int argc, char** argv) {
+  const char* path = zenoh_rpc::kTelemetryBusPath;
+  bool rate = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--rate") == 0) {
+      rate = true;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  zenoh_rpc::TelemetryBusReader bus;
+  if (!bus.open(path)) {
+    std::fprintf(stderr, "Cannot open telemetry bus %s\n", path);
+    return 1;
+  }
+
+  static zenoh_rpc::TelemetryRecord records[256];
+  uint64_t count = 0;
+  auto last = std::chrono::steady_clock::now();
+  while (true) {
+    const size_t n = bus.poll(records, 256);
+    for (size_t i = 0; i < n && !rate; ++i) {
+      const zenoh_rpc::TelemetryRecord& r = records[i];
+      const zenoh_rpc::TelemetryStream* s = bus.stream(r.stream);
+      std::printf("%.6f %s seq=%" PRIu32 " device_us=%" PRId64,
+                  r.receive_ns / 1e9, s ? s->key_expr.c_str() : "?",
+                  r.sequence, r.device_us);
+      for (uint16_t c = 0; c < r.count; ++c) {
+        const bool named = s && c < s->columns.size();
+        std::printf(" %s=%g", named ? s->columns[c].c_str() : "?",
+                    r.values[c]);
+      }
+      std::printf("\n");
+    }
+    count += n;
+    const auto now = std::chrono::steady_clock::now();
+    if (rate && now - last >= std::chrono::seconds(1)) {
+      std::printf("%" PRIu64 " records/s, lost %" PRIu64 "\n", count,
+                  bus.lost());
+      count = 0;
+      last = now;
+    }
+    if (n == 0) {
+      std::fflush(stdout);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
@@ -0,0 +1,192 @@
+"""
+Telemetry recorder - records device telemetry with per-sample sequence/latency metadata.
+
+Every telemetry sample is written as one JSON line:
+    {"host_time": ..., "key_expr": ..., "seq": ..., "source_us": ..., "age_us": ..., "data": {...}}
+
+Compressed batches (<topic>/batch, see rpc/telemetry_batch.py) are expanded to one line per sample, with the
+device timestamp and the position in the batch:
+    {..., "key_expr": ".../batch", "seq": ..., "batch_index": ..., "device_ms": ..., "data": {...}}
+
+Loss, reordering and latency counters (see rpc/telemetry_stats.py) are logged periodically and can be
+written in the Prometheus text format, e.g. for the node_exporter textfile collector.
+
+Usage:
+    # Record all telemetry of one device
+    uv run python tools/telemetry_recorder.py -d pico2w-001 -o sensor.jsonl
+
+    # Record every device, export metrics every 10 s
+    uv run python tools/telemetry_recorder.py -d "*" --metrics-file /var/lib/node_exporter/zenoh.prom
+
+    # Start with the device's cached samples and fetch missed ones (CONFIG_APP_ZENOH_ADVANCED_PUBLICATION)
+    uv run python tools/telemetry_recorder.py -d pico2w-001 -o sensor.jsonl --history 16 --recover
+"""
+
+import argparse
+import json
+import logging
+import os
+import sys
+import threading
+import time
+from typing import Optional, TextIO
+
+import zenoh
+from google.protobuf import json_format
+from rpc.gateway_client import GatewaySubscriberClient
+from rpc.service_client import TELEMETRY_TOPICS
+from rpc.telemetry_batch import BATCH_SUFFIX, decode_batch_payload
+from rpc.telemetry_stats import TelemetryStats, host_monotonic_us
+from rpc.zenoh_attachment import Attachment
+from rpc.zenoh_rpc_client import AdvancedSubscription, ZenohSubscriberClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Record Zenoh RPC telemetry with loss/latency accounting")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument(
+        "-g", "--gateway", type=str, help="Use a local RPC gateway (http://host:port or unix:///path) instead of zenoh"
+    )
+    parser.add_argument(
+        "-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID, or * for all devices (default: {DEVICE_ID})"
+    )
+    parser.add_argument("-o", "--output", type=str, help="JSON lines output file (default: stdout)")
+    parser.add_argument("--duration", type=float, help="Stop after this many seconds (default: until Ctrl+C)")
+    parser.add_argument("--metrics-interval", type=float, default=10.0, help="Stats report interval in seconds")
+    parser.add_argument("--metrics-file", type=str, help="Write Prometheus text metrics to this file on each report")
+    parser.add_argument(
+        "--history", type=int, default=0, help="Cached samples per publisher to record on start (default: 0)"
+    )
+    parser.add_argument("--recover", action="store_true", help="Fetch samples missed in a gap from the device cache")
+    return parser.parse_args()
+
+
+class TelemetryRecorder:
+    """Decodes telemetry samples, updates TelemetryStats and writes JSON lines."""
+
+    def __init__(self, out: TextIO, stats: TelemetryStats):
+        self.out = out
+        self.stats = stats
+        self._lock = threading.Lock()
+
+    def on_sample(self, key_expr: str, payload: bytes, attachment: Optional[bytes]):
+        arrival_us = host_monotonic_us()
+        self.stats.observe(key_expr, attachment, arrival_us)
+
+        is_batch = key_expr.endswith(BATCH_SUFFIX)
+        topic = key_expr[: -len(BATCH_SUFFIX)] if is_batch else key_expr
+        msg_cls = next((cls for suffix, cls in TELEMETRY_TOPICS.items() if topic.endswith(suffix)), None)
+        record = {"host_time": time.time(), "key_expr": key_expr}
+        att = Attachment.decode(attachment)
+        if att.sequence is not None:
+            record["seq"] = att.sequence
+            record["source_us"] = att.source_timestamp_us
+            stream = self.stats.stream(key_expr)
+            if stream is not None:
+                record["age_us"] = stream.last_age_us
+        if msg_cls is None:
+            record["payload_hex"] = payload.hex()
+        elif is_batch:
+            self._write_batch(record, payload, msg_cls)
+            return
+        else:
+            try:
+                msg = msg_cls()
+                msg.ParseFromString(payload)
+                record["data"] = json_format.MessageToDict(msg, preserving_proto_field_name=True)
+            except Exception as e:
+                logger.error(f"Failed to parse {msg_cls.__name__} from {key_expr}: {e}")
+                record["payload_hex"] = payload.hex()
+
+        self._write([json.dumps(record)])
+
+    def _write_batch(self, record: dict, payload: bytes, msg_cls):
+        try:
+            columns = decode_batch_payload(payload, msg_cls)
+        except Exception as e:
+            logger.error(f"Failed to decode {msg_cls.__name__} batch from {record['key_expr']}: {e}")
+            record["payload_hex"] = payload.hex()
+            self._write([json.dumps(record)])
+            return
+        lines = []
+        for i, row in enumerate(columns.rows()):
+            device_ms = row.pop("timestamp_ms")
+            lines.append(json.dumps({**record, "batch_index": i, "device_ms": device_ms, "data": row}))
+        self._write(lines)
+
+    def _write(self, lines: list[str]):
+        with self._lock:
+            for line in lines:
+                self.out.write(line + "\n")
+            self.out.flush()
+
+
+def report(stats: TelemetryStats, metrics_file: Optional[str]):
+    for summary in stats.summary():
+        logger.info(f"Telemetry stats: {summary}")
+    if metrics_file:
+        # Write atomically so scrapers never see a partial file
+        tmp = f"{metrics_file}.tmp"
+        with open(tmp, "w") as f:
+            f.write(stats.to_prometheus())
+        os.replace(tmp, metrics_file)
+
+
+def main():
+    args = parse_args()
+    key_expr = f"{args.device_id}/telemetry/**"
+
+    session = None
+    if args.gateway:
+        logger.info(f"Using RPC gateway: {args.gateway}")
+        sub_client = GatewaySubscriberClient(args.gateway)
+    else:
+        config = zenoh.Config()
+        config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+        config.insert_json5("scouting/multicast/enabled", "false")
+        logger.info(f"Connecting to router: {args.connect}")
+        session = zenoh.open(config)
+        sub_client = ZenohSubscriberClient(session)
+
+    out = open(args.output, "a") if args.output else sys.stdout
+    stats = TelemetryStats()
+    recorder = TelemetryRecorder(out, stats)
+
+    advanced = None
+    if args.history > 0 or args.recover:
+        advanced = AdvancedSubscription(history=args.history, recovery=args.recover)
+    try:
+        sub_client.subscribe_sample(key_expr, recorder.on_sample, advanced=advanced)
+        logger.info(f"Recording {key_expr}")
+        start = time.monotonic()
+        next_report = start + args.metrics_interval
+        while args.duration is None or time.monotonic() - start < args.duration:
+            time.sleep(0.2)
+            if time.monotonic() >= next_report:
+                report(stats, args.metrics_file)
+                next_report += args.metrics_interval
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sub_client.unsubscribe_all()
+        report(stats, args.metrics_file)
+        if args.output:
+            out.close()
+        if session is not None:
+            session.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+"""
+Telemetry recovery - late-joiner history and gap recovery latency with the device publication cache.
+
+Needs firmware built with CONFIG_APP_ZENOH_ADVANCED_PUBLICATION=y. A plain reference subscriber follows the topic
+all the time; against it the tool measures:
+
+    late joiner   every --interval seconds an advanced subscriber with --history is declared; reported are the number
+                  of cached samples it receives (sequence not newer than the reference had seen) and the time from
+                  declaring it to the first and last of them
+    recovery      a long-lived advanced subscriber with recovery; a sample arriving after a later one was a gap
+                  filled from the cache, its latency is the time since the gap was seen. Gaps need real loss, e.g.
+                  a weak Wi-Fi link or `tc qdisc add dev <if> root netem loss 5%` on the router host
+
+The RAM the caches take on the device is in its periodic "Heap: ... allocated" log (compare with the option off).
+
+Usage:
+    uv run python tools/telemetry_recovery.py -d pico2w-001 --history 16 --rounds 10
+    uv run python tools/telemetry_recovery.py --rounds 0 --duration 300 --label netem5 --json recovery.jsonl
+"""
+
+import argparse
+import json
+import statistics
+import threading
+import time
+from typing import Optional
+
+import zenoh
+from rpc.zenoh_attachment import Attachment
+from rpc.zenoh_rpc_client import AdvancedSubscription, ZenohSubscriberClient
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Measure late-joiner history and gap recovery latency")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument("-d", "--device-id", type=str, default=DEVICE_ID, help=f"Device ID (default: {DEVICE_ID})")
+    parser.add_argument("-t", "--topic", type=str, default="telemetry/sensor", help="Topic below the device ID")
+    parser.add_argument("--history", type=int, default=16, help="Samples requested by late joiners (default: 16)")
+    parser.add_argument("--rounds", type=int, default=5, help="Late-joiner rounds (default: 5)")
+    parser.add_argument("--interval", type=float, default=5.0, help="Seconds between rounds (default: 5)")
+    parser.add_argument("--settle", type=float, default=2.0, help="Seconds a late joiner waits for history")
+    parser.add_argument("--duration", type=float, default=0.0, help="Seconds of gap recovery measurement after rounds")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. link type)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def sequence_of(attachment: Optional[bytes]) -> Optional[int]:
+    return Attachment.decode(attachment).sequence
+
+
+class Reference:
+    """Highest sequence number seen by a plain subscriber."""
+
+    def __init__(self):
+        self.highest: Optional[int] = None
+        self._lock = threading.Lock()
+
+    def on_sample(self, _key: str, _payload: bytes, attachment: Optional[bytes]):
+        seq = sequence_of(attachment)
+        with self._lock:
+            if seq is not None and (self.highest is None or seq > self.highest):
+                self.highest = seq
+
+
+class GapTracker:
+    """Latency of samples that arrive after a later one (filled from the cache)."""
+
+    def __init__(self):
+        self.received = 0
+        self.latencies_ms: list[float] = []
+        self._highest: Optional[int] = None
+        self._gap_seen: dict[int, float] = {}
+        self._lock = threading.Lock()
+
+    def on_sample(self, _key: str, _payload: bytes, attachment: Optional[bytes]):
+        now = time.monotonic()
+        seq = sequence_of(attachment)
+        if seq is None:
+            return
+        with self._lock:
+            self.received += 1
+            if self._highest is not None and seq > self._highest + 1:
+                for missing in range(self._highest + 1, seq):
+                    self._gap_seen[missing] = now
+            seen = self._gap_seen.pop(seq, None)
+            if seen is not None:
+                self.latencies_ms.append((now - seen) * 1000)
+            if self._highest is None or seq > self._highest:
+                self._highest = seq
+
+    @property
+    def open_gaps(self) -> int:
+        return len(self._gap_seen)
+
+
+def late_joiner_round(sub_client: ZenohSubscriberClient, key_expr: str, reference: Reference, args) -> dict:
+    arrivals: list[float] = []
+    known = reference.highest
+    t0 = time.monotonic()
+
+    def on_sample(_key: str, _payload: bytes, attachment: Optional[bytes]):
+        seq = sequence_of(attachment)
+        if seq is not None and known is not None and seq <= known:
+            arrivals.append(time.monotonic() - t0)
+
+    sub_id = sub_client.subscribe_sample(key_expr, on_sample, advanced=AdvancedSubscription(history=args.history))
+    time.sleep(args.settle)
+    sub_client.unsubscribe(sub_id)
+    return {
+        "history": len(arrivals),
+        "first_ms": round(arrivals[0] * 1000, 1) if arrivals else None,
+        "last_ms": round(arrivals[-1] * 1000, 1) if arrivals else None,
+    }
+
+
+def main():
+    args = parse_args()
+    key_expr = f"{args.device_id}/{args.topic}"
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    sub_client = ZenohSubscriberClient(session)
+    reference = Reference()
+    sub_client.subscribe_sample(key_expr, reference.on_sample)
+
+    result = {"label": args.label, "key_expr": key_expr, "history": args.history, "rounds": []}
+    try:
+        # Let the reference see the current sequence first
+        time.sleep(args.interval)
+        for i in range(args.rounds):
+            r = late_joiner_round(sub_client, key_expr, reference, args)
+            result["rounds"].append(r)
+            print(f"round {i + 1}: {r['history']} cached samples, first {r['first_ms']} ms, last {r['last_ms']} ms")
+            time.sleep(max(0.0, args.interval - args.settle))
+
+        if args.duration > 0:
+            tracker = GapTracker()
+            sub_client.subscribe_sample(key_expr, tracker.on_sample, advanced=AdvancedSubscription(recovery=True))
+            print(f"Measuring gap recovery for {args.duration:.0f} s...")
+            time.sleep(args.duration)
+            lat = sorted(tracker.latencies_ms)
+            result["recovery"] = {
+                "received": tracker.received,
+                "recovered": len(lat),
+                "unrecovered": sub_client.unrecovered + tracker.open_gaps,
+                "p50_ms": round(statistics.median(lat), 1) if lat else None,
+                "max_ms": round(lat[-1], 1) if lat else None,
+            }
+            print(f"recovery: {result['recovery']}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sub_client.unsubscribe_all()
+        session.close()
+
+    last = [r["last_ms"] for r in result["rounds"] if r["last_ms"] is not None]
+    if last:
+        result["history_last_p50_ms"] = round(statistics.median(last), 1)
+        print(f"late joiner: history complete after {result['history_last_p50_ms']} ms (median)")
+    if args.json:
+        with open(args.json, "a") as f:
+            f.write(json.dumps(result) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+"""
+Timed jitter - actuation jitter of SetLed across devices, run on arrival versus at a scheduled time.
+
+Every round toggles the LED of all devices (-d, repeatable) with concurrent calls, in two modes:
+
+    immediate   EXECUTE_AT_US = 0: the handler runs when the query arrives
+    timed       EXECUTE_AT_US = T: the device queues the decoded call and runs it at T on its clock (T = now + --lead)
+
+Either way the reply carries the device time the implementation started, which the device clocks (synced over
+<device>/rpc/clock, tools/rpc/device_clock.py) turn into host time. Reported per mode:
+
+    spread      per round, latest minus earliest start across the devices (needs two or more devices)
+    offset      start minus the send time (immediate) or minus T (timed)
+
+The clock error bound (half the best sync round trip, per device) limits what the timed figures can resolve. Each
+board needs its own CONFIG_APP_DEVICE_ID.
+
+Usage:
+    uv run python tools/timed_jitter.py -d pico2w-001 -d pico2w-002
+    uv run python tools/timed_jitter.py -d pico2w-001 -d pico2w-002 --rounds 100 --lead 20 --label wifi \
+        --json timed_jitter.jsonl
+"""
+
+import argparse
+import json
+import logging
+import statistics
+import time
+from concurrent.futures import ThreadPoolExecutor
+from typing import Optional
+
+import zenoh
+from rpc import service_pb2 as pb
+from rpc.device_clock import DeviceClock, host_us
+from rpc.service_client import DeviceServiceClient
+from rpc.zenoh_attachment import Attachment, execute_at_attachment
+from rpc.zenoh_rpc_client import ZenohRpcClient
+
+logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(name)s - %(levelname)s - %(message)s")
+logger = logging.getLogger(__name__)
+
+DEVICE_ID = "pico2w-001"
+DEFAULT_ROUTER = "tcp/127.0.0.1:7447"
+MODES = ("immediate", "timed")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Measure actuation jitter of immediate and timed RPC calls")
+    parser.add_argument(
+        "-c",
+        "--connect",
+        type=str,
+        default=DEFAULT_ROUTER,
+        help=f"Router endpoint to connect to (default: {DEFAULT_ROUTER})",
+    )
+    parser.add_argument(
+        "-d", "--device-id", action="append", dest="device_ids", help=f"Device ID, repeatable (default: {DEVICE_ID})"
+    )
+    parser.add_argument("--rounds", type=int, default=50, help="Rounds per mode (default: 50)")
+    parser.add_argument("--lead", type=float, default=50.0, help="Target time ahead of sending [ms] (default: 50)")
+    parser.add_argument("--interval", type=float, default=0.2, help="Seconds between rounds (default: 0.2)")
+    parser.add_argument("--sync-samples", type=int, default=16, help="Clock queries per sync (default: 16)")
+    parser.add_argument("--resync", type=float, default=5.0, help="Sync the clocks again after seconds (default: 5)")
+    parser.add_argument("--label", type=str, default="", help="Label stored with the results (e.g. transport)")
+    parser.add_argument("--json", type=str, help="Append the result as one JSON line to this file")
+    return parser.parse_args()
+
+
+def percentile(sorted_values: list[float], q: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(q * len(sorted_values)))]
+
+
+def stats_us(values: list[float]) -> Optional[dict]:
+    if not values:
+        return None
+    values = sorted(values)
+    return {
+        "mean": round(statistics.fmean(values), 1),
+        "stdev": round(statistics.pstdev(values), 1),
+        "p50": round(percentile(values, 0.50), 1),
+        "p99": round(percentile(values, 0.99), 1),
+        "max": round(values[-1], 1),
+    }
+
+
+class Device:
+    """SetLed client and clock of one device."""
+
+    def __init__(self, session: zenoh.Session, device_id: str):
+        self.device_id = device_id
+        rpc_client = ZenohRpcClient(session, device_id)
+        self.service = DeviceServiceClient(rpc_client)
+        self.clock = DeviceClock(rpc_client)
+
+    def set_led_at(self, request: bytes, device_us: int) -> tuple[Optional[float], Optional[str]]:
+        """Host time the implementation started, or the error."""
+        result = self.service.set_led_raw(request, execute_at_attachment(device_us))
+        if not result.success:
+            return None, result.error or "failed"
+        started_us = Attachment.decode(result.attachment).execute_at_us
+        if started_us is None:
+            # Firmware without timed calls runs it but cannot tell when
+            return None, "no start time in reply"
+        return self.clock.from_device_us(started_us), None
+
+
+def run_round(pool: ThreadPoolExecutor, devices: list[Device], request: bytes, mode: str, lead_us: float) -> dict:
+    if mode == "timed":
+        reference_us = host_us() + lead_us
+        targets = [d.clock.to_device_us(reference_us) for d in devices]
+    else:
+        reference_us = host_us()
+        targets = [0] * len(devices)
+    results = list(pool.map(lambda args: args[0].set_led_at(request, args[1]), zip(devices, targets)))
+    starts = [start for start, _ in results if start is not None]
+    return {
+        "offsets_us": [start - reference_us for start in starts],
+        "spread_us": max(starts) - min(starts) if len(starts) == len(devices) and len(starts) > 1 else None,
+        "errors": [error for _, error in results if error is not None],
+    }
+
+
+def main():
+    args = parse_args()
+    device_ids = args.device_ids or [DEVICE_ID]
+    config = zenoh.Config()
+    config.insert_json5("connect/endpoints", f'["{args.connect}"]')
+    config.insert_json5("scouting/multicast/enabled", "false")
+    session = zenoh.open(config)
+    devices = [Device(session, device_id) for device_id in device_ids]
+    lead_us = args.lead * 1000.0
+
+    results = {mode: {"offsets_us": [], "spreads_us": [], "errors": {}} for mode in MODES}
+    clock_errors_us = {}
+    try:
+        for device in devices:
+            clock = device.clock
+            if not clock.sync(args.sync_samples):
+                logger.error(f"{device.device_id}: no answer on {clock.key_expr} (firmware without timed calls?)")
+                raise SystemExit(1)
+            clock_errors_us[device.device_id] = clock.error_us
+            logger.info(f"{device.device_id}: clock offset {clock.offset_us:.0f} us, +/- {clock.error_us:.0f} us")
+
+        with ThreadPoolExecutor(max_workers=len(devices)) as pool:
+            for n in range(args.rounds):
+                if devices[0].clock.age_s() > args.resync:
+                    for device in devices:
+                        device.clock.sync(args.sync_samples)
+                        previous = clock_errors_us[device.device_id]
+                        clock_errors_us[device.device_id] = max(previous, device.clock.error_us)
+                request = pb.LedRequest(on=n % 2 == 0).SerializeToString()
+                # Alternate the modes so that both see the same link conditions
+                for mode in MODES:
+                    round_result = run_round(pool, devices, request, mode, lead_us)
+                    summary = results[mode]
+                    summary["offsets_us"].extend(round_result["offsets_us"])
+                    if round_result["spread_us"] is not None:
+                        summary["spreads_us"].append(round_result["spread_us"])
+                    for error in round_result["errors"]:
+                        summary["errors"][error] = summary["errors"].get(error, 0) + 1
+                    time.sleep(args.interval / 2)
+    finally:
+        session.close()
+
+    rows = []
+    for mode in MODES:
+        summary = results[mode]
+        row = {
+            "mode": mode,
+            "calls": len(summary["offsets_us"]),
+            "errors": summary["errors"],
+            "offset_us": stats_us(summary["offsets_us"]),
+            "spread_us": stats_us(summary["spreads_us"]),
+        }
+        rows.append(row)
+        logger.info(
+            f"{mode:9s} calls={row['calls']} errors={row['errors']} offset={row['offset_us']} spread={row['spread_us']}"
+        )
+    logger.info(f"Clock error bound per device [us]: {clock_errors_us}")
+    if args.json:
+        with open(args.json, "a") as f:
+            record = {
+                "label": args.label,
+                "devices": device_ids,
+                "lead_ms": args.lead,
+                "clock_error_us": clock_errors_us,
+                "rows": rows,
+            }
+            f.write(json.dumps(record) + "\n")
+
+
+if __name__ == "__main__":
+    main()